@@ -2,10 +2,14 @@
 //
 
 #include "CUESDK.h"
+#include "ConnectionSupervisor.h"
+#include "DeviceManager.h"
+#include "Easing.h"
+#include "FrameClock.h"
+#include "Framebuffer.h"
 
 #include <windows.h>
 #include <iostream>
-#include <thread>
 #include <future>
 #include <vector>
 
@@ -29,71 +33,57 @@ const char* toString(CorsairError error)
 	}
 }
 
-std::vector<CorsairLedColor> getAvailableKeys() 
-{
-	auto colorsVector = std::vector<CorsairLedColor>();
-	for (auto deviceIndex = 0; deviceIndex < CorsairGetDeviceCount(); deviceIndex++) {
-		if (auto deviceInfo = CorsairGetDeviceInfo(deviceIndex)) {
-			switch (deviceInfo->type) {
-			case CDT_Mouse: {
-				auto numberOfKeys = deviceInfo->physicalLayout - CPL_Zones1 + 1;
-				for (auto i = 0; i < numberOfKeys; i++) {
-					auto ledId = static_cast<CorsairLedId>(CLM_1 + i);
-					colorsVector.push_back(CorsairLedColor{ ledId, 0, 0, 0 });
-				}
-			} break;
-			case CDT_Keyboard: {
-				auto ledPositions = CorsairGetLedPositions();
-				if (ledPositions) {
-					for (auto i = 0; i < ledPositions->numberOfLed; i++) {
-						auto ledId = ledPositions->pLedPosition[i].ledId;
-						colorsVector.push_back(CorsairLedColor{ ledId, 0, 0, 0 });
-					}
-				}
-			} break;
-			case CDT_Headset: {
-				colorsVector.push_back(CorsairLedColor{ CLH_LeftLogo, 0, 0, 0 });
-				colorsVector.push_back(CorsairLedColor{ CLH_RightLogo, 0, 0, 0 });
-			} break;
-			}
-		}
-	}
-	return colorsVector;
-}
-
-void performPulseEffect(std::vector<CorsairLedColor> &ledColorsVec)
+void performPulseEffect(Framebuffer &frame, FrameClock &frameClock, ConnectionSupervisor &connection)
 {
 	static auto waveDuration = 500;
-	const auto timePerFrame = 25;
-	for (auto x = .0; x < 2; x += static_cast<double>(timePerFrame) / waveDuration) {
-		auto val = (1 - pow(x - 1, 2)) * 255;
-		for (auto &ledColor : ledColorsVec) 
-			ledColor.g = val;
-		CorsairSetLedsColorsAsync(ledColorsVec.size(), ledColorsVec.data(), nullptr, nullptr);
+	PhaseAccumulator wave(2 * waveDuration);
+	auto lastOffset = 0;
+	frameClock.restart();
+	while (true) {
+		const auto tick = frameClock.waitForNextFrame();
+		const auto waves = wave.advance(tick.offset - lastOffset);
+		lastOffset = tick.offset;
+		if (waves)
+			break;
+
+		frame.fill(0, Easing::level(EasingCurve::Quad, wave.phase()), 0);
+		connection.submitAsync(frame);
 		
 		if (GetAsyncKeyState(VK_OEM_PLUS) && waveDuration > 100)
 			waveDuration -= 100;
 		if (GetAsyncKeyState(VK_OEM_MINUS) && waveDuration < 2000)
 			waveDuration += 100;
-		std::this_thread::sleep_for(std::chrono::milliseconds(timePerFrame));
+		wave.setPeriod(2 * waveDuration);
 	}
 }
 
 int main()
 {
-	CorsairPerformProtocolHandshake();
-	if (const auto error = CorsairGetLastError()) {
-		std::cout << "Handshake failed: " << toString(error) << std::endl;
+	// Every device gets its own pipeline, a slow one only delays its own frames.
+	DeviceManager devices;
+	// Reconnects on its own if CUE restarts or another client takes control, replaying the last frame.
+	ConnectionSupervisor connection(devices);
+	if (!connection.connect() && connection.lastError()) {
+		std::cout << "Handshake failed: " << toString(connection.lastError()) << std::endl;
 		getchar();
 		return -1;
 	}
-	auto colorsVector = getAvailableKeys();
-	if (!colorsVector.empty()) {
+	if (devices.deviceCount()) {
+		auto frame = devices.availableLeds();
+		FrameClock frameClock(FR_60Hz);
 		std::cout << "Working... Use \"+\" or \"-\" to increase or decrease speed.\nPress Escape to close program..."; 
 		while (!GetAsyncKeyState(VK_ESCAPE)) {
-			performPulseEffect(colorsVector);
-			std::this_thread::sleep_for(std::chrono::milliseconds(25));
+			performPulseEffect(frame, frameClock, connection);
+		}
+		devices.waitIdle(std::chrono::milliseconds(500));
+		std::cout << std::endl;
+		for (auto i = 0; i < devices.deviceCount(); ++i) {
+			const auto &pipeline = devices.device(i).output.pipeline();
+			std::cout << devices.device(i).model << " (" << DeviceManager::typeName(devices.device(i).type) << "): submit to ack latency "
+				<< pipeline.submitToAckLatency().summary() << ", " << pipeline.stats().coalescedFrames << " frames merged while the SDK was busy" << std::endl;
 		}
+		if (connection.stats().disconnects)
+			std::cout << "Connection lost " << connection.stats().disconnects << " times, recovery time: " << connection.recoveryTime().summary() << std::endl;
 	}
 	return 0;
 }
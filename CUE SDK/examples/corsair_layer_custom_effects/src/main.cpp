@@ -1,7 +1,8 @@
 #include "CorsairLayers/CorsairLayers.h"
+#include "PooledEffect.h"
 
+#include <algorithm>
 #include <iostream>
-#include <memory>
 #include <vector>
 #include <conio.h>
 
@@ -31,51 +32,31 @@ namespace
 		}
 	}
 
-	CorsairFrame* getFrameFunc(Guid effectId, int offset);
-	void freeFrameFunc(CorsairFrame *frame);
-
-	class Effect
+	class Effect : public PooledEffect
 	{
 	public:
 
 		explicit Effect(const std::vector<CorsairLedColor>& colors)
-			: effectId(0), mColors(colors), stopEffect(false)
+			: PooledEffect(static_cast<int>(colors.size())), stopEffect(false), mColors(colors)
 		{
 		}
 
-		virtual ~Effect() {}
+		bool stopEffect;
 
-		CorsairEffect* effect() 
-		{
-			if (!mEffect) {
-				mEffect = std::unique_ptr<CorsairEffect>(new CorsairEffect);
-				mEffect->effectId = reinterpret_cast<Guid>(this);
-				effectId = mEffect->effectId;
-				mEffect->getFrameFunction = getFrameFunc;
-				mEffect->freeFrameFunction = freeFrameFunc;
-			}
-			return mEffect.get();
-		}
+	protected:
 
-		virtual CorsairFrame* getFrame(Guid effectId, int offset) 
+		bool renderFrame(int offset, CorsairFrame &frame) override
 		{
-			if (reinterpret_cast<Effect*>(effectId) != this || stopEffect) {
-				return nullptr;
-			} else {
-				CorsairFrame *frame = new CorsairFrame;
-				frame->size = static_cast<int>(mColors.size());
-				frame->ledsColors = new CorsairLedColor[mColors.size()];
-				std::copy(mColors.begin(), mColors.end(), frame->ledsColors);
-				return frame;
+			if (stopEffect) {
+				return false;
 			}
+			frame.size = static_cast<int>(mColors.size());
+			std::copy(mColors.begin(), mColors.end(), frame.ledsColors);
+			return true;
 		}
 
-		Guid effectId;
-		bool stopEffect;
-
 	private:
 		std::vector<CorsairLedColor> mColors;
-		std::unique_ptr<CorsairEffect> mEffect;
 	};
 
 	class BlinkEffect : public Effect 
@@ -87,36 +68,19 @@ namespace
 		{
 		}
 
-		CorsairFrame* getFrame(Guid effectId, int offset) override 
+	protected:
+
+		bool renderFrame(int offset, CorsairFrame &frame) override
 		{
 			if ((offset / 500) % 2 ) {
-				return Effect::getFrame(effectId, offset);
+				return Effect::renderFrame(offset, frame);
 			} else {
-				CorsairFrame *frame = new CorsairFrame;
-				frame->size = 0;
-				frame->ledsColors = nullptr;
-				return frame;
+				frame.size = 0;
+				return true;
 			}
 		}
 	};
 
-	CorsairFrame* getFrameFunc(Guid effectId, int offset) 
-	{
-		if (effectId) {
-			return reinterpret_cast<Effect*>(effectId)->getFrame(effectId, offset);
-		} else {
-			return nullptr;
-		}
-	}
-
-	void freeFrameFunc(CorsairFrame *frame)
-	{
-		if (frame) {
-			delete[] frame->ledsColors;
-			delete frame;
-		}
-	}
-
 	std::vector<CorsairLedColor> getFirstColorList(const CorsairColor &baseColor)
 	{
 		std::vector<CorsairLedColor> colors;
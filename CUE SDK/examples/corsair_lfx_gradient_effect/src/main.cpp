@@ -1,17 +1,17 @@
 #include "CUESDK.h"
 #include "CorsairLFX/CorsairLFX.h"
 #include "Shared/LFX.h"
+#include "FrameClock.h"
 
 #include <Windows.h>
 
+#include <cstdlib>
 #include <iostream>
 #include <vector>
-#include <thread>
 
 const int cDefaultDuration = 1000;
 const double cDefaultPower = 1.0;
-
-using Clock = std::chrono::steady_clock;
+const int cFrameRate = FR_60Hz;
 
 const char* errorString(CorsairError error)
 {
@@ -86,11 +86,11 @@ void generateRamp(CorsairEffect *effect)
 
 void playEffect(CorsairEffect *effect)
 {
-	auto startPoint = Clock::now();
+	FrameClock frameClock(cFrameRate);
 
 	while (!GetAsyncKeyState(VK_ESCAPE)) {
-		auto offset = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startPoint).count();
-		auto frame = CorsairLFXGetFrame(effect->effectId, static_cast<int>(offset));
+		auto tick = frameClock.waitForNextFrame();
+		auto frame = CorsairLFXGetFrame(effect->effectId, tick.offset);
 		
 		if (frame && frame->ledsColors) {
 			auto res = CorsairSetLedsColors(frame->size, frame->ledsColors);
@@ -103,12 +103,11 @@ void playEffect(CorsairEffect *effect)
 
 			if (GetAsyncKeyState(VK_OEM_PLUS) & 0x1) {
 				generateRamp(effect);
-				startPoint = Clock::now();
+				frameClock.restart();
 			}
 		} else {
 			break;
 		}
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
 	}
 }
 
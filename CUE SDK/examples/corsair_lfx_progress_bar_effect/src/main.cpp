@@ -1,14 +1,14 @@
 #include "CUESDK.h"
 #include "CorsairLFX/CorsairLFX.h"
 #include "Shared/LFX.h"
+#include "FrameClock.h"
 
 #include <Windows.h>
 
 #include <iostream>
 #include <vector>
-#include <thread>
 
-using Clock = std::chrono::steady_clock;
+const int cFrameRate = FR_60Hz;
 
 const char* errorString(CorsairError error)
 {
@@ -43,13 +43,13 @@ std::vector<CorsairLedId> getLeds()
 
 void playEffect(CorsairEffect *effect)
 {
-	auto startPoint = Clock::now();
+	FrameClock frameClock(cFrameRate);
 	int progressValue = 0;
 
 	while (true) {
 		
-		auto offset = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startPoint).count();
-		auto frame = CorsairLFXGetFrame(effect->effectId, static_cast<int>(offset));
+		auto tick = frameClock.waitForNextFrame();
+		auto frame = CorsairLFXGetFrame(effect->effectId, tick.offset);
 		
 		if (frame && frame->ledsColors) {
 			auto res = CorsairSetLedsColors(frame->size, frame->ledsColors);
@@ -76,7 +76,6 @@ void playEffect(CorsairEffect *effect)
 		} else {
 			break;
 		}
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
 	}
 }
 
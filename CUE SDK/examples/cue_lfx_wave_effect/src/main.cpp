@@ -1,14 +1,14 @@
 #include "CUESDK.h"
 #include "CUELFX/CUELFX.h"
 #include "Shared/LFX.h"
+#include "FrameClock.h"
 
 #include <Windows.h>
 
 #include <iostream>
 #include <vector>
-#include <thread>
 
-using Clock = std::chrono::steady_clock;
+const int cFrameRate = FR_60Hz;
 
 const char* errorString(CorsairError error)
 {
@@ -41,12 +41,12 @@ std::vector<CorsairLedId> getLeds()
 
 void playEffect(CorsairEffect *effect)
 {
-	auto startPoint = Clock::now();
+	FrameClock frameClock(cFrameRate);
 
 	while (!GetAsyncKeyState(VK_ESCAPE)) {
 		
-		auto offset = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startPoint).count();
-		auto frame = CUELFXGetFrame(effect->effectId, static_cast<int>(offset));
+		auto tick = frameClock.waitForNextFrame();
+		auto frame = CUELFXGetFrame(effect->effectId, tick.offset);
 		
 		if (frame && frame->ledsColors) {
 			auto res = CorsairSetLedsColors(frame->size, frame->ledsColors);
@@ -57,7 +57,6 @@ void playEffect(CorsairEffect *effect)
 				return;
 			}
 		}
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
 	}
 }
 
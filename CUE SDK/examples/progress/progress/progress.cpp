@@ -2,10 +2,12 @@
 //
 
 #include "CUESDK.h"
+#include "DeltaOutput.h"
+#include "FrameClock.h"
+#include "Framebuffer.h"
+#include "LedGeometry.h"
 
 #include <iostream>
-#include <algorithm>
-#include <thread>
 #include <future>
 #include <vector>
 #include <windows.h>
@@ -30,15 +32,6 @@ const char* toString(CorsairError error)
 	}
 }
 
-double getKeyboardWidth(CorsairLedPositions *ledPositions)
-{
-	const auto minmaxLeds = std::minmax_element(ledPositions->pLedPosition, ledPositions->pLedPosition + ledPositions->numberOfLed,
-		[](const CorsairLedPosition &clp1, const CorsairLedPosition &clp2) {
-		return clp1.left < clp2.left;
-	});
-	return minmaxLeds.second->left + minmaxLeds.second->width - minmaxLeds.first->left;
-}
-
 int main()
 {
 	CorsairPerformProtocolHandshake();
@@ -48,28 +41,25 @@ int main()
 		return -1;
 	}
 
-	const auto ledPositions = CorsairGetLedPositions();
-	if (ledPositions && ledPositions->numberOfLed > 0) {
-				
-		const auto keyboardWidth = getKeyboardWidth(ledPositions);
+	LedGeometry geometry;
+	if (geometry.loadFromSdk()) {
 		const auto numberOfSteps = 50;
+		const auto timePerStep = 25;
+		FrameClock frameClock(FR_60Hz);
+		DeltaOutput output;
+		Framebuffer frame;
+		const auto ledIds = geometry.ledIds();
+		const auto x = geometry.normalizedX();
 		std::cout << "Working... Press Escape to close program...";
-		for (auto n = 0; !GetAsyncKeyState(VK_ESCAPE); n++) {
+		while (!GetAsyncKeyState(VK_ESCAPE)) {
 
-			std::vector<CorsairLedColor> vec;
-			const auto currWidth = double(keyboardWidth) * (n % (numberOfSteps + 1)) / numberOfSteps;
+			const auto n = frameClock.waitForNextFrame().offset / timePerStep;
+			const auto progress = static_cast<float>(n % (numberOfSteps + 1)) / numberOfSteps;
 
-			for (auto i = 0; i < ledPositions->numberOfLed; i++) {
-				const auto ledPos = ledPositions->pLedPosition[i];
-				auto ledColor = CorsairLedColor();
-				ledColor.ledId = ledPos.ledId;
-				if (ledPos.left < currWidth)
-					ledColor.r = 255;
-				vec.push_back(ledColor);
+			for (auto i = 0; i < geometry.count(); i++) {
+				frame.set(ledIds[i], x[i] < progress ? 255 : 0, 0, 0);
 			}
-			CorsairSetLedsColors(vec.size(), vec.data());
-
-			std::this_thread::sleep_for(std::chrono::milliseconds(25));
+			output.submit(frame);
 		}
 	}
 	return 0;
@@ -2,9 +2,11 @@
 //
 
 #include "CUESDK.h"
+#include "Easing.h"
+#include "FrameClock.h"
+#include "KeyLayoutTable.h"
 
 #include <iostream>
-#include <thread>
 #include <string>
 
 const char* toString(CorsairError error) 
@@ -27,13 +29,17 @@ const char* toString(CorsairError error)
 	}
 }
 
-void highlightKey(CorsairLedId ledId)
+void highlightKey(CorsairLedId ledId, FrameClock &frameClock)
 {
-	for (auto x = .0; x < 2; x += .1) {
-		auto val = (1 - abs(x - 1)) * 255;
+	const auto highlightDuration = 300;
+	PhaseAccumulator fade(2 * highlightDuration);
+	auto lastOffset = 0;
+	frameClock.restart();
+	for (auto tick = frameClock.waitForNextFrame(); !fade.advance(tick.offset - lastOffset); tick = frameClock.waitForNextFrame()) {
+		lastOffset = tick.offset;
+		auto val = static_cast<int>(Easing::level(EasingCurve::Triangle, fade.phase()));
 		auto ledColor = CorsairLedColor{ ledId, val, val, val };
 		CorsairSetLedsColors(1, &ledColor);
-		std::this_thread::sleep_for(std::chrono::milliseconds(30));
 	}
 }
 
@@ -52,10 +58,14 @@ int main()
 	auto userInputStr = std::string();
 	std::cin >> userInputStr;
 		
+	// Every character is resolved once for the keyboard's layout, not through the SDK per keystroke.
+	KeyLayoutTable keys;
+	keys.updateFromSdk();
+	FrameClock frameClock(FR_60Hz);
 	for (const auto &symbol : userInputStr) {
-		auto ledId = CorsairGetLedIdForKeyName(symbol);
+		auto ledId = keys.ledOf(symbol);
 		if (ledId != CLI_Invalid)
-			highlightKey(ledId);
+			highlightKey(ledId, frameClock);
 	}
     return 0;
 }
@@ -1,7 +1,11 @@
 #pragma once
 
-#ifdef CUELFX_DLL
-#define CUELFX_EXPORT __declspec(dllexport)
+#if defined(_WIN32) || defined(WIN32)
+#   ifdef CUELFX_DLL
+#       define CUELFX_EXPORT __declspec(dllexport)
+#   else
+#       define CUELFX_EXPORT __declspec(dllimport)
+#   endif
 #else
-#define CUELFX_EXPORT __declspec(dllimport)
-#endif
+#   define CUELFX_EXPORT __attribute__((visibility("default")))
+#endif // WIN32
@@ -1,7 +1,11 @@
 #pragma once
 
-#ifdef CORSAIRLFX_DLL
-#define CORSAIRLFX_EXPORT __declspec(dllexport)
+#if defined(_WIN32) || defined(WIN32)
+#   ifdef CORSAIRLFX_DLL
+#       define CORSAIRLFX_EXPORT __declspec(dllexport)
+#   else
+#       define CORSAIRLFX_EXPORT __declspec(dllimport)
+#   endif
 #else
-#define CORSAIRLFX_EXPORT __declspec(dllimport)
-#endif
+#   define CORSAIRLFX_EXPORT __attribute__((visibility("default")))
+#endif // WIN32
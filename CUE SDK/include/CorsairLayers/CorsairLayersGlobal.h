@@ -1,7 +1,11 @@
 #pragma once
 
-#ifdef CORSAIRLAYERS_DLL
-#define CORSAIRLAYERS_EXPORT __declspec(dllexport)
+#if defined(_WIN32) || defined(WIN32)
+#   ifdef CORSAIRLAYERS_DLL
+#       define CORSAIRLAYERS_EXPORT __declspec(dllexport)
+#   else
+#       define CORSAIRLAYERS_EXPORT __declspec(dllimport)
+#   endif
 #else
-#define CORSAIRLAYERS_EXPORT __declspec(dllimport)
-#endif
+#   define CORSAIRLAYERS_EXPORT __attribute__((visibility("default")))
+#endif // WIN32
@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * @file conio.h
+ *
+ * Minimal replacement of the MSVC console header for building the SDK examples against the CUE SDK stand-in.
+ */
+
+#include <stdio.h>
+
+static inline int _getch()
+{
+	return getchar();
+}
+
+static inline int getch()
+{
+	return getchar();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+/**
+ * @file windows.h
+ *
+ * Minimal replacement of the Win32 header for building the SDK examples against the CUE SDK stand-in on
+ * platforms without it. Only what the examples use is provided; key states are simulated by the stand-in
+ * (see CorsairStandInSetKeyState() and CUESDK_STANDIN_RUN_MS).
+ */
+
+#include "CUESDKGlobal.h"
+
+#define VK_LBUTTON    0x01
+#define VK_RBUTTON    0x02
+#define VK_ESCAPE     0x1B
+#define VK_SPACE      0x20
+#define VK_LEFT       0x25
+#define VK_UP         0x26
+#define VK_RIGHT      0x27
+#define VK_DOWN       0x28
+#define VK_OEM_1      0xBA
+#define VK_OEM_PLUS   0xBB
+#define VK_OEM_MINUS  0xBD
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/// Returns 0x8000 while the virtual key is held and sets bit 0 if it was pressed since the previous call.
+	CORSAIR_LIGHTING_SDK_EXPORT short GetAsyncKeyState(int vKey);
+
+	/// Suspends the calling thread for specified number of milliseconds.
+	CORSAIR_LIGHTING_SDK_EXPORT void Sleep(unsigned long milliseconds);
+
+#ifdef __cplusplus
+} //exten "C"
+#endif
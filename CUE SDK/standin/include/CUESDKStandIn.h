@@ -0,0 +1,150 @@
+#pragma once
+
+#include "CUESDK.h"
+
+#include <stdint.h>
+
+/**
+ * @file CUESDKStandIn.h
+ *
+ * Control interface of the local CUE SDK stand-in library. The stand-in implements every function
+ * declared in CUESDK.h against configurable virtual devices, so programs written against the SDK can be
+ * built, benchmarked and regression-tested without CUE running (or without Windows at all).
+ * The CUELFX, CorsairLFX and CorsairLayers libraries are provided by the stand-in as well, with effects
+ * that approximate the ones rendered by the libraries shipped with the SDK.
+ *
+ * Without any explicit configuration the stand-in behaves like a server with a K95 RGB keyboard,
+ * a Scimitar RGB mouse, a VOID RGB headset and an MM800 RGB mousemat attached. The same knobs exposed
+ * by the functions below can be set through environment variables before the first SDK call:
+ *
+ *   CUESDK_STANDIN_DEVICES           comma separated list of k95, k70, m65, scimitar, void, mm800
+ *   CUESDK_STANDIN_LATENCY_US        simulated latency of every CorsairSetLedsColors* call in microseconds
+ *   CUESDK_STANDIN_JITTER_US         random extra latency added on top of CUESDK_STANDIN_LATENCY_US
+ *   CUESDK_STANDIN_QUERY_LATENCY_US  simulated latency of the handshake and every device or LED position query
+ *   CUESDK_STANDIN_ERROR             ServerNotFound or NoControl to start in the corresponding failure state
+ *   CUESDK_STANDIN_TRACE             path of the binary trace file every pushed frame is appended to
+ *   CUESDK_STANDIN_RUN_MS            report VK_ESCAPE as pressed after that many milliseconds (non-Windows shim)
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/// Contains list of virtual devices the stand-in can simulate.
+	enum CorsairStandInDeviceModel
+	{
+		CSIDM_K95RGB,        /**< Full size keyboard with 18 G keys and media keys, US layout */
+		CSIDM_K70RGB,        /**< Full size keyboard without G keys, US layout */
+		CSIDM_M65RGB,        /**< Mouse with a single lighting zone */
+		CSIDM_ScimitarRGB,   /**< Mouse with four lighting zones */
+		CSIDM_VoidRGB,       /**< Headset with left and right logo LEDs */
+		CSIDM_MM800RGB       /**< Mousemat with 15 zones around its edge */
+	};
+
+	/// Contains one frame recorded by the stand-in.
+	struct CorsairStandInFrame
+	{
+		int64_t timestampNs;                /**< Time of the call in nanoseconds since the stand-in was (re)initialized */
+		int async;                          /**< Non-zero if the frame was pushed through CorsairSetLedsColorsAsync() */
+		int size;                           /**< Number of leds in ledsColors array */
+		const CorsairLedColor *ledsColors;  /**< Colors as they were passed to the SDK call */
+	};
+
+	/**
+	 * @brief Drops every device, recorded frame and injected failure and restores the default configuration.
+	 *
+	 * Waits for pending asynchronous submissions first. The protocol handshake has to be performed again.
+	 *
+	 * @param withDefaultDevices Non-zero to attach the default set of devices, zero to start with none.
+	 */
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInReset(int withDefaultDevices);
+
+	/**
+	 * @brief Attaches a virtual device.
+	 * @return Index of the device as seen by CorsairGetDeviceInfo().
+	 */
+	CORSAIR_LIGHTING_SDK_EXPORT int CorsairStandInAddDevice(enum CorsairStandInDeviceModel model);
+
+	/// Changes logical layout reported for the keyboard at specified index; used by CorsairGetLedIdForKeyName().
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInSetLogicalLayout(int deviceIndex, enum CorsairLogicalLayout layout);
+
+	/**
+	 * @brief Simulates CUE being shut down or started.
+	 *
+	 * While the server is unavailable every call fails with CE_ServerNotFound. After it becomes available
+	 * again calls fail with CE_ProtocolHandshakeMissing until CorsairPerformProtocolHandshake() is repeated.
+	 * Async calls made before the server went away fail with CE_ServerNotFound whenever they complete.
+	 */
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInSetServerAvailable(int available);
+
+	/// Simulates another client taking exclusive control: lighting calls fail with CE_NoControl until CorsairRequestControl().
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInRevokeControl();
+
+	/**
+	 * @brief Configures simulated latency of CorsairSetLedsColors() and CorsairSetLedsColorsAsync().
+	 *
+	 * Synchronous calls block the caller for the latency, asynchronous calls are executed on a worker thread
+	 * and their callbacks are delayed by it. Like on a real server, every device works through its calls
+	 * one by one, and a call waits for each device it sets LEDs of.
+	 *
+	 * @param latencyUs Fixed part of the latency in microseconds.
+	 * @param jitterUs  Upper bound of the uniformly distributed random part in microseconds.
+	 */
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInSetLatency(int latencyUs, int jitterUs);
+
+	/**
+	 * @brief Adds latency to calls setting LEDs of the device at specified index, e.g. to simulate a slow headset.
+	 *
+	 * A call pays the latency of the slowest device it sets LEDs of on top of the one of CorsairStandInSetLatency().
+	 * Asynchronous calls setting LEDs of other devices only are not held up by it.
+	 */
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInSetDeviceLatency(int deviceIndex, int latencyUs);
+
+	/// Sets latency of the handshake, CorsairGetDeviceCount(), CorsairGetDeviceInfo() and the LED position queries, as a round trip to CUE.
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInSetQueryLatency(int latencyUs);
+
+	/// Blocks until every asynchronous submission has been executed and its callback invoked.
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInWaitForIdle();
+
+	/// Resizes in-memory ring of recorded frames, dropping its content. Zero disables recording.
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInSetRecordCapacity(int frameCount);
+
+	/// Returns number of frames currently held in the ring (at most its capacity).
+	CORSAIR_LIGHTING_SDK_EXPORT int CorsairStandInGetRecordedFrameCount();
+
+	/// Returns total number of frames pushed since the last reset, including the ones dropped from the ring.
+	CORSAIR_LIGHTING_SDK_EXPORT int64_t CorsairStandInGetTotalFrameCount();
+
+	/**
+	 * @brief Copies description of a recorded frame.
+	 *
+	 * @param index Index within a range [0..CorsairStandInGetRecordedFrameCount()), 0 being the oldest frame.
+	 * @param frame Receives the frame. ledsColors stays valid until the ring slot is reused or the stand-in reset.
+	 * @return Non-zero on success.
+	 */
+	CORSAIR_LIGHTING_SDK_EXPORT int CorsairStandInGetRecordedFrame(int index, struct CorsairStandInFrame *frame);
+
+	/// Returns color the virtual devices currently show for specified LED.
+	CORSAIR_LIGHTING_SDK_EXPORT struct CorsairLedColor CorsairStandInGetLedColor(enum CorsairLedId ledId);
+
+	/**
+	 * @brief Starts appending every pushed frame to a binary trace file.
+	 *
+	 * The file starts with the 8 byte magic "CUETRACE" followed by a little-endian uint32 version (1).
+	 * Each frame is stored as int64 timestampNs, int32 async, int32 size and size records of
+	 * int32 ledId, uint8 r, uint8 g, uint8 b, uint8 reserved.
+	 *
+	 * @return Non-zero if the file could be opened.
+	 */
+	CORSAIR_LIGHTING_SDK_EXPORT int CorsairStandInOpenTrace(const char *path);
+
+	/// Flushes and closes the trace file opened by CorsairStandInOpenTrace().
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInCloseTrace();
+
+	/// Sets state reported for a virtual key by the GetAsyncKeyState() shim on non-Windows platforms.
+	CORSAIR_LIGHTING_SDK_EXPORT void CorsairStandInSetKeyState(int virtualKey, int pressed);
+
+#ifdef __cplusplus
+} //exten "C"
+#endif
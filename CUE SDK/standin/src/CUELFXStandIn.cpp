@@ -0,0 +1,594 @@
+#include "CUELFX/CUELFX.h"
+#include "EffectLibrary.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace
+{
+	const double cPi = 3.14159265358979323846;
+
+	EffectLibrary& library()
+	{
+		static EffectLibrary effects(&CUELFXGetFrame, &CUELFXFreeFrame);
+		return effects;
+	}
+
+	int cycleDuration(CorsairLightingEffectSpeed speed)
+	{
+		switch (speed) {
+		case CLES_Slow:
+			return 6000;
+		case CLES_Fast:
+			return 1500;
+		default:
+			return 3000;
+		}
+	}
+
+	double fraction(double value)
+	{
+		return value - std::floor(value);
+	}
+
+	uint32_t hash(uint32_t value)
+	{
+		value ^= value >> 16;
+		value *= 0x7feb352d;
+		value ^= value >> 15;
+		value *= 0x846ca68b;
+		value ^= value >> 16;
+		return value;
+	}
+
+	/// Color used during n-th cycle of an effect with color options.
+	CorsairColor cycleColor(const CorsairLightingEffectColorOptions &options, int cycle)
+	{
+		if (options.mode == CLECM_Alternating) {
+			return cycle % 2 ? options.color2 : options.color1;
+		}
+		return hueColor((hash(static_cast<uint32_t>(cycle)) % 360) / 360.);
+	}
+
+	/// Smooth bump rising from 0 at start to 1 and back to 0 after length milliseconds.
+	double bump(int time, int start, int length)
+	{
+		if (time < start || time >= start + length) {
+			return 0.;
+		}
+		const auto s = std::sin(cPi * (time - start) / length);
+		return s * s;
+	}
+
+	/// Projects a LED onto the axis of a linear direction, 0 being where the effect starts.
+	double alongDirection(const LedPoint &point, CorsairLightingEffectLinearDirection direction)
+	{
+		switch (direction) {
+		case CLELD_Left:
+			return 1. - point.x;
+		case CLELD_Up:
+			return 1. - point.y;
+		case CLELD_Down:
+			return point.y;
+		default:
+			return point.x;
+		}
+	}
+
+	class SolidColorEffect : public StandInEffect
+	{
+	public:
+		SolidColorEffect(int size, const CorsairLedId *leds, CorsairColor color)
+			: StandInEffect(size, leds), mColor(color)
+		{
+		}
+
+		bool render(int /*offset*/, const std::vector<LedPoint> &/*points*/, std::vector<CorsairColor> &colors) override
+		{
+			std::fill(colors.begin(), colors.end(), mColor);
+			return true;
+		}
+
+	private:
+		CorsairColor mColor;
+	};
+
+	class SpiralRainbowEffect : public StandInEffect
+	{
+	public:
+		SpiralRainbowEffect(int size, const CorsairLedId *leds, CorsairLightingEffectSpeed speed, CorsairLightingEffectCircularDirection direction)
+			: StandInEffect(size, leds), mCycle(cycleDuration(speed)), mDirection(direction == CLECD_Clockwise ? -1. : 1.)
+		{
+		}
+
+		bool render(int offset, const std::vector<LedPoint> &points, std::vector<CorsairColor> &colors) override
+		{
+			const auto phase = mDirection * offset / mCycle;
+			for (size_t i = 0; i < points.size(); ++i) {
+				const auto angle = std::atan2(points[i].y - .5, points[i].x - .5) / (2 * cPi);
+				colors[i] = hueColor(angle + phase);
+			}
+			return true;
+		}
+
+	private:
+		double mCycle;
+		double mDirection;
+	};
+
+	class RainbowWaveEffect : public StandInEffect
+	{
+	public:
+		RainbowWaveEffect(int size, const CorsairLedId *leds, CorsairLightingEffectSpeed speed, CorsairLightingEffectLinearDirection direction)
+			: StandInEffect(size, leds), mCycle(cycleDuration(speed)), mDirection(direction)
+		{
+		}
+
+		bool render(int offset, const std::vector<LedPoint> &points, std::vector<CorsairColor> &colors) override
+		{
+			const auto phase = offset / mCycle;
+			for (size_t i = 0; i < points.size(); ++i) {
+				colors[i] = hueColor(phase - alongDirection(points[i], mDirection));
+			}
+			return true;
+		}
+
+	private:
+		double mCycle;
+		CorsairLightingEffectLinearDirection mDirection;
+	};
+
+	/// Base of the effects whose color changes every cycle according to CorsairLightingEffectColorOptions.
+	class ColorCycleEffect : public StandInEffect
+	{
+	public:
+		ColorCycleEffect(int size, const CorsairLedId *leds, CorsairLightingEffectSpeed speed, CorsairLightingEffectColorOptions options)
+			: StandInEffect(size, leds), mCycle(cycleDuration(speed)), mOptions(options)
+		{
+		}
+
+	protected:
+		int period() const { return mCycle; }
+		int cycle(int offset) const { return offset / mCycle; }
+		double position(int offset) const { return static_cast<double>(offset % mCycle) / mCycle; }
+		CorsairColor color(int cycle) const { return cycleColor(mOptions, cycle); }
+
+	private:
+		int mCycle;
+		CorsairLightingEffectColorOptions mOptions;
+	};
+
+	class VisorEffect : public ColorCycleEffect
+	{
+	public:
+		using ColorCycleEffect::ColorCycleEffect;
+
+		bool render(int offset, const std::vector<LedPoint> &points, std::vector<CorsairColor> &colors) override
+		{
+			// One sweep to the right and back per cycle, the visor is a quarter of the width wide.
+			const auto t = position(offset);
+			const auto center = t < .5 ? t * 2. : 2. - t * 2.;
+			const auto sweepColor = color(cycle(offset) * 2 + (t < .5 ? 0 : 1));
+			for (size_t i = 0; i < points.size(); ++i) {
+				const auto distance = std::abs(points[i].x - center);
+				colors[i] = scaleColor(sweepColor, 1. - distance / .125);
+			}
+			return true;
+		}
+	};
+
+	class RainEffect : public ColorCycleEffect
+	{
+	public:
+		using ColorCycleEffect::ColorCycleEffect;
+
+		bool render(int offset, const std::vector<LedPoint> &points, std::vector<CorsairColor> &colors) override
+		{
+			const double cTail = .35;
+			for (size_t i = 0; i < points.size(); ++i) {
+				// Every key column gets its own drop, shifted by a pseudo random amount.
+				const auto column = static_cast<uint32_t>(std::lround(points[i].keyX));
+				const auto shift = (hash(column) % 1000) / 1000.;
+				const auto time = static_cast<double>(offset) / period() + shift;
+				const auto drop = static_cast<int>(std::floor(time)) * 31 + static_cast<int>(column);
+				const auto head = fraction(time) * (1. + cTail);
+				const auto behind = head - points[i].y;
+				colors[i] = behind >= 0. && behind <= cTail ? scaleColor(color(drop), 1. - behind / cTail) : CorsairColor{ 0, 0, 0 };
+			}
+			return true;
+		}
+	};
+
+	class ColorShiftEffect : public ColorCycleEffect
+	{
+	public:
+		using ColorCycleEffect::ColorCycleEffect;
+
+		bool render(int offset, const std::vector<LedPoint> &/*points*/, std::vector<CorsairColor> &colors) override
+		{
+			const auto current = cycle(offset);
+			const auto t = position(offset);
+			const auto shift = t < .5 ? 0. : (1. - std::cos(cPi * (t - .5) * 2.)) / 2.;
+			std::fill(colors.begin(), colors.end(), mixColors(color(current), color(current + 1), shift));
+			return true;
+		}
+	};
+
+	class ColorPulseEffect : public ColorCycleEffect
+	{
+	public:
+		using ColorCycleEffect::ColorCycleEffect;
+
+		bool render(int offset, const std::vector<LedPoint> &/*points*/, std::vector<CorsairColor> &colors) override
+		{
+			const auto s = std::sin(cPi * position(offset));
+			std::fill(colors.begin(), colors.end(), scaleColor(color(cycle(offset)), s * s));
+			return true;
+		}
+	};
+
+	class ColorWaveEffect : public ColorCycleEffect
+	{
+	public:
+		ColorWaveEffect(int size, const CorsairLedId *leds, CorsairLightingEffectSpeed speed, CorsairLightingEffectLinearDirection direction, CorsairLightingEffectColorOptions options)
+			: ColorCycleEffect(size, leds, speed, options), mDirection(direction)
+		{
+		}
+
+		bool render(int offset, const std::vector<LedPoint> &points, std::vector<CorsairColor> &colors) override
+		{
+			const double cTail = .3;
+			const auto head = position(offset) * (1. + cTail);
+			const auto waveColor = color(cycle(offset));
+			for (size_t i = 0; i < points.size(); ++i) {
+				const auto behind = head - alongDirection(points[i], mDirection);
+				colors[i] = behind >= 0. && behind <= cTail ? scaleColor(waveColor, 1. - behind / cTail) : CorsairColor{ 0, 0, 0 };
+			}
+			return true;
+		}
+
+	private:
+		CorsairLightingEffectLinearDirection mDirection;
+	};
+
+	/// Base of ripple and wave: a front moving across the keys, colored by the intensity chart over its tail.
+	class ChartEffect : public StandInEffect
+	{
+	public:
+		ChartEffect(int size, const CorsairLedId *leds, double tail, double velocity, int duration, int repeatCount)
+			: StandInEffect(size, leds),
+			mTail(std::max(tail, 0.)),
+			mVelocity(std::max(velocity, 1e-3)),
+			mDuration(std::max(duration, 0)),
+			mRepeatCount(std::max(repeatCount, 0))
+		{
+		}
+
+		void addPoint(double position, CorsairColor color) override
+		{
+			const auto point = std::make_pair(std::min(std::max(position, 0.), 1.), color);
+			const auto it = std::upper_bound(mChart.begin(), mChart.end(), point, [](const ChartPoint &a, const ChartPoint &b) {
+				return a.first < b.first;
+			});
+			mChart.insert(it, point);
+		}
+
+		bool render(int offset, const std::vector<LedPoint> &points, std::vector<CorsairColor> &colors) override
+		{
+			auto span = 0.;
+			for (const auto &point : points) {
+				span = std::max(span, distance(point, points));
+			}
+			// A cycle lasts at least until the tail has left the last key.
+			const auto travel = static_cast<int>((span + mTail) / mVelocity * 1000.);
+			const auto cycle = std::max(std::max(mDuration, travel), 1);
+			if (mRepeatCount && offset >= cycle * mRepeatCount) {
+				return false;
+			}
+
+			const auto front = (offset % cycle) / 1000. * mVelocity;
+			for (size_t i = 0; i < points.size(); ++i) {
+				const auto behind = front - distance(points[i], points);
+				colors[i] = behind >= 0. && behind <= mTail ? chartColor(mTail > 0. ? behind / mTail : 0.) : CorsairColor{ 0, 0, 0 };
+			}
+			return true;
+		}
+
+	protected:
+		/// Distance in key pitches the front has to travel from its origin to reach the LED.
+		virtual double distance(const LedPoint &point, const std::vector<LedPoint> &points) const = 0;
+
+	private:
+		using ChartPoint = std::pair<double, CorsairColor>;
+
+		CorsairColor chartColor(double position) const
+		{
+			if (mChart.empty()) {
+				return CorsairColor{ 0, 0, 0 };
+			}
+			if (position <= mChart.front().first) {
+				return mChart.front().second;
+			}
+			for (size_t i = 1; i < mChart.size(); ++i) {
+				if (position <= mChart[i].first) {
+					const auto &from = mChart[i - 1];
+					const auto &to = mChart[i];
+					const auto width = to.first - from.first;
+					return mixColors(from.second, to.second, width > 0. ? (position - from.first) / width : 1.);
+				}
+			}
+			return mChart.back().second;
+		}
+
+		double mTail;
+		double mVelocity;
+		int mDuration;
+		int mRepeatCount;
+		std::vector<ChartPoint> mChart;
+	};
+
+	LedPoint centerOf(const std::vector<LedPoint> &points)
+	{
+		auto minX = points.front().keyX, maxX = minX;
+		auto minY = points.front().keyY, maxY = minY;
+		for (const auto &point : points) {
+			minX = std::min(minX, point.keyX);
+			maxX = std::max(maxX, point.keyX);
+			minY = std::min(minY, point.keyY);
+			maxY = std::max(maxY, point.keyY);
+		}
+		return LedPoint{ .5, .5, (minX + maxX) / 2, (minY + maxY) / 2 };
+	}
+
+	class RippleEffect : public ChartEffect
+	{
+	public:
+		using ChartEffect::ChartEffect;
+
+	protected:
+		double distance(const LedPoint &point, const std::vector<LedPoint> &points) const override
+		{
+			const auto center = centerOf(points);
+			return std::hypot(point.keyX - center.keyX, point.keyY - center.keyY);
+		}
+	};
+
+	class WaveEffect : public ChartEffect
+	{
+	public:
+		WaveEffect(int size, const CorsairLedId *leds, double tail, double velocity, int duration, int orientation, bool twoSided, int repeatCount)
+			: ChartEffect(size, leds, tail, velocity, duration, repeatCount),
+			mCos(std::cos(orientation * cPi / 180.)),
+			mSin(std::sin(orientation * cPi / 180.)),
+			mTwoSided(twoSided)
+		{
+		}
+
+	protected:
+		double distance(const LedPoint &point, const std::vector<LedPoint> &points) const override
+		{
+			if (mTwoSided) {
+				const auto center = centerOf(points);
+				return std::abs(project(point) - project(center));
+			}
+			auto origin = project(points.front());
+			for (const auto &other : points) {
+				origin = std::min(origin, project(other));
+			}
+			return project(point) - origin;
+		}
+
+	private:
+		double project(const LedPoint &point) const
+		{
+			return point.keyX * mCos + point.keyY * mSin;
+		}
+
+		double mCos;
+		double mSin;
+		bool mTwoSided;
+	};
+
+	class RainbowPulseEffect : public StandInEffect
+	{
+	public:
+		RainbowPulseEffect(int size, const CorsairLedId *leds, CorsairLightingEffectSpeed speed)
+			: StandInEffect(size, leds), mCycle(cycleDuration(speed))
+		{
+		}
+
+		bool render(int offset, const std::vector<LedPoint> &/*points*/, std::vector<CorsairColor> &colors) override
+		{
+			const auto pulse = offset / mCycle;
+			const auto s = std::sin(cPi * (offset % mCycle) / mCycle);
+			std::fill(colors.begin(), colors.end(), scaleColor(hueColor(pulse / 7.), s * s));
+			return true;
+		}
+
+	private:
+		int mCycle;
+	};
+
+	/// Single color effect repeating an intensity envelope defined over a fixed period.
+	class EnvelopeEffect : public StandInEffect
+	{
+	public:
+		using Envelope = std::function<double(int time)>;
+
+		EnvelopeEffect(int size, const CorsairLedId *leds, CorsairColor color, int period, Envelope envelope)
+			: StandInEffect(size, leds), mColor(color), mPeriod(period), mEnvelope(std::move(envelope))
+		{
+		}
+
+		bool render(int offset, const std::vector<LedPoint> &/*points*/, std::vector<CorsairColor> &colors) override
+		{
+			std::fill(colors.begin(), colors.end(), scaleColor(mColor, mEnvelope(offset % mPeriod)));
+			return true;
+		}
+
+	private:
+		CorsairColor mColor;
+		int mPeriod;
+		Envelope mEnvelope;
+	};
+
+	class AlternatingRapidBlinkEffect : public StandInEffect
+	{
+	public:
+		AlternatingRapidBlinkEffect(int size, const CorsairLedId *leds, CorsairColor firstColor, CorsairColor secondColor)
+			: StandInEffect(size, leds), mFirstColor(firstColor), mSecondColor(secondColor)
+		{
+		}
+
+		bool render(int offset, const std::vector<LedPoint> &/*points*/, std::vector<CorsairColor> &colors) override
+		{
+			std::fill(colors.begin(), colors.end(), offset % 200 < 100 ? mFirstColor : mSecondColor);
+			return true;
+		}
+
+	private:
+		CorsairColor mFirstColor;
+		CorsairColor mSecondColor;
+	};
+
+	CorsairEffect* addEnvelopeEffect(int size, CorsairLedId *pLeds, CorsairColor color, int period, EnvelopeEffect::Envelope envelope)
+	{
+		return library().add(std::unique_ptr<StandInEffect>(new EnvelopeEffect(size, pLeds, color, period, std::move(envelope))));
+	}
+
+	double heartbeat(int time)
+	{
+		return std::max(bump(time, 0, 150), .6 * bump(time, 250, 150));
+	}
+}
+
+CorsairFrame *CUELFXGetFrame(Guid effectId, int offset)
+{
+	return library().getFrame(effectId, offset);
+}
+
+void CUELFXFreeFrame(CorsairFrame *pFrame)
+{
+	EffectLibrary::freeFrame(pFrame);
+}
+
+void CUELFXSetLedPositions(CorsairLedPositions *ledPositions)
+{
+	library().setLedPositions(ledPositions);
+}
+
+CorsairEffect *CUELFXCreateSpiralRainbowEffect(int size, CorsairLedId *pLeds, CorsairLightingEffectSpeed speed, CorsairLightingEffectCircularDirection direction)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new SpiralRainbowEffect(size, pLeds, speed, direction)));
+}
+
+CorsairEffect *CUELFXCreateRainbowWaveEffect(int size, CorsairLedId *pLeds, CorsairLightingEffectSpeed speed, CorsairLightingEffectLinearDirection direction)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new RainbowWaveEffect(size, pLeds, speed, direction)));
+}
+
+CorsairEffect *CUELFXCreateVisorEffect(int size, CorsairLedId *pLeds, CorsairLightingEffectSpeed speed, CorsairLightingEffectColorOptions colorOptions)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new VisorEffect(size, pLeds, speed, colorOptions)));
+}
+
+CorsairEffect *CUELFXCreateRainEffect(int size, CorsairLedId *pLeds, CorsairLightingEffectSpeed speed, CorsairLightingEffectColorOptions colorOptions)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new RainEffect(size, pLeds, speed, colorOptions)));
+}
+
+CorsairEffect *CUELFXCreateColorShiftEffect(int size, CorsairLedId *pLeds, CorsairLightingEffectSpeed speed, CorsairLightingEffectColorOptions colorOptions)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new ColorShiftEffect(size, pLeds, speed, colorOptions)));
+}
+
+CorsairEffect *CUELFXCreateColorPulseEffect(int size, CorsairLedId *pLeds, CorsairLightingEffectSpeed speed, CorsairLightingEffectColorOptions colorOptions)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new ColorPulseEffect(size, pLeds, speed, colorOptions)));
+}
+
+CorsairEffect *CUELFXCreateColorWaveEffect(int size, CorsairLedId *pLeds, CorsairLightingEffectSpeed speed, CorsairLightingEffectLinearDirection direction, CorsairLightingEffectColorOptions colorOptions)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new ColorWaveEffect(size, pLeds, speed, direction, colorOptions)));
+}
+
+CorsairEffect *CUELFXCreateRippleEffect(int size, CorsairLedId *pLeds, double tail, double velocity, int duration, int repeatCount)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new RippleEffect(size, pLeds, tail, velocity, duration, repeatCount)));
+}
+
+CorsairEffect *CUELFXCreateWaveEffect(int size, CorsairLedId *pLeds, double tail, double velocity, int duration, int orientation, int boolTwoSided, int repeatCount)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new WaveEffect(size, pLeds, tail, velocity, duration, orientation, boolTwoSided != 0, repeatCount)));
+}
+
+CorsairEffect *CUELFXCreateSolidColorEffect(int size, CorsairLedId *pLeds, CorsairColor color)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new SolidColorEffect(size, pLeds, color)));
+}
+
+CorsairEffect *CUELFXCreateRainbowPulseEffect(int size, CorsairLedId *pLeds, CorsairLightingEffectSpeed speed)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new RainbowPulseEffect(size, pLeds, speed)));
+}
+
+CorsairEffect *CUELFXCreateSingleBlinkEffect(int size, CorsairLedId *pLeds, CorsairColor color)
+{
+	return addEnvelopeEffect(size, pLeds, color, 1000, [](int time) { return time < 300 ? 1. : 0.; });
+}
+
+CorsairEffect *CUELFXCreateDoubleBlinkEffect(int size, CorsairLedId *pLeds, CorsairColor color)
+{
+	return addEnvelopeEffect(size, pLeds, color, 1200, [](int time) { return time < 150 || (time >= 300 && time < 450) ? 1. : 0.; });
+}
+
+CorsairEffect *CUELFXCreateRapidBlinkEffect(int size, CorsairLedId *pLeds, CorsairColor color)
+{
+	return addEnvelopeEffect(size, pLeds, color, 200, [](int time) { return time < 100 ? 1. : 0.; });
+}
+
+CorsairEffect *CUELFXCreateAlternatingRapidBlinkEffect(int size, CorsairLedId *pLeds, CorsairColor firstColor, CorsairColor secondColor)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new AlternatingRapidBlinkEffect(size, pLeds, firstColor, secondColor)));
+}
+
+CorsairEffect *CUELFXCreateHeartbeatEffect(int size, CorsairLedId *pLeds, CorsairColor color)
+{
+	return addEnvelopeEffect(size, pLeds, color, 1000, &heartbeat);
+}
+
+CorsairEffect *CUELFXCreateOffBeatEffect(int size, CorsairLedId *pLeds, CorsairColor color)
+{
+	return addEnvelopeEffect(size, pLeds, color, 1000, [](int time) { return heartbeat((time + 500) % 1000); });
+}
+
+CorsairEffect *CUELFXCreateBreatheEffect(int size, CorsairLedId *pLeds, CorsairColor color)
+{
+	return addEnvelopeEffect(size, pLeds, color, 4000, [](int time) { return bump(time, 0, 4000); });
+}
+
+CorsairEffect *CUELFXCreateSlowBreatheEffect(int size, CorsairLedId *pLeds, CorsairColor color)
+{
+	return addEnvelopeEffect(size, pLeds, color, 8000, [](int time) { return bump(time, 0, 8000); });
+}
+
+CorsairEffect *CUELFXCreateSlowLongBreatheEffect(int size, CorsairLedId *pLeds, CorsairColor color)
+{
+	// Four seconds in, two seconds held, four seconds out and two seconds off.
+	return addEnvelopeEffect(size, pLeds, color, 12000, [](int time) {
+		if (time >= 4000 && time < 6000) {
+			return 1.;
+		}
+		return time < 4000 ? bump(time, 0, 8000) : bump(time - 2000, 0, 8000);
+	});
+}
+
+void CUELFXAddPointToEffect(Guid effectId, double position, CorsairColor color)
+{
+	library().update(effectId, [position, color](StandInEffect &effect) {
+		effect.addPoint(position, color);
+	});
+}
@@ -0,0 +1,143 @@
+#include "CUESDK.h"
+#include "CUESDKStandIn.h"
+#include "StandInServer.h"
+
+bool CorsairSetLedsColors(int size, CorsairLedColor* ledsColors)
+{
+	return StandInServer::instance().setLedsColors(size, ledsColors);
+}
+
+bool CorsairSetLedsColorsAsync(int size, CorsairLedColor* ledsColors, void(*CallbackType)(void*, bool, CorsairError), void *context)
+{
+	return StandInServer::instance().setLedsColorsAsync(size, ledsColors, CallbackType, context);
+}
+
+int CorsairGetDeviceCount()
+{
+	return StandInServer::instance().deviceCount();
+}
+
+CorsairDeviceInfo *CorsairGetDeviceInfo(int deviceIndex)
+{
+	return StandInServer::instance().deviceInfo(deviceIndex);
+}
+
+CorsairLedPositions *CorsairGetLedPositions()
+{
+	return StandInServer::instance().ledPositions();
+}
+
+CorsairLedPositions *CorsairGetLedPositionsByDeviceIndex(int deviceIndex)
+{
+	return StandInServer::instance().ledPositionsByDeviceIndex(deviceIndex);
+}
+
+CorsairLedId CorsairGetLedIdForKeyName(char keyName)
+{
+	return StandInServer::instance().ledIdForKeyName(keyName);
+}
+
+bool CorsairRequestControl(CorsairAccessMode accessMode)
+{
+	return StandInServer::instance().requestControl(accessMode);
+}
+
+CorsairProtocolDetails CorsairPerformProtocolHandshake()
+{
+	return StandInServer::instance().performProtocolHandshake();
+}
+
+CorsairError CorsairGetLastError()
+{
+	return StandInServer::lastError();
+}
+
+bool CorsairReleaseControl(CorsairAccessMode accessMode)
+{
+	return StandInServer::instance().releaseControl(accessMode);
+}
+
+void CorsairStandInReset(int withDefaultDevices)
+{
+	StandInServer::instance().reset(withDefaultDevices != 0);
+}
+
+int CorsairStandInAddDevice(CorsairStandInDeviceModel model)
+{
+	return StandInServer::instance().addDevice(model);
+}
+
+void CorsairStandInSetLogicalLayout(int deviceIndex, CorsairLogicalLayout layout)
+{
+	StandInServer::instance().setLogicalLayout(deviceIndex, layout);
+}
+
+void CorsairStandInSetServerAvailable(int available)
+{
+	StandInServer::instance().setServerAvailable(available != 0);
+}
+
+void CorsairStandInRevokeControl()
+{
+	StandInServer::instance().revokeControl();
+}
+
+void CorsairStandInSetLatency(int latencyUs, int jitterUs)
+{
+	StandInServer::instance().setLatency(latencyUs, jitterUs);
+}
+
+void CorsairStandInSetDeviceLatency(int deviceIndex, int latencyUs)
+{
+	StandInServer::instance().setDeviceLatency(deviceIndex, latencyUs);
+}
+
+void CorsairStandInSetQueryLatency(int latencyUs)
+{
+	StandInServer::instance().setQueryLatency(latencyUs);
+}
+
+void CorsairStandInWaitForIdle()
+{
+	StandInServer::instance().waitForIdle();
+}
+
+void CorsairStandInSetRecordCapacity(int frameCount)
+{
+	StandInServer::instance().setRecordCapacity(frameCount);
+}
+
+int CorsairStandInGetRecordedFrameCount()
+{
+	return StandInServer::instance().recordedFrameCount();
+}
+
+int64_t CorsairStandInGetTotalFrameCount()
+{
+	return StandInServer::instance().totalFrameCount();
+}
+
+int CorsairStandInGetRecordedFrame(int index, CorsairStandInFrame *frame)
+{
+	return frame && StandInServer::instance().recordedFrame(index, *frame) ? 1 : 0;
+}
+
+CorsairLedColor CorsairStandInGetLedColor(CorsairLedId ledId)
+{
+	return StandInServer::instance().ledColor(ledId);
+}
+
+int CorsairStandInOpenTrace(const char *path)
+{
+	return StandInServer::instance().openTrace(path) ? 1 : 0;
+}
+
+void CorsairStandInCloseTrace()
+{
+	StandInServer::instance().closeTrace();
+}
+
+void CorsairStandInSetKeyState(int virtualKey, int pressed)
+{
+	StandInServer::instance().setKeyState(virtualKey, pressed != 0);
+}
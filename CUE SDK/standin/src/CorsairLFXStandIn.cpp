@@ -0,0 +1,157 @@
+#include "CorsairLFX/CorsairLFX.h"
+#include "EffectLibrary.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	EffectLibrary& library()
+	{
+		static EffectLibrary effects(&CorsairLFXGetFrame, &CorsairLFXFreeFrame);
+		return effects;
+	}
+
+	class GradientEffect : public StandInEffect
+	{
+	public:
+		GradientEffect(int size, const CorsairLedId *leds, CorsairColor startColor)
+			: StandInEffect(size, leds), mStartColor(startColor)
+		{
+		}
+
+		void addRamp(int duration, CorsairColor endColor, double power)
+		{
+			mRamps.push_back(Ramp{ std::max(duration, 0), endColor, power });
+		}
+
+		bool render(int offset, const std::vector<LedPoint> &/*points*/, std::vector<CorsairColor> &colors) override
+		{
+			auto from = mStartColor;
+			for (const auto &ramp : mRamps) {
+				if (offset < ramp.duration) {
+					const auto t = static_cast<double>(offset) / ramp.duration;
+					std::fill(colors.begin(), colors.end(), mixColors(from, ramp.endColor, shape(t, ramp.power)));
+					return true;
+				}
+				offset -= ramp.duration;
+				from = ramp.endColor;
+			}
+			return false;
+		}
+
+	private:
+		struct Ramp
+		{
+			int duration;
+			CorsairColor endColor;
+			double power;
+		};
+
+		/// Positive power eases in (t^power), negative power eases out with the mirrored curve, zero is linear.
+		static double shape(double t, double power)
+		{
+			if (power > 0.) {
+				return std::pow(t, power);
+			}
+			if (power < 0.) {
+				return 1. - std::pow(1. - t, -power);
+			}
+			return t;
+		}
+
+		CorsairColor mStartColor;
+		std::vector<Ramp> mRamps;
+	};
+
+	class ProgressBarEffect : public StandInEffect
+	{
+	public:
+		ProgressBarEffect(int size, const CorsairLedId *leds, CorsairColor foregroundColor, CorsairColor backgroundColor)
+			: StandInEffect(size, leds), mForegroundColor(foregroundColor), mBackgroundColor(backgroundColor), mProgress(0), mHidden(false)
+		{
+		}
+
+		void setProgress(int progressValue)
+		{
+			mProgress = std::min(std::max(progressValue, 0), 100);
+			mHidden = false;
+		}
+
+		void hide()
+		{
+			mHidden = true;
+		}
+
+		bool render(int /*offset*/, const std::vector<LedPoint> &/*points*/, std::vector<CorsairColor> &colors) override
+		{
+			if (mHidden) {
+				return false;
+			}
+			// LEDs fill up in the order they were passed in.
+			const auto active = (colors.size() * mProgress + 50) / 100;
+			for (size_t i = 0; i < colors.size(); ++i) {
+				colors[i] = i < active ? mForegroundColor : mBackgroundColor;
+			}
+			return true;
+		}
+
+	private:
+		CorsairColor mForegroundColor;
+		CorsairColor mBackgroundColor;
+		int mProgress;
+		bool mHidden;
+	};
+}
+
+CorsairFrame *CorsairLFXGetFrame(Guid effectId, int offset)
+{
+	return library().getFrame(effectId, offset);
+}
+
+void CorsairLFXFreeFrame(CorsairFrame* pFrame)
+{
+	EffectLibrary::freeFrame(pFrame);
+}
+
+void CorsairLFXSetLedPositions(CorsairLedPositions *ledPositions)
+{
+	library().setLedPositions(ledPositions);
+}
+
+CorsairEffect* CorsairLFXCreateGradientEffect(int size, CorsairLedId* pLeds, CorsairColor startColor)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new GradientEffect(size, pLeds, startColor)));
+}
+
+void CorsairLFXAddRampToGradientEffect(Guid effectId, int duration, CorsairColor endColor, double power)
+{
+	library().update(effectId, [duration, endColor, power](StandInEffect &effect) {
+		if (auto gradient = dynamic_cast<GradientEffect*>(&effect)) {
+			gradient->addRamp(duration, endColor, power);
+		}
+	});
+}
+
+CorsairEffect* CorsairLFXCreateProgressBarEffect(int size, CorsairLedId* pLeds, CorsairColor foregroundColor, CorsairColor backgroundColor)
+{
+	return library().add(std::unique_ptr<StandInEffect>(new ProgressBarEffect(size, pLeds, foregroundColor, backgroundColor)));
+}
+
+void CorsairLFXSetProgress(Guid effectId, int progressValue)
+{
+	library().update(effectId, [progressValue](StandInEffect &effect) {
+		if (auto progressBar = dynamic_cast<ProgressBarEffect*>(&effect)) {
+			progressBar->setProgress(progressValue);
+		}
+	});
+}
+
+void CorsairLFXHideProgressBar(Guid effectId)
+{
+	library().update(effectId, [](StandInEffect &effect) {
+		if (auto progressBar = dynamic_cast<ProgressBarEffect*>(&effect)) {
+			progressBar->hide();
+		}
+	});
+}
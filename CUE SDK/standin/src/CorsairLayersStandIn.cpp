@@ -0,0 +1,168 @@
+#include "CorsairLayers/CorsairLayers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	const auto cFramePeriod = std::chrono::milliseconds(33);
+
+	/**
+	 * Plays effects on layers from a background thread, the same as the CorsairLayers library shipped with the SDK.
+	 * Higher layers are drawn over lower ones, and within one layer the effect started last is drawn on top.
+	 */
+	class LayerPlayer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		LayerPlayer()
+			: mSetColors(nullptr), mNextSequence(0), mStop(false)
+		{
+		}
+
+		~LayerPlayer()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mStop = true;
+			}
+			mChanged.notify_all();
+			if (mThread.joinable()) {
+				mThread.join();
+			}
+		}
+
+		void initialize(CorsairSetLedsColorsAsyncType setColors)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mSetColors = setColors;
+		}
+
+		LayerGuid play(CorsairEffect *effect, int layer)
+		{
+			if (!effect || !effect->getFrameFunction) {
+				return nullptr;
+			}
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			std::unique_ptr<Playback> playback(new Playback{ *effect, layer, mNextSequence++, Clock::now() });
+			auto id = reinterpret_cast<LayerGuid>(playback.get());
+			mPlaybacks.push_back(std::move(playback));
+			std::stable_sort(mPlaybacks.begin(), mPlaybacks.end(), [](const std::unique_ptr<Playback> &a, const std::unique_ptr<Playback> &b) {
+				return a->layer != b->layer ? a->layer < b->layer : a->sequence < b->sequence;
+			});
+			if (!mThread.joinable()) {
+				mThread = std::thread(&LayerPlayer::run, this);
+			}
+			mChanged.notify_all();
+			return id;
+		}
+
+		void stop(LayerGuid id)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mPlaybacks.erase(std::remove_if(mPlaybacks.begin(), mPlaybacks.end(), [id](const std::unique_ptr<Playback> &playback) {
+				return reinterpret_cast<LayerGuid>(playback.get()) == id;
+			}), mPlaybacks.end());
+		}
+
+	private:
+		struct Playback
+		{
+			CorsairEffect effect;
+			int layer;
+			int sequence;
+			Clock::time_point start;
+		};
+
+		void run()
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			auto deadline = Clock::now();
+			while (!mStop) {
+				mChanged.wait(lock, [this] { return mStop || !mPlaybacks.empty(); });
+				if (mStop) {
+					break;
+				}
+
+				composeFrame();
+				if (mSetColors && !mColors.empty()) {
+					mSetColors(static_cast<int>(mColors.size()), mColors.data(), nullptr, nullptr);
+				}
+
+				deadline = std::max(deadline + cFramePeriod, Clock::now());
+				mChanged.wait_until(lock, deadline, [this] { return mStop; });
+			}
+		}
+
+		void composeFrame()
+		{
+			const auto now = Clock::now();
+			mColors.clear();
+			for (auto it = mPlaybacks.begin(); it != mPlaybacks.end();) {
+				auto &playback = **it;
+				const auto offset = std::chrono::duration_cast<std::chrono::milliseconds>(now - playback.start).count();
+				auto frame = playback.effect.getFrameFunction(playback.effect.effectId, static_cast<int>(offset));
+				if (!frame) {
+					// Finished effects are removed from their layer.
+					it = mPlaybacks.erase(it);
+					continue;
+				}
+				for (auto i = 0; i < frame->size; ++i) {
+					merge(frame->ledsColors[i]);
+				}
+				if (playback.effect.freeFrameFunction) {
+					playback.effect.freeFrameFunction(frame);
+				}
+				++it;
+			}
+		}
+
+		void merge(const CorsairLedColor &ledColor)
+		{
+			for (auto &existing : mColors) {
+				if (existing.ledId == ledColor.ledId) {
+					existing = ledColor;
+					return;
+				}
+			}
+			mColors.push_back(ledColor);
+		}
+
+		std::mutex mMutex;
+		std::condition_variable mChanged;
+		CorsairSetLedsColorsAsyncType mSetColors;
+		std::vector<std::unique_ptr<Playback>> mPlaybacks;
+		std::vector<CorsairLedColor> mColors;
+		int mNextSequence;
+		bool mStop;
+		std::thread mThread;
+	};
+
+	LayerPlayer& player()
+	{
+		static LayerPlayer layers;
+		return layers;
+	}
+}
+
+void CorsairLayersInitialize(CorsairSetLedsColorsAsyncType setColorsAsyncFunc)
+{
+	player().initialize(setColorsAsyncFunc);
+}
+
+LayerGuid CorsairLayersPlayEffect(CorsairEffect* effect, int layer)
+{
+	return player().play(effect, layer);
+}
+
+void CorsairLayersStopEffect(LayerGuid layerId)
+{
+	player().stop(layerId);
+}
@@ -0,0 +1,149 @@
+#include "EffectLibrary.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const double cKeyPitch = 19.0;   // mm
+}
+
+StandInEffect::StandInEffect(int size, const CorsairLedId *leds)
+	: mLeds(leds, leds + std::max(size, 0))
+{
+	mEffect.effectId = id();
+	mEffect.getFrameFunction = nullptr;
+	mEffect.freeFrameFunction = nullptr;
+}
+
+EffectLibrary::EffectLibrary(GetFrameFunction getFrame, FreeFrameFunction freeFrame)
+	: mGetFrame(getFrame), mFreeFrame(freeFrame)
+{
+}
+
+void EffectLibrary::setLedPositions(const CorsairLedPositions *ledPositions)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mPoints.clear();
+	if (!ledPositions || ledPositions->numberOfLed <= 0) {
+		return;
+	}
+
+	const auto first = ledPositions->pLedPosition;
+	const auto last = first + ledPositions->numberOfLed;
+	auto minX = first->left, maxX = first->left + first->width;
+	auto minY = first->top, maxY = first->top + first->height;
+	for (auto position = first; position != last; ++position) {
+		minX = std::min(minX, position->left);
+		maxX = std::max(maxX, position->left + position->width);
+		minY = std::min(minY, position->top);
+		maxY = std::max(maxY, position->top + position->height);
+	}
+
+	const auto width = std::max(maxX - minX, 1.);
+	const auto height = std::max(maxY - minY, 1.);
+	for (auto position = first; position != last; ++position) {
+		const auto x = position->left + position->width / 2 - minX;
+		const auto y = position->top + position->height / 2 - minY;
+		mPoints[position->ledId] = LedPoint{ x / width, y / height, x / cKeyPitch, y / cKeyPitch };
+	}
+}
+
+CorsairEffect* EffectLibrary::add(std::unique_ptr<StandInEffect> effect)
+{
+	if (effect->leds().empty()) {
+		return nullptr;
+	}
+	effect->mEffect.getFrameFunction = mGetFrame;
+	effect->mEffect.freeFrameFunction = mFreeFrame;
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto result = effect->effect();
+	mEffects[effect->id()] = std::move(effect);
+	return result;
+}
+
+bool EffectLibrary::update(Guid effectId, const std::function<void(StandInEffect&)> &update)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mEffects.find(effectId);
+	if (it == mEffects.end()) {
+		return false;
+	}
+	update(*it->second);
+	return true;
+}
+
+CorsairFrame* EffectLibrary::getFrame(Guid effectId, int offset)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mEffects.find(effectId);
+	if (it == mEffects.end() || offset < 0) {
+		return nullptr;
+	}
+
+	auto &effect = *it->second;
+	const auto &leds = effect.leds();
+	mScratchPoints.clear();
+	for (auto ledId : leds) {
+		mScratchPoints.push_back(point(ledId));
+	}
+	mScratchColors.assign(leds.size(), CorsairColor{ 0, 0, 0 });
+	if (!effect.render(offset, mScratchPoints, mScratchColors)) {
+		return nullptr;
+	}
+
+	auto frame = new CorsairFrame;
+	frame->size = static_cast<int>(leds.size());
+	frame->ledsColors = new CorsairLedColor[leds.size()];
+	for (size_t i = 0; i < leds.size(); ++i) {
+		const auto &color = mScratchColors[i];
+		frame->ledsColors[i] = CorsairLedColor{ leds[i], color.r, color.g, color.b };
+	}
+	return frame;
+}
+
+void EffectLibrary::freeFrame(CorsairFrame *frame)
+{
+	if (frame) {
+		delete[] frame->ledsColors;
+		delete frame;
+	}
+}
+
+LedPoint EffectLibrary::point(CorsairLedId ledId) const
+{
+	auto it = mPoints.find(ledId);
+	return it != mPoints.end() ? it->second : LedPoint{ .5, .5, 0., 0. };
+}
+
+CorsairColor hueColor(double hue)
+{
+	hue = (hue - std::floor(hue)) * 6.;
+	const auto sector = static_cast<int>(hue) % 6;
+	const auto rising = static_cast<int>((hue - std::floor(hue)) * 255. + .5);
+	const auto falling = 255 - rising;
+	switch (sector) {
+	case 0: return CorsairColor{ 255, rising, 0 };
+	case 1: return CorsairColor{ falling, 255, 0 };
+	case 2: return CorsairColor{ 0, 255, rising };
+	case 3: return CorsairColor{ 0, falling, 255 };
+	case 4: return CorsairColor{ rising, 0, 255 };
+	default: return CorsairColor{ 255, 0, falling };
+	}
+}
+
+CorsairColor mixColors(const CorsairColor &from, const CorsairColor &to, double t)
+{
+	t = std::min(std::max(t, 0.), 1.);
+	return CorsairColor{
+		static_cast<int>(from.r + (to.r - from.r) * t + .5),
+		static_cast<int>(from.g + (to.g - from.g) * t + .5),
+		static_cast<int>(from.b + (to.b - from.b) * t + .5)
+	};
+}
+
+CorsairColor scaleColor(const CorsairColor &color, double intensity)
+{
+	return mixColors(CorsairColor{ 0, 0, 0 }, color, intensity);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Shared/LFX.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/// Position of a LED relative to the top left corner of the bounding box of all known positions.
+struct LedPoint
+{
+	double x;      /**< Normalized horizontal position [0..1] */
+	double y;      /**< Normalized vertical position [0..1] */
+	double keyX;   /**< Horizontal position in key pitches (19 mm) */
+	double keyY;   /**< Vertical position in key pitches (19 mm) */
+};
+
+/**
+ * @brief Base of the effects implemented by the stand-in effect libraries.
+ *
+ * The effect identifier handed out to the client is the address of the effect object.
+ */
+class StandInEffect
+{
+public:
+	StandInEffect(int size, const CorsairLedId *leds);
+	virtual ~StandInEffect() = default;
+
+	StandInEffect(const StandInEffect&) = delete;
+	StandInEffect& operator=(const StandInEffect&) = delete;
+
+	Guid id() { return reinterpret_cast<Guid>(this); }
+	CorsairEffect* effect() { return &mEffect; }
+	const std::vector<CorsairLedId>& leds() const { return mLeds; }
+
+	/**
+	 * @brief Renders the effect at specified offset.
+	 * @param offset Offset in milliseconds.
+	 * @param points Normalized position of every LED of the effect, in the same order as leds().
+	 * @param colors Receives one color per LED, in the same order as leds().
+	 * @return false if the effect is finished at specified offset.
+	 */
+	virtual bool render(int offset, const std::vector<LedPoint> &points, std::vector<CorsairColor> &colors) = 0;
+
+	/// Adds a point to the intensity chart of the effect; ignored by effects without one.
+	virtual void addPoint(double /*position*/, CorsairColor /*color*/) {}
+
+private:
+	friend class EffectLibrary;
+
+	std::vector<CorsairLedId> mLeds;
+	CorsairEffect mEffect;
+};
+
+/**
+ * @brief Owns the effects of one stand-in library (CUELFX or CorsairLFX) and produces their frames.
+ *
+ * Effects live until the library is unloaded, the same as with the libraries shipped with the SDK.
+ */
+class EffectLibrary
+{
+public:
+	using GetFrameFunction = CorsairFrame* (*)(Guid, int);
+	using FreeFrameFunction = void (*)(CorsairFrame*);
+
+	EffectLibrary(GetFrameFunction getFrame, FreeFrameFunction freeFrame);
+
+	void setLedPositions(const CorsairLedPositions *ledPositions);
+
+	/// Takes ownership of the effect; returns nullptr and drops it if it has no LEDs.
+	CorsairEffect* add(std::unique_ptr<StandInEffect> effect);
+
+	/// Calls update on the effect with specified id while no frame of it is being rendered. Returns false if there is no such effect.
+	bool update(Guid effectId, const std::function<void(StandInEffect&)> &update);
+
+	CorsairFrame* getFrame(Guid effectId, int offset);
+	static void freeFrame(CorsairFrame *frame);
+
+private:
+	LedPoint point(CorsairLedId ledId) const;
+
+	GetFrameFunction mGetFrame;
+	FreeFrameFunction mFreeFrame;
+	std::mutex mMutex;
+	std::unordered_map<Guid, std::unique_ptr<StandInEffect>> mEffects;
+	std::unordered_map<int, LedPoint> mPoints;
+	std::vector<LedPoint> mScratchPoints;
+	std::vector<CorsairColor> mScratchColors;
+};
+
+/// Color of a hue in [0..1) at full saturation and value.
+CorsairColor hueColor(double hue);
+
+/// Linear interpolation between two colors, t in [0..1].
+CorsairColor mixColors(const CorsairColor &from, const CorsairColor &to, double t);
+
+/// Multiplies every component of the color by intensity in [0..1].
+CorsairColor scaleColor(const CorsairColor &color, double intensity);
@@ -0,0 +1,111 @@
+#include "FrameRecorder.h"
+
+#include <algorithm>
+
+namespace
+{
+	const char cTraceMagic[8] = { 'C', 'U', 'E', 'T', 'R', 'A', 'C', 'E' };
+	const uint32_t cTraceVersion = 1;
+
+	void putLE(std::vector<unsigned char> &buffer, uint64_t value, int bytes)
+	{
+		for (auto i = 0; i < bytes; ++i) {
+			buffer.push_back(static_cast<unsigned char>(value >> (8 * i)));
+		}
+	}
+}
+
+FrameRecorder::FrameRecorder(int capacity)
+	: mHead(0), mCount(0), mTotal(0), mTrace(nullptr)
+{
+	setCapacity(capacity);
+}
+
+FrameRecorder::~FrameRecorder()
+{
+	closeTrace();
+}
+
+void FrameRecorder::setCapacity(int capacity)
+{
+	mRing.clear();
+	mRing.resize(std::max(capacity, 0));
+	mHead = 0;
+	mCount = 0;
+}
+
+void FrameRecorder::clear()
+{
+	mHead = 0;
+	mCount = 0;
+	mTotal = 0;
+}
+
+void FrameRecorder::record(int64_t timestampNs, bool async, int size, const CorsairLedColor *ledsColors)
+{
+	mTotal++;
+
+	Entry scratch;
+	auto &entry = mRing.empty() ? scratch : mRing[mHead];
+	entry.timestampNs = timestampNs;
+	entry.async = async;
+	entry.ledsColors.assign(ledsColors, ledsColors + size);
+
+	if (!mRing.empty()) {
+		mHead = (mHead + 1) % mRing.size();
+		mCount = std::min(mCount + 1, mRing.size());
+	}
+	if (mTrace) {
+		writeTrace(entry);
+	}
+}
+
+bool FrameRecorder::frame(int index, CorsairStandInFrame &frame) const
+{
+	if (index < 0 || static_cast<size_t>(index) >= mCount) {
+		return false;
+	}
+	const auto &entry = mRing[(mHead + mRing.size() - mCount + index) % mRing.size()];
+	frame.timestampNs = entry.timestampNs;
+	frame.async = entry.async ? 1 : 0;
+	frame.size = static_cast<int>(entry.ledsColors.size());
+	frame.ledsColors = entry.ledsColors.data();
+	return true;
+}
+
+bool FrameRecorder::openTrace(const std::string &path)
+{
+	closeTrace();
+	mTrace = std::fopen(path.c_str(), "wb");
+	if (!mTrace) {
+		return false;
+	}
+	mTraceBuffer.assign(cTraceMagic, cTraceMagic + sizeof(cTraceMagic));
+	putLE(mTraceBuffer, cTraceVersion, 4);
+	std::fwrite(mTraceBuffer.data(), 1, mTraceBuffer.size(), mTrace);
+	return true;
+}
+
+void FrameRecorder::closeTrace()
+{
+	if (mTrace) {
+		std::fclose(mTrace);
+		mTrace = nullptr;
+	}
+}
+
+void FrameRecorder::writeTrace(const Entry &entry)
+{
+	mTraceBuffer.clear();
+	putLE(mTraceBuffer, static_cast<uint64_t>(entry.timestampNs), 8);
+	putLE(mTraceBuffer, entry.async ? 1 : 0, 4);
+	putLE(mTraceBuffer, entry.ledsColors.size(), 4);
+	for (const auto &ledColor : entry.ledsColors) {
+		putLE(mTraceBuffer, static_cast<uint32_t>(ledColor.ledId), 4);
+		mTraceBuffer.push_back(static_cast<unsigned char>(ledColor.r));
+		mTraceBuffer.push_back(static_cast<unsigned char>(ledColor.g));
+		mTraceBuffer.push_back(static_cast<unsigned char>(ledColor.b));
+		mTraceBuffer.push_back(0);
+	}
+	std::fwrite(mTraceBuffer.data(), 1, mTraceBuffer.size(), mTrace);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CUESDKStandIn.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Keeps the most recent frames pushed to the stand-in in a fixed ring and optionally appends them to a trace file.
+ *
+ * Not thread-safe on its own, the stand-in server serializes access to it.
+ */
+class FrameRecorder
+{
+public:
+	explicit FrameRecorder(int capacity);
+	~FrameRecorder();
+
+	FrameRecorder(const FrameRecorder&) = delete;
+	FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+	void setCapacity(int capacity);
+	void clear();
+
+	void record(int64_t timestampNs, bool async, int size, const CorsairLedColor *ledsColors);
+
+	int count() const { return static_cast<int>(mCount); }
+	int64_t total() const { return mTotal; }
+	bool frame(int index, CorsairStandInFrame &frame) const;
+
+	bool openTrace(const std::string &path);
+	void closeTrace();
+
+private:
+	struct Entry
+	{
+		int64_t timestampNs;
+		bool async;
+		std::vector<CorsairLedColor> ledsColors;
+	};
+
+	void writeTrace(const Entry &entry);
+
+	std::vector<Entry> mRing;
+	size_t mHead;
+	size_t mCount;
+	int64_t mTotal;
+	FILE *mTrace;
+	std::vector<unsigned char> mTraceBuffer;
+};
@@ -0,0 +1,602 @@
+#include "StandInServer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+namespace
+{
+	const int cDefaultRecordCapacity = 4096;
+	const int cProtocolVersion = 2;
+	const char *cSdkVersion = "2.18.127";
+	const char *cServerVersion = "2.18.127-standin";
+	const int cVirtualKeyEscape = 0x1B;
+
+	thread_local CorsairError tLastError = CE_Success;
+
+	const char* environment(const char *name)
+	{
+		const auto value = std::getenv(name);
+		return value && *value ? value : nullptr;
+	}
+}
+
+StandInServer& StandInServer::instance()
+{
+	static StandInServer server;
+	return server;
+}
+
+StandInServer::StandInServer()
+	: mWorkerBusy(false),
+	mStopWorker(false),
+	mServerAvailable(true),
+	mSession(0),
+	mHandshakeDone(false),
+	mControlRevoked(false),
+	mLatencyUs(0),
+	mQueryLatencyUs(0),
+	mJitterUs(0),
+	mRecorder(cDefaultRecordCapacity),
+	mStart(Clock::now()),
+	mHasEscapeDeadline(false)
+{
+	for (auto i = 0; i < 256; ++i) {
+		mKeyDown[i] = false;
+		mKeyPressed[i] = false;
+	}
+	reset(true);
+	applyEnvironment();
+	mWorker = std::thread(&StandInServer::asyncWorker, this);
+}
+
+StandInServer::~StandInServer()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopWorker = true;
+	}
+	mQueueChanged.notify_all();
+	if (mWorker.joinable()) {
+		mWorker.join();
+	}
+}
+
+CorsairError StandInServer::lastError()
+{
+	return tLastError;
+}
+
+void StandInServer::setLastError(CorsairError error)
+{
+	tLastError = error;
+}
+
+void StandInServer::applyEnvironment()
+{
+	if (auto devices = environment("CUESDK_STANDIN_DEVICES")) {
+		mDevices.clear();
+		std::istringstream stream(devices);
+		std::string name;
+		while (std::getline(stream, name, ',')) {
+			CorsairStandInDeviceModel model;
+			if (parseDeviceModel(name, model)) {
+				mDevices.push_back(createVirtualDevice(model));
+			}
+		}
+	}
+	if (auto latency = environment("CUESDK_STANDIN_LATENCY_US")) {
+		mLatencyUs = std::atoi(latency);
+	}
+	if (auto latency = environment("CUESDK_STANDIN_QUERY_LATENCY_US")) {
+		mQueryLatencyUs = std::atoi(latency);
+	}
+	if (auto jitter = environment("CUESDK_STANDIN_JITTER_US")) {
+		mJitterUs = std::atoi(jitter);
+	}
+	if (auto error = environment("CUESDK_STANDIN_ERROR")) {
+		const auto name = std::string(error);
+		mServerAvailable = name != "ServerNotFound";
+		mControlRevoked = name == "NoControl";
+	}
+	if (auto path = environment("CUESDK_STANDIN_TRACE")) {
+		mRecorder.openTrace(path);
+	}
+	if (auto runMs = environment("CUESDK_STANDIN_RUN_MS")) {
+		mHasEscapeDeadline = true;
+		mEscapeDeadline = mStart + std::chrono::milliseconds(std::atoi(runMs));
+	}
+}
+
+void StandInServer::addDefaultDevices()
+{
+	mDevices.push_back(createVirtualDevice(CSIDM_K95RGB));
+	mDevices.push_back(createVirtualDevice(CSIDM_ScimitarRGB));
+	mDevices.push_back(createVirtualDevice(CSIDM_VoidRGB));
+	mDevices.push_back(createVirtualDevice(CSIDM_MM800RGB));
+}
+
+bool StandInServer::checkConnection() const
+{
+	if (!mServerAvailable) {
+		setLastError(CE_ServerNotFound);
+		return false;
+	}
+	if (!mHandshakeDone) {
+		setLastError(CE_ProtocolHandshakeMissing);
+		return false;
+	}
+	return true;
+}
+
+bool StandInServer::checkColors(int size, const CorsairLedColor *ledsColors) const
+{
+	if (size < 0 || (size > 0 && !ledsColors)) {
+		return false;
+	}
+	bool seen[CLI_Last + 1] = {};
+	for (auto i = 0; i < size; ++i) {
+		const auto &ledColor = ledsColors[i];
+		if (ledColor.r < 0 || ledColor.r > 255 || ledColor.g < 0 || ledColor.g > 255 || ledColor.b < 0 || ledColor.b > 255) {
+			return false;
+		}
+		if (ledColor.ledId > CLI_Invalid && ledColor.ledId <= CLI_Last) {
+			if (seen[ledColor.ledId]) {
+				return false;
+			}
+			seen[ledColor.ledId] = true;
+		}
+	}
+	return true;
+}
+
+int StandInServer::latencyOf(int size, const CorsairLedColor *ledsColors, std::vector<VirtualDevice*> &devices)
+{
+	auto latencyUs = mLatencyUs;
+	if (mJitterUs > 0) {
+		latencyUs += std::uniform_int_distribution<int>(0, mJitterUs)(mRandom);
+	}
+	auto deviceUs = 0;
+	devices.clear();
+	for (const auto &device : mDevices) {
+		const auto touched = std::any_of(ledsColors, ledsColors + size, [&device](const CorsairLedColor &ledColor) {
+			return std::find(device->leds.begin(), device->leds.end(), ledColor.ledId) != device->leds.end();
+		});
+		if (touched) {
+			devices.push_back(device.get());
+			deviceUs = std::max(deviceUs, device->latencyUs);
+		}
+	}
+	return latencyUs + deviceUs;
+}
+
+void StandInServer::simulateLatency(int size, const CorsairLedColor *ledsColors)
+{
+	int delayUs;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		std::vector<VirtualDevice*> devices;
+		delayUs = latencyOf(size, ledsColors, devices);
+	}
+	if (delayUs > 0) {
+		std::this_thread::sleep_for(std::chrono::microseconds(delayUs));
+	}
+}
+
+void StandInServer::simulateQueryLatency()
+{
+	int delayUs;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		delayUs = mQueryLatencyUs;
+	}
+	if (delayUs > 0) {
+		std::this_thread::sleep_for(std::chrono::microseconds(delayUs));
+	}
+}
+
+void StandInServer::applyFrame(bool async, int size, const CorsairLedColor *ledsColors)
+{
+	for (auto i = 0; i < size; ++i) {
+		const auto ledId = ledsColors[i].ledId;
+		if (ledId > CLI_Invalid && ledId <= CLI_Last) {
+			mLedState[ledId] = ledsColors[i];
+		}
+	}
+	const auto timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - mStart).count();
+	mRecorder.record(timestampNs, async, size, ledsColors);
+}
+
+void StandInServer::asyncWorker()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true) {
+		mQueueChanged.wait(lock, [this] { return mStopWorker || !mQueue.empty(); });
+		if (mQueue.empty()) {
+			return;
+		}
+		// The first of the calls due earliest, so calls of one device keep their order.
+		const auto next = std::min_element(mQueue.begin(), mQueue.end(), [](const AsyncRequest &a, const AsyncRequest &b) {
+			return a.due < b.due;
+		});
+		if (!mStopWorker && next->due > Clock::now()) {
+			mQueueChanged.wait_until(lock, next->due);
+			continue;
+		}
+		auto request = std::move(*next);
+		mQueue.erase(next);
+		mWorkerBusy = true;
+
+		auto error = CE_Success;
+		if (!mServerAvailable || request.session != mSession) {
+			error = CE_ServerNotFound;
+		} else if (mControlRevoked) {
+			error = CE_NoControl;
+		} else {
+			applyFrame(true, static_cast<int>(request.ledsColors.size()), request.ledsColors.data());
+		}
+		lock.unlock();
+
+		if (request.callback) {
+			request.callback(request.context, error == CE_Success, error);
+		}
+
+		lock.lock();
+		mWorkerBusy = false;
+		if (mQueue.empty()) {
+			mIdle.notify_all();
+		}
+	}
+}
+
+CorsairProtocolDetails StandInServer::performProtocolHandshake()
+{
+	simulateQueryLatency();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	CorsairProtocolDetails details;
+	details.sdkVersion = cSdkVersion;
+	details.sdkProtocolVersion = cProtocolVersion;
+	details.breakingChanges = false;
+	if (!mServerAvailable) {
+		details.serverVersion = nullptr;
+		details.serverProtocolVersion = 0;
+		setLastError(CE_ServerNotFound);
+		return details;
+	}
+	details.serverVersion = cServerVersion;
+	details.serverProtocolVersion = cProtocolVersion;
+	mHandshakeDone = true;
+	setLastError(CE_Success);
+	return details;
+}
+
+bool StandInServer::requestControl(CorsairAccessMode accessMode)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!checkConnection()) {
+		return false;
+	}
+	if (accessMode != CAM_ExclusiveLightingControl) {
+		setLastError(CE_InvalidArguments);
+		return false;
+	}
+	// Exclusive control follows a "last wins" strategy, so requesting it always succeeds.
+	mControlRevoked = false;
+	setLastError(CE_Success);
+	return true;
+}
+
+bool StandInServer::releaseControl(CorsairAccessMode accessMode)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!checkConnection()) {
+		return false;
+	}
+	if (accessMode != CAM_ExclusiveLightingControl) {
+		setLastError(CE_InvalidArguments);
+		return false;
+	}
+	setLastError(CE_Success);
+	return true;
+}
+
+int StandInServer::deviceCount()
+{
+	simulateQueryLatency();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!checkConnection()) {
+		return -1;
+	}
+	setLastError(CE_Success);
+	return static_cast<int>(mDevices.size());
+}
+
+CorsairDeviceInfo* StandInServer::deviceInfo(int deviceIndex)
+{
+	simulateQueryLatency();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!checkConnection()) {
+		return nullptr;
+	}
+	if (deviceIndex < 0 || deviceIndex >= static_cast<int>(mDevices.size())) {
+		setLastError(CE_InvalidArguments);
+		return nullptr;
+	}
+	setLastError(CE_Success);
+	return &mDevices[deviceIndex]->info;
+}
+
+CorsairLedPositions* StandInServer::ledPositions()
+{
+	simulateQueryLatency();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!checkConnection()) {
+		return nullptr;
+	}
+	for (auto &device : mDevices) {
+		if (device->info.type == CDT_Keyboard) {
+			setLastError(CE_Success);
+			return &device->ledPositions;
+		}
+	}
+	setLastError(CE_Success);
+	return nullptr;
+}
+
+CorsairLedPositions* StandInServer::ledPositionsByDeviceIndex(int deviceIndex)
+{
+	simulateQueryLatency();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!checkConnection()) {
+		return nullptr;
+	}
+	if (deviceIndex < 0 || deviceIndex >= static_cast<int>(mDevices.size())) {
+		setLastError(CE_InvalidArguments);
+		return nullptr;
+	}
+	auto &device = *mDevices[deviceIndex];
+	if (device.info.type != CDT_Keyboard && device.info.type != CDT_MouseMat) {
+		setLastError(CE_InvalidArguments);
+		return nullptr;
+	}
+	setLastError(CE_Success);
+	return &device.ledPositions;
+}
+
+CorsairLedId StandInServer::ledIdForKeyName(char keyName)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!checkConnection()) {
+		return CLI_Invalid;
+	}
+	auto layout = CLL_US_Int;
+	for (auto &device : mDevices) {
+		if (device->info.type == CDT_Keyboard) {
+			layout = device->info.logicalLayout;
+			break;
+		}
+	}
+	const auto ledId = ::ledIdForKeyName(layout, keyName);
+	setLastError(ledId == CLI_Invalid ? CE_InvalidArguments : CE_Success);
+	return ledId;
+}
+
+bool StandInServer::setLedsColors(int size, CorsairLedColor *ledsColors)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!checkConnection()) {
+			return false;
+		}
+		if (!checkColors(size, ledsColors)) {
+			setLastError(CE_InvalidArguments);
+			return false;
+		}
+	}
+
+	simulateLatency(size, ledsColors);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!checkConnection()) {
+		return false;
+	}
+	if (mControlRevoked) {
+		setLastError(CE_NoControl);
+		return false;
+	}
+	applyFrame(false, size, ledsColors);
+	setLastError(CE_Success);
+	return true;
+}
+
+bool StandInServer::setLedsColorsAsync(int size, CorsairLedColor *ledsColors, void (*callback)(void*, bool, CorsairError), void *context)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!checkConnection()) {
+			return false;
+		}
+		if (!checkColors(size, ledsColors)) {
+			setLastError(CE_InvalidArguments);
+			return false;
+		}
+		AsyncRequest request;
+		request.ledsColors.assign(ledsColors, ledsColors + size);
+		request.callback = callback;
+		request.context = context;
+		request.session = mSession;
+		// Each device works through its calls one by one, a call waits for every device it sets LEDs of.
+		std::vector<VirtualDevice*> devices;
+		const auto latency = std::chrono::microseconds(latencyOf(size, ledsColors, devices));
+		auto start = std::max(Clock::now(), mIdleAt);
+		for (const auto device : devices) {
+			start = std::max(start, device->idleAt);
+		}
+		request.due = start + latency;
+		mIdleAt = devices.empty() ? request.due : mIdleAt;
+		for (const auto device : devices) {
+			device->idleAt = request.due;
+		}
+		mQueue.push_back(std::move(request));
+		setLastError(CE_Success);
+	}
+	mQueueChanged.notify_one();
+	return true;
+}
+
+void StandInServer::reset(bool withDefaultDevices)
+{
+	waitForIdle();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mDevices.clear();
+	if (withDefaultDevices) {
+		addDefaultDevices();
+	}
+	for (auto i = 0; i <= CLI_Last; ++i) {
+		mLedState[i] = CorsairLedColor{ static_cast<CorsairLedId>(i), 0, 0, 0 };
+	}
+	mServerAvailable = true;
+	mHandshakeDone = false;
+	mControlRevoked = false;
+	mLatencyUs = 0;
+	mQueryLatencyUs = 0;
+	mJitterUs = 0;
+	mRecorder.closeTrace();
+	mRecorder.setCapacity(cDefaultRecordCapacity);
+	mRecorder.clear();
+	mStart = Clock::now();
+}
+
+int StandInServer::addDevice(CorsairStandInDeviceModel model)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mDevices.push_back(createVirtualDevice(model));
+	return static_cast<int>(mDevices.size()) - 1;
+}
+
+void StandInServer::setLogicalLayout(int deviceIndex, CorsairLogicalLayout layout)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (deviceIndex >= 0 && deviceIndex < static_cast<int>(mDevices.size())) {
+		mDevices[deviceIndex]->info.logicalLayout = layout;
+	}
+}
+
+void StandInServer::setServerAvailable(bool available)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!available) {
+		mHandshakeDone = false;
+		mSession += mServerAvailable ? 1 : 0;
+	}
+	mServerAvailable = available;
+}
+
+void StandInServer::revokeControl()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mControlRevoked = true;
+}
+
+void StandInServer::setLatency(int latencyUs, int jitterUs)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mLatencyUs = latencyUs > 0 ? latencyUs : 0;
+	mJitterUs = jitterUs > 0 ? jitterUs : 0;
+}
+
+void StandInServer::setQueryLatency(int latencyUs)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mQueryLatencyUs = latencyUs > 0 ? latencyUs : 0;
+}
+
+void StandInServer::setDeviceLatency(int deviceIndex, int latencyUs)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (deviceIndex >= 0 && deviceIndex < static_cast<int>(mDevices.size())) {
+		mDevices[deviceIndex]->latencyUs = latencyUs > 0 ? latencyUs : 0;
+	}
+}
+
+void StandInServer::waitForIdle()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mIdle.wait(lock, [this] { return mQueue.empty() && !mWorkerBusy; });
+}
+
+void StandInServer::setRecordCapacity(int frameCount)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mRecorder.setCapacity(frameCount);
+}
+
+int StandInServer::recordedFrameCount()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mRecorder.count();
+}
+
+int64_t StandInServer::totalFrameCount()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mRecorder.total();
+}
+
+bool StandInServer::recordedFrame(int index, CorsairStandInFrame &frame)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mRecorder.frame(index, frame);
+}
+
+CorsairLedColor StandInServer::ledColor(CorsairLedId ledId)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (ledId <= CLI_Invalid || ledId > CLI_Last) {
+		return CorsairLedColor{ CLI_Invalid, 0, 0, 0 };
+	}
+	return mLedState[ledId];
+}
+
+bool StandInServer::openTrace(const char *path)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return path && mRecorder.openTrace(path);
+}
+
+void StandInServer::closeTrace()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mRecorder.closeTrace();
+}
+
+void StandInServer::setKeyState(int virtualKey, bool pressed)
+{
+	if (virtualKey < 0 || virtualKey > 255) {
+		return;
+	}
+	mKeyDown[virtualKey] = pressed;
+	if (pressed) {
+		mKeyPressed[virtualKey] = true;
+	}
+}
+
+short StandInServer::keyState(int virtualKey)
+{
+	if (virtualKey < 0 || virtualKey > 255) {
+		return 0;
+	}
+	auto down = mKeyDown[virtualKey].load();
+	if (virtualKey == cVirtualKeyEscape && mHasEscapeDeadline && Clock::now() >= mEscapeDeadline) {
+		down = true;
+	}
+	const auto pressedSinceLastCall = mKeyPressed[virtualKey].exchange(false);
+	return static_cast<short>((down ? 0x8000 : 0) | (pressedSinceLastCall ? 0x1 : 0));
+}
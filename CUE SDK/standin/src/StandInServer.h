@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CUESDKStandIn.h"
+#include "FrameRecorder.h"
+#include "VirtualDevices.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Simulated CUE server behind the stand-in implementation of CUESDK.h.
+ *
+ * Every SDK entry point forwards to the single instance. All state is guarded by one mutex, simulated
+ * latency is spent outside of it, and asynchronous submissions are executed on a worker thread, in order for
+ * every device they set LEDs of.
+ */
+class StandInServer
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static StandInServer& instance();
+	~StandInServer();
+
+	static CorsairError lastError();
+	static void setLastError(CorsairError error);
+
+	CorsairProtocolDetails performProtocolHandshake();
+	bool requestControl(CorsairAccessMode accessMode);
+	bool releaseControl(CorsairAccessMode accessMode);
+	int deviceCount();
+	CorsairDeviceInfo* deviceInfo(int deviceIndex);
+	CorsairLedPositions* ledPositions();
+	CorsairLedPositions* ledPositionsByDeviceIndex(int deviceIndex);
+	CorsairLedId ledIdForKeyName(char keyName);
+	bool setLedsColors(int size, CorsairLedColor *ledsColors);
+	bool setLedsColorsAsync(int size, CorsairLedColor *ledsColors, void (*callback)(void*, bool, CorsairError), void *context);
+
+	void reset(bool withDefaultDevices);
+	int addDevice(CorsairStandInDeviceModel model);
+	void setLogicalLayout(int deviceIndex, CorsairLogicalLayout layout);
+	void setServerAvailable(bool available);
+	void revokeControl();
+	void setLatency(int latencyUs, int jitterUs);
+	void setQueryLatency(int latencyUs);
+	void setDeviceLatency(int deviceIndex, int latencyUs);
+	void waitForIdle();
+	void setRecordCapacity(int frameCount);
+	int recordedFrameCount();
+	int64_t totalFrameCount();
+	bool recordedFrame(int index, CorsairStandInFrame &frame);
+	CorsairLedColor ledColor(CorsairLedId ledId);
+	bool openTrace(const char *path);
+	void closeTrace();
+
+	void setKeyState(int virtualKey, bool pressed);
+	short keyState(int virtualKey);
+
+private:
+	struct AsyncRequest
+	{
+		std::vector<CorsairLedColor> ledsColors;
+		void (*callback)(void*, bool, CorsairError);
+		void *context;
+		Clock::time_point due;           /**< When the devices it sets LEDs of are done with it */
+		unsigned session;                /**< Server session it was made in, see mSession */
+	};
+
+	StandInServer();
+
+	void applyEnvironment();
+	void addDefaultDevices();
+	bool checkConnection() const;
+	bool checkColors(int size, const CorsairLedColor *ledsColors) const;
+	int latencyOf(int size, const CorsairLedColor *ledsColors, std::vector<VirtualDevice*> &devices);
+	void simulateLatency(int size, const CorsairLedColor *ledsColors);
+	void simulateQueryLatency();
+	void applyFrame(bool async, int size, const CorsairLedColor *ledsColors);
+	void asyncWorker();
+
+	std::mutex mMutex;
+	std::condition_variable mQueueChanged;
+	std::condition_variable mIdle;
+	std::deque<AsyncRequest> mQueue;
+	Clock::time_point mIdleAt;       /**< Same as VirtualDevice::idleAt for calls setting no LED of a device */
+	bool mWorkerBusy;
+	bool mStopWorker;
+	std::thread mWorker;
+
+	std::vector<std::unique_ptr<VirtualDevice>> mDevices;
+	CorsairLedColor mLedState[CLI_Last + 1];
+	bool mServerAvailable;
+	unsigned mSession;               /**< Incremented whenever the server goes away, calls of earlier sessions fail */
+	bool mHandshakeDone;
+	bool mControlRevoked;
+	int mLatencyUs;
+	int mQueryLatencyUs;
+	int mJitterUs;
+	std::mt19937 mRandom;
+	FrameRecorder mRecorder;
+	Clock::time_point mStart;
+
+	std::atomic<bool> mKeyDown[256];
+	std::atomic<bool> mKeyPressed[256];
+	Clock::time_point mEscapeDeadline;
+	bool mHasEscapeDeadline;
+};
@@ -0,0 +1,307 @@
+#include "VirtualDevices.h"
+
+#include <algorithm>
+#include <cctype>
+#include <initializer_list>
+
+namespace
+{
+	const double cKeyUnit = 19.0;   // key pitch in mm
+
+	struct KeySlot
+	{
+		CorsairLedId ledId;   // CLI_Invalid for a gap
+		double width;         // in key units
+		double height;        // in key units
+	};
+
+	KeySlot key(CorsairLedId ledId, double width = 1., double height = 1.)
+	{
+		return KeySlot{ ledId, width, height };
+	}
+
+	KeySlot gap(double width)
+	{
+		return KeySlot{ CLI_Invalid, width, 1. };
+	}
+
+	void addRow(VirtualDevice &device, double y, double x, std::initializer_list<KeySlot> slots)
+	{
+		for (const auto &slot : slots) {
+			if (slot.ledId != CLI_Invalid) {
+				device.positions.push_back(CorsairLedPosition{ slot.ledId, y * cKeyUnit, x * cKeyUnit, slot.height * cKeyUnit, slot.width * cKeyUnit });
+			}
+			x += slot.width;
+		}
+	}
+
+	void addRange(VirtualDevice &device, double y, double &x, int first, int last)
+	{
+		for (auto i = first; i <= last; ++i) {
+			addRow(device, y, x, { key(static_cast<CorsairLedId>(i)) });
+			x += 1.;
+		}
+	}
+
+	CorsairLedId gKey(int index)
+	{
+		// G1..G10 and G11..G18 are two separate runs of the enum.
+		return static_cast<CorsairLedId>(index < 10 ? CLK_G1 + index : CLK_G11 + index - 10);
+	}
+
+	void addKeyboard(VirtualDevice &device, bool withGKeys)
+	{
+		const auto mainX = withGKeys ? 3.5 : 0.;
+		const auto navX = mainX + 15.25;
+		const auto padX = mainX + 18.5;
+
+		if (withGKeys) {
+			addRow(device, 0., 0., { key(CLK_MR), key(CLK_M1), key(CLK_M2), gap(.5), key(CLK_M3) });
+			for (auto row = 0; row < 6; ++row) {
+				const auto y = row ? 1.5 + row : 1.25;
+				addRow(device, y, 0., { key(gKey(row * 3)), key(gKey(row * 3 + 1)), key(gKey(row * 3 + 2)) });
+			}
+		}
+		addRow(device, 0., mainX + 13., { key(CLK_Brightness), key(CLK_WinLock) });
+		addRow(device, 0., padX + 3., { key(CLK_Mute) });
+
+		auto x = mainX;
+		addRow(device, 1.25, x, { key(CLK_Escape), gap(1.) });
+		x += 2.;
+		addRange(device, 1.25, x, CLK_F1, CLK_F4);
+		x += .5;
+		addRange(device, 1.25, x, CLK_F5, CLK_F8);
+		x += .5;
+		addRange(device, 1.25, x, CLK_F9, CLK_F11);
+		addRow(device, 1.25, x, { key(CLK_F12) });
+		addRow(device, 1.25, navX, { key(CLK_PrintScreen), key(CLK_ScrollLock), key(CLK_PauseBreak) });
+		addRow(device, 1.25, padX, { key(CLK_Stop), key(CLK_ScanPreviousTrack), key(CLK_PlayPause), key(CLK_ScanNextTrack) });
+
+		x = mainX;
+		addRange(device, 2.5, x, CLK_GraveAccentAndTilde, CLK_MinusAndUnderscore);
+		addRow(device, 2.5, x, { key(CLK_EqualsAndPlus), key(CLK_Backspace, 2.) });
+		addRow(device, 2.5, navX, { key(CLK_Insert), key(CLK_Home), key(CLK_PageUp) });
+		addRow(device, 2.5, padX, { key(CLK_NumLock), key(CLK_KeypadSlash), key(CLK_KeypadAsterisk), key(CLK_KeypadMinus) });
+
+		x = mainX;
+		addRow(device, 3.5, x, { key(CLK_Tab, 1.5) });
+		x += 1.5;
+		addRange(device, 3.5, x, CLK_Q, CLK_BracketLeft);
+		addRow(device, 3.5, x, { key(CLK_BracketRight), key(CLK_Backslash, 1.5) });
+		addRow(device, 3.5, navX, { key(CLK_Delete), key(CLK_End), key(CLK_PageDown) });
+		addRow(device, 3.5, padX, { key(CLK_Keypad7), key(CLK_Keypad8), key(CLK_Keypad9), key(CLK_KeypadPlus, 1., 2.) });
+
+		x = mainX;
+		addRow(device, 4.5, x, { key(CLK_CapsLock, 1.75) });
+		x += 1.75;
+		addRange(device, 4.5, x, CLK_A, CLK_ApostropheAndDoubleQuote);
+		addRow(device, 4.5, x, { key(CLK_Enter, 2.25) });
+		addRow(device, 4.5, padX, { key(CLK_Keypad4), key(CLK_Keypad5), key(CLK_Keypad6) });
+
+		x = mainX;
+		addRow(device, 5.5, x, { key(CLK_LeftShift, 2.25) });
+		x += 2.25;
+		addRange(device, 5.5, x, CLK_Z, CLK_SlashAndQuestionMark);
+		addRow(device, 5.5, x, { key(CLK_RightShift, 2.75) });
+		addRow(device, 5.5, navX + 1., { key(CLK_UpArrow) });
+		addRow(device, 5.5, padX, { key(CLK_Keypad1), key(CLK_Keypad2), key(CLK_Keypad3), key(CLK_KeypadEnter, 1., 2.) });
+
+		addRow(device, 6.5, mainX, {
+			key(CLK_LeftCtrl, 1.25), key(CLK_LeftGui, 1.25), key(CLK_LeftAlt, 1.25), key(CLK_Space, 6.25),
+			key(CLK_RightAlt, 1.25), key(CLK_RightGui, 1.25), key(CLK_Application, 1.25), key(CLK_RightCtrl, 1.25) });
+		addRow(device, 6.5, navX, { key(CLK_LeftArrow), key(CLK_DownArrow), key(CLK_RightArrow) });
+		addRow(device, 6.5, padX, { key(CLK_Keypad0, 2.), key(CLK_KeypadPeriodAndDelete) });
+	}
+
+	void addMousemat(VirtualDevice &device)
+	{
+		// MM800 zones run clockwise around a 350 x 260 mm mat, starting at the top right corner.
+		const double width = 350., height = 260., zone = 20.;
+		for (auto i = 0; i < 5; ++i) {
+			device.positions.push_back(CorsairLedPosition{ static_cast<CorsairLedId>(CLMM_Zone1 + i), (height - zone) * i / 4, width - zone, zone, zone });
+		}
+		for (auto i = 0; i < 5; ++i) {
+			device.positions.push_back(CorsairLedPosition{ static_cast<CorsairLedId>(CLMM_Zone6 + i), height - zone, (width - zone) * (4 - i) / 4, zone, zone });
+		}
+		for (auto i = 0; i < 5; ++i) {
+			device.positions.push_back(CorsairLedPosition{ static_cast<CorsairLedId>(CLMM_Zone11 + i), (height - zone) * (4 - i) / 4, 0., zone, zone });
+		}
+	}
+
+	void addMouseZones(VirtualDevice &device, int zones)
+	{
+		device.info.physicalLayout = static_cast<CorsairPhysicalLayout>(CPL_Zones1 + zones - 1);
+		for (auto i = 0; i < zones; ++i) {
+			device.leds.push_back(static_cast<CorsairLedId>(CLM_1 + i));
+		}
+	}
+
+	struct KeyNameTable
+	{
+		CorsairLedId leds[256];
+	};
+
+	void mapKeys(KeyNameTable &table, const char *names, int firstLed)
+	{
+		for (auto i = 0; names[i]; ++i) {
+			const auto ledId = static_cast<CorsairLedId>(firstLed + i);
+			table.leds[static_cast<unsigned char>(names[i])] = ledId;
+			table.leds[static_cast<unsigned char>(std::toupper(names[i]))] = ledId;
+		}
+	}
+
+	void mapKey(KeyNameTable &table, const char *names, CorsairLedId ledId)
+	{
+		for (auto i = 0; names[i]; ++i) {
+			table.leds[static_cast<unsigned char>(names[i])] = ledId;
+		}
+	}
+
+	KeyNameTable makeKeyNameTable(CorsairLogicalLayout layout)
+	{
+		KeyNameTable table;
+		std::fill(std::begin(table.leds), std::end(table.leds), CLI_Invalid);
+
+		switch (layout) {
+		case CLL_FR:
+		case CLL_BE:
+			mapKeys(table, "azertyuiop", CLK_Q);
+			mapKeys(table, "qsdfghjklm", CLK_A);
+			mapKeys(table, "wxcvbn", CLK_Z);
+			mapKey(table, ",?", CLK_M);
+			mapKey(table, ";.", CLK_CommaAndLessThan);
+			mapKey(table, ":/", CLK_PeriodAndBiggerThan);
+			break;
+		case CLL_DE:
+		case CLL_CH:
+			mapKeys(table, "qwertzuiop", CLK_Q);
+			mapKeys(table, "asdfghjkl", CLK_A);
+			mapKeys(table, "yxcvbnm", CLK_Z);
+			mapKey(table, ",;", CLK_CommaAndLessThan);
+			mapKey(table, ".:", CLK_PeriodAndBiggerThan);
+			mapKey(table, "-_", CLK_SlashAndQuestionMark);
+			break;
+		default:
+			mapKeys(table, "qwertyuiop", CLK_Q);
+			mapKeys(table, "asdfghjkl", CLK_A);
+			mapKeys(table, "zxcvbnm", CLK_Z);
+			mapKey(table, "`~", CLK_GraveAccentAndTilde);
+			mapKey(table, "-_", CLK_MinusAndUnderscore);
+			mapKey(table, "=+", CLK_EqualsAndPlus);
+			mapKey(table, "[{", CLK_BracketLeft);
+			mapKey(table, "]}", CLK_BracketRight);
+			mapKey(table, "\\|", CLK_Backslash);
+			mapKey(table, ";:", CLK_SemicolonAndColon);
+			mapKey(table, "'\"", CLK_ApostropheAndDoubleQuote);
+			mapKey(table, ",<", CLK_CommaAndLessThan);
+			mapKey(table, ".>", CLK_PeriodAndBiggerThan);
+			mapKey(table, "/?", CLK_SlashAndQuestionMark);
+			mapKey(table, "!", CLK_1);
+			mapKey(table, "@", CLK_2);
+			mapKey(table, "#", CLK_3);
+			mapKey(table, "$", CLK_4);
+			mapKey(table, "%", CLK_5);
+			mapKey(table, "^", CLK_6);
+			mapKey(table, "&", CLK_7);
+			mapKey(table, "*", CLK_8);
+			mapKey(table, "(", CLK_9);
+			mapKey(table, ")", CLK_0);
+			break;
+		}
+		mapKeys(table, "123456789", CLK_1);
+		mapKey(table, "0", CLK_0);
+		mapKey(table, " ", CLK_Space);
+		mapKey(table, "\t", CLK_Tab);
+		mapKey(table, "\n\r", CLK_Enter);
+		return table;
+	}
+}
+
+std::unique_ptr<VirtualDevice> createVirtualDevice(CorsairStandInDeviceModel model)
+{
+	std::unique_ptr<VirtualDevice> device(new VirtualDevice);
+	device->model = model;
+	device->latencyUs = 0;
+	device->info.capsMask = CDC_Lighting;
+	device->info.physicalLayout = CPL_Invalid;
+	device->info.logicalLayout = CLL_Invalid;
+
+	switch (model) {
+	case CSIDM_K95RGB:
+	case CSIDM_K70RGB:
+		device->modelName = model == CSIDM_K95RGB ? "K95 RGB" : "K70 RGB";
+		device->info.type = CDT_Keyboard;
+		device->info.physicalLayout = CPL_US;
+		device->info.logicalLayout = CLL_US_Int;
+		addKeyboard(*device, model == CSIDM_K95RGB);
+		break;
+	case CSIDM_M65RGB:
+		device->modelName = "M65 RGB";
+		device->info.type = CDT_Mouse;
+		addMouseZones(*device, 1);
+		break;
+	case CSIDM_ScimitarRGB:
+		device->modelName = "Scimitar RGB";
+		device->info.type = CDT_Mouse;
+		addMouseZones(*device, 4);
+		break;
+	case CSIDM_VoidRGB:
+		device->modelName = "VOID RGB";
+		device->info.type = CDT_Headset;
+		device->leds.push_back(CLH_LeftLogo);
+		device->leds.push_back(CLH_RightLogo);
+		break;
+	case CSIDM_MM800RGB:
+		device->modelName = "MM800 RGB POLARIS";
+		device->info.type = CDT_MouseMat;
+		addMousemat(*device);
+		break;
+	}
+
+	for (const auto &position : device->positions) {
+		device->leds.push_back(position.ledId);
+	}
+	device->info.model = device->modelName.c_str();
+	device->info.ledsCount = static_cast<int>(device->leds.size());
+	device->ledPositions.numberOfLed = static_cast<int>(device->positions.size());
+	device->ledPositions.pLedPosition = device->positions.empty() ? nullptr : device->positions.data();
+	return device;
+}
+
+bool parseDeviceModel(const std::string &name, CorsairStandInDeviceModel &model)
+{
+	static const struct { const char *name; CorsairStandInDeviceModel model; } models[] = {
+		{ "k95", CSIDM_K95RGB },
+		{ "k70", CSIDM_K70RGB },
+		{ "m65", CSIDM_M65RGB },
+		{ "scimitar", CSIDM_ScimitarRGB },
+		{ "void", CSIDM_VoidRGB },
+		{ "mm800", CSIDM_MM800RGB },
+	};
+	for (const auto &entry : models) {
+		if (name == entry.name) {
+			model = entry.model;
+			return true;
+		}
+	}
+	return false;
+}
+
+CorsairLedId ledIdForKeyName(CorsairLogicalLayout layout, char keyName)
+{
+	static const KeyNameTable us = makeKeyNameTable(CLL_US_Int);
+	static const KeyNameTable de = makeKeyNameTable(CLL_DE);
+	static const KeyNameTable fr = makeKeyNameTable(CLL_FR);
+
+	const auto index = static_cast<unsigned char>(keyName);
+	switch (layout) {
+	case CLL_DE:
+	case CLL_CH:
+		return de.leds[index];
+	case CLL_FR:
+	case CLL_BE:
+		return fr.leds[index];
+	default:
+		return us.leds[index];
+	}
+}
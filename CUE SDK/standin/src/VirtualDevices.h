@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CUESDKStandIn.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Describes one device simulated by the stand-in together with the structures handed out by the SDK calls.
+struct VirtualDevice
+{
+	CorsairStandInDeviceModel model;
+	std::string modelName;
+	CorsairDeviceInfo info;                      /**< info.model points into modelName */
+	std::vector<CorsairLedPosition> positions;
+	CorsairLedPositions ledPositions;            /**< Points into positions */
+	std::vector<CorsairLedId> leds;              /**< Every LED of the device, including the ones without a position */
+	int latencyUs;                               /**< Extra latency of calls setting LEDs of the device */
+	std::chrono::steady_clock::time_point idleAt; /**< When the device is done with the asynchronous calls queued so far */
+};
+
+/// Creates a device with the layout and LED positions of specified model.
+std::unique_ptr<VirtualDevice> createVirtualDevice(CorsairStandInDeviceModel model);
+
+/// Parses a model name as used by CUESDK_STANDIN_DEVICES ("k95", "mm800", ...). Returns false for unknown names.
+bool parseDeviceModel(const std::string &name, CorsairStandInDeviceModel &model);
+
+/// Resolves key name to LED the same way CUE does for specified logical layout.
+CorsairLedId ledIdForKeyName(CorsairLogicalLayout layout, char keyName);
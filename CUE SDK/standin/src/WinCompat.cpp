@@ -0,0 +1,19 @@
+#ifndef _WIN32
+
+#include "windows.h"
+#include "StandInServer.h"
+
+#include <chrono>
+#include <thread>
+
+short GetAsyncKeyState(int vKey)
+{
+	return StandInServer::instance().keyState(vKey);
+}
+
+void Sleep(unsigned long milliseconds)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+#endif
@@ -0,0 +1,172 @@
+#include "BenchHarness.h"
+
+#include "Beatmap.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+namespace
+{
+	const int cMarathonObjects = 12000;
+
+	bool hasOsuExtension(const std::string &name)
+	{
+		return name.size() > 4 && name.compare(name.size() - 4, 4, ".osu") == 0;
+	}
+
+	/// Collects .osu files below directory, e.g. every beatmap set of a Songs directory.
+	void findBeatmaps(const std::string &directory, std::vector<std::string> &paths)
+	{
+#ifdef _WIN32
+		WIN32_FIND_DATAA entry;
+		const auto handle = FindFirstFileA((directory + "\\*").c_str(), &entry);
+		if (handle == INVALID_HANDLE_VALUE) {
+			return;
+		}
+		do {
+			const std::string name = entry.cFileName;
+			if (name == "." || name == "..") {
+				continue;
+			}
+			if (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+				findBeatmaps(directory + "\\" + name, paths);
+			} else if (hasOsuExtension(name)) {
+				paths.push_back(directory + "\\" + name);
+			}
+		} while (FindNextFileA(handle, &entry));
+		FindClose(handle);
+#else
+		const auto dir = opendir(directory.c_str());
+		if (!dir) {
+			return;
+		}
+		while (const auto entry = readdir(dir)) {
+			const std::string name = entry->d_name;
+			if (name == "." || name == "..") {
+				continue;
+			}
+			const auto path = directory + "/" + name;
+			if (hasOsuExtension(name)) {
+				paths.push_back(path);
+			} else if (auto child = opendir(path.c_str())) {
+				closedir(child);
+				findBeatmaps(path, paths);
+			}
+		}
+		closedir(dir);
+#endif
+	}
+
+	/// Contents of every beatmap of the corpus, read once so the benchmark measures parsing only.
+	const std::vector<std::string>& corpus()
+	{
+		static std::vector<std::string> texts;
+		if (texts.empty()) {
+			const auto override = std::getenv("CORSAIR_BENCH_BEATMAPS");
+			const std::string directory = override ? override : CORSAIR_FIXTURE_DIR "/beatmaps";
+			std::vector<std::string> paths;
+			findBeatmaps(directory, paths);
+			for (const auto &path : paths) {
+				std::ifstream file(path, std::ios::binary);
+				texts.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			}
+			std::cout << "beatmap corpus: " << texts.size() << " files from " << directory << std::endl;
+		}
+		return texts;
+	}
+}
+
+std::string marathonBeatmap()
+{
+	std::ostringstream text;
+	text << "osu file format v14\r\n\r\n[General]\r\nAudioFilename: audio.mp3\r\nMode: 0\r\n\r\n"
+		<< "[Difficulty]\r\nSliderMultiplier:1.8\r\n\r\n[TimingPoints]\r\n";
+	for (auto section = 0; section < 40; ++section) {
+		const auto time = section * 30000;
+		text << time << ',' << (section % 2 ? 300 : 333.333) << ",4,2,1,60,1," << (section % 4 == 3) << "\r\n";
+		text << time + 15000 << ",-" << 50 + section << ",4,2,1,60,0,0\r\n";
+	}
+	text << "\r\n[HitObjects]\r\n";
+	for (auto i = 0; i < cMarathonObjects; ++i) {
+		const auto time = 1000 + i * 100;
+		if (i % 5 == 4) {
+			text << (i * 37) % 512 << ',' << (i * 91) % 384 << ',' << time << ",2,0,B|" << (i * 13) % 512 << ':' << (i * 7) % 384
+				<< "|300:200,1," << 70 + i % 90 << ",0|0,0:0|0:0,0:0:0:0:\r\n";
+		} else {
+			text << (i * 37) % 512 << ',' << (i * 91) % 384 << ',' << time << ',' << (i % 8 ? 1 : 5) << ",0,0:0:0:0:\r\n";
+		}
+	}
+	return text.str();
+}
+
+void registerBeatmapBenchmarks(BenchRegistry &registry)
+{
+	registry.add("beatmap/parse_corpus", [](int64_t iterations) -> int64_t {
+		const auto &texts = corpus();
+		Beatmap beatmap;
+		int64_t parsed = 0;
+		for (int64_t i = 0; i < iterations; ++i) {
+			for (const auto &text : texts) {
+				beatmap.parse(text.data(), text.size());
+				doNotOptimize(beatmap.objectCount());
+				parsed++;
+			}
+		}
+		return parsed;
+	});
+
+	registry.add("beatmap/parse_marathon_12k", [](int64_t iterations) -> int64_t {
+		const auto text = marathonBeatmap();
+		Beatmap beatmap;
+		for (int64_t i = 0; i < iterations; ++i) {
+			beatmap.parse(text.data(), text.size());
+			doNotOptimize(beatmap.objectCount());
+		}
+		return iterations;
+	});
+
+	// One operation is one 240 Hz frame of playback through the whole marathon.
+	registry.add("beatmap/cursor_advance_240hz", [](int64_t iterations) -> int64_t {
+		const auto text = marathonBeatmap();
+		Beatmap beatmap;
+		beatmap.parse(text.data(), text.size());
+		const auto length = beatmap.maxEndTimes()[beatmap.objectCount() - 1];
+		BeatmapCursor cursor(beatmap);
+		auto time = 0.;
+		for (int64_t i = 0; i < iterations; ++i) {
+			time += 1000. / 240;
+			if (time > length) {
+				time = 0.;
+			}
+			cursor.advance(static_cast<int>(time));
+			auto active = 0;
+			cursor.forEachActive([&](int) { active++; });
+			doNotOptimize(active);
+		}
+		return iterations;
+	});
+
+	registry.add("beatmap/cursor_seek", [](int64_t iterations) -> int64_t {
+		const auto text = marathonBeatmap();
+		Beatmap beatmap;
+		beatmap.parse(text.data(), text.size());
+		const auto length = beatmap.maxEndTimes()[beatmap.objectCount() - 1];
+		BeatmapCursor cursor(beatmap);
+		for (int64_t i = 0; i < iterations; ++i) {
+			cursor.seek(static_cast<int>((i * 7919) % length));
+			doNotOptimize(cursor.nextObject());
+		}
+		return iterations;
+	});
+}
@@ -0,0 +1,55 @@
+#include "BenchHarness.h"
+
+#include <algorithm>
+#include <cstdio>
+
+void BenchRegistry::add(const std::string &name, Body body)
+{
+	mBenchmarks.push_back(Benchmark{ name, std::move(body) });
+}
+
+void BenchRegistry::list() const
+{
+	for (const auto &benchmark : mBenchmarks) {
+		std::printf("%s\n", benchmark.name.c_str());
+	}
+}
+
+int BenchRegistry::run(const std::string &filter, std::chrono::duration<double> minTime) const
+{
+	using Clock = std::chrono::steady_clock;
+
+	auto count = 0;
+	std::printf("%-48s %14s %14s\n", "benchmark", "operations", "ns/op");
+	for (const auto &benchmark : mBenchmarks) {
+		if (benchmark.name.find(filter) == std::string::npos) {
+			continue;
+		}
+
+		// Grow the iteration count until a run takes a tenth of the budget, then scale up to the full budget.
+		int64_t iterations = 1;
+		std::chrono::duration<double> elapsed(0);
+		int64_t operations = 0;
+		while (true) {
+			const auto start = Clock::now();
+			operations = benchmark.body(iterations);
+			elapsed = Clock::now() - start;
+			if (elapsed >= minTime / 10 || iterations >= (int64_t(1) << 40)) {
+				break;
+			}
+			iterations *= elapsed.count() > 0. ? std::max<int64_t>(2, static_cast<int64_t>(minTime.count() / 10 / elapsed.count())) : 10;
+		}
+		if (elapsed < minTime) {
+			iterations = std::max<int64_t>(iterations, static_cast<int64_t>(iterations * minTime.count() / std::max(elapsed.count(), 1e-9)));
+			const auto start = Clock::now();
+			operations = benchmark.body(iterations);
+			elapsed = Clock::now() - start;
+		}
+
+		const auto nsPerOp = operations > 0 ? elapsed.count() * 1e9 / operations : 0.;
+		std::printf("%-48s %14lld %14.1f\n", benchmark.name.c_str(), static_cast<long long>(operations), nsPerOp);
+		std::fflush(stdout);
+		count++;
+	}
+	return count;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// Keeps the compiler from optimizing away a value computed by a benchmark body.
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const T *sink;
+	sink = &value;
+#endif
+}
+
+/**
+ * @brief Collects named benchmarks and runs the ones matching a filter.
+ *
+ * A benchmark body gets the number of iterations to run and returns the number of
+ * operations it performed, which is used to report the time per operation.
+ */
+class BenchRegistry
+{
+public:
+	using Body = std::function<int64_t(int64_t iterations)>;
+
+	void add(const std::string &name, Body body);
+
+	/// Prints names of every registered benchmark.
+	void list() const;
+
+	/**
+	 * @brief Runs every benchmark whose name contains filter.
+	 * @param minTime Time every benchmark is run for after calibration.
+	 * @return Number of benchmarks run.
+	 */
+	int run(const std::string &filter, std::chrono::duration<double> minTime) const;
+
+private:
+	struct Benchmark
+	{
+		std::string name;
+		Body body;
+	};
+
+	std::vector<Benchmark> mBenchmarks;
+};
+
+/// Performs the protocol handshake once per process. Returns false (and reports why) if it failed.
+bool connectSdk();
+
+/// .osu text of a marathon: 12k circles and sliders over a few BPM and velocity changes.
+std::string marathonBeatmap();
+
+/// Benchmarks of the raw SDK calls (handshake, device enumeration, frame submission).
+void registerSdkBenchmarks(BenchRegistry &registry);
+
+/// Benchmarks of frame allocation for custom effects (FramePool against plain heap frames).
+void registerFrameBenchmarks(BenchRegistry &registry);
+
+/// Benchmarks of building frames with Framebuffer against per-frame CorsairLedColor vectors.
+void registerFramebufferBenchmarks(BenchRegistry &registry);
+
+/// Compositing 1 to 64 layers with the scalar kernels against the SSE2 and AVX2 ones.
+void registerCompositorBenchmarks(BenchRegistry &registry);
+
+/// Coloring a ripple through a ColorChart: search and interpolation per key against its baked LUT, scalar and AVX2.
+void registerColorChartBenchmarks(BenchRegistry &registry);
+
+/// The ramps of a gradient effect shaped with pow for every key against the tables baked by GradientEffect.
+void registerGradientBenchmarks(BenchRegistry &registry);
+
+/// Pulse and heartbeat intensities computed with pow and sin against the easing tables.
+void registerEasingBenchmarks(BenchRegistry &registry);
+
+/// Spiral rainbow over keyboard and mousemat: atan2 and floating point hues per LED against RainbowEffect.
+void registerRainbowBenchmarks(BenchRegistry &registry);
+
+/// Per-frame polar geometry: rescanning CorsairLedPositions against the LedGeometry cache.
+void registerGeometryBenchmarks(BenchRegistry &registry);
+
+/// Parsing a corpus of .osu files (CORSAIR_BENCH_BEATMAPS, the test fixtures by default) and seeking through a map.
+void registerBeatmapBenchmarks(BenchRegistry &registry);
+
+/// Starting a map from a mapped lighting timeline against parsing and compiling it, and per-frame playback.
+void registerTimelineBenchmarks(BenchRegistry &registry);
+
+/// Decoding an .osr replay and driving key splashes with its 300 BPM stream, headless.
+void registerReplayBenchmarks(BenchRegistry &registry);
+
+/// Rendering the marathon offline into a frame trace, on one thread against every hardware thread.
+void registerOfflineBenchmarks(BenchRegistry &registry);
+
+/// Recording frames to a compact frame trace and decoding them from a mapped one.
+void registerTraceBenchmarks(BenchRegistry &registry);
+
+/// Resuming after CUE restarted: enumerating the devices again against revalidating the enumerated ones, both replaying a frame.
+void registerConnectionBenchmarks(BenchRegistry &registry);
+
+/// Time to first frame with devices enumerated at launch against devices mapped from the cache while connecting.
+void registerStartupBenchmarks(BenchRegistry &registry);
+
+/// Characters to LEDs through CorsairGetLedIdForKeyName against the per-layout KeyLayoutTable, and building the table.
+void registerKeyLayoutBenchmarks(BenchRegistry &registry);
+
+/// Cost of the trace markers: a scope, an instant event and a frame's worth of them.
+void registerProfilerBenchmarks(BenchRegistry &registry);
+
+/// Updating a metric from the render thread and writing the registry out for a scrape.
+void registerMetricsBenchmarks(BenchRegistry &registry);
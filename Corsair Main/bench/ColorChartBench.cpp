@@ -0,0 +1,108 @@
+#include "BenchHarness.h"
+
+#include "CUESDK.h"
+#include "ColorChart.h"
+#include "Framebuffer.h"
+#include "LedGeometry.h"
+
+#include <vector>
+
+namespace
+{
+	/// Five point chart, as a CUE gradient effect would have it, over the ripple phase of every key.
+	struct RippleSetup
+	{
+		LedGeometry geometry;
+		ColorChart chart;
+		std::vector<float> phases;
+
+		explicit RippleSetup(int lutSize = ColorChart::cDefaultLutSize, Compositor::Isa isa = Compositor::bestIsa())
+			: chart(lutSize, isa)
+		{
+			chart.addPoint(0., CorsairColor{ 255, 255, 255 });
+			chart.addPoint(.2, CorsairColor{ 255, 0, 64 });
+			chart.addPoint(.45, CorsairColor{ 0, 128, 255 });
+			chart.addPoint(.7, CorsairColor{ 0, 255, 0 });
+			chart.addPoint(1., CorsairColor{ 0, 0, 0 });
+		}
+
+		bool load()
+		{
+			if (!connectSdk() || !geometry.loadFromSdk()) {
+				return false;
+			}
+			const auto origin = geometry.addOrigin(.5f, .5f);
+			const auto distances = geometry.distances(origin);
+			const auto maxDistance = geometry.maxDistance(origin);
+			for (auto led = 0; led < geometry.count(); ++led) {
+				phases.push_back(distances[led] / maxDistance);
+			}
+			return true;
+		}
+
+		/// Moves the ripple outwards by a step, wrapping around.
+		void advance()
+		{
+			for (auto &phase : phases) {
+				phase += 1.f / 64;
+				phase = phase < 1.f ? phase : phase - 1.f;
+			}
+		}
+	};
+
+	void addLutBenchmark(BenchRegistry &registry, const char *name, int lutSize, Compositor::Isa isa)
+	{
+		if (!Compositor::isSupported(isa)) {
+			return;
+		}
+		registry.add(name, [lutSize, isa](int64_t iterations) -> int64_t {
+			RippleSetup setup(lutSize, isa);
+			if (!setup.load()) {
+				return 0;
+			}
+			Framebuffer frame;
+			for (int64_t i = 0; i < iterations; ++i) {
+				setup.advance();
+				setup.chart.lut()->apply(setup.phases.data(), setup.geometry.ledIds(), setup.geometry.count(), frame);
+				doNotOptimize(frame.red());
+			}
+			return iterations;
+		});
+	}
+}
+
+void registerColorChartBenchmarks(BenchRegistry &registry)
+{
+	// Searching the points and interpolating for every key, every frame.
+	registry.add("chart/ripple_search_lerp", [](int64_t iterations) -> int64_t {
+		RippleSetup setup;
+		if (!setup.load()) {
+			return 0;
+		}
+		Framebuffer frame;
+		for (int64_t i = 0; i < iterations; ++i) {
+			setup.advance();
+			for (auto led = 0; led < setup.geometry.count(); ++led) {
+				const auto color = setup.chart.evaluate(setup.phases[led]);
+				frame.set(setup.geometry.ledIds()[led], color.r, color.g, color.b);
+			}
+			doNotOptimize(frame.red());
+		}
+		return iterations;
+	});
+
+	addLutBenchmark(registry, "chart/ripple_lut256_scalar", ColorChart::cDefaultLutSize, Compositor::Isa::Scalar);
+	addLutBenchmark(registry, "chart/ripple_lut256_avx2", ColorChart::cDefaultLutSize, Compositor::Isa::Avx2);
+	addLutBenchmark(registry, "chart/ripple_lut1024_avx2", ColorChart::cLargeLutSize, Compositor::Isa::Avx2);
+
+	// Baking after every edit, the cost an animated chart pays per change.
+	registry.add("chart/bake_lut1024", [](int64_t iterations) -> int64_t {
+		RippleSetup setup(ColorChart::cLargeLutSize);
+		for (int64_t i = 0; i < iterations; ++i) {
+			setup.chart.addPoint(.5, CorsairColor{ static_cast<int>(i & 255), 0, 0 });
+			doNotOptimize(setup.chart.lut()->entries());
+			setup.chart.clear();
+		}
+		return iterations;
+	});
+}
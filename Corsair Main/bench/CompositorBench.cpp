@@ -0,0 +1,56 @@
+#include "BenchHarness.h"
+
+#include "Compositor.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const int cKeyboardLeds = 144;
+	const int cLayerCounts[] = { 1, 4, 16, 64 };
+	const BlendMode cModes[] = { BlendMode::Over, BlendMode::Alpha, BlendMode::Additive, BlendMode::Multiply, BlendMode::Max };
+
+	/// Keyboard sized layers cycling through every blend mode, every other one translucent.
+	struct LayerStack
+	{
+		explicit LayerStack(int count)
+			: frames(new Framebuffer[count])
+		{
+			for (auto i = 0; i < count; ++i) {
+				for (auto led = 1; led <= cKeyboardLeds; ++led) {
+					const auto value = static_cast<uint8_t>(led * 7 + i * 31);
+					frames[i].set(static_cast<CorsairLedId>(led), value, static_cast<uint8_t>(255 - value), static_cast<uint8_t>(i * 13), value);
+				}
+				layers.push_back(CompositeLayer{ &frames[i], cModes[i % 5], static_cast<uint8_t>(i % 2 ? 160 : 255) });
+			}
+		}
+
+		std::unique_ptr<Framebuffer[]> frames;
+		std::vector<CompositeLayer> layers;
+	};
+}
+
+void registerCompositorBenchmarks(BenchRegistry &registry)
+{
+	const Compositor::Isa isas[] = { Compositor::Isa::Scalar, Compositor::Isa::Sse2, Compositor::Isa::Avx2 };
+	for (auto isa : isas) {
+		if (!Compositor::isSupported(isa)) {
+			continue;
+		}
+		for (auto count : cLayerCounts) {
+			const auto name = std::string("compositor/") + Compositor::isaName(isa) + "/layers_" + std::to_string(count);
+			registry.add(name, [isa, count](int64_t iterations) -> int64_t {
+				const Compositor compositor(isa);
+				const std::unique_ptr<LayerStack> stack(new LayerStack(count));
+				Framebuffer target;
+				for (int64_t i = 0; i < iterations; ++i) {
+					compositor.composite(target, stack->layers.data(), count);
+					doNotOptimize(target.red());
+				}
+				return iterations;
+			});
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#include "BenchHarness.h"
+
+#include "CUESDK.h"
+#include "DeviceManager.h"
+
+#include <chrono>
+
+namespace
+{
+	/// What every resume starts with: a new session and exclusive control.
+	bool resumeSession()
+	{
+		CorsairPerformProtocolHandshake();
+		return !CorsairGetLastError() && CorsairRequestControl(CAM_ExclusiveLightingControl);
+	}
+}
+
+void registerConnectionBenchmarks(BenchRegistry &registry)
+{
+	registry.add("connection/cold_resume", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		DeviceManager devices;
+		for (int64_t i = 0; i < iterations; ++i) {
+			if (!resumeSession() || !devices.enumerate()) {
+				return 0;
+			}
+			devices.submitAsync();
+			devices.waitIdle(std::chrono::seconds(1));
+		}
+		return iterations;
+	});
+
+	registry.add("connection/warm_resume", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		DeviceManager devices;
+		if (!devices.enumerate()) {
+			return 0;
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			if (!resumeSession() || (!devices.revalidate() && !devices.enumerate())) {
+				return 0;
+			}
+			devices.invalidate();
+			devices.submitAsync();
+			devices.waitIdle(std::chrono::seconds(1));
+		}
+		return iterations;
+	});
+}
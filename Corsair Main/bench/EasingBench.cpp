@@ -0,0 +1,67 @@
+#include "BenchHarness.h"
+
+#include "Easing.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const double cPi = 3.14159265358979323846;
+
+	double bump(int time, int start, int length)
+	{
+		if (time < start || time >= start + length) {
+			return 0.;
+		}
+		const auto s = std::sin(cPi * (time - start) / length);
+		return s * s;
+	}
+}
+
+void registerEasingBenchmarks(BenchRegistry &registry)
+{
+	// The idle pulse of the app at 240 Hz frame offsets, as it was computed before the tables.
+	registry.add("easing/pulse_pow", [](int64_t iterations) -> int64_t {
+		const auto pulseDuration = 1000;
+		for (int64_t i = 0; i < iterations; ++i) {
+			const auto offset = static_cast<int>(i * 1000 / 240);
+			const auto x = static_cast<double>(offset % (2 * pulseDuration)) / pulseDuration;
+			doNotOptimize(static_cast<uint8_t>((1 - std::pow(x - 1, 2)) * 255));
+		}
+		return iterations;
+	});
+
+	registry.add("easing/pulse_table", [](int64_t iterations) -> int64_t {
+		PhaseAccumulator pulse(2000);
+		auto lastOffset = 0;
+		for (int64_t i = 0; i < iterations; ++i) {
+			const auto offset = static_cast<int>(i * 1000 / 240);
+			pulse.advance(offset - lastOffset);
+			lastOffset = offset;
+			doNotOptimize(Easing::level(EasingCurve::Quad, pulse.phase()));
+		}
+		return iterations;
+	});
+
+	// The heartbeat envelope of the CUELFX stand-in against its table.
+	registry.add("easing/heartbeat_sin", [](int64_t iterations) -> int64_t {
+		for (int64_t i = 0; i < iterations; ++i) {
+			const auto time = static_cast<int>(i * 1000 / 240 % 1000);
+			doNotOptimize(static_cast<uint8_t>(std::max(bump(time, 0, 150), .6 * bump(time, 250, 150)) * 255 + .5));
+		}
+		return iterations;
+	});
+
+	registry.add("easing/heartbeat_table", [](int64_t iterations) -> int64_t {
+		PhaseAccumulator beat(1000);
+		auto lastOffset = 0;
+		for (int64_t i = 0; i < iterations; ++i) {
+			const auto offset = static_cast<int>(i * 1000 / 240);
+			beat.advance(offset - lastOffset);
+			lastOffset = offset;
+			doNotOptimize(Easing::level(EasingCurve::Heartbeat, beat.phase()));
+		}
+		return iterations;
+	});
+}
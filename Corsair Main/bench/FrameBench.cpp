@@ -0,0 +1,46 @@
+#include "BenchHarness.h"
+
+#include "FramePool.h"
+
+namespace
+{
+	const int cKeyboardLeds = 144;
+
+	CorsairFrame* allocateFrame(int size)
+	{
+		auto frame = new CorsairFrame;
+		frame->size = size;
+		frame->ledsColors = new CorsairLedColor[size];
+		return frame;
+	}
+
+	void freeFrame(CorsairFrame *frame)
+	{
+		delete[] frame->ledsColors;
+		delete frame;
+	}
+}
+
+void registerFrameBenchmarks(BenchRegistry &registry)
+{
+	registry.add("frame/heap_allocate_free", [](int64_t iterations) -> int64_t {
+		for (int64_t i = 0; i < iterations; ++i) {
+			auto frame = allocateFrame(cKeyboardLeds);
+			frame->ledsColors[0].r = static_cast<int>(i);
+			doNotOptimize(frame);
+			freeFrame(frame);
+		}
+		return iterations;
+	});
+
+	registry.add("frame/pool_acquire_release", [](int64_t iterations) -> int64_t {
+		FramePool pool(4, cKeyboardLeds);
+		for (int64_t i = 0; i < iterations; ++i) {
+			auto frame = pool.acquire(cKeyboardLeds);
+			frame->ledsColors[0].r = static_cast<int>(i);
+			doNotOptimize(frame);
+			FramePool::release(frame);
+		}
+		return iterations;
+	});
+}
@@ -0,0 +1,40 @@
+#include "BenchHarness.h"
+
+#include "Framebuffer.h"
+
+#include <vector>
+
+namespace
+{
+	const int cKeyboardLeds = 144;
+}
+
+void registerFramebufferBenchmarks(BenchRegistry &registry)
+{
+	// What the examples used to do: build a fresh CorsairLedColor vector for every frame.
+	registry.add("framebuffer/vector_rebuild", [](int64_t iterations) -> int64_t {
+		for (int64_t i = 0; i < iterations; ++i) {
+			std::vector<CorsairLedColor> frame;
+			for (auto led = 1; led <= cKeyboardLeds; ++led) {
+				frame.push_back(CorsairLedColor{ static_cast<CorsairLedId>(led), static_cast<int>(i & 0xff), 0, 0 });
+			}
+			doNotOptimize(frame.data());
+		}
+		return iterations;
+	});
+
+	registry.add("framebuffer/fill_and_stage", [](int64_t iterations) -> int64_t {
+		Framebuffer frame;
+		for (auto led = 1; led <= cKeyboardLeds; ++led) {
+			frame.activate(static_cast<CorsairLedId>(led));
+		}
+		std::vector<CorsairLedColor> staging;
+		staging.reserve(Framebuffer::cCapacity);
+		for (int64_t i = 0; i < iterations; ++i) {
+			frame.fill(static_cast<uint8_t>(i), 0, 0);
+			frame.stage(staging);
+			doNotOptimize(staging.data());
+		}
+		return iterations;
+	});
+}
@@ -0,0 +1,55 @@
+#include "BenchHarness.h"
+
+#include "CUESDK.h"
+#include "LedGeometry.h"
+
+#include <cmath>
+
+void registerGeometryBenchmarks(BenchRegistry &registry)
+{
+	// Distance and angle of every key from the keyboard center, the inner loop of a radial effect.
+	registry.add("geometry/rescan_positions_polar", [](int64_t iterations) -> int64_t {
+		const auto positions = connectSdk() ? CorsairGetLedPositions() : nullptr;
+		if (!positions) {
+			return 0;
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			auto minX = positions->pLedPosition[0].left, maxX = minX + positions->pLedPosition[0].width;
+			auto minY = positions->pLedPosition[0].top, maxY = minY + positions->pLedPosition[0].height;
+			for (auto led = 0; led < positions->numberOfLed; ++led) {
+				const auto position = positions->pLedPosition[led];
+				minX = std::fmin(minX, position.left);
+				maxX = std::fmax(maxX, position.left + position.width);
+				minY = std::fmin(minY, position.top);
+				maxY = std::fmax(maxY, position.top + position.height);
+			}
+			auto sum = 0.;
+			for (auto led = 0; led < positions->numberOfLed; ++led) {
+				const auto position = positions->pLedPosition[led];
+				const auto dx = position.left + position.width / 2 - (minX + maxX) / 2;
+				const auto dy = position.top + position.height / 2 - (minY + maxY) / 2;
+				sum += std::sqrt(dx * dx + dy * dy) + std::atan2(dy, dx);
+			}
+			doNotOptimize(sum);
+		}
+		return iterations;
+	});
+
+	registry.add("geometry/cached_polar", [](int64_t iterations) -> int64_t {
+		LedGeometry geometry;
+		if (!connectSdk() || !geometry.loadFromSdk()) {
+			return 0;
+		}
+		const auto origin = geometry.addOrigin(.5f, .5f);
+		const auto distances = geometry.distances(origin);
+		const auto angles = geometry.angles(origin);
+		for (int64_t i = 0; i < iterations; ++i) {
+			auto sum = 0.f;
+			for (auto led = 0; led < geometry.count(); ++led) {
+				sum += distances[led] + angles[led];
+			}
+			doNotOptimize(sum);
+		}
+		return iterations;
+	});
+}
@@ -0,0 +1,81 @@
+#include "BenchHarness.h"
+
+#include "CUESDK.h"
+#include "Framebuffer.h"
+#include "GradientEffect.h"
+#include "LedGeometry.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	struct NaiveRamp
+	{
+		int duration;
+		CorsairColor endColor;
+		double power;
+	};
+
+	/// The four ramps of the corsair_layers_all_effects example, 8.5 s in total.
+	const NaiveRamp cExampleRamps[] = {
+		{ 2500, { 255, 255, 255 }, 3. },
+		{ 2000, { 125, 125, 0 }, .2 },
+		{ 1000, { 0, 0, 0 }, -1. },
+		{ 3000, { 0, 0, 255 }, 1. }
+	};
+
+	/// 60 Hz frame offsets through the example, wrapping around.
+	int frameOffset(int64_t frame)
+	{
+		return static_cast<int>(frame * 1000 / 60 % 8500);
+	}
+}
+
+void registerGradientBenchmarks(BenchRegistry &registry)
+{
+	// Walking the ramps and shaping t with pow for every key, as an effect written after the SDK would.
+	registry.add("gradient/example_naive_pow", [](int64_t iterations) -> int64_t {
+		LedGeometry geometry;
+		if (!connectSdk() || !geometry.loadFromSdk()) {
+			return 0;
+		}
+		Framebuffer frame;
+		for (int64_t i = 0; i < iterations; ++i) {
+			const auto offset = frameOffset(i);
+			for (auto led = 0; led < geometry.count(); ++led) {
+				auto from = CorsairColor{ 0, 0, 0 };
+				auto rampOffset = offset;
+				for (const auto &ramp : cExampleRamps) {
+					if (rampOffset < ramp.duration) {
+						const auto t = GradientEffect::shape(static_cast<double>(rampOffset) / ramp.duration, ramp.power);
+						frame.set(geometry.ledIds()[led], static_cast<uint8_t>(from.r + (ramp.endColor.r - from.r) * t + .5),
+							static_cast<uint8_t>(from.g + (ramp.endColor.g - from.g) * t + .5), static_cast<uint8_t>(from.b + (ramp.endColor.b - from.b) * t + .5));
+						break;
+					}
+					rampOffset -= ramp.duration;
+					from = ramp.endColor;
+				}
+			}
+			doNotOptimize(frame.red());
+		}
+		return iterations;
+	});
+
+	registry.add("gradient/example_table", [](int64_t iterations) -> int64_t {
+		LedGeometry geometry;
+		if (!connectSdk() || !geometry.loadFromSdk()) {
+			return 0;
+		}
+		GradientEffect gradient(CorsairColor{ 0, 0, 0 });
+		for (const auto &ramp : cExampleRamps) {
+			gradient.addRamp(ramp.duration, ramp.endColor, ramp.power);
+		}
+		Framebuffer frame;
+		for (int64_t i = 0; i < iterations; ++i) {
+			gradient.render(frameOffset(i), geometry.ledIds(), geometry.count(), frame);
+			doNotOptimize(frame.red());
+		}
+		return iterations;
+	});
+}
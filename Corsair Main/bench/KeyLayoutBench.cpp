@@ -0,0 +1,55 @@
+#include "BenchHarness.h"
+
+#include "CUESDK.h"
+#include "KeyLayoutTable.h"
+
+namespace
+{
+	/// Text typed by the benchmarks: letters, digits, punctuation and a few characters no key types.
+	const char cText[] = "The quick brown fox jumps over the lazy dog 0123456789 ,.-;'[]/\\=` \t\xe4\xf6\xfc";
+	const int cTextLength = sizeof(cText) - 1;
+}
+
+void registerKeyLayoutBenchmarks(BenchRegistry &registry)
+{
+	registry.add("keys/sdk_led_id_for_key_name", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			for (auto c = 0; c < cTextLength; ++c) {
+				doNotOptimize(CorsairGetLedIdForKeyName(cText[c]));
+			}
+		}
+		return iterations * cTextLength;
+	});
+
+	registry.add("keys/table_led_of", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		KeyLayoutTable keys;
+		if (!keys.updateFromSdk()) {
+			return 0;
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			for (auto c = 0; c < cTextLength; ++c) {
+				doNotOptimize(keys.ledOf(cText[c]));
+			}
+		}
+		return iterations * cTextLength;
+	});
+
+	// What a layout change costs: every character resolved through the SDK once.
+	registry.add("keys/table_build", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			KeyLayoutTable keys;
+			keys.updateFromSdk();
+			doNotOptimize(keys.builds());
+		}
+		return iterations;
+	});
+}
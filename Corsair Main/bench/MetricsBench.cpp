@@ -0,0 +1,40 @@
+#include "BenchHarness.h"
+
+#include "Metrics.h"
+
+void registerMetricsBenchmarks(BenchRegistry &registry)
+{
+	registry.add("metrics/counter_add", [](int64_t iterations) -> int64_t {
+		MetricsRegistry metrics;
+		auto &counter = metrics.counter("bench_total", "Benchmark counter.");
+		for (int64_t i = 0; i < iterations; ++i) {
+			counter.add();
+		}
+		doNotOptimize(counter.value());
+		return iterations;
+	});
+
+	registry.add("metrics/histogram_record", [](int64_t iterations) -> int64_t {
+		MetricsRegistry metrics;
+		auto &histogram = metrics.histogram("bench_seconds", "Benchmark histogram.");
+		for (int64_t i = 0; i < iterations; ++i) {
+			histogram.record(i & 0xffff);
+		}
+		doNotOptimize(histogram.count());
+		return iterations;
+	});
+
+	// What a scrape costs the serving thread with the metrics of the app registered.
+	registry.add("metrics/prometheus_text", [](int64_t iterations) -> int64_t {
+		MetricsRegistry metrics;
+		FrameMetrics frameMetrics(metrics);
+		const char *effects[] = { "timeline", "idle_pulse", "key_splash", "composite" };
+		for (const auto effect : effects) {
+			frameMetrics.effect(effect).record(100);
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			doNotOptimize(metrics.prometheusText().size());
+		}
+		return iterations;
+	});
+}
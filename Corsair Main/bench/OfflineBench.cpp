@@ -0,0 +1,54 @@
+#include "BenchHarness.h"
+
+#include "Beatmap.h"
+#include "OfflineRenderer.h"
+
+#include <vector>
+
+namespace
+{
+	const uint8_t cHash[Md5::cDigestSize] = {};
+
+	/// Renders the marathon at 120 Hz with a hit every 75 ms on pool, in memory. One operation is one frame.
+	int64_t renderMarathon(int64_t iterations, int threads)
+	{
+		LedGeometry geometry;
+		if (!connectSdk() || !geometry.loadFromSdk()) {
+			return 0;
+		}
+		const auto text = marathonBeatmap();
+		Beatmap beatmap;
+		LightingTimeline timeline;
+		if (!beatmap.parse(text.data(), text.size()) || !timeline.compile(beatmap, cHash, LightingProfile())) {
+			return 0;
+		}
+		OfflineRenderer renderer(timeline, geometry);
+		std::vector<OfflineHit> hits;
+		for (auto time = 0; time < timeline.header().endTime; time += 75) {
+			hits.push_back(OfflineHit{ time, time % 2 ? CLK_X : CLK_Z });
+		}
+		renderer.setHits(hits);
+
+		ThreadPool pool(threads);
+		std::vector<std::vector<uint8_t>> chunks;
+		int64_t frames = 0;
+		while (frames < iterations) {
+			if (!renderer.render(120, pool, chunks)) {
+				return 0;
+			}
+			frames += renderer.stats().frames;
+		}
+		return frames;
+	}
+}
+
+void registerOfflineBenchmarks(BenchRegistry &registry)
+{
+	registry.add("offline/render_marathon_120hz_1_thread", [](int64_t iterations) -> int64_t {
+		return renderMarathon(iterations, 1);
+	});
+
+	registry.add("offline/render_marathon_120hz_all_threads", [](int64_t iterations) -> int64_t {
+		return renderMarathon(iterations, 0);
+	});
+}
@@ -0,0 +1,107 @@
+#include "BenchHarness.h"
+
+#include "CUESDK.h"
+#include "Framebuffer.h"
+#include "LedGeometry.h"
+#include "RainbowEffect.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	const double cPi = 3.14159265358979323846;
+
+	/// Keyboard and mousemat LEDs of the connected devices, the mousemat placed below the keyboard.
+	bool loadKeyboardAndMousemat(LedGeometry &geometry)
+	{
+		if (!connectSdk()) {
+			return false;
+		}
+		std::vector<CorsairLedPosition> positions;
+		auto below = 0.;
+		for (auto device = 0; device < CorsairGetDeviceCount(); ++device) {
+			const auto info = CorsairGetDeviceInfo(device);
+			const auto devicePositions = CorsairGetLedPositionsByDeviceIndex(device);
+			if (!info || !devicePositions || (info->type != CDT_Keyboard && info->type != CDT_MouseMat)) {
+				continue;
+			}
+			auto bottom = below;
+			for (auto led = 0; led < devicePositions->numberOfLed; ++led) {
+				auto position = devicePositions->pLedPosition[led];
+				position.top += below;
+				bottom = std::fmax(bottom, position.top + position.height);
+				positions.push_back(position);
+			}
+			below = bottom;
+		}
+		CorsairLedPositions ledPositions{ static_cast<int>(positions.size()), positions.data() };
+		return geometry.load(&ledPositions);
+	}
+
+	void addSpiralBenchmark(BenchRegistry &registry, const char *name, Compositor::Isa isa)
+	{
+		if (!Compositor::isSupported(isa)) {
+			return;
+		}
+		registry.add(name, [isa](int64_t iterations) -> int64_t {
+			LedGeometry geometry;
+			if (!loadKeyboardAndMousemat(geometry)) {
+				return 0;
+			}
+			const auto spiral = RainbowEffect::spiral(geometry, CLES_Medium, CLECD_Clockwise, isa);
+			Framebuffer frame;
+			for (int64_t i = 0; i < iterations; ++i) {
+				spiral.render(static_cast<int>(i * 1000 / 60), frame);
+				doNotOptimize(frame.red());
+			}
+			return iterations;
+		});
+	}
+}
+
+void registerRainbowBenchmarks(BenchRegistry &registry)
+{
+	// The spiral as the SDK effect draws it: an angle and a floating point hue conversion per LED per frame.
+	registry.add("rainbow/spiral_keyboard_mousemat_atan2", [](int64_t iterations) -> int64_t {
+		LedGeometry geometry;
+		if (!loadKeyboardAndMousemat(geometry)) {
+			return 0;
+		}
+		Framebuffer frame;
+		for (int64_t i = 0; i < iterations; ++i) {
+			const auto phase = -static_cast<double>(i * 1000 / 60) / RainbowEffect::cycleDuration(CLES_Medium);
+			for (auto led = 0; led < geometry.count(); ++led) {
+				auto hue = std::atan2(geometry.normalizedY()[led] - .5, geometry.normalizedX()[led] - .5) / (2 * cPi) + phase;
+				hue = (hue - std::floor(hue)) * 6.;
+				const auto sector = static_cast<int>(hue) % 6;
+				const auto rising = static_cast<uint8_t>((hue - std::floor(hue)) * 255. + .5);
+				const auto falling = static_cast<uint8_t>(255 - rising);
+				const uint8_t r[] = { 255, falling, 0, 0, rising, 255 };
+				const uint8_t g[] = { rising, 255, 255, falling, 0, 0 };
+				const uint8_t b[] = { 0, 0, rising, 255, 255, falling };
+				frame.set(geometry.ledIds()[led], r[sector], g[sector], b[sector]);
+			}
+			doNotOptimize(frame.red());
+		}
+		return iterations;
+	});
+
+	addSpiralBenchmark(registry, "rainbow/spiral_keyboard_mousemat_scalar", Compositor::Isa::Scalar);
+	addSpiralBenchmark(registry, "rainbow/spiral_keyboard_mousemat_avx2", Compositor::Isa::Avx2);
+
+	// The conversion alone over every LED id the SDK knows.
+	registry.add("rainbow/convert_all_leds", [](int64_t iterations) -> int64_t {
+		const HsvConverter converter;
+		std::vector<uint16_t> hues(CLI_Last);
+		std::vector<uint32_t> colors(CLI_Last);
+		for (int64_t i = 0; i < iterations; ++i) {
+			for (size_t led = 0; led < hues.size(); ++led) {
+				hues[led] = static_cast<uint16_t>(led * 397 + i * 64);
+			}
+			converter.convert(hues.data(), 255, 255, static_cast<int>(hues.size()), colors.data());
+			doNotOptimize(colors.data());
+		}
+		return iterations;
+	});
+}
@@ -0,0 +1,86 @@
+#include "BenchHarness.h"
+
+#include "Compositor.h"
+#include "KeySplash.h"
+#include "Replay.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+	const char cStreamReplay[] = CORSAIR_FIXTURE_DIR "/replays/stream.osr";
+
+	std::vector<uint8_t> readStreamReplay()
+	{
+		std::ifstream file(cStreamReplay, std::ios::binary);
+		std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if (bytes.empty()) {
+			std::cerr << "Cannot read " << cStreamReplay << std::endl;
+		}
+		return bytes;
+	}
+}
+
+void registerReplayBenchmarks(BenchRegistry &registry)
+{
+	// Header, LZMA and frame text of a 300 BPM stream replay.
+	registry.add("replay/decode_stream", [](int64_t iterations) -> int64_t {
+		const auto bytes = readStreamReplay();
+		Replay replay;
+		if (bytes.empty() || !replay.parse(bytes.data(), bytes.size())) {
+			return 0;
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			replay.parse(bytes.data(), bytes.size());
+			doNotOptimize(replay.frames().size());
+		}
+		return iterations;
+	});
+
+	// One operation is one 1 kHz frame of the stream's key events splashing over a base layer, without waiting.
+	registry.add("replay/splash_stream_1khz", [](int64_t iterations) -> int64_t {
+		const auto bytes = readStreamReplay();
+		Replay replay;
+		if (bytes.empty() || !replay.parse(bytes.data(), bytes.size())) {
+			return 0;
+		}
+		const InputThread::Clock::time_point start;
+		const auto events = replay.keyEvents(start);
+		const auto length = events.back().timestamp + std::chrono::seconds(1);
+
+		KeySplash splash;
+		Compositor compositor;
+		Framebuffer base;
+		base.fill(0, 0, 255);
+		for (auto led = static_cast<int>(CLK_Escape); led <= static_cast<int>(CLK_Fn); ++led) {
+			base.activate(static_cast<CorsairLedId>(led));
+		}
+		Framebuffer splashLayer;
+		Framebuffer composed;
+		size_t next = 0;
+		auto frameTime = start;
+		for (int64_t i = 0; i < iterations; ++i) {
+			frameTime += std::chrono::milliseconds(1);
+			if (frameTime > length) {
+				frameTime = start;
+				next = 0;
+			}
+			for (; next < events.size() && events[next].timestamp <= frameTime; ++next) {
+				if (events[next].pressed) {
+					splash.trigger(events[next].virtualKey == 'Z' ? CLK_Z : CLK_X, events[next].timestamp);
+				}
+			}
+			splash.render(splashLayer, frameTime);
+			const CompositeLayer layers[] = {
+				{ &base, BlendMode::Over, 255 },
+				{ &splashLayer, BlendMode::Alpha, 255 }
+			};
+			compositor.composite(composed, layers, 2);
+			doNotOptimize(composed.red()[CLK_Z]);
+		}
+		return iterations;
+	});
+}
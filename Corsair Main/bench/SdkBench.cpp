@@ -0,0 +1,105 @@
+#include "BenchHarness.h"
+
+#include "CUESDK.h"
+#include "DeltaOutput.h"
+
+#include <iostream>
+#include <vector>
+
+bool connectSdk()
+{
+	static auto connected = false;
+	if (!connected) {
+		CorsairPerformProtocolHandshake();
+		if (const auto error = CorsairGetLastError()) {
+			std::cerr << "Protocol handshake failed: " << error << std::endl;
+			return false;
+		}
+		connected = true;
+	}
+	return true;
+}
+
+namespace
+{
+	std::vector<CorsairLedColor> keyboardFrame()
+	{
+		std::vector<CorsairLedColor> frame;
+		if (const auto ledPositions = CorsairGetLedPositions()) {
+			for (auto i = 0; i < ledPositions->numberOfLed; ++i) {
+				frame.push_back(CorsairLedColor{ ledPositions->pLedPosition[i].ledId, 0, 0, 0 });
+			}
+		}
+		return frame;
+	}
+}
+
+void registerSdkBenchmarks(BenchRegistry &registry)
+{
+	registry.add("sdk/get_device_info", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		const auto count = CorsairGetDeviceCount();
+		for (int64_t i = 0; i < iterations; ++i) {
+			for (auto device = 0; device < count; ++device) {
+				doNotOptimize(CorsairGetDeviceInfo(device));
+			}
+		}
+		return iterations * count;
+	});
+
+	registry.add("sdk/get_led_id_for_key_name", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			doNotOptimize(CorsairGetLedIdForKeyName(static_cast<char>('a' + i % 26)));
+		}
+		return iterations;
+	});
+
+	registry.add("sdk/set_leds_colors/keyboard", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		auto frame = keyboardFrame();
+		for (int64_t i = 0; i < iterations; ++i) {
+			for (auto &ledColor : frame) {
+				ledColor.r = static_cast<int>(i & 0xff);
+			}
+			CorsairSetLedsColors(static_cast<int>(frame.size()), frame.data());
+		}
+		return iterations;
+	});
+
+	// Typical gameplay: a handful of keys change per frame while the rest of the keyboard stays lit.
+	registry.add("sdk/set_leds_colors/keyboard_4_changed", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		auto frame = keyboardFrame();
+		for (int64_t i = 0; i < iterations; ++i) {
+			for (auto k = 0; k < 4; ++k) {
+				frame[(i * 4 + k) % frame.size()].g = static_cast<int>(i & 0xff);
+			}
+			CorsairSetLedsColors(static_cast<int>(frame.size()), frame.data());
+		}
+		return iterations;
+	});
+
+	registry.add("sdk/delta_output/keyboard_4_changed", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		auto frame = keyboardFrame();
+		DeltaOutput output;
+		for (int64_t i = 0; i < iterations; ++i) {
+			for (auto k = 0; k < 4; ++k) {
+				frame[(i * 4 + k) % frame.size()].g = static_cast<int>(i & 0xff);
+			}
+			output.submit(static_cast<int>(frame.size()), frame.data());
+		}
+		return iterations;
+	});
+}
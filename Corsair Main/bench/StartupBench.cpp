@@ -0,0 +1,109 @@
+#include "BenchHarness.h"
+
+#include "ConnectionSupervisor.h"
+#include "DeviceManager.h"
+#include "Framebuffer.h"
+#include "RainbowEffect.h"
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+
+namespace
+{
+	const char cDeviceCachePath[] = "corsair_bench_devices.cldc";
+
+	/// Spiral rainbow over the first keyboard, the effect set up before the first frame.
+	RainbowEffect keyboardRainbow(const DeviceManager &devices)
+	{
+		for (auto i = 0; i < devices.deviceCount(); ++i) {
+			if (devices.device(i).type == CDT_Keyboard) {
+				return RainbowEffect::spiral(devices.device(i).geometry, CLES_Medium, CLECD_Clockwise);
+			}
+		}
+		return RainbowEffect::spiral(LedGeometry(), CLES_Medium, CLECD_Clockwise);
+	}
+
+	/// Submits the first frame and waits for it to reach the devices.
+	void submitFirstFrame(DeviceManager &devices, const Framebuffer &frame)
+	{
+		devices.submitAsync(frame);
+		devices.waitIdle(std::chrono::seconds(1));
+	}
+}
+
+void registerStartupBenchmarks(BenchRegistry &registry)
+{
+	// Time to first frame without a cache: connect, enumerate, then set the effect up and render.
+	registry.add("startup/first_frame_enumerated", [](int64_t iterations) -> int64_t {
+		for (int64_t i = 0; i < iterations; ++i) {
+			DeviceManager devices;
+			ConnectionSupervisor connection(devices);
+			if (!connection.connect()) {
+				return 0;
+			}
+			auto frame = devices.availableLeds();
+			keyboardRainbow(devices).render(0, frame);
+			submitFirstFrame(devices, frame);
+		}
+		return iterations;
+	});
+
+	// Same from the mapped cache: the effect is set up and rendered while connecting and revalidating.
+	registry.add("startup/first_frame_cached", [](int64_t iterations) -> int64_t {
+		{
+			DeviceManager devices;
+			if (!connectSdk() || !devices.enumerate() || !devices.saveCache(cDeviceCachePath)) {
+				return 0;
+			}
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			DeviceManager devices;
+			ConnectionSupervisor connection(devices);
+			if (!devices.loadCache(cDeviceCachePath)) {
+				return 0;
+			}
+			auto frame = devices.availableLeds();
+			const auto rainbow = keyboardRainbow(devices);
+			auto connected = std::async(std::launch::async, [&connection] { return connection.connect(); });
+			rainbow.render(0, frame);
+			if (!connected.get()) {
+				return 0;
+			}
+			if (!devices.isCached()) {
+				// Stale cache, the devices were enumerated again.
+				frame = devices.availableLeds();
+				keyboardRainbow(devices).render(0, frame);
+			}
+			submitFirstFrame(devices, frame);
+		}
+		std::remove(cDeviceCachePath);
+		return iterations;
+	});
+
+	registry.add("startup/open_device_cache", [](int64_t iterations) -> int64_t {
+		{
+			DeviceManager devices;
+			if (!connectSdk() || !devices.enumerate() || !devices.saveCache(cDeviceCachePath)) {
+				return 0;
+			}
+		}
+		DeviceManager devices;
+		for (int64_t i = 0; i < iterations; ++i) {
+			doNotOptimize(devices.loadCache(cDeviceCachePath));
+		}
+		std::remove(cDeviceCachePath);
+		return iterations;
+	});
+
+	registry.add("startup/enumerate_devices", [](int64_t iterations) -> int64_t {
+		if (!connectSdk()) {
+			return 0;
+		}
+		DeviceManager devices;
+		for (int64_t i = 0; i < iterations; ++i) {
+			doNotOptimize(devices.enumerate());
+		}
+		return iterations;
+	});
+}
@@ -0,0 +1,77 @@
+#include "BenchHarness.h"
+
+#include "Beatmap.h"
+#include "LightingTimeline.h"
+
+#include <cstdio>
+#include <iostream>
+
+namespace
+{
+	const char cTimelinePath[] = "corsair_bench_timeline.cltl";
+	const uint8_t cHash[Md5::cDigestSize] = {};
+}
+
+void registerTimelineBenchmarks(BenchRegistry &registry)
+{
+	// What starting a map costs without a cache: hashing, parsing and compiling the whole map.
+	registry.add("timeline/start_parse_compile", [](int64_t iterations) -> int64_t {
+		const auto text = marathonBeatmap();
+		Beatmap beatmap;
+		LightingTimeline timeline;
+		const LightingProfile profile;
+		for (int64_t i = 0; i < iterations; ++i) {
+			uint8_t hash[Md5::cDigestSize];
+			Md5::hash(text.data(), text.size(), hash);
+			beatmap.parse(text.data(), text.size());
+			timeline.compile(beatmap, hash, profile);
+			doNotOptimize(timeline.colorAt(0));
+		}
+		return iterations;
+	});
+
+	// Starting from the cache: mapping the compiled timeline and sampling its first frame.
+	registry.add("timeline/start_mapped", [](int64_t iterations) -> int64_t {
+		const auto text = marathonBeatmap();
+		Beatmap beatmap;
+		LightingTimeline timeline;
+		if (!beatmap.parse(text.data(), text.size()) || !timeline.compile(beatmap, cHash, LightingProfile()) || !timeline.save(cTimelinePath)) {
+			std::cerr << "Cannot write " << cTimelinePath << std::endl;
+			return 0;
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			timeline.open(cTimelinePath);
+			doNotOptimize(timeline.colorAt(0));
+		}
+		timeline.clear();
+		std::remove(cTimelinePath);
+		return iterations;
+	});
+
+	// One operation is one 240 Hz frame rendered from the timeline onto the keyboard.
+	registry.add("timeline/render_240hz", [](int64_t iterations) -> int64_t {
+		LedGeometry geometry;
+		if (!connectSdk() || !geometry.loadFromSdk()) {
+			return 0;
+		}
+		const auto text = marathonBeatmap();
+		Beatmap beatmap;
+		LightingTimeline timeline;
+		if (!beatmap.parse(text.data(), text.size()) || !timeline.compile(beatmap, cHash, LightingProfile())) {
+			return 0;
+		}
+		Framebuffer frame;
+		TimelineCursor cursor(timeline);
+		auto time = 0.;
+		for (int64_t i = 0; i < iterations; ++i) {
+			time += 1000. / 240;
+			if (time > timeline.header().endTime) {
+				time = 0.;
+			}
+			cursor.advance(static_cast<int>(time));
+			cursor.render(frame, geometry);
+			doNotOptimize(frame.red()[CLK_Z]);
+		}
+		return iterations;
+	});
+}
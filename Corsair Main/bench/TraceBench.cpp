@@ -0,0 +1,71 @@
+#include "BenchHarness.h"
+
+#include "FrameTrace.h"
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	const char cTracePath[] = "corsair_bench.trace";
+
+	/// Whole keyboard pulsing in one color, the typical frame of the app.
+	void pulseFrame(Framebuffer &frame, int64_t index)
+	{
+		const auto level = static_cast<uint8_t>(index * 3);
+		for (auto led = static_cast<int>(CLK_Escape); led <= static_cast<int>(CLK_Fn); ++led) {
+			frame.set(static_cast<CorsairLedId>(led), 0, level / 2, level);
+		}
+	}
+}
+
+void registerTraceBenchmarks(BenchRegistry &registry)
+{
+	// Recording one frame of the pulse to a trace file, as DeltaOutput does with a trace set.
+	registry.add("trace/write_pulse_frame", [](int64_t iterations) -> int64_t {
+		FrameTraceWriter writer;
+		if (!writer.open(cTracePath)) {
+			std::cerr << "Cannot write " << cTracePath << std::endl;
+			return 0;
+		}
+		Framebuffer frame;
+		for (int64_t i = 0; i < iterations; ++i) {
+			pulseFrame(frame, i);
+			writer.writeFrame(i * 4166666, frame);
+		}
+		writer.close();
+		std::remove(cTracePath);
+		return iterations;
+	});
+
+	// Decoding the frames of a mapped trace, one operation per frame.
+	registry.add("trace/read_pulse_frame", [](int64_t iterations) -> int64_t {
+		FrameTraceWriter writer;
+		if (!writer.open(cTracePath)) {
+			std::cerr << "Cannot write " << cTracePath << std::endl;
+			return 0;
+		}
+		Framebuffer frame;
+		for (auto i = 0; i < 24000; ++i) {
+			pulseFrame(frame, i);
+			writer.writeFrame(i * 4166666LL, frame);
+		}
+		writer.close();
+
+		FrameTraceReader reader;
+		if (!reader.open(cTracePath)) {
+			return 0;
+		}
+		for (int64_t i = 0; i < iterations; ++i) {
+			if (!reader.next()) {
+				reader.rewind();
+				reader.next();
+			}
+			doNotOptimize(reader.frame().blue()[CLK_Z]);
+		}
+		reader.close();
+		std::remove(cTracePath);
+		return iterations;
+	});
+}
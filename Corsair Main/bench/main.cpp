@@ -0,0 +1,66 @@
+#include "BenchHarness.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	void printUsage(const char *program)
+	{
+		std::cout << "Usage: " << program << " [--list] [--filter <substring>] [--min-time <seconds>]\n"
+			<< "Set CORSAIR_BENCH_BEATMAPS to a directory (such as osu!'s Songs) to parse it in beatmap/parse_corpus.\n";
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	std::string filter;
+	auto minTime = 0.5;
+	auto listOnly = false;
+
+	for (auto i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "--list")) {
+			listOnly = true;
+		} else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+			filter = argv[++i];
+		} else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) {
+			minTime = std::atof(argv[++i]);
+		} else {
+			printUsage(argv[0]);
+			return -1;
+		}
+	}
+
+	BenchRegistry registry;
+	registerSdkBenchmarks(registry);
+	registerFrameBenchmarks(registry);
+	registerFramebufferBenchmarks(registry);
+	registerCompositorBenchmarks(registry);
+	registerColorChartBenchmarks(registry);
+	registerGradientBenchmarks(registry);
+	registerEasingBenchmarks(registry);
+	registerRainbowBenchmarks(registry);
+	registerGeometryBenchmarks(registry);
+	registerBeatmapBenchmarks(registry);
+	registerTimelineBenchmarks(registry);
+	registerReplayBenchmarks(registry);
+	registerOfflineBenchmarks(registry);
+	registerTraceBenchmarks(registry);
+	registerConnectionBenchmarks(registry);
+	registerStartupBenchmarks(registry);
+	registerKeyLayoutBenchmarks(registry);
+	registerProfilerBenchmarks(registry);
+	registerMetricsBenchmarks(registry);
+
+	if (listOnly) {
+		registry.list();
+		return 0;
+	}
+	if (!registry.run(filter, std::chrono::duration<double>(minTime))) {
+		std::cerr << "No benchmark matches \"" << filter << "\"" << std::endl;
+		return -1;
+	}
+	return 0;
+}
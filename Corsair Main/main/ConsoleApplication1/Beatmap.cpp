@@ -0,0 +1,436 @@
+#include "Beatmap.h"
+#include "TextParsing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	using parsing::isSpace;
+	using parsing::parseInt;
+	using parsing::parseNumber;
+
+	const double cDefaultBeatLength = 500.;
+	const char cFormatHeader[] = "osu file format v";
+
+	void trim(const char *&begin, const char *&end)
+	{
+		while (begin < end && isSpace(*begin)) {
+			++begin;
+		}
+		while (end > begin && isSpace(end[-1])) {
+			--end;
+		}
+	}
+
+	bool startsWith(const char *begin, const char *end, const char *prefix)
+	{
+		const auto length = std::strlen(prefix);
+		return static_cast<size_t>(end - begin) >= length && !std::memcmp(begin, prefix, length);
+	}
+
+	bool equals(const char *begin, const char *end, const char *text)
+	{
+		return static_cast<size_t>(end - begin) == std::strlen(text) && startsWith(begin, end, text);
+	}
+
+	/// Moves p past the next comma. Returns false if the line has no more fields.
+	bool nextField(const char *&p, const char *end)
+	{
+		const auto comma = static_cast<const char*>(std::memchr(p, ',', end - p));
+		if (!comma) {
+			p = end;
+			return false;
+		}
+		p = comma + 1;
+		return true;
+	}
+
+	int16_t clampCoordinate(int value)
+	{
+		return static_cast<int16_t>(std::min(std::max(value, -32768), 32767));
+	}
+}
+
+Beatmap::Beatmap()
+{
+	clear();
+}
+
+void Beatmap::clear()
+{
+	mFormatVersion = 0;
+	mAudioFilename.clear();
+	mBackgroundFilename.clear();
+	mAudioLeadIn = 0;
+	mPreviewTime = -1;
+	mMode = 0;
+	mSliderMultiplier = 1.4;
+	mCircleSize = 5.;
+	mBreaks.clear();
+	mComboColours.clear();
+	mTimes.clear();
+	mEndTimes.clear();
+	mMaxEndTimes.clear();
+	mTypes.clear();
+	mX.clear();
+	mY.clear();
+	mComboIndices.clear();
+	mComboNumbers.clear();
+	mTimingTimes.clear();
+	mBeatLengths.clear();
+	mSliderVelocities.clear();
+	mMeters.clear();
+	mTimingFlags.clear();
+	mRedLineTimes.clear();
+	mPendingSliders.clear();
+}
+
+bool Beatmap::loadFile(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		clear();
+		return false;
+	}
+	const auto size = static_cast<size_t>(file.tellg());
+	mFileBuffer.resize(size);
+	file.seekg(0);
+	if (size && !file.read(mFileBuffer.data(), size)) {
+		clear();
+		return false;
+	}
+	return parse(mFileBuffer.data(), size);
+}
+
+bool Beatmap::parse(const char *text, size_t size)
+{
+	clear();
+	const char *p = text;
+	const char *end = text + size;
+	if (size >= 3 && !std::memcmp(p, "\xEF\xBB\xBF", 3)) {
+		p += 3;
+	}
+
+	auto section = S_None;
+	while (p < end) {
+		const auto newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+		const char *lineBegin = p;
+		const char *lineEnd = newline ? newline : end;
+		p = newline ? newline + 1 : end;
+		trim(lineBegin, lineEnd);
+		if (lineBegin == lineEnd || startsWith(lineBegin, lineEnd, "//")) {
+			continue;
+		}
+
+		if (!mFormatVersion) {
+			// The version header has to come first, anything else is not a beatmap.
+			if (!startsWith(lineBegin, lineEnd, cFormatHeader)) {
+				clear();
+				return false;
+			}
+			auto version = lineBegin + sizeof(cFormatHeader) - 1;
+			mFormatVersion = std::max(parseInt(version, lineEnd), 1);
+			continue;
+		}
+
+		if (*lineBegin == '[' && lineEnd[-1] == ']') {
+			const auto name = lineBegin + 1;
+			const auto nameEnd = lineEnd - 1;
+			section = equals(name, nameEnd, "General") ? S_General
+				: equals(name, nameEnd, "Difficulty") ? S_Difficulty
+				: equals(name, nameEnd, "Events") ? S_Events
+				: equals(name, nameEnd, "Colours") ? S_Colours
+				: equals(name, nameEnd, "TimingPoints") ? S_TimingPoints
+				: equals(name, nameEnd, "HitObjects") ? S_HitObjects
+				: S_Other;
+			continue;
+		}
+		parseLine(section, lineBegin, lineEnd);
+	}
+	if (!mFormatVersion) {
+		return false;
+	}
+	finish();
+	return true;
+}
+
+void Beatmap::parseLine(Section section, const char *begin, const char *end)
+{
+	switch (section) {
+	case S_General:
+	case S_Difficulty:
+	case S_Colours:
+		parseKeyValue(section, begin, end);
+		break;
+	case S_Events:
+		parseEvent(begin, end);
+		break;
+	case S_TimingPoints:
+		parseTimingPoint(begin, end);
+		break;
+	case S_HitObjects:
+		parseHitObject(begin, end);
+		break;
+	default:
+		break;
+	}
+}
+
+void Beatmap::parseKeyValue(Section section, const char *begin, const char *end)
+{
+	const auto colon = static_cast<const char*>(std::memchr(begin, ':', end - begin));
+	if (!colon) {
+		return;
+	}
+	const char *key = begin;
+	const char *keyEnd = colon;
+	const char *value = colon + 1;
+	const char *valueEnd = end;
+	trim(key, keyEnd);
+	trim(value, valueEnd);
+
+	if (section == S_Colours) {
+		if (startsWith(key, keyEnd, "Combo")) {
+			auto number = key + 5;
+			const auto index = parseInt(number, keyEnd) - 1;
+			if (index >= 0 && index < 8) {
+				if (mComboColours.size() <= static_cast<size_t>(index)) {
+					mComboColours.resize(index + 1, BeatmapColour{ 255, 255, 255 });
+				}
+				const auto channel = [&value, valueEnd]() {
+					const auto component = static_cast<uint8_t>(std::min(std::max(parseInt(value, valueEnd), 0), 255));
+					nextField(value, valueEnd);
+					return component;
+				};
+				const auto red = channel();
+				const auto green = channel();
+				mComboColours[index] = BeatmapColour{ red, green, channel() };
+			}
+		}
+	} else if (section == S_Difficulty) {
+		if (equals(key, keyEnd, "SliderMultiplier")) {
+			const auto multiplier = parseNumber(value, valueEnd);
+			mSliderMultiplier = multiplier > 0. ? multiplier : mSliderMultiplier;
+		} else if (equals(key, keyEnd, "CircleSize")) {
+			mCircleSize = parseNumber(value, valueEnd);
+		}
+	} else if (equals(key, keyEnd, "AudioFilename")) {
+		mAudioFilename.assign(value, valueEnd);
+	} else if (equals(key, keyEnd, "AudioLeadIn")) {
+		mAudioLeadIn = parseInt(value, valueEnd);
+	} else if (equals(key, keyEnd, "PreviewTime")) {
+		mPreviewTime = parseInt(value, valueEnd);
+	} else if (equals(key, keyEnd, "Mode")) {
+		mMode = parseInt(value, valueEnd);
+	}
+}
+
+void Beatmap::parseEvent(const char *begin, const char *end)
+{
+	auto p = begin;
+	const auto comma = static_cast<const char*>(std::memchr(p, ',', end - p));
+	if (!comma) {
+		return;
+	}
+	if (equals(begin, comma, "0") && mBackgroundFilename.empty()) {
+		// 0,startTime,"filename",xOffset,yOffset
+		p = comma + 1;
+		if (!nextField(p, end)) {
+			return;
+		}
+		auto fileEnd = static_cast<const char*>(std::memchr(p, ',', end - p));
+		fileEnd = fileEnd ? fileEnd : end;
+		if (fileEnd - p >= 2 && *p == '"' && fileEnd[-1] == '"') {
+			++p;
+			--fileEnd;
+		}
+		mBackgroundFilename.assign(p, fileEnd);
+	} else if (equals(begin, comma, "2") || equals(begin, comma, "Break")) {
+		// 2,startTime,endTime
+		p = comma + 1;
+		const auto start = parseInt(p, end);
+		if (nextField(p, end)) {
+			mBreaks.push_back(BeatmapBreak{ start, parseInt(p, end) });
+		}
+	}
+}
+
+void Beatmap::parseTimingPoint(const char *begin, const char *end)
+{
+	// time,beatLength,meter,sampleSet,sampleIndex,volume,uninherited,effects
+	auto p = begin;
+	const auto time = static_cast<int32_t>(std::floor(parseNumber(p, end)));
+	if (!nextField(p, end)) {
+		return;
+	}
+	const auto beatLength = parseNumber(p, end);
+	auto meter = 4;
+	auto uninherited = beatLength > 0.;
+	auto effects = 0;
+	if (nextField(p, end)) {
+		meter = parseInt(p, end);
+		for (auto field = 3; field < 7 && nextField(p, end); ++field) {
+			if (field == 6) {
+				uninherited = parseInt(p, end) != 0;
+			}
+		}
+		if (nextField(p, end)) {
+			effects = parseInt(p, end);
+		}
+	}
+
+	const auto previous = timingPointCount() - 1;
+	if (uninherited && beatLength > 0.) {
+		mBeatLengths.push_back(beatLength);
+		mSliderVelocities.push_back(1.f);
+		mRedLineTimes.push_back(time);
+	} else {
+		// Negative beat length of a green line is the inverse slider velocity in percent.
+		const auto velocity = beatLength < 0. ? std::min(std::max(-100. / beatLength, .1), 10.) : 1.;
+		mBeatLengths.push_back(previous >= 0 ? mBeatLengths[previous] : cDefaultBeatLength);
+		mSliderVelocities.push_back(static_cast<float>(velocity));
+		mRedLineTimes.push_back(previous >= 0 ? mRedLineTimes[previous] : time);
+		uninherited = false;
+	}
+	mTimingTimes.push_back(time);
+	mMeters.push_back(static_cast<uint8_t>(std::min(std::max(meter, 1), 255)));
+	mTimingFlags.push_back(static_cast<uint8_t>((uninherited ? TPF_Uninherited : 0) | (effects & 1 ? TPF_Kiai : 0)));
+}
+
+void Beatmap::parseHitObject(const char *begin, const char *end)
+{
+	// x,y,time,type,hitSound,objectParams,hitSample
+	int fields[4];
+	auto p = begin;
+	for (auto i = 0; i < 4; ++i) {
+		fields[i] = parseInt(p, end);
+		if (!nextField(p, end) && i < 3) {
+			return;
+		}
+	}
+	const auto time = fields[2];
+	const auto type = fields[3];
+	auto endTime = time;
+
+	nextField(p, end);   // hitSound
+	if (type & HOT_Slider) {
+		// curveType|points,slides,length
+		if (nextField(p, end)) {
+			const auto slides = parseInt(p, end);
+			const auto length = nextField(p, end) ? parseNumber(p, end) : 0.;
+			mPendingSliders.push_back(PendingSlider{ objectCount(), length, std::max(slides, 1) });
+		}
+	} else if (type & (HOT_Spinner | HOT_Hold)) {
+		// Spinners end at the next field, holds at the part of it before the first colon.
+		endTime = std::max(parseInt(p, end), time);
+	}
+
+	const auto first = mTimes.empty();
+	const auto newCombo = first || (type & (HOT_NewCombo | HOT_Spinner)) || (mTypes.back() & HOT_Spinner);
+	auto comboIndex = first ? 0 : mComboIndices.back();
+	auto comboNumber = first ? 1 : mComboNumbers.back() + 1;
+	if (newCombo) {
+		comboIndex = first ? 0 : comboIndex + 1 + ((type & HOT_ComboSkip) >> 4);
+		comboNumber = 1;
+	}
+
+	mTimes.push_back(time);
+	mEndTimes.push_back(endTime);
+	mTypes.push_back(static_cast<uint8_t>(type));
+	mX.push_back(clampCoordinate(fields[0]));
+	mY.push_back(clampCoordinate(fields[1]));
+	mComboIndices.push_back(comboIndex);
+	mComboNumbers.push_back(static_cast<uint16_t>(std::min(comboNumber, 65535)));
+}
+
+void Beatmap::finish()
+{
+	// Slider durations depend on timing points, which may come after the objects in the file.
+	for (const auto &slider : mPendingSliders) {
+		const auto point = timingPointAt(mTimes[slider.object]);
+		const auto beatLength = point >= 0 ? mBeatLengths[point] : cDefaultBeatLength;
+		const auto velocity = point >= 0 ? mSliderVelocities[point] : 1.f;
+		const auto pixelsPerBeat = mSliderMultiplier * 100. * velocity;
+		const auto duration = slider.length / pixelsPerBeat * beatLength * slider.slides;
+		mEndTimes[slider.object] = mTimes[slider.object] + static_cast<int32_t>(duration + .5);
+	}
+	mPendingSliders.clear();
+
+	mMaxEndTimes.resize(mEndTimes.size());
+	auto maxEnd = INT32_MIN;
+	for (size_t i = 0; i < mEndTimes.size(); ++i) {
+		maxEnd = std::max(maxEnd, mEndTimes[i]);
+		mMaxEndTimes[i] = maxEnd;
+	}
+}
+
+int Beatmap::objectAfter(int time) const
+{
+	return static_cast<int>(std::upper_bound(mTimes.begin(), mTimes.end(), time) - mTimes.begin());
+}
+
+int Beatmap::timingPointAt(int time) const
+{
+	if (mTimingTimes.empty()) {
+		return -1;
+	}
+	const auto after = std::upper_bound(mTimingTimes.begin(), mTimingTimes.end(), time) - mTimingTimes.begin();
+	return after ? static_cast<int>(after - 1) : 0;
+}
+
+BeatmapCursor::BeatmapCursor(const Beatmap &beatmap)
+	: mBeatmap(beatmap)
+{
+	seek(INT32_MIN);
+}
+
+void BeatmapCursor::seek(int time)
+{
+	mTime = time;
+	mNextObject = mBeatmap.objectAfter(time);
+	const auto maxEndTimes = mBeatmap.maxEndTimes();
+	mFirstCandidate = static_cast<int>(std::lower_bound(maxEndTimes, maxEndTimes + mBeatmap.objectCount(), time) - maxEndTimes);
+	mTimingPoint = mBeatmap.timingPointAt(time);
+}
+
+void BeatmapCursor::advance(int time)
+{
+	if (time < mTime) {
+		seek(time);
+		return;
+	}
+	mTime = time;
+	const auto count = mBeatmap.objectCount();
+	const auto times = mBeatmap.times();
+	const auto maxEndTimes = mBeatmap.maxEndTimes();
+	while (mNextObject < count && times[mNextObject] <= time) {
+		++mNextObject;
+	}
+	while (mFirstCandidate < count && maxEndTimes[mFirstCandidate] < time) {
+		++mFirstCandidate;
+	}
+	const auto timingTimes = mBeatmap.timingTimes();
+	while (mTimingPoint + 1 < mBeatmap.timingPointCount() && timingTimes[mTimingPoint + 1] <= time) {
+		++mTimingPoint;
+	}
+}
+
+bool BeatmapCursor::kiai() const
+{
+	return mTimingPoint >= 0 && (mBeatmap.timingFlags()[mTimingPoint] & TPF_Kiai);
+}
+
+double BeatmapCursor::beatLength() const
+{
+	return mTimingPoint >= 0 ? mBeatmap.beatLengths()[mTimingPoint] : cDefaultBeatLength;
+}
+
+double BeatmapCursor::beatPhase() const
+{
+	const auto origin = mTimingPoint >= 0 ? mBeatmap.redLineTimes()[mTimingPoint] : 0;
+	const auto beats = (static_cast<double>(mTime) - origin) / beatLength();
+	return beats - std::floor(beats);
+}
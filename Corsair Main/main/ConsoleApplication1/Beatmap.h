@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Bits of the type field of a hit object, as written in the [HitObjects] section.
+enum HitObjectType
+{
+	HOT_Circle = 1,
+	HOT_Slider = 2,
+	HOT_NewCombo = 4,
+	HOT_Spinner = 8,
+	HOT_ComboSkip = 16 | 32 | 64,
+	HOT_Hold = 128
+};
+
+/// Bits of Beatmap::timingFlags().
+enum TimingPointFlag
+{
+	TPF_Uninherited = 1,   /**< Red line: sets beat length and meter */
+	TPF_Kiai = 2           /**< Kiai time is on from this point */
+};
+
+/// A break from the [Events] section.
+struct BeatmapBreak
+{
+	int start;
+	int end;
+};
+
+/// A combo colour from the [Colours] section.
+struct BeatmapColour
+{
+	uint8_t red;
+	uint8_t green;
+	uint8_t blue;
+};
+
+/**
+ * @brief Contents of a .osu file relevant for lighting, stored as parallel arrays ordered by time.
+ *
+ * Hit object i is described by times()[i], endTimes()[i], types()[i] and so on; circles end when they
+ * start, slider ends are computed from the timing points and the slider multiplier. Timing points are
+ * kept the same way. Parsing is a single pass over the text; reusing one Beatmap for several files
+ * keeps the capacity of every array, so switching maps does not allocate once the largest was seen.
+ */
+class Beatmap
+{
+public:
+	Beatmap();
+
+	/// Parses .osu text. Returns false if it is not an osu! file; the beatmap is empty then.
+	bool parse(const char *text, size_t size);
+	/// Reads and parses a .osu file. Returns false if it cannot be read or parsed.
+	bool loadFile(const std::string &path);
+	void clear();
+
+	int formatVersion() const { return mFormatVersion; }
+	const std::string& audioFilename() const { return mAudioFilename; }
+	const std::string& backgroundFilename() const { return mBackgroundFilename; }
+	int audioLeadIn() const { return mAudioLeadIn; }
+	int previewTime() const { return mPreviewTime; }
+	int mode() const { return mMode; }
+	double sliderMultiplier() const { return mSliderMultiplier; }
+	/// CircleSize of the [Difficulty] section, which is the number of columns in osu!mania.
+	double circleSize() const { return mCircleSize; }
+	const std::vector<BeatmapBreak>& breaks() const { return mBreaks; }
+	/// Combo1, Combo2... in order, empty if the map uses the skin's colours.
+	const std::vector<BeatmapColour>& comboColours() const { return mComboColours; }
+
+	int objectCount() const { return static_cast<int>(mTimes.size()); }
+	const int32_t* times() const { return mTimes.data(); }
+	const int32_t* endTimes() const { return mEndTimes.data(); }
+	/// Largest end time among objects [0..i], which lets a cursor find every object still active at a time.
+	const int32_t* maxEndTimes() const { return mMaxEndTimes.data(); }
+	const uint8_t* types() const { return mTypes.data(); }
+	const int16_t* x() const { return mX.data(); }
+	const int16_t* y() const { return mY.data(); }
+	/// Index of the combo the object belongs to, counting from 0.
+	const int32_t* comboIndices() const { return mComboIndices.data(); }
+	/// Position of the object within its combo, counting from 1 like the numbers shown in game.
+	const uint16_t* comboNumbers() const { return mComboNumbers.data(); }
+
+	int timingPointCount() const { return static_cast<int>(mTimingTimes.size()); }
+	const int32_t* timingTimes() const { return mTimingTimes.data(); }
+	/// Beat length in milliseconds in effect from the point, inherited points repeat the one of their red line.
+	const double* beatLengths() const { return mBeatLengths.data(); }
+	/// Slider velocity multiplier in effect from the point, 1 on red lines.
+	const float* sliderVelocities() const { return mSliderVelocities.data(); }
+	const uint8_t* meters() const { return mMeters.data(); }
+	const uint8_t* timingFlags() const { return mTimingFlags.data(); }
+	/// Time of the red line the point belongs to (its own time for red lines), where beats are counted from.
+	const int32_t* redLineTimes() const { return mRedLineTimes.data(); }
+
+	/// Index of the first object starting after time, O(log n).
+	int objectAfter(int time) const;
+	/// Index of the timing point in effect at time, O(log n). 0 before the first point, -1 if there are none.
+	int timingPointAt(int time) const;
+
+private:
+	enum Section
+	{
+		S_None,
+		S_General,
+		S_Difficulty,
+		S_Events,
+		S_Colours,
+		S_TimingPoints,
+		S_HitObjects,
+		S_Other
+	};
+
+	struct PendingSlider
+	{
+		int object;
+		double length;
+		int slides;
+	};
+
+	void parseLine(Section section, const char *begin, const char *end);
+	void parseKeyValue(Section section, const char *begin, const char *end);
+	void parseEvent(const char *begin, const char *end);
+	void parseTimingPoint(const char *begin, const char *end);
+	void parseHitObject(const char *begin, const char *end);
+	void finish();
+
+	int mFormatVersion;
+	std::string mAudioFilename;
+	std::string mBackgroundFilename;
+	int mAudioLeadIn;
+	int mPreviewTime;
+	int mMode;
+	double mSliderMultiplier;
+	double mCircleSize;
+	std::vector<BeatmapBreak> mBreaks;
+	std::vector<BeatmapColour> mComboColours;
+
+	std::vector<int32_t> mTimes;
+	std::vector<int32_t> mEndTimes;
+	std::vector<int32_t> mMaxEndTimes;
+	std::vector<uint8_t> mTypes;
+	std::vector<int16_t> mX;
+	std::vector<int16_t> mY;
+	std::vector<int32_t> mComboIndices;
+	std::vector<uint16_t> mComboNumbers;
+
+	std::vector<int32_t> mTimingTimes;
+	std::vector<double> mBeatLengths;
+	std::vector<float> mSliderVelocities;
+	std::vector<uint8_t> mMeters;
+	std::vector<uint8_t> mTimingFlags;
+	std::vector<int32_t> mRedLineTimes;
+
+	std::vector<PendingSlider> mPendingSliders;
+	std::vector<char> mFileBuffer;
+};
+
+/**
+ * @brief Answers "what is going on at time t" while playback moves forward.
+ *
+ * advance() costs O(1) amortized when time only grows, as during playback; seeking backwards or far
+ * ahead falls back to binary searches. Active objects are those with time <= t < endTime, circles
+ * being active only at their exact time.
+ */
+class BeatmapCursor
+{
+public:
+	explicit BeatmapCursor(const Beatmap &beatmap);
+
+	/// Positions the cursor at time with binary searches.
+	void seek(int time);
+	/// Moves the cursor forward to time; seeks if time is before the current one.
+	void advance(int time);
+
+	int time() const { return mTime; }
+
+	/// Objects that may be active are in [firstCandidate(), nextObject()), see forEachActive().
+	int firstCandidate() const { return mFirstCandidate; }
+	/// First object starting after the current time, objectCount() at the end of the map.
+	int nextObject() const { return mNextObject; }
+
+	/// Calls function(index) for every object active at the current time.
+	template <typename Function>
+	void forEachActive(Function function) const
+	{
+		const auto times = mBeatmap.times();
+		const auto endTimes = mBeatmap.endTimes();
+		for (auto i = mFirstCandidate; i < mNextObject; ++i) {
+			if (endTimes[i] > mTime || times[i] == mTime) {
+				function(i);
+			}
+		}
+	}
+
+	/// Index of the timing point in effect, -1 without timing points.
+	int timingPoint() const { return mTimingPoint; }
+	bool kiai() const;
+	/// Beat length in milliseconds in effect, 500 (120 BPM) without timing points.
+	double beatLength() const;
+	/// Position within the current beat [0..1), measured from the last red line.
+	double beatPhase() const;
+
+private:
+	const Beatmap &mBeatmap;
+	int mTime;
+	int mFirstCandidate;
+	int mNextObject;
+	int mTimingPoint;
+};
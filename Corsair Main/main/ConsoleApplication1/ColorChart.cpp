@@ -0,0 +1,119 @@
+#include "ColorChart.h"
+#include "ColorChartKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	int clampChannel(int value)
+	{
+		return std::min(std::max(value, 0), 255);
+	}
+}
+
+const int ColorLut::cApplyBlock;
+
+void colorchart::sampleScalar(const uint32_t *entries, int size, const float *positions, int count, uint32_t *colors)
+{
+	const auto scale = static_cast<float>(size - 1);
+	for (auto i = 0; i < count; ++i) {
+		// Written so NaN ends up at 0, as with the max_ps of the vector kernels.
+		auto position = positions[i] > 0.f ? positions[i] : 0.f;
+		position = position < 1.f ? position : 1.f;
+		colors[i] = entries[static_cast<int>(position * scale + .5f)];
+	}
+}
+
+ColorLut::ColorLut(std::vector<uint32_t> entries, uint32_t version, Compositor::Isa isa)
+	: mEntries(std::move(entries)), mVersion(version), mIsa(Compositor::Isa::Scalar), mKernel(&colorchart::sampleScalar)
+{
+	if (mEntries.empty()) {
+		mEntries.push_back(0);
+	}
+#ifdef CORSAIR_COMPOSITOR_AVX2
+	if (isa == Compositor::Isa::Avx2 && Compositor::isSupported(isa)) {
+		mIsa = isa;
+		mKernel = &colorchart::sampleAvx2;
+	}
+#endif
+}
+
+int ColorLut::indexOf(float position) const
+{
+	position = position > 0.f ? position : 0.f;
+	position = position < 1.f ? position : 1.f;
+	return static_cast<int>(position * static_cast<float>(size() - 1) + .5f);
+}
+
+void ColorLut::sample(const float *positions, int count, uint32_t *colors) const
+{
+	mKernel(mEntries.data(), size(), positions, count, colors);
+}
+
+void ColorLut::apply(const float *positions, const CorsairLedId *ledIds, int count, Framebuffer &frame) const
+{
+	applyBlocks(ledIds, count, frame, [&](int start, int block, uint32_t *colors) {
+		sample(positions + start, block, colors);
+	});
+}
+
+uint32_t ColorLut::pack(const CorsairColor &color)
+{
+	return static_cast<uint32_t>(clampChannel(color.r)) | static_cast<uint32_t>(clampChannel(color.g)) << 8
+		| static_cast<uint32_t>(clampChannel(color.b)) << 16;
+}
+
+ColorChart::ColorChart(int lutSize, Compositor::Isa isa)
+	: mLutSize(std::max(lutSize, 2)), mIsa(isa), mVersion(0)
+{
+}
+
+void ColorChart::addPoint(double position, CorsairColor color)
+{
+	const auto point = Point{ std::min(std::max(position, 0.), 1.), color };
+	const auto it = std::upper_bound(mPoints.begin(), mPoints.end(), point, [](const Point &a, const Point &b) {
+		return a.position < b.position;
+	});
+	mPoints.insert(it, point);
+	++mVersion;
+}
+
+void ColorChart::clear()
+{
+	mPoints.clear();
+	++mVersion;
+}
+
+CorsairColor ColorChart::evaluate(double position) const
+{
+	if (mPoints.empty()) {
+		return CorsairColor{ 0, 0, 0 };
+	}
+	if (position <= mPoints.front().position) {
+		return mPoints.front().color;
+	}
+	// First point past position; equal positions resolve to the last one added, as with a step.
+	const auto to = std::upper_bound(mPoints.begin(), mPoints.end(), position, [](double value, const Point &point) {
+		return value < point.position;
+	});
+	if (to == mPoints.end()) {
+		return mPoints.back().color;
+	}
+	const auto &from = *(to - 1);
+	const auto t = (position - from.position) / (to->position - from.position);
+	const auto mix = [t](int a, int b) { return static_cast<int>(std::lround(a + (b - a) * t)); };
+	return CorsairColor{ mix(from.color.r, to->color.r), mix(from.color.g, to->color.g), mix(from.color.b, to->color.b) };
+}
+
+std::shared_ptr<const ColorLut> ColorChart::lut() const
+{
+	if (!mLut || mLut->version() != mVersion) {
+		std::vector<uint32_t> entries(mLutSize);
+		for (auto i = 0; i < mLutSize; ++i) {
+			entries[i] = ColorLut::pack(evaluate(static_cast<double>(i) / (mLutSize - 1)));
+		}
+		mLut = std::make_shared<const ColorLut>(std::move(entries), mVersion, mIsa);
+	}
+	return mLut;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "Compositor.h"
+#include "Framebuffer.h"
+#include "Shared/LFX.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Color chart baked into a table of evenly spaced colors over [0..1].
+ *
+ * Entries are packed as 0x00bbggrr so a lookup is a single 32-bit load, or eight of them in one AVX2
+ * gather. A LUT never changes once baked: editing its ColorChart bakes a new one, and whoever still holds
+ * the old one keeps using it until it picks up the new version.
+ */
+class ColorLut
+{
+public:
+	/// Kernel looking up count positions, see sample().
+	using Kernel = void (*)(const uint32_t *entries, int size, const float *positions, int count, uint32_t *colors);
+
+	/// Colors are staged in blocks of this many LEDs before they are scattered into a frame.
+	static const int cApplyBlock = 64;
+
+	ColorLut(std::vector<uint32_t> entries, uint32_t version, Compositor::Isa isa = Compositor::bestIsa());
+
+	int size() const { return static_cast<int>(mEntries.size()); }
+	/// ColorChart::version() the LUT was baked from.
+	uint32_t version() const { return mVersion; }
+	Compositor::Isa isa() const { return mIsa; }
+	const uint32_t* entries() const { return mEntries.data(); }
+
+	/// Entry nearest to position, clamped to [0..1].
+	int indexOf(float position) const;
+	uint32_t at(float position) const { return mEntries[indexOf(position)]; }
+
+	/// Packed colors of count positions into colors, one per position.
+	void sample(const float *positions, int count, uint32_t *colors) const;
+	/// Sets LED ledIds[i] of frame to the color at positions[i].
+	void apply(const float *positions, const CorsairLedId *ledIds, int count, Framebuffer &frame) const;
+
+	/// Packs color as 0x00bbggrr with every channel clamped to [0..255].
+	static uint32_t pack(const CorsairColor &color);
+	static uint8_t red(uint32_t color) { return static_cast<uint8_t>(color); }
+	static uint8_t green(uint32_t color) { return static_cast<uint8_t>(color >> 8); }
+	static uint8_t blue(uint32_t color) { return static_cast<uint8_t>(color >> 16); }
+
+	/// Sets LED ledIds[i] of frame to packed color i, which fill(start, block, colors) writes a block at a time.
+	template <typename Fill>
+	static void applyBlocks(const CorsairLedId *ledIds, int count, Framebuffer &frame, Fill fill)
+	{
+		uint32_t colors[cApplyBlock];
+		for (auto start = 0; start < count; start += cApplyBlock) {
+			const auto block = std::min(cApplyBlock, count - start);
+			fill(start, block, colors);
+			for (auto i = 0; i < block; ++i) {
+				frame.set(ledIds[start + i], red(colors[i]), green(colors[i]), blue(colors[i]));
+			}
+		}
+	}
+
+private:
+	std::vector<uint32_t> mEntries;
+	uint32_t mVersion;
+	Compositor::Isa mIsa;
+	Kernel mKernel;
+};
+
+/**
+ * @brief Piecewise linear color chart over [0..1], the native counterpart of CUELFXAddPointToEffect().
+ *
+ * Points are interpolated linearly; before the first and after the last point the chart holds their
+ * colors. Every change bumps version(), and lut() bakes the points into a ColorLut on first use after a
+ * change, so effects sharing a chart (through a shared_ptr, say) share its LUT and only ever pay for
+ * one bake per edit. Not thread safe: edit and bake from the thread that renders.
+ */
+class ColorChart
+{
+public:
+	static const int cDefaultLutSize = 256;
+	static const int cLargeLutSize = 1024;
+
+	/// lutSize entries per LUT, at least 2.
+	explicit ColorChart(int lutSize = cDefaultLutSize, Compositor::Isa isa = Compositor::bestIsa());
+
+	/// Adds a point at position, clamped to [0..1]. Points at the same position keep the order they were added in.
+	void addPoint(double position, CorsairColor color);
+	void clear();
+
+	int pointCount() const { return static_cast<int>(mPoints.size()); }
+	int lutSize() const { return mLutSize; }
+	/// Changes with every edit of the points.
+	uint32_t version() const { return mVersion; }
+
+	/// Color at position, searched and interpolated from the points; black without points.
+	CorsairColor evaluate(double position) const;
+
+	/// LUT of the current points.
+	std::shared_ptr<const ColorLut> lut() const;
+
+private:
+	struct Point
+	{
+		double position;
+		CorsairColor color;
+	};
+
+	std::vector<Point> mPoints;
+	int mLutSize;
+	Compositor::Isa mIsa;
+	uint32_t mVersion;
+	mutable std::shared_ptr<const ColorLut> mLut;
+};
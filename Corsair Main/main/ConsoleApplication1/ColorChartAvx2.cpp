@@ -0,0 +1,23 @@
+// Compiled with AVX2 code generation enabled (-mavx2); only reached through ColorLut once the CPU reported AVX2.
+#include "ColorChartKernels.h"
+
+#ifdef CORSAIR_COMPOSITOR_AVX2
+#include <immintrin.h>
+
+void colorchart::sampleAvx2(const uint32_t *entries, int size, const float *positions, int count, uint32_t *colors)
+{
+	const auto zero = _mm256_setzero_ps();
+	const auto one = _mm256_set1_ps(1.f);
+	const auto scale = _mm256_set1_ps(static_cast<float>(size - 1));
+	const auto half = _mm256_set1_ps(.5f);
+	const auto table = reinterpret_cast<const int*>(entries);
+	auto i = 0;
+	for (; i + 8 <= count; i += 8) {
+		// max_ps returns its second operand for NaN, which maps NaN to 0 like the scalar kernel.
+		const auto position = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(positions + i), zero), one);
+		const auto index = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(position, scale), half));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(colors + i), _mm256_i32gather_epi32(table, index, 4));
+	}
+	sampleScalar(entries, size, positions + i, count - i, colors + i);
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CompositorKernels.h"
+
+#include <cstdint>
+
+// Lookup kernels behind ColorLut, picked like the ones of Compositor. All of them round positions the same
+// way (clamp to [0..1], scale, add one half, truncate) in single precision, so they return the same entries.
+
+namespace colorchart
+{
+	void sampleScalar(const uint32_t *entries, int size, const float *positions, int count, uint32_t *colors);
+#ifdef CORSAIR_COMPOSITOR_AVX2
+	void sampleAvx2(const uint32_t *entries, int size, const float *positions, int count, uint32_t *colors);
+#endif
+}
@@ -0,0 +1,266 @@
+#include "Compositor.h"
+#include "CompositorKernels.h"
+
+#ifdef CORSAIR_COMPOSITOR_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(CORSAIR_COMPOSITOR_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	bool cpuHasAvx2()
+	{
+#if defined(CORSAIR_COMPOSITOR_AVX2) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+		// AVX state has to be enabled by the OS as well (OSXSAVE, then XCR0 bits 1 and 2).
+		__cpuid(info, 1);
+		if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6) {
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#elif defined(CORSAIR_COMPOSITOR_AVX2)
+		return __builtin_cpu_supports("avx2") != 0;
+#else
+		return false;
+#endif
+	}
+
+	int lerp(int below, int blended, int coverage)
+	{
+		return compositor::div255(below * (255 - coverage) + blended * coverage);
+	}
+
+	template <BlendMode Mode>
+	int apply(int below, int layer)
+	{
+		switch (Mode) {
+		case BlendMode::Additive: return below + layer > 255 ? 255 : below + layer;
+		case BlendMode::Multiply: return compositor::div255(below * layer);
+		case BlendMode::Max: return below > layer ? below : layer;
+		default: return layer;
+		}
+	}
+
+	template <BlendMode Mode>
+	void blendLeds(Framebuffer &target, const Framebuffer &layer, uint8_t opacity)
+	{
+		uint8_t *below[] = { target.red(), target.green(), target.blue() };
+		const uint8_t *above[] = { layer.red(), layer.green(), layer.blue() };
+		const auto alpha = layer.alpha();
+		const auto targetAlpha = target.alpha();
+		layer.forEachActive([&](CorsairLedId ledId) {
+			const auto coverage = Mode == BlendMode::Alpha ? compositor::div255(alpha[ledId] * opacity) : opacity;
+			for (auto plane = 0; plane < 3; ++plane) {
+				const int color = below[plane][ledId];
+				below[plane][ledId] = static_cast<uint8_t>(lerp(color, apply<Mode>(color, above[plane][ledId]), coverage));
+			}
+			targetAlpha[ledId] = static_cast<uint8_t>(lerp(targetAlpha[ledId], 255, coverage));
+		});
+	}
+
+#ifdef CORSAIR_COMPOSITOR_SSE2
+	const int cSse2Width = 16;
+
+	/// 0xff for every LED whose bit is set in the 16 bits of mask.
+	__m128i expandMask(uint32_t bits)
+	{
+		const auto bitOfByte = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+		const auto bytes = _mm_set_epi64x(static_cast<long long>((bits >> 8 & 0xff) * 0x0101010101010101ull),
+			static_cast<long long>((bits & 0xff) * 0x0101010101010101ull));
+		return _mm_cmpeq_epi8(_mm_and_si128(bytes, bitOfByte), bitOfByte);
+	}
+
+	/// Rounded x / 255 of eight 16-bit lanes holding [0..255 * 255].
+	__m128i div255(__m128i x)
+	{
+		x = _mm_add_epi16(x, _mm_set1_epi16(128));
+		return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+	}
+
+	__m128i lerpHalf(__m128i below, __m128i blended, __m128i coverage)
+	{
+		const auto inverse = _mm_sub_epi16(_mm_set1_epi16(255), coverage);
+		return div255(_mm_add_epi16(_mm_mullo_epi16(below, inverse), _mm_mullo_epi16(blended, coverage)));
+	}
+
+	__m128i lerp(__m128i below, __m128i blended, __m128i coverage)
+	{
+		const auto zero = _mm_setzero_si128();
+		const auto low = lerpHalf(_mm_unpacklo_epi8(below, zero), _mm_unpacklo_epi8(blended, zero), _mm_unpacklo_epi8(coverage, zero));
+		const auto high = lerpHalf(_mm_unpackhi_epi8(below, zero), _mm_unpackhi_epi8(blended, zero), _mm_unpackhi_epi8(coverage, zero));
+		return _mm_packus_epi16(low, high);
+	}
+
+	__m128i multiply(__m128i a, __m128i b)
+	{
+		const auto zero = _mm_setzero_si128();
+		const auto low = div255(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)));
+		const auto high = div255(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)));
+		return _mm_packus_epi16(low, high);
+	}
+
+	template <BlendMode Mode>
+	__m128i apply(__m128i below, __m128i layer)
+	{
+		switch (Mode) {
+		case BlendMode::Additive: return _mm_adds_epu8(below, layer);
+		case BlendMode::Multiply: return multiply(below, layer);
+		case BlendMode::Max: return _mm_max_epu8(below, layer);
+		default: return layer;
+		}
+	}
+
+	/// Opaque layers (opacity 255, any mode but Alpha) have a coverage of 0 or 255, which reduces lerp to a select.
+	template <BlendMode Mode, bool Opaque>
+	void blendBlocks(Framebuffer &target, const Framebuffer &layer, uint8_t opacity)
+	{
+		uint8_t *below[] = { target.red(), target.green(), target.blue(), target.alpha() };
+		const uint8_t *above[] = { layer.red(), layer.green(), layer.blue() };
+		const auto mask = layer.activeMask();
+		const auto opacityBytes = _mm_set1_epi8(static_cast<char>(opacity));
+		for (auto offset = 0; offset < Framebuffer::cCapacity; offset += cSse2Width) {
+			const auto bits = static_cast<uint32_t>(mask[offset >> 6] >> (offset & 63)) & 0xffff;
+			if (!bits) {
+				continue;
+			}
+			const auto active = expandMask(bits);
+			auto coverage = active;
+			if (Mode == BlendMode::Alpha) {
+				const auto alpha = _mm_loadu_si128(reinterpret_cast<const __m128i*>(layer.alpha() + offset));
+				coverage = _mm_and_si128(multiply(alpha, opacityBytes), active);
+			} else if (!Opaque) {
+				coverage = _mm_and_si128(opacityBytes, active);
+			}
+
+			for (auto plane = 0; plane < 3; ++plane) {
+				const auto destination = reinterpret_cast<__m128i*>(below[plane] + offset);
+				const auto color = _mm_loadu_si128(destination);
+				const auto blended = apply<Mode>(color, _mm_loadu_si128(reinterpret_cast<const __m128i*>(above[plane] + offset)));
+				_mm_storeu_si128(destination, Opaque
+					? _mm_or_si128(_mm_and_si128(active, blended), _mm_andnot_si128(active, color))
+					: lerp(color, blended, coverage));
+			}
+			const auto destination = reinterpret_cast<__m128i*>(below[3] + offset);
+			const auto alpha = _mm_loadu_si128(destination);
+			_mm_storeu_si128(destination, Opaque ? _mm_or_si128(alpha, active) : lerp(alpha, _mm_set1_epi8(-1), coverage));
+		}
+	}
+
+	template <BlendMode Mode>
+	void blendVectors(Framebuffer &target, const Framebuffer &layer, uint8_t opacity)
+	{
+		if (Mode != BlendMode::Alpha && opacity == 255) {
+			blendBlocks<Mode, true>(target, layer, opacity);
+		} else {
+			blendBlocks<Mode, false>(target, layer, opacity);
+		}
+	}
+#endif
+}
+
+void compositor::blendScalar(Framebuffer &target, const Framebuffer &layer, BlendMode mode, uint8_t opacity)
+{
+	switch (mode) {
+	case BlendMode::Over: blendLeds<BlendMode::Over>(target, layer, opacity); break;
+	case BlendMode::Alpha: blendLeds<BlendMode::Alpha>(target, layer, opacity); break;
+	case BlendMode::Additive: blendLeds<BlendMode::Additive>(target, layer, opacity); break;
+	case BlendMode::Multiply: blendLeds<BlendMode::Multiply>(target, layer, opacity); break;
+	case BlendMode::Max: blendLeds<BlendMode::Max>(target, layer, opacity); break;
+	}
+}
+
+#ifdef CORSAIR_COMPOSITOR_SSE2
+void compositor::blendSse2(Framebuffer &target, const Framebuffer &layer, BlendMode mode, uint8_t opacity)
+{
+	switch (mode) {
+	case BlendMode::Over: blendVectors<BlendMode::Over>(target, layer, opacity); break;
+	case BlendMode::Alpha: blendVectors<BlendMode::Alpha>(target, layer, opacity); break;
+	case BlendMode::Additive: blendVectors<BlendMode::Additive>(target, layer, opacity); break;
+	case BlendMode::Multiply: blendVectors<BlendMode::Multiply>(target, layer, opacity); break;
+	case BlendMode::Max: blendVectors<BlendMode::Max>(target, layer, opacity); break;
+	}
+}
+#endif
+
+Compositor::Isa Compositor::bestIsa()
+{
+	if (isSupported(Isa::Avx2)) {
+		return Isa::Avx2;
+	}
+	return isSupported(Isa::Sse2) ? Isa::Sse2 : Isa::Scalar;
+}
+
+bool Compositor::isSupported(Isa isa)
+{
+	switch (isa) {
+	case Isa::Scalar:
+		return true;
+	case Isa::Sse2:
+#ifdef CORSAIR_COMPOSITOR_SSE2
+		return true;
+#else
+		return false;
+#endif
+	case Isa::Avx2:
+		return cpuHasAvx2();
+	}
+	return false;
+}
+
+const char* Compositor::isaName(Isa isa)
+{
+	switch (isa) {
+	case Isa::Sse2: return "sse2";
+	case Isa::Avx2: return "avx2";
+	default: return "scalar";
+	}
+}
+
+Compositor::Compositor(Isa isa)
+	: mIsa(isSupported(isa) ? isa : Isa::Scalar), mKernel(&compositor::blendScalar)
+{
+	switch (mIsa) {
+#ifdef CORSAIR_COMPOSITOR_SSE2
+	case Isa::Sse2:
+		mKernel = &compositor::blendSse2;
+		break;
+#endif
+#ifdef CORSAIR_COMPOSITOR_AVX2
+	case Isa::Avx2:
+		mKernel = &compositor::blendAvx2;
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
+void Compositor::blend(Framebuffer &target, const Framebuffer &layer, BlendMode mode, uint8_t opacity) const
+{
+	if (!opacity) {
+		return;
+	}
+	mKernel(target, layer, mode, opacity);
+	const auto layerMask = layer.activeMask();
+	auto targetMask = target.activeMask();
+	for (auto word = 0; word < Framebuffer::cMaskWords; ++word) {
+		targetMask[word] |= layerMask[word];
+	}
+}
+
+void Compositor::composite(Framebuffer &target, const CompositeLayer *layers, int count) const
+{
+	target.clear();
+	for (auto i = 0; i < count; ++i) {
+		if (layers[i].frame) {
+			blend(target, *layers[i].frame, layers[i].mode, layers[i].opacity);
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Framebuffer.h"
+
+#include <cstdint>
+
+/// How a layer is combined with the layers below it.
+enum class BlendMode
+{
+	Over,     /**< Active LEDs of the layer replace what is below, the alpha plane is ignored */
+	Alpha,    /**< Source-over blending weighted by the alpha plane of the layer */
+	Additive, /**< Channels are added, saturating at 255 */
+	Multiply, /**< Channels are multiplied (255 is identity), darkening what is below */
+	Max       /**< Brightest channel wins */
+};
+
+/// One entry of the stack passed to Compositor::composite().
+struct CompositeLayer
+{
+	const Framebuffer *frame; /**< Colors of the layer; only its active LEDs take part */
+	BlendMode mode;
+	uint8_t opacity;          /**< Opacity of the whole layer, 255 is fully opaque */
+};
+
+/**
+ * @brief Blends framebuffers on top of each other, e.g. the background, combo, hit burst and HP bar layers.
+ *
+ * Every mode is computed as lerp(below, mode(below, layer), coverage) per channel, where coverage is the
+ * layer opacity (times the alpha plane for BlendMode::Alpha) on active LEDs of the layer and zero elsewhere.
+ * The alpha plane of the target accumulates coverage the same way (source-over), and LEDs active in any
+ * layer become active in the target.
+ *
+ * Kernels exist for SSE2 and AVX2 besides the plain C++ one; the best one supported by the CPU is picked
+ * at run time. All of them produce bit-identical results.
+ */
+class Compositor
+{
+public:
+	enum class Isa
+	{
+		Scalar,
+		Sse2,
+		Avx2
+	};
+
+	/// Most capable instruction set supported by both the build and the CPU.
+	static Isa bestIsa();
+	static bool isSupported(Isa isa);
+	static const char* isaName(Isa isa);
+
+	/// Uses kernels for specified instruction set, or the scalar ones if it is not supported.
+	explicit Compositor(Isa isa = bestIsa());
+
+	Isa isa() const { return mIsa; }
+
+	/// Blends layer into target.
+	void blend(Framebuffer &target, const Framebuffer &layer, BlendMode mode, uint8_t opacity = 255) const;
+
+	/// Clears target and blends count layers into it, the first one being the bottom layer.
+	void composite(Framebuffer &target, const CompositeLayer *layers, int count) const;
+
+	/// Signature of the per-instruction-set kernels; they blend colors and alpha but leave the active mask alone.
+	using Kernel = void (*)(Framebuffer &target, const Framebuffer &layer, BlendMode mode, uint8_t opacity);
+
+private:
+	Isa mIsa;
+	Kernel mKernel;
+};
@@ -0,0 +1,119 @@
+// Compiled with AVX2 code generation enabled (-mavx2); only reached through Compositor once the CPU reported AVX2.
+#include "CompositorKernels.h"
+
+#ifdef CORSAIR_COMPOSITOR_AVX2
+#include <immintrin.h>
+
+namespace
+{
+	const int cAvx2Width = 32;
+
+	/// 0xff for every LED whose bit is set in the 32 bits of mask.
+	__m256i expandMask(uint32_t bits)
+	{
+		const auto bitOfByte = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+			1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+		const auto bytes = _mm256_set_epi64x(
+			static_cast<long long>((bits >> 24 & 0xff) * 0x0101010101010101ull),
+			static_cast<long long>((bits >> 16 & 0xff) * 0x0101010101010101ull),
+			static_cast<long long>((bits >> 8 & 0xff) * 0x0101010101010101ull),
+			static_cast<long long>((bits & 0xff) * 0x0101010101010101ull));
+		return _mm256_cmpeq_epi8(_mm256_and_si256(bytes, bitOfByte), bitOfByte);
+	}
+
+	/// Rounded x / 255 of sixteen 16-bit lanes holding [0..255 * 255].
+	__m256i div255(__m256i x)
+	{
+		x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+		return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+	}
+
+	__m256i lerpHalf(__m256i below, __m256i blended, __m256i coverage)
+	{
+		const auto inverse = _mm256_sub_epi16(_mm256_set1_epi16(255), coverage);
+		return div255(_mm256_add_epi16(_mm256_mullo_epi16(below, inverse), _mm256_mullo_epi16(blended, coverage)));
+	}
+
+	// Unpacking and packing both work within 128-bit lanes, so the byte order survives the round trip.
+	__m256i lerp(__m256i below, __m256i blended, __m256i coverage)
+	{
+		const auto zero = _mm256_setzero_si256();
+		const auto low = lerpHalf(_mm256_unpacklo_epi8(below, zero), _mm256_unpacklo_epi8(blended, zero), _mm256_unpacklo_epi8(coverage, zero));
+		const auto high = lerpHalf(_mm256_unpackhi_epi8(below, zero), _mm256_unpackhi_epi8(blended, zero), _mm256_unpackhi_epi8(coverage, zero));
+		return _mm256_packus_epi16(low, high);
+	}
+
+	__m256i multiply(__m256i a, __m256i b)
+	{
+		const auto zero = _mm256_setzero_si256();
+		const auto low = div255(_mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)));
+		const auto high = div255(_mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)));
+		return _mm256_packus_epi16(low, high);
+	}
+
+	template <BlendMode Mode>
+	__m256i apply(__m256i below, __m256i layer)
+	{
+		switch (Mode) {
+		case BlendMode::Additive: return _mm256_adds_epu8(below, layer);
+		case BlendMode::Multiply: return multiply(below, layer);
+		case BlendMode::Max: return _mm256_max_epu8(below, layer);
+		default: return layer;
+		}
+	}
+
+	template <BlendMode Mode, bool Opaque>
+	void blendBlocks(Framebuffer &target, const Framebuffer &layer, uint8_t opacity)
+	{
+		uint8_t *below[] = { target.red(), target.green(), target.blue(), target.alpha() };
+		const uint8_t *above[] = { layer.red(), layer.green(), layer.blue() };
+		const auto mask = layer.activeMask();
+		const auto opacityBytes = _mm256_set1_epi8(static_cast<char>(opacity));
+		for (auto offset = 0; offset < Framebuffer::cCapacity; offset += cAvx2Width) {
+			const auto bits = static_cast<uint32_t>(mask[offset >> 6] >> (offset & 63));
+			if (!bits) {
+				continue;
+			}
+			const auto active = expandMask(bits);
+			auto coverage = active;
+			if (Mode == BlendMode::Alpha) {
+				const auto alpha = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(layer.alpha() + offset));
+				coverage = _mm256_and_si256(multiply(alpha, opacityBytes), active);
+			} else if (!Opaque) {
+				coverage = _mm256_and_si256(opacityBytes, active);
+			}
+
+			for (auto plane = 0; plane < 3; ++plane) {
+				const auto destination = reinterpret_cast<__m256i*>(below[plane] + offset);
+				const auto color = _mm256_loadu_si256(destination);
+				const auto blended = apply<Mode>(color, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above[plane] + offset)));
+				_mm256_storeu_si256(destination, Opaque ? _mm256_blendv_epi8(color, blended, active) : lerp(color, blended, coverage));
+			}
+			const auto destination = reinterpret_cast<__m256i*>(below[3] + offset);
+			const auto alpha = _mm256_loadu_si256(destination);
+			_mm256_storeu_si256(destination, Opaque ? _mm256_or_si256(alpha, active) : lerp(alpha, _mm256_set1_epi8(-1), coverage));
+		}
+	}
+
+	template <BlendMode Mode>
+	void blendVectors(Framebuffer &target, const Framebuffer &layer, uint8_t opacity)
+	{
+		if (Mode != BlendMode::Alpha && opacity == 255) {
+			blendBlocks<Mode, true>(target, layer, opacity);
+		} else {
+			blendBlocks<Mode, false>(target, layer, opacity);
+		}
+	}
+}
+
+void compositor::blendAvx2(Framebuffer &target, const Framebuffer &layer, BlendMode mode, uint8_t opacity)
+{
+	switch (mode) {
+	case BlendMode::Over: blendVectors<BlendMode::Over>(target, layer, opacity); break;
+	case BlendMode::Alpha: blendVectors<BlendMode::Alpha>(target, layer, opacity); break;
+	case BlendMode::Additive: blendVectors<BlendMode::Additive>(target, layer, opacity); break;
+	case BlendMode::Multiply: blendVectors<BlendMode::Multiply>(target, layer, opacity); break;
+	case BlendMode::Max: blendVectors<BlendMode::Max>(target, layer, opacity); break;
+	}
+}
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Compositor.h"
+
+// Kernels behind Compositor, one per instruction set. Each lives in a translation unit compiled for
+// its instruction set, so none of them may be called before Compositor::isSupported() said so.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CORSAIR_COMPOSITOR_SSE2 1
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CORSAIR_COMPOSITOR_AVX2 1
+#endif
+
+namespace compositor
+{
+	/// Rounded x / 255 for x in [0..255 * 255], the same formula the vector kernels use.
+	inline int div255(int x)
+	{
+		x += 128;
+		return (x + (x >> 8)) >> 8;
+	}
+
+	void blendScalar(Framebuffer &target, const Framebuffer &layer, BlendMode mode, uint8_t opacity);
+#ifdef CORSAIR_COMPOSITOR_SSE2
+	void blendSse2(Framebuffer &target, const Framebuffer &layer, BlendMode mode, uint8_t opacity);
+#endif
+#ifdef CORSAIR_COMPOSITOR_AVX2
+	void blendAvx2(Framebuffer &target, const Framebuffer &layer, BlendMode mode, uint8_t opacity);
+#endif
+}
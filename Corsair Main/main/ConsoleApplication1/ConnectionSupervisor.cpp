@@ -0,0 +1,124 @@
+#include "ConnectionSupervisor.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+ConnectionSupervisor::ConnectionSupervisor(DeviceManager &devices, std::chrono::milliseconds initialBackoff, std::chrono::milliseconds maxBackoff)
+	: mDevices(devices),
+	mInitialBackoff(std::max(initialBackoff, std::chrono::milliseconds(1))),
+	mMaxBackoff(std::max(maxBackoff, mInitialBackoff)),
+	mBackoff(mInitialBackoff),
+	mConnected(false),
+	mRecovering(false),
+	mRevalidate(true),
+	mLastError(CE_Success),
+	mFailedSubmissions(0),
+	mStats()
+{
+}
+
+bool ConnectionSupervisor::connect()
+{
+	mConnected = false;
+	mRecovering = false;
+	mRevalidate = true;
+	mBackoff = mInitialBackoff;
+	return reconnect();
+}
+
+bool ConnectionSupervisor::submitAsync(const Framebuffer &frame)
+{
+	if (!poll()) {
+		mDevices.route(frame);
+		++mStats.droppedFrames;
+		return false;
+	}
+	if (mDevices.submitAsync(frame)) {
+		return true;
+	}
+	// Rejected right away: the frame is routed already, so a successful retry replays it.
+	lose();
+	return reconnect();
+}
+
+bool ConnectionSupervisor::poll()
+{
+	if (mConnected) {
+		if (mDevices.stats().failedSubmissions == mFailedSubmissions) {
+			return true;
+		}
+		lose();
+	}
+	if (Clock::now() < mNextAttempt) {
+		return false;
+	}
+	return reconnect();
+}
+
+bool ConnectionSupervisor::reconnect()
+{
+	CORSAIR_PROFILE_SCOPE("ConnectionSupervisor::reconnect");
+	++mStats.attempts;
+	auto handshake = false;
+	// Another client taking control keeps our session, only a server that went away needs a new handshake.
+	if (!CorsairRequestControl(CAM_ExclusiveLightingControl)) {
+		const auto error = CorsairGetLastError();
+		if (error != CE_ServerNotFound && error != CE_ProtocolHandshakeMissing) {
+			return fail(error);
+		}
+		{
+			CORSAIR_PROFILE_SCOPE("CorsairPerformProtocolHandshake");
+			CorsairPerformProtocolHandshake();
+		}
+		if (const auto handshakeError = CorsairGetLastError()) {
+			return fail(handshakeError);
+		}
+		++mStats.handshakes;
+		if (!CorsairRequestControl(CAM_ExclusiveLightingControl)) {
+			return fail(CorsairGetLastError());
+		}
+		handshake = true;
+	}
+	// Devices may have been plugged in, unplugged or switched to another layout while CUE was away, or
+	// since the devices were cached.
+	if ((handshake || mRevalidate || !mDevices.deviceCount()) && !mDevices.revalidate()) {
+		const auto last = mDevices.lastFrame();
+		if (!mDevices.enumerate()) {
+			return fail(CorsairGetLastError());
+		}
+		mDevices.route(last);
+		mStats.reenumerations += mRecovering ? 1 : 0;
+	}
+
+	mConnected = true;
+	mRevalidate = false;
+	mLastError = CE_Success;
+	mBackoff = mInitialBackoff;
+	mFailedSubmissions = mDevices.stats().failedSubmissions;
+	if (mRecovering) {
+		mRecovering = false;
+		mDevices.invalidate();
+		mDevices.submitAsync();
+		mRecoveryTime.record(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - mLostAt).count());
+	}
+	return true;
+}
+
+bool ConnectionSupervisor::fail(CorsairError error)
+{
+	mLastError = error;
+	mNextAttempt = Clock::now() + mBackoff;
+	mBackoff = std::min(mBackoff * 2, mMaxBackoff);
+	return false;
+}
+
+void ConnectionSupervisor::lose()
+{
+	mConnected = false;
+	mRecovering = true;
+	mLostAt = Clock::now();
+	mNextAttempt = mLostAt;
+	++mStats.disconnects;
+	// Frames still in flight fail as well, however late their acknowledgements they must not count as a new failure.
+	mDevices.newConnection();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "DeviceManager.h"
+#include "Framebuffer.h"
+#include "LatencyHistogram.h"
+
+#include <chrono>
+#include <cstdint>
+
+/// Contains counters collected by ConnectionSupervisor.
+struct ConnectionStats
+{
+	int64_t disconnects;     /**< Number of times a failed submission started a recovery */
+	int64_t attempts;        /**< Number of connection attempts, the first connect() included */
+	int64_t handshakes;      /**< Number of successful protocol handshakes, more than one means CUE restarted */
+	int64_t reenumerations;  /**< Number of recoveries that found the devices changed and enumerated them again */
+	int64_t droppedFrames;   /**< Number of frames routed to the devices but not submitted while disconnected */
+};
+
+/**
+ * @brief Keeps the connection to CUE alive around a DeviceManager.
+ *
+ * Any failed submission, rejected or reported through an async acknowledgement, marks the connection
+ * lost. Recovery first requests exclusive control again, which is all it takes when another client took
+ * it (CE_NoControl). If CUE is gone (CE_ServerNotFound) or restarted (CE_ProtocolHandshakeMissing) it
+ * performs the handshake again, with the retries backing off from initialBackoff up to maxBackoff.
+ *
+ * connect() and every reconnect after a handshake revalidate the devices instead of enumerating them
+ * again, so devices loaded from a cache are checked once connected. After a recovery the colors last
+ * routed to the devices are submitted in full right away, so the lighting comes back without waiting for
+ * the effect to change every LED. Frames submitted while disconnected are routed but not sent, so that
+ * replay shows the latest frame. The time from noticing the failure to the replay is recorded.
+ * Acknowledgements of frames sent before the connection was lost are not counted as failures of the next.
+ *
+ * Meant to be used from the rendering thread, like DeviceManager.
+ */
+class ConnectionSupervisor
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit ConnectionSupervisor(DeviceManager &devices, std::chrono::milliseconds initialBackoff = std::chrono::milliseconds(20),
+		std::chrono::milliseconds maxBackoff = std::chrono::milliseconds(2000));
+
+	ConnectionSupervisor(const ConnectionSupervisor&) = delete;
+	ConnectionSupervisor& operator=(const ConnectionSupervisor&) = delete;
+
+	/**
+	 * @brief Performs the handshake, requests exclusive control and enumerates the devices.
+	 *
+	 * Devices already enumerated or loaded from a cache are revalidated instead, and only enumerated if
+	 * they changed. Returns false if one of the steps failed, poll() and submitAsync() then keep retrying.
+	 */
+	bool connect();
+
+	/// Submits the frame through the devices if connected, otherwise routes it and retries once the backoff elapsed.
+	bool submitAsync(const Framebuffer &frame);
+
+	/// Checks the device outputs for failures and retries connecting once the backoff elapsed. Returns true if connected.
+	bool poll();
+
+	bool isConnected() const { return mConnected; }
+	/// Error of the last failed connection attempt, CE_Success once connected.
+	CorsairError lastError() const { return mLastError; }
+	/// Delay before the next attempt after another failure.
+	std::chrono::milliseconds backoff() const { return mBackoff; }
+
+	const ConnectionStats& stats() const { return mStats; }
+	/// From noticing a failed submission to submitting the last frame again, in microseconds.
+	const LatencyHistogram& recoveryTime() const { return mRecoveryTime; }
+
+private:
+	/// Makes one attempt to get the connection back. Returns false and schedules the next one on failure.
+	bool reconnect();
+	bool fail(CorsairError error);
+	void lose();
+
+	DeviceManager &mDevices;
+	std::chrono::milliseconds mInitialBackoff;
+	std::chrono::milliseconds mMaxBackoff;
+	std::chrono::milliseconds mBackoff;
+	bool mConnected;
+	bool mRecovering;          /**< Lost a working connection, as opposed to not having one yet */
+	bool mRevalidate;          /**< Devices have not been checked since connect(), e.g. loaded from a cache */
+	CorsairError mLastError;
+	Clock::time_point mLostAt;
+	Clock::time_point mNextAttempt;
+	int64_t mFailedSubmissions; /**< Failures of the device outputs already accounted for */
+	ConnectionStats mStats;
+	LatencyHistogram mRecoveryTime;
+};
@@ -0,0 +1,211 @@
+#include "DeltaOutput.h"
+#include "Profiler.h"
+
+#include <chrono>
+
+DeltaOutput::DeltaOutput(int fullRefreshInterval, int maxInFlight)
+	: mFullRefreshInterval(0),
+	mFramesSinceRefresh(0),
+	mInvalidated(true),
+	mFailedSubmissions(0),
+	mTrace(nullptr),
+	mMetrics(nullptr),
+	mPipeline(maxInFlight)
+{
+	mPipeline.setCompletionHandler(&DeltaOutput::onPipelineCompleted, this);
+	setFullRefreshInterval(fullRefreshInterval);
+	mStaging.reserve(Framebuffer::cCapacity);
+	resetStats();
+}
+
+void DeltaOutput::setMetrics(DeviceMetrics *metrics)
+{
+	mMetrics.store(metrics, std::memory_order_relaxed);
+	mPipeline.setMetrics(metrics);
+}
+
+void DeltaOutput::invalidate()
+{
+	mInvalidated.store(true, std::memory_order_release);
+}
+
+bool DeltaOutput::submit(int size, const CorsairLedColor *ledsColors)
+{
+	return send(stage(size, ledsColors), false);
+}
+
+bool DeltaOutput::submitAsync(int size, const CorsairLedColor *ledsColors)
+{
+	return send(stage(size, ledsColors), true);
+}
+
+bool DeltaOutput::submit(const Framebuffer &frame)
+{
+	return send(stage(frame), false);
+}
+
+bool DeltaOutput::submitAsync(const Framebuffer &frame)
+{
+	return send(stage(frame), true);
+}
+
+DeltaOutputStats DeltaOutput::stats() const
+{
+	auto stats = mStats;
+	stats.failedSubmissions = mFailedSubmissions.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void DeltaOutput::resetStats()
+{
+	mStats = DeltaOutputStats();
+	mFailedSubmissions.store(0, std::memory_order_relaxed);
+}
+
+void DeltaOutput::onPipelineCompleted(void *context, int size, const CorsairLedColor *ledsColors, bool result, bool current)
+{
+	static_cast<DeltaOutput*>(context)->complete(size, ledsColors, result, current);
+}
+
+bool DeltaOutput::beginFrame()
+{
+	mStats.frames++;
+	mFramesSinceRefresh++;
+
+	auto full = mInvalidated.exchange(false, std::memory_order_acq_rel);
+	if (mFullRefreshInterval && mFramesSinceRefresh >= mFullRefreshInterval) {
+		full = true;
+	}
+	if (full) {
+		mStats.fullRefreshes++;
+		mFramesSinceRefresh = 0;
+	}
+	mStaging.clear();
+	return full;
+}
+
+int DeltaOutput::endFrame(int size)
+{
+	const auto count = static_cast<int>(mStaging.size());
+	mStats.submittedLeds += count;
+	mStats.suppressedLeds += size - count;
+	if (!count) {
+		mStats.skippedFrames++;
+	}
+	return count;
+}
+
+int DeltaOutput::stage(int size, const CorsairLedColor *ledsColors)
+{
+	CORSAIR_PROFILE_SCOPE("DeltaOutput::stage");
+	const auto full = beginFrame();
+	std::lock_guard<std::mutex> lock(mShadowMutex);
+	for (auto i = 0; i < size; ++i) {
+		const auto &ledColor = ledsColors[i];
+		const auto ledId = ledColor.ledId;
+		if (ledId <= CLI_Invalid || ledId > CLI_Last) {
+			// Not something the shadow can track, leave it to the SDK.
+			mStaging.push_back(ledColor);
+			continue;
+		}
+		if (!full && isUnchanged(ledId, ledColor.r, ledColor.g, ledColor.b)) {
+			continue;
+		}
+		mOutstanding.set(ledId, static_cast<uint8_t>(ledColor.r), static_cast<uint8_t>(ledColor.g), static_cast<uint8_t>(ledColor.b));
+		mStaging.push_back(ledColor);
+	}
+	return endFrame(size);
+}
+
+int DeltaOutput::stage(const Framebuffer &frame)
+{
+	CORSAIR_PROFILE_SCOPE("DeltaOutput::stage");
+	const auto full = beginFrame();
+	const auto frameRed = frame.red();
+	const auto frameGreen = frame.green();
+	const auto frameBlue = frame.blue();
+	auto size = 0;
+	std::lock_guard<std::mutex> lock(mShadowMutex);
+	frame.forEachActive([&](CorsairLedId ledId) {
+		size++;
+		if (!full && isUnchanged(ledId, frameRed[ledId], frameGreen[ledId], frameBlue[ledId])) {
+			return;
+		}
+		mOutstanding.set(ledId, frameRed[ledId], frameGreen[ledId], frameBlue[ledId]);
+		mStaging.push_back(CorsairLedColor{ ledId, frameRed[ledId], frameGreen[ledId], frameBlue[ledId] });
+	});
+	return endFrame(size);
+}
+
+bool DeltaOutput::isUnchanged(CorsairLedId ledId, int r, int g, int b) const
+{
+	// The LED is going to show its outstanding color, if any, once the SDK gets to it.
+	const auto &known = mOutstanding.isActive(ledId) ? mOutstanding : mShadow;
+	return known.isActive(ledId) && known.red()[ledId] == r && known.green()[ledId] == g && known.blue()[ledId] == b;
+}
+
+bool DeltaOutput::send(int count, bool async)
+{
+	if (mTrace) {
+		const auto now = std::chrono::steady_clock::now().time_since_epoch();
+		mTrace->writeFrame(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), count, mStaging.data(), async);
+	}
+	if (!count) {
+		return true;
+	}
+	if (async) {
+		// The pipeline copies the LEDs and reports their outcome through onPipelineCompleted().
+		return mPipeline.submit(count, mStaging.data());
+	}
+	CORSAIR_PROFILE_SCOPE("CorsairSetLedsColors");
+	const auto metrics = mMetrics.load(std::memory_order_relaxed);
+	const auto start = metrics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+	const auto result = CorsairSetLedsColors(count, mStaging.data());
+	if (metrics) {
+		metrics->setLedsColors.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+		if (result) {
+			metrics->ledsSent.add(count);
+		}
+	}
+	complete(count, mStaging.data(), result, true);
+	return result;
+}
+
+void DeltaOutput::complete(int size, const CorsairLedColor *ledsColors, bool result, bool current)
+{
+	{
+		std::lock_guard<std::mutex> lock(mShadowMutex);
+		for (auto i = 0; i < size; ++i) {
+			const auto &ledColor = ledsColors[i];
+			const auto ledId = ledColor.ledId;
+			if (ledId <= CLI_Invalid || ledId > CLI_Last) {
+				continue;
+			}
+			const auto red = static_cast<uint8_t>(ledColor.r);
+			const auto green = static_cast<uint8_t>(ledColor.g);
+			const auto blue = static_cast<uint8_t>(ledColor.b);
+			// A newer color handed over after this one stays outstanding until its own acknowledgement.
+			if (mOutstanding.isActive(ledId) && mOutstanding.red()[ledId] == red && mOutstanding.green()[ledId] == green
+				&& mOutstanding.blue()[ledId] == blue) {
+				mOutstanding.deactivate(ledId);
+			}
+			if (result) {
+				mShadow.set(ledId, red, green, blue);
+			} else {
+				mShadow.deactivate(ledId);
+			}
+		}
+	}
+	if (!result && current) {
+		onFailure();
+	}
+}
+
+void DeltaOutput::onFailure()
+{
+	mFailedSubmissions.fetch_add(1, std::memory_order_relaxed);
+	if (const auto metrics = mMetrics.load(std::memory_order_relaxed)) {
+		metrics->submissionsFailed.add();
+	}
+	invalidate();
+}
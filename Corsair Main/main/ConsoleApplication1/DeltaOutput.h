@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "FrameTrace.h"
+#include "Framebuffer.h"
+#include "Metrics.h"
+#include "SubmitPipeline.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/// Contains counters collected by DeltaOutput.
+struct DeltaOutputStats
+{
+	int64_t frames;            /**< Number of frames passed to submit() or submitAsync() */
+	int64_t fullRefreshes;     /**< Number of frames sent in full because of the refresh interval or an invalidation */
+	int64_t skippedFrames;     /**< Number of frames not sent at all because no LED changed */
+	int64_t submittedLeds;     /**< Number of LEDs handed to the SDK */
+	int64_t suppressedLeds;    /**< Number of LEDs dropped because their color was already on the device */
+	int64_t failedSubmissions; /**< Number of SDK calls (or async completions) that reported an error */
+};
+
+/**
+ * @brief Shadow of the device state that forwards only LEDs whose color changed since the previous push.
+ *
+ * Every outgoing frame is diffed against the colors last handed to the SDK and only the differing
+ * LEDs are submitted; a frame without changes does not reach the SDK at all. The shadow only takes a
+ * color once the SDK acknowledged it; until then the LED is outstanding, so a frame lost on the way is
+ * sent again rather than taken for shown. As a safety net every fullRefreshInterval-th frame is
+ * submitted in full, and any failed submission invalidates the shadow so the next frame is submitted in
+ * full as well.
+ *
+ * Asynchronous submissions go through a SubmitPipeline, which bounds the number of frames in flight and
+ * merges frames while the SDK is behind; merged frames still carry every changed LED.
+ *
+ * submit() and submitAsync() are meant to be called from a single thread, async completions may
+ * arrive on any thread.
+ */
+class DeltaOutput
+{
+public:
+	static const int cDefaultFullRefreshInterval = 120;
+
+	explicit DeltaOutput(int fullRefreshInterval = cDefaultFullRefreshInterval, int maxInFlight = SubmitPipeline::cDefaultMaxInFlight);
+
+	DeltaOutput(const DeltaOutput&) = delete;
+	DeltaOutput& operator=(const DeltaOutput&) = delete;
+
+	/// Sets every how many frames the whole frame is submitted regardless of the shadow. Zero disables full refreshes.
+	void setFullRefreshInterval(int frames) { mFullRefreshInterval = frames > 0 ? frames : 0; }
+	int fullRefreshInterval() const { return mFullRefreshInterval; }
+
+	/**
+	 * @brief Records every frame to trace as it is handed to the SDK, nullptr stops recording.
+	 *
+	 * Frames without changes are recorded as well, so the trace keeps the frame timing. The writer has to
+	 * outlive its use here. Frames are only encoded on the submitting thread, the file is written on the
+	 * writer's own thread.
+	 */
+	void setTrace(FrameTraceWriter *trace) { mTrace = trace; }
+
+	/// Records SDK calls, LEDs sent and failed submissions to metrics, nullptr stops recording. metrics has to outlive its use here.
+	void setMetrics(DeviceMetrics *metrics);
+
+	/// Forgets the device state, e.g. after reconnecting to CUE, so the next frame is submitted in full.
+	void invalidate();
+
+	/// Failures of frames in flight no longer count once the connection to CUE is lost, see SubmitPipeline::newConnection().
+	void newConnection() { mPipeline.newConnection(); }
+
+	/// Submits changed LEDs through CorsairSetLedsColors(). Returns false if the SDK call failed.
+	bool submit(int size, const CorsairLedColor *ledsColors);
+
+	/// Submits changed LEDs through the async pipeline. Returns false if the request was rejected.
+	bool submitAsync(int size, const CorsairLedColor *ledsColors);
+
+	/// Same as submit() for the active LEDs of a framebuffer, diffed plane by plane without an intermediate array.
+	bool submit(const Framebuffer &frame);
+	bool submitAsync(const Framebuffer &frame);
+
+	DeltaOutputStats stats() const;
+	void resetStats();
+
+	SubmitPipeline& pipeline() { return mPipeline; }
+	const SubmitPipeline& pipeline() const { return mPipeline; }
+
+private:
+	static void onPipelineCompleted(void *context, int size, const CorsairLedColor *ledsColors, bool result, bool current);
+
+	/// Fills the staging buffer with LEDs to send. Returns number of LEDs staged.
+	int stage(int size, const CorsairLedColor *ledsColors);
+	int stage(const Framebuffer &frame);
+	/// Whether the LED already shows, or is about to show, the color. mShadowMutex must be held.
+	bool isUnchanged(CorsairLedId ledId, int r, int g, int b) const;
+	/// Starts a frame, returns true if it has to be sent in full.
+	bool beginFrame();
+	int endFrame(int size);
+	bool send(int count, bool async);
+	/// Commits LEDs the SDK acknowledged to the shadow, or forgets them if result is false. Only current failures are counted.
+	void complete(int size, const CorsairLedColor *ledsColors, bool result, bool current);
+	void onFailure();
+
+	std::mutex mShadowMutex;                   /**< Guards mShadow and mOutstanding, acknowledgements arrive on the SDK callback thread */
+	Framebuffer mShadow;                       /**< Colors the SDK acknowledged, active for LEDs whose color is known */
+	Framebuffer mOutstanding;                  /**< Last color handed to the SDK and not acknowledged yet, active for such LEDs */
+	std::vector<CorsairLedColor> mStaging;
+	int mFullRefreshInterval;
+	int mFramesSinceRefresh;
+	std::atomic<bool> mInvalidated;
+	DeltaOutputStats mStats;
+	std::atomic<int64_t> mFailedSubmissions;
+	FrameTraceWriter *mTrace;
+	std::atomic<DeviceMetrics*> mMetrics;       /**< Atomic: failures are counted on the SDK callback thread too */
+	SubmitPipeline mPipeline;                  /**< Last member: once destroyed, acknowledgements no longer report to this object */
+};
@@ -0,0 +1,186 @@
+#include "DeviceCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	const char cMagic[4] = { 'C', 'L', 'D', 'C' };
+
+	uint32_t alignUp(size_t offset, size_t alignment)
+	{
+		return static_cast<uint32_t>((offset + alignment - 1) / alignment * alignment);
+	}
+
+	/// Entry of a device without its positions, false for devices without lighting.
+	bool describe(int deviceIndex, DeviceCacheEntry &entry)
+	{
+		const auto info = CorsairGetDeviceInfo(deviceIndex);
+		if (!info || !(info->capsMask & CDC_Lighting)) {
+			return false;
+		}
+		entry = DeviceCacheEntry();
+		std::strncpy(entry.model, info->model ? info->model : "", DeviceCache::cMaxModelLength);
+		entry.index = deviceIndex;
+		entry.type = info->type;
+		entry.physicalLayout = info->physicalLayout;
+		entry.logicalLayout = info->logicalLayout;
+		return true;
+	}
+
+	/// Adds what identifies the device to the key, its positions left out: they follow from it.
+	void hashEntry(Md5 &hash, DeviceCacheEntry entry)
+	{
+		const auto modelLength = std::strlen(entry.model);
+		std::memset(entry.model + modelLength, 0, sizeof(entry.model) - modelLength);
+		entry.firstPosition = 0;
+		entry.positionCount = 0;
+		hash.update(&entry, sizeof(entry));
+	}
+}
+
+DeviceCache::DeviceCache()
+	: mHeader(nullptr),
+	mEntries(nullptr),
+	mPositions(nullptr),
+	mKeyLeds(nullptr)
+{
+}
+
+void DeviceCache::clear()
+{
+	mImage.clear();
+	mHeader = nullptr;
+	mEntries = nullptr;
+	mPositions = nullptr;
+	mKeyLeds = nullptr;
+}
+
+bool DeviceCache::capture()
+{
+	clear();
+	const auto sdkDeviceCount = CorsairGetDeviceCount();
+	std::vector<DeviceCacheEntry> entries;
+	std::vector<CorsairLedPosition> positions;
+	std::vector<int32_t> keyLeds;
+	for (auto deviceIndex = 0; deviceIndex < sdkDeviceCount; ++deviceIndex) {
+		DeviceCacheEntry entry;
+		if (!describe(deviceIndex, entry)) {
+			continue;
+		}
+		entry.firstPosition = static_cast<uint32_t>(positions.size());
+		if (entry.type == CDT_Keyboard && keyLeds.empty()) {
+			// The SDK resolves key names in the layout of the keyboard, one round trip each.
+			for (auto keyName = 0; keyName < cKeyNames; ++keyName) {
+				keyLeds.push_back(CorsairGetLedIdForKeyName(static_cast<char>(keyName)));
+			}
+		}
+		if (entry.type == CDT_Keyboard || entry.type == CDT_MouseMat) {
+			if (const auto ledPositions = CorsairGetLedPositionsByDeviceIndex(deviceIndex)) {
+				positions.insert(positions.end(), ledPositions->pLedPosition, ledPositions->pLedPosition + ledPositions->numberOfLed);
+			}
+		}
+		entry.positionCount = static_cast<uint32_t>(positions.size()) - entry.firstPosition;
+		entries.push_back(entry);
+	}
+	if (entries.empty()) {
+		return false;
+	}
+
+	DeviceCacheHeader header = DeviceCacheHeader();
+	std::memcpy(header.magic, cMagic, sizeof(cMagic));
+	header.version = cFormatVersion;
+	header.headerSize = sizeof(DeviceCacheHeader);
+	header.sdkDeviceCount = static_cast<uint32_t>(sdkDeviceCount);
+	header.deviceCount = static_cast<uint32_t>(entries.size());
+	header.deviceOffset = alignUp(sizeof(DeviceCacheHeader), alignof(DeviceCacheEntry));
+	header.positionCount = static_cast<uint32_t>(positions.size());
+	header.positionOffset = alignUp(header.deviceOffset + entries.size() * sizeof(DeviceCacheEntry), alignof(CorsairLedPosition));
+	const auto positionsEnd = header.positionOffset + positions.size() * sizeof(CorsairLedPosition);
+	header.keyLedOffset = keyLeds.empty() ? 0 : alignUp(positionsEnd, alignof(int32_t));
+
+	std::vector<uint8_t> image(keyLeds.empty() ? positionsEnd : header.keyLedOffset + keyLeds.size() * sizeof(int32_t), 0);
+	std::memcpy(image.data(), &header, sizeof(header));
+	std::memcpy(image.data() + header.deviceOffset, entries.data(), entries.size() * sizeof(DeviceCacheEntry));
+	if (!positions.empty()) {
+		std::memcpy(image.data() + header.positionOffset, positions.data(), positions.size() * sizeof(CorsairLedPosition));
+	}
+	if (!keyLeds.empty()) {
+		std::memcpy(image.data() + header.keyLedOffset, keyLeds.data(), keyLeds.size() * sizeof(int32_t));
+	}
+	mImage.assign(std::move(image));
+	return attach();
+}
+
+bool DeviceCache::open(const std::string &path)
+{
+	clear();
+	if (!mImage.open(path) || !attach()) {
+		clear();
+		return false;
+	}
+	return true;
+}
+
+bool DeviceCache::attach()
+{
+	const auto header = mImage.header<DeviceCacheHeader>(cMagic, cFormatVersion);
+	if (!header || !header->deviceCount) {
+		return false;
+	}
+	const auto entries = mImage.records<DeviceCacheEntry>(header->deviceOffset, header->deviceCount, sizeof(DeviceCacheHeader));
+	const auto positions = mImage.records<CorsairLedPosition>(header->positionOffset, header->positionCount, sizeof(DeviceCacheHeader));
+	const auto keyLeds = header->keyLedOffset ? mImage.records<int32_t>(header->keyLedOffset, cKeyNames, sizeof(DeviceCacheHeader)) : nullptr;
+	if (!entries || !positions || (header->keyLedOffset && !keyLeds)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < header->deviceCount; ++i) {
+		if (static_cast<uint64_t>(entries[i].firstPosition) + entries[i].positionCount > header->positionCount
+			|| !std::memchr(entries[i].model, 0, sizeof(entries[i].model))) {
+			return false;
+		}
+	}
+	mHeader = header;
+	mEntries = entries;
+	mPositions = positions;
+	mKeyLeds = keyLeds;
+	return true;
+}
+
+std::string DeviceCache::key() const
+{
+	Md5 hash;
+	const auto sdkDeviceCount = mHeader ? mHeader->sdkDeviceCount : 0;
+	hash.update(&sdkDeviceCount, sizeof(sdkDeviceCount));
+	for (auto i = 0; i < deviceCount(); ++i) {
+		hashEntry(hash, mEntries[i]);
+	}
+	uint8_t digest[Md5::cDigestSize];
+	hash.finish(digest);
+	return Md5::toHex(digest);
+}
+
+std::string DeviceCache::currentKey()
+{
+	Md5 hash;
+	const auto sdkDeviceCount = static_cast<uint32_t>(std::max(CorsairGetDeviceCount(), 0));
+	hash.update(&sdkDeviceCount, sizeof(sdkDeviceCount));
+	for (uint32_t deviceIndex = 0; deviceIndex < sdkDeviceCount; ++deviceIndex) {
+		DeviceCacheEntry entry;
+		if (describe(static_cast<int>(deviceIndex), entry)) {
+			hashEntry(hash, entry);
+		}
+	}
+	uint8_t digest[Md5::cDigestSize];
+	hash.finish(digest);
+	return Md5::toHex(digest);
+}
+
+CorsairLedPositions DeviceCache::positions(int index) const
+{
+	const auto &entry = mEntries[index];
+	// The SDK declares the array mutable, LedGeometry::load() only reads it.
+	return CorsairLedPositions{ static_cast<int>(entry.positionCount), const_cast<CorsairLedPosition*>(mPositions + entry.firstPosition) };
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "MappedImage.h"
+#include "Md5.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * Layout of a device cache, little endian as written by capture():
+ *   DeviceCacheHeader, then deviceCount DeviceCacheEntries at deviceOffset,
+ *   then positionCount CorsairLedPositions at positionOffset, the positions of each device in a row,
+ *   then, with a keyboard, DeviceCache::cKeyNames int32 LED ids at keyLedOffset indexed by key name.
+ */
+
+struct DeviceCacheHeader
+{
+	char magic[4];              /**< "CLDC" */
+	uint16_t version;           /**< DeviceCache::cFormatVersion */
+	uint16_t headerSize;        /**< sizeof(DeviceCacheHeader) */
+	uint32_t sdkDeviceCount;    /**< CorsairGetDeviceCount(), devices without lighting included */
+	uint32_t deviceCount;
+	uint32_t deviceOffset;
+	uint32_t positionCount;
+	uint32_t positionOffset;
+	uint32_t keyLedOffset;      /**< CorsairGetLedIdForKeyName() of every character for the first keyboard, 0 without one */
+};
+
+/// Lighting device as reported by CorsairGetDeviceInfo(), the key its LED positions depend on.
+struct DeviceCacheEntry
+{
+	char model[64];             /**< Null terminated, truncated to DeviceCache::cMaxModelLength */
+	int32_t index;              /**< Index for CorsairGetDeviceInfo() */
+	int32_t type;               /**< CorsairDeviceType */
+	int32_t physicalLayout;     /**< CorsairPhysicalLayout */
+	int32_t logicalLayout;      /**< CorsairLogicalLayout */
+	uint32_t firstPosition;
+	uint32_t positionCount;     /**< Zero for devices without LED positions (mice, headsets) */
+};
+
+/**
+ * @brief Devices, layouts and LED positions of a previous enumeration in a compact binary image.
+ *
+ * capture() asks the SDK for every lighting device and the LED positions of the keyboards and mousemats.
+ * With a keyboard it also resolves every key name in the keyboard's layout, for KeyLayoutTable::load().
+ * The image can be saved and opened again by mapping the file, so the next launch knows its devices
+ * and keys before the handshake is even done. A cache may be stale, DeviceManager::revalidate() tells
+ * once connected.
+ *
+ * key() identifies the set of devices with their models and layouts, so a machine switching between
+ * keyboards or layouts keeps a cache for each, see DeviceManager::setCacheDirectory().
+ */
+class DeviceCache
+{
+public:
+	static const uint16_t cFormatVersion = 2;
+	static const int cMaxModelLength = 63;
+	static const int cKeyNames = 256;
+
+	DeviceCache();
+
+	/// Builds the image from the SDK in memory. Returns false if no device has lighting.
+	bool capture();
+	/// Maps a saved cache. Returns false if it is missing, truncated, inconsistent or of another format version.
+	bool open(const std::string &path);
+	/// Saves the image for open() on the next launch, see MappedImage::save().
+	bool save(const std::string &path) const { return !empty() && mImage.save(path); }
+	void clear();
+
+	bool empty() const { return !mHeader; }
+	bool isMapped() const { return mImage.isMapped(); }
+	const DeviceCacheHeader& header() const { return *mHeader; }
+	int deviceCount() const { return mHeader ? static_cast<int>(mHeader->deviceCount) : 0; }
+	const DeviceCacheEntry& device(int index) const { return mEntries[index]; }
+	/// Positions of a device, in place. numberOfLed is 0 for devices without LED positions.
+	CorsairLedPositions positions(int index) const;
+	/// LED of every key name [0..cKeyNames) in the layout of the first keyboard, nullptr without a keyboard.
+	const int32_t* keyLeds() const { return mKeyLeds; }
+	size_t size() const { return mHeader ? mImage.size() : 0; }
+
+	/// MD5 in hex of the device count and the model, type and layouts of every device, empty caches included.
+	std::string key() const;
+	/// Same as key() for the devices CUE reports now, without asking for their LED positions.
+	static std::string currentKey();
+
+private:
+	/// Points the members into mImage if it holds a valid cache.
+	bool attach();
+
+	MappedImage mImage;
+	const DeviceCacheHeader *mHeader;
+	const DeviceCacheEntry *mEntries;
+	const CorsairLedPosition *mPositions;
+	const int32_t *mKeyLeds;
+};
@@ -0,0 +1,270 @@
+#include "DeviceManager.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+
+DeviceManager::Device::Device(int maxInFlight)
+	: index(0), type(CDT_Unknown), physicalLayout(CPL_Invalid), logicalLayout(CLL_Invalid), dirty(false), output(DeltaOutput::cDefaultFullRefreshInterval, maxInFlight)
+{
+}
+
+DeviceManager::DeviceManager(int maxInFlight)
+	: mMaxInFlight(maxInFlight), mBuilds(0), mTrace(nullptr), mMetrics(nullptr)
+{
+	std::fill(mDeviceOfLed, mDeviceOfLed + Framebuffer::cCapacity, static_cast<int8_t>(-1));
+}
+
+bool DeviceManager::enumerate()
+{
+	CORSAIR_PROFILE_SCOPE("DeviceManager::enumerate");
+	waitIdle(std::chrono::milliseconds(500));
+	if (mCacheDirectory.empty()) {
+		mCache.capture();
+		return build();
+	}
+
+	const auto key = DeviceCache::currentKey();
+	if (mCache.open(cachePathOf(key)) && build() && revalidate()) {
+		rememberLast(key);
+		return true;
+	}
+	mCache.capture();
+	if (!build()) {
+		return false;
+	}
+	MappedImage::makeDirectory(mCacheDirectory);
+	// Not being able to store the cache only costs the next launch the enumeration.
+	if (saveCache(cachePathOf(mCache.key()))) {
+		rememberLast(mCache.key());
+	}
+	return true;
+}
+
+bool DeviceManager::loadCache(const std::string &path)
+{
+	waitIdle(std::chrono::milliseconds(500));
+	mCache.open(path);
+	return build();
+}
+
+bool DeviceManager::loadLastCache()
+{
+	std::string key;
+	if (mCacheDirectory.empty() || !(std::ifstream(mCacheDirectory + "/last") >> key)) {
+		return false;
+	}
+	return loadCache(cachePathOf(key));
+}
+
+void DeviceManager::rememberLast(const std::string &key) const
+{
+	std::ofstream(mCacheDirectory + "/last", std::ios::trunc) << key << '\n';
+}
+
+bool DeviceManager::build()
+{
+	++mBuilds;
+	mDevices.clear();
+	std::fill(mDeviceOfLed, mDeviceOfLed + Framebuffer::cCapacity, static_cast<int8_t>(-1));
+
+	const auto count = std::min(mCache.deviceCount(), static_cast<int>(INT8_MAX));
+	for (auto i = 0; i < count; ++i) {
+		const auto &entry = mCache.device(i);
+		std::unique_ptr<Device> device(new Device(mMaxInFlight));
+		device->index = entry.index;
+		device->type = static_cast<CorsairDeviceType>(entry.type);
+		device->model = entry.model;
+		device->physicalLayout = static_cast<CorsairPhysicalLayout>(entry.physicalLayout);
+		device->logicalLayout = static_cast<CorsairLogicalLayout>(entry.logicalLayout);
+		device->output.setTrace(mTrace);
+		device->output.setMetrics(mMetrics ? &mMetrics->device(device->index, device->model) : nullptr);
+		switch (device->type) {
+		case CDT_Keyboard:
+		case CDT_MouseMat: {
+			const auto positions = mCache.positions(i);
+			if (device->geometry.load(&positions)) {
+				device->ledIds.assign(device->geometry.ledIds(), device->geometry.ledIds() + device->geometry.count());
+			}
+		} break;
+		case CDT_Mouse:
+			for (auto zone = 0; zone < device->physicalLayout - CPL_Zones1 + 1; ++zone) {
+				device->ledIds.push_back(static_cast<CorsairLedId>(CLM_1 + zone));
+			}
+			break;
+		case CDT_Headset:
+			device->ledIds.push_back(CLH_LeftLogo);
+			device->ledIds.push_back(CLH_RightLogo);
+			break;
+		default:
+			break;
+		}
+
+		// A LED reported by two devices stays with the first one.
+		device->ledIds.erase(std::remove_if(device->ledIds.begin(), device->ledIds.end(), [this](CorsairLedId ledId) {
+			return ledId <= CLI_Invalid || ledId > CLI_Last || mDeviceOfLed[ledId] >= 0;
+		}), device->ledIds.end());
+		if (device->ledIds.empty()) {
+			continue;
+		}
+		for (const auto ledId : device->ledIds) {
+			mDeviceOfLed[ledId] = static_cast<int8_t>(mDevices.size());
+			device->frame.activate(ledId);
+		}
+		// The device shows whatever it showed before, the first submission sets every LED.
+		device->dirty = true;
+		mDevices.push_back(std::move(device));
+	}
+	return !mDevices.empty();
+}
+
+bool DeviceManager::revalidate() const
+{
+	CORSAIR_PROFILE_SCOPE("DeviceManager::revalidate");
+	if (mDevices.empty() || CorsairGetDeviceCount() != static_cast<int>(mCache.header().sdkDeviceCount)) {
+		return false;
+	}
+	for (const auto &device : mDevices) {
+		const auto info = CorsairGetDeviceInfo(device->index);
+		if (!info || info->type != device->type || device->model != (info->model ? info->model : "")
+			|| info->physicalLayout != device->physicalLayout || info->logicalLayout != device->logicalLayout) {
+			return false;
+		}
+	}
+	return true;
+}
+
+Framebuffer DeviceManager::availableLeds() const
+{
+	Framebuffer frame;
+	for (const auto &device : mDevices) {
+		for (const auto ledId : device->ledIds) {
+			frame.activate(ledId);
+		}
+	}
+	return frame;
+}
+
+Framebuffer DeviceManager::lastFrame() const
+{
+	Framebuffer frame;
+	for (const auto &device : mDevices) {
+		for (const auto ledId : device->ledIds) {
+			frame.set(ledId, device->frame.red()[ledId], device->frame.green()[ledId], device->frame.blue()[ledId]);
+		}
+	}
+	return frame;
+}
+
+void DeviceManager::route(const Framebuffer &frame)
+{
+	CORSAIR_PROFILE_SCOPE("DeviceManager::route");
+	for (auto &device : mDevices) {
+		auto &target = device->frame;
+		auto changed = false;
+		for (const auto ledId : device->ledIds) {
+			if (!frame.isActive(ledId)) {
+				continue;
+			}
+			const auto r = frame.red()[ledId];
+			const auto g = frame.green()[ledId];
+			const auto b = frame.blue()[ledId];
+			if (target.red()[ledId] != r || target.green()[ledId] != g || target.blue()[ledId] != b) {
+				target.set(ledId, r, g, b);
+				changed = true;
+			}
+		}
+		device->dirty = device->dirty || changed;
+	}
+}
+
+bool DeviceManager::submitAsync()
+{
+	auto result = true;
+	for (auto &device : mDevices) {
+		if (device->dirty) {
+			device->dirty = false;
+			result = device->output.submitAsync(device->frame) && result;
+		}
+	}
+	return result;
+}
+
+bool DeviceManager::submitAsync(const Framebuffer &frame)
+{
+	route(frame);
+	return submitAsync();
+}
+
+void DeviceManager::invalidate()
+{
+	for (auto &device : mDevices) {
+		device->output.invalidate();
+		device->dirty = true;
+	}
+}
+
+void DeviceManager::newConnection()
+{
+	for (auto &device : mDevices) {
+		device->output.newConnection();
+	}
+}
+
+DeltaOutputStats DeviceManager::stats() const
+{
+	DeltaOutputStats total = DeltaOutputStats();
+	for (const auto &device : mDevices) {
+		const auto stats = device->output.stats();
+		total.frames += stats.frames;
+		total.fullRefreshes += stats.fullRefreshes;
+		total.skippedFrames += stats.skippedFrames;
+		total.submittedLeds += stats.submittedLeds;
+		total.suppressedLeds += stats.suppressedLeds;
+		total.failedSubmissions += stats.failedSubmissions;
+	}
+	return total;
+}
+
+void DeviceManager::setTrace(FrameTraceWriter *trace)
+{
+	mTrace = trace;
+	for (auto &device : mDevices) {
+		device->output.setTrace(trace);
+	}
+}
+
+void DeviceManager::setMetrics(FrameMetrics *metrics)
+{
+	mMetrics = metrics;
+	for (auto &device : mDevices) {
+		device->output.setMetrics(metrics ? &metrics->device(device->index, device->model) : nullptr);
+	}
+}
+
+bool DeviceManager::waitIdle(std::chrono::milliseconds timeout)
+{
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	auto idle = true;
+	for (auto &device : mDevices) {
+		const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+		idle = device->output.pipeline().waitIdle(std::max(left, std::chrono::milliseconds(0))) && idle;
+	}
+	return idle;
+}
+
+const char* DeviceManager::typeName(CorsairDeviceType type)
+{
+	switch (type) {
+	case CDT_Mouse:
+		return "mouse";
+	case CDT_Keyboard:
+		return "keyboard";
+	case CDT_Headset:
+		return "headset";
+	case CDT_MouseMat:
+		return "mousemat";
+	default:
+		return "unknown";
+	}
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "DeltaOutput.h"
+#include "DeviceCache.h"
+#include "Framebuffer.h"
+#include "LedGeometry.h"
+#include "SubmitPipeline.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Every lighting device CUE reports, each with its own framebuffer, dirty flag and output.
+ *
+ * Frames are rendered once for all devices and route() splits them by device, flagging the devices
+ * whose colors changed. submitAsync() then submits every dirty device through its own DeltaOutput, so
+ * each device has its own SubmitPipeline slots: a slow headset or mousemat fills and merges its own
+ * pending frames while keyboard frames keep going out, and latency is recorded per device.
+ *
+ * Meant to be used from a single thread, like DeltaOutput.
+ */
+class DeviceManager
+{
+public:
+	struct Device
+	{
+		explicit Device(int maxInFlight);
+
+		/// Holds Framebuffers, so is allocated with their alignment.
+		static void* operator new(size_t size) { return Framebuffer::operator new(size); }
+		static void operator delete(void *memory) { Framebuffer::operator delete(memory); }
+
+		int index;                     /**< Index for CorsairGetDeviceInfo() */
+		CorsairDeviceType type;
+		std::string model;
+		CorsairPhysicalLayout physicalLayout;
+		CorsairLogicalLayout logicalLayout;
+		std::vector<CorsairLedId> ledIds;
+		LedGeometry geometry;          /**< Empty for devices without LED positions (mice, headsets) */
+		Framebuffer frame;             /**< Colors last routed to the device */
+		bool dirty;                    /**< Colors changed since the last submission */
+		DeltaOutput output;
+	};
+
+	explicit DeviceManager(int maxInFlight = SubmitPipeline::cDefaultMaxInFlight);
+
+	DeviceManager(const DeviceManager&) = delete;
+	DeviceManager& operator=(const DeviceManager&) = delete;
+
+	/**
+	 * @brief Drops the devices and enumerates them again.
+	 *
+	 * LEDs come from CorsairGetLedPositionsByDeviceIndex() for keyboards and mousemats, from the zone count
+	 * for mice and are the two logos for headsets. Returns false if no device has LEDs.
+	 *
+	 * With a cache directory, devices seen before are loaded from their cache instead of asking for their
+	 * positions again, and new ones are saved to one.
+	 */
+	bool enumerate();
+
+	/**
+	 * @brief Keeps a cache per set of devices in directory, named after DeviceCache::key().
+	 *
+	 * A machine switching between keyboards, or a keyboard between layouts, then does not enumerate them
+	 * again every time. Empty disables the directory.
+	 */
+	void setCacheDirectory(const std::string &directory) { mCacheDirectory = directory; }
+	/// Path the cache of the devices with key is saved at in the cache directory.
+	std::string cachePathOf(const std::string &key) const { return mCacheDirectory + "/" + key + ".cldc"; }
+	/// loadCache() of the devices enumerated last in the cache directory.
+	bool loadLastCache();
+
+	/**
+	 * @brief Drops the devices and builds them from a cache saved by saveCache(), without calling the SDK.
+	 *
+	 * Lets effects be set up before the handshake is done; revalidate() once connected tells whether the
+	 * cache is still current. Returns false if the cache is missing, invalid or has no device with LEDs.
+	 */
+	bool loadCache(const std::string &path);
+	/// Saves the devices as last enumerated or loaded, so the next launch can loadCache() them.
+	bool saveCache(const std::string &path) const { return mCache.save(path); }
+	/// True while the devices come from a cache file, false once enumerated.
+	bool isCached() const { return mCache.isMapped(); }
+	/// Devices, positions and key names as last enumerated or loaded.
+	const DeviceCache& cache() const { return mCache; }
+	/// Number of times the devices were enumerated or loaded, to tell whether they changed since.
+	int64_t builds() const { return mBuilds; }
+
+	/**
+	 * @brief Checks that CUE still reports the devices as enumerated, e.g. after reconnecting to it.
+	 *
+	 * Compares the device count and the model and layouts of every device, which is all their LEDs and
+	 * positions depend on, without asking for the positions again. Returns false if enumerate() is needed.
+	 */
+	bool revalidate() const;
+
+	int deviceCount() const { return static_cast<int>(mDevices.size()); }
+	Device& device(int index) { return *mDevices[index]; }
+	const Device& device(int index) const { return *mDevices[index]; }
+
+	/// Index of the device the LED belongs to, or -1.
+	int deviceOf(CorsairLedId ledId) const
+	{
+		return ledId > CLI_Invalid && ledId < Framebuffer::cCapacity ? mDeviceOfLed[ledId] : -1;
+	}
+
+	/// Frame with every LED of every device active and black.
+	Framebuffer availableLeds() const;
+
+	/// Frame with every LED of every device active, in the colors last routed to it.
+	Framebuffer lastFrame() const;
+
+	/// Copies the active LEDs of frame to their devices, marking devices whose colors changed dirty.
+	void route(const Framebuffer &frame);
+
+	/// Submits every dirty device through its own pipeline. Returns false if the SDK rejected one of them.
+	bool submitAsync();
+	/// route() followed by submitAsync().
+	bool submitAsync(const Framebuffer &frame);
+
+	/// Forgets the state of every device, e.g. after reconnecting to CUE, so the next frames are submitted in full.
+	void invalidate();
+
+	/// Leaves frames in flight to the lost connection, so their failures do not count against the next one.
+	void newConnection();
+
+	/// Counters of every device output added up.
+	DeltaOutputStats stats() const;
+
+	/**
+	 * @brief Records every device submission to trace, nullptr stops recording.
+	 *
+	 * Each device records its own changed LEDs, devices without changes record nothing.
+	 */
+	void setTrace(FrameTraceWriter *trace);
+	/// Records the SDK calls of every device output to its FrameMetrics::device() metrics, nullptr stops recording.
+	void setMetrics(FrameMetrics *metrics);
+
+	/// Waits for every device pipeline to drain. Returns false on timeout.
+	bool waitIdle(std::chrono::milliseconds timeout);
+
+	static const char* typeName(CorsairDeviceType type);
+
+private:
+	/// Builds the devices from mCache.
+	bool build();
+	/// Remembers the cache at key as the one to load on the next launch.
+	void rememberLast(const std::string &key) const;
+
+	int mMaxInFlight;
+	DeviceCache mCache;            /**< Devices and LED positions as last enumerated or loaded */
+	std::string mCacheDirectory;
+	int64_t mBuilds;
+	FrameTraceWriter *mTrace;
+	FrameMetrics *mMetrics;
+	std::vector<std::unique_ptr<Device>> mDevices;
+	int8_t mDeviceOfLed[Framebuffer::cCapacity];
+};
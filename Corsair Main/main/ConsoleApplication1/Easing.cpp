@@ -0,0 +1,106 @@
+#include "Easing.h"
+
+#include <algorithm>
+
+namespace
+{
+	constexpr double cPi = 3.14159265358979323846;
+
+	/// sin(x) for x in [0..pi], from its Taylor series as std::sin is not constexpr.
+	constexpr double sine(double x)
+	{
+		x = x > cPi / 2 ? cPi - x : x;
+		const auto x2 = x * x;
+		return x * (1 - x2 / 6 * (1 - x2 / 20 * (1 - x2 / 42 * (1 - x2 / 72 * (1 - x2 / 110 * (1 - x2 / 156 * (1 - x2 / 210)))))));
+	}
+
+	/// Same bump as the CUELFX stand-in: sin^2 rising from 0 at start to 1 and back to 0 after length.
+	constexpr double bump(double time, double start, double length)
+	{
+		if (time < start || time >= start + length) {
+			return 0.;
+		}
+		const auto s = sine(cPi * (time - start) / length);
+		return s * s;
+	}
+
+	constexpr double evaluate(EasingCurve curve, double t)
+	{
+		const auto centered = 2 * t - 1;
+		const auto distance = centered < 0 ? -centered : centered;
+		switch (curve) {
+		case EasingCurve::Sine:
+			return sine(cPi * t);
+		case EasingCurve::Quad:
+			return 1 - distance * distance;
+		case EasingCurve::Cubic:
+			return 1 - distance * distance * distance;
+		case EasingCurve::Triangle:
+			return 1 - distance;
+		case EasingCurve::Pulse:
+			return t < .3 ? 1. : 0.;
+		case EasingCurve::Heartbeat: {
+			const auto first = bump(t * 1000, 0, 150);
+			const auto second = .6 * bump(t * 1000, 250, 150);
+			return first > second ? first : second;
+		}
+		default:
+			return bump(t, 0, 1);
+		}
+	}
+
+	struct Table
+	{
+		uint16_t values[Easing::cTableSize];
+
+		constexpr explicit Table(EasingCurve curve)
+			: values()
+		{
+			for (auto i = 0; i < Easing::cTableSize; ++i) {
+				const auto value = evaluate(curve, static_cast<double>(i) / Easing::cTableSize);
+				values[i] = static_cast<uint16_t>((value < 0 ? 0 : value > 1 ? 1 : value) * Easing::cOne + .5);
+			}
+		}
+	};
+
+	// One table per curve keeps every constant evaluation short enough for the compilers' step limits.
+	constexpr Table cSine(EasingCurve::Sine);
+	constexpr Table cQuad(EasingCurve::Quad);
+	constexpr Table cCubic(EasingCurve::Cubic);
+	constexpr Table cTriangle(EasingCurve::Triangle);
+	constexpr Table cPulse(EasingCurve::Pulse);
+	constexpr Table cHeartbeat(EasingCurve::Heartbeat);
+	constexpr Table cBreathe(EasingCurve::Breathe);
+
+	static_assert(cSine.values[Easing::cTableSize / 2] == Easing::cOne && cBreathe.values[Easing::cTableSize / 2] == Easing::cOne,
+		"Sine and breathe peak at half the period");
+	static_assert(cQuad.values[0] == 0 && cTriangle.values[Easing::cTableSize / 4] == Easing::cOne / 2 + 1, "Tables are sampled from the start of the period");
+}
+
+const uint16_t* Easing::table(EasingCurve curve)
+{
+	static const uint16_t *const tables[] = {
+		cSine.values, cQuad.values, cCubic.values, cTriangle.values, cPulse.values, cHeartbeat.values, cBreathe.values
+	};
+	return tables[static_cast<int>(curve)];
+}
+
+PhaseAccumulator::PhaseAccumulator(int periodMs)
+	: mPeriodMs(0), mStep(0), mPhase(0)
+{
+	setPeriod(periodMs);
+}
+
+void PhaseAccumulator::setPeriod(int periodMs)
+{
+	mPeriodMs = std::max(periodMs, 1);
+	// Rounded up so that a whole period of milliseconds always completes the period.
+	mStep = ((static_cast<uint64_t>(1) << 32) + mPeriodMs - 1) / static_cast<uint64_t>(mPeriodMs);
+}
+
+int PhaseAccumulator::advance(int elapsedMs)
+{
+	const auto next = mPhase + mStep * static_cast<uint64_t>(std::max(elapsedMs, 0));
+	mPhase = static_cast<uint32_t>(next);
+	return static_cast<int>(next >> 32);
+}
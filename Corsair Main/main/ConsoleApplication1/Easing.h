@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+/// Periodic intensity curves, each going from 0 at the start of its period and back to 0 at the end.
+enum class EasingCurve
+{
+	Sine,      /**< sin(pi t) */
+	Quad,      /**< 1 - (2t - 1)^2, the pulse of the color_pulse example */
+	Cubic,     /**< 1 - |2t - 1|^3 */
+	Triangle,  /**< 1 - |2t - 1|, the fade of the text_highlight example */
+	Pulse,     /**< Full intensity for the first 30% of the period, as the CUELFX single blink */
+	Heartbeat, /**< Two beats, the second one at 60%, as the CUELFX heartbeat over one second */
+	Breathe    /**< sin^2(pi t), as the CUELFX breathe */
+};
+
+/**
+ * @brief Fixed-point tables of the easing curves, generated at compile time.
+ *
+ * A curve is sampled cTableSize times over its period into 16 bit values, cOne being full intensity.
+ * Phases are 32 bit fractions of a period, as kept by PhaseAccumulator, so a lookup is a shift and a
+ * table read with no floating point math involved.
+ */
+class Easing
+{
+public:
+	static const int cTableBits = 10;
+	static const int cTableSize = 1 << cTableBits;
+	static const uint16_t cOne = 65535;
+
+	static const uint16_t* table(EasingCurve curve);
+
+	/// Intensity of curve at phase, from 0 to cOne.
+	static uint16_t at(EasingCurve curve, uint32_t phase) { return table(curve)[phase >> (32 - cTableBits)]; }
+	/// Same as at() scaled to a color channel.
+	static uint8_t level(EasingCurve curve, uint32_t phase) { return static_cast<uint8_t>((at(curve, phase) * 255u + cOne / 2) / cOne); }
+};
+
+/**
+ * @brief Phase of a periodic effect moved along by the elapsed frame time.
+ *
+ * The phase is a 32 bit fraction of the period and wraps around on its own. Changing the period keeps
+ * the phase, so an effect speeds up or slows down from where it is instead of jumping.
+ */
+class PhaseAccumulator
+{
+public:
+	explicit PhaseAccumulator(int periodMs = 1000);
+
+	/// Changes the period, at least 1 ms, keeping the phase.
+	void setPeriod(int periodMs);
+	int periodMs() const { return mPeriodMs; }
+
+	uint32_t phase() const { return mPhase; }
+	void reset(uint32_t phase = 0) { mPhase = phase; }
+
+	/// Moves the phase elapsedMs milliseconds ahead. Returns the number of periods completed on the way.
+	int advance(int elapsedMs);
+
+private:
+	int mPeriodMs;
+	uint64_t mStep;       /**< Phase per millisecond */
+	uint32_t mPhase;
+};
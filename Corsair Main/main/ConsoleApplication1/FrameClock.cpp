@@ -0,0 +1,87 @@
+#include "FrameClock.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace
+{
+	const auto cDefaultSpinThreshold = std::chrono::milliseconds(1);
+}
+
+FrameClock::FrameClock(int rate)
+	: mRate(0), mPeriod(), mSpinThreshold(cDefaultSpinThreshold), mNextIndex(0)
+{
+	resetStats();
+	setRate(rate);
+}
+
+void FrameClock::setRate(int rate)
+{
+	mRate = std::max(rate, 1);
+	mPeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(1000000000LL / mRate));
+	restart();
+}
+
+void FrameClock::restart()
+{
+	mStart = Clock::now();
+	mNextIndex = 0;
+}
+
+void FrameClock::resetStats()
+{
+	mStats = FrameClockStats();
+	mStats.minJitterNs = std::numeric_limits<int64_t>::max();
+}
+
+FrameTick FrameClock::waitForNextFrame()
+{
+	auto index = mNextIndex;
+	const auto now = Clock::now();
+
+	if (now >= deadline(index) + mPeriod) {
+		// We overran past the following deadline as well: drop every slot that is already
+		// gone and wait for the next one on the original grid.
+		index = (now - mStart) / mPeriod + 1;
+	}
+	const auto skipped = static_cast<int>(index - mNextIndex);
+	const auto frameDeadline = deadline(index);
+
+	sleepUntil(frameDeadline);
+
+	const auto jitterNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - frameDeadline).count();
+	recordFrame(jitterNs, skipped);
+	mNextIndex = index + 1;
+
+	FrameTick tick;
+	tick.index = index;
+	tick.offset = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(frameDeadline - mStart).count());
+	tick.skipped = skipped;
+	tick.jitterNs = jitterNs;
+	tick.deadline = frameDeadline;
+	return tick;
+}
+
+FrameClock::Clock::time_point FrameClock::deadline(int64_t index) const
+{
+	return mStart + mPeriod * index;
+}
+
+void FrameClock::sleepUntil(Clock::time_point deadline) const
+{
+	if (Clock::now() + mSpinThreshold < deadline)
+		std::this_thread::sleep_until(deadline - mSpinThreshold);
+	while (Clock::now() < deadline)
+		std::this_thread::yield();
+}
+
+void FrameClock::recordFrame(int64_t jitterNs, int skipped)
+{
+	mStats.frames++;
+	mStats.skippedFrames += skipped;
+	mStats.minJitterNs = std::min(mStats.minJitterNs, jitterNs);
+	mStats.maxJitterNs = std::max(mStats.maxJitterNs, jitterNs);
+	mStats.lastJitterNs = jitterNs;
+	mStats.meanJitterNs += (jitterNs - mStats.meanJitterNs) / mStats.frames;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/// Frame rates supported out of the box by the playback loops.
+enum FrameRate
+{
+	FR_60Hz = 60,
+	FR_120Hz = 120,
+	FR_240Hz = 240
+};
+
+/// Contains information about the frame handed out by FrameClock::waitForNextFrame().
+struct FrameTick
+{
+	int64_t index;       /**< Index of the frame slot since the clock was (re)started */
+	int offset;          /**< Deadline of the frame slot in milliseconds since the clock was (re)started */
+	int skipped;         /**< Number of frame slots dropped right before this one because of an overrun */
+	int64_t jitterNs;    /**< How late the caller was woken up relative to the frame deadline, in nanoseconds */
+	std::chrono::steady_clock::time_point deadline; /**< Deadline of the frame slot, the instant the frame should show */
+};
+
+/// Contains aggregated jitter statistics collected by FrameClock.
+struct FrameClockStats
+{
+	int64_t frames;          /**< Number of frames handed out */
+	int64_t skippedFrames;   /**< Number of frame slots dropped because of overruns */
+	int64_t minJitterNs;     /**< Smallest observed wake up delay */
+	int64_t maxJitterNs;     /**< Largest observed wake up delay */
+	int64_t lastJitterNs;    /**< Wake up delay of the most recent frame */
+	double meanJitterNs;     /**< Average wake up delay over all frames */
+};
+
+/**
+ * @brief Paces playback loops on absolute per-frame deadlines.
+ *
+ * Frame n is due at start + n * period, so time spent rendering and pushing a frame
+ * never accumulates into the period. When a frame overruns past the next deadline the
+ * missed slots are dropped and the clock continues on the original grid instead of drifting.
+ */
+class FrameClock
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit FrameClock(int rate = FR_60Hz);
+
+	/// Changes the frame rate and restarts the clock on a new grid.
+	void setRate(int rate);
+	int rate() const { return mRate; }
+	Clock::duration period() const { return mPeriod; }
+
+	/**
+	 * @brief Sets how long before a deadline the clock stops sleeping and starts spinning.
+	 *
+	 * OS sleep granularity is often coarser than a 240 Hz period, so the tail of every wait
+	 * is spent yielding instead. Zero disables spinning.
+	 */
+	void setSpinThreshold(Clock::duration threshold) { mSpinThreshold = threshold; }
+
+	/// Moves the origin of the frame grid to the current time. Statistics are kept.
+	void restart();
+
+	/// Blocks until the deadline of the next frame slot and returns its description.
+	FrameTick waitForNextFrame();
+
+	const FrameClockStats& stats() const { return mStats; }
+	void resetStats();
+
+private:
+	Clock::time_point deadline(int64_t index) const;
+	void sleepUntil(Clock::time_point deadline) const;
+	void recordFrame(int64_t jitterNs, int skipped);
+
+	int mRate;
+	Clock::duration mPeriod;
+	Clock::duration mSpinThreshold;
+	Clock::time_point mStart;
+	int64_t mNextIndex;
+	FrameClockStats mStats;
+};
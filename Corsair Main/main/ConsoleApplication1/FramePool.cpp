@@ -0,0 +1,65 @@
+#include "FramePool.h"
+
+#include <algorithm>
+
+FramePool::FramePool(int frameCount, int ledCapacity)
+	: mLedCapacity(std::max(ledCapacity, 0)),
+	mCursor(0),
+	mSlots(std::max(frameCount, 1)),
+	mStorage(mSlots.size() * mLedCapacity),
+	mOverflowCount(0)
+{
+	for (size_t i = 0; i < mSlots.size(); ++i) {
+		auto &slot = mSlots[i];
+		slot.owner = this;
+		slot.storage = mStorage.data() + i * mLedCapacity;
+		slot.frame.size = 0;
+		slot.frame.ledsColors = slot.storage;
+		slot.inUse.store(false, std::memory_order_relaxed);
+	}
+}
+
+CorsairFrame* FramePool::acquire(int size)
+{
+	size = std::max(size, 0);
+	if (size <= mLedCapacity) {
+		const auto count = static_cast<int>(mSlots.size());
+		for (auto i = 0; i < count; ++i) {
+			auto &slot = mSlots[(mCursor + i) % count];
+			if (!slot.inUse.exchange(true, std::memory_order_acquire)) {
+				mCursor = (mCursor + i + 1) % count;
+				slot.frame.size = size;
+				slot.frame.ledsColors = slot.storage;
+				return &slot.frame;
+			}
+		}
+	}
+
+	mOverflowCount.fetch_add(1, std::memory_order_relaxed);
+	auto slot = new Slot;
+	slot->owner = nullptr;
+	slot->storage = new CorsairLedColor[std::max(size, 1)];
+	slot->frame.size = size;
+	slot->frame.ledsColors = slot->storage;
+	slot->inUse.store(true, std::memory_order_relaxed);
+	return &slot->frame;
+}
+
+void FramePool::release(CorsairFrame *frame)
+{
+	if (!frame)
+		return;
+
+	auto slot = slotOf(frame);
+	if (slot->owner) {
+		slot->inUse.store(false, std::memory_order_release);
+	} else {
+		delete[] slot->storage;
+		delete slot;
+	}
+}
+
+FramePool::Slot* FramePool::slotOf(CorsairFrame *frame)
+{
+	return reinterpret_cast<Slot*>(frame);
+}
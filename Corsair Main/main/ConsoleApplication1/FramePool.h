@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Shared/LFX.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Recycles CorsairFrame structures handed out through the getFrameFunction/freeFrameFunction contract.
+ *
+ * Frames and their ledsColors arrays are preallocated as a fixed ring of slots, so steady-state
+ * playback does not touch the heap. A frame is returned to its pool by FramePool::release(), which
+ * has the signature of CorsairEffect::freeFrameFunction and can be plugged into it directly.
+ *
+ * acquire() is meant to be called from a single thread (the one calling getFrameFunction), release()
+ * may be called from any thread.
+ */
+class FramePool
+{
+public:
+	FramePool(int frameCount, int ledCapacity);
+
+	FramePool(const FramePool&) = delete;
+	FramePool& operator=(const FramePool&) = delete;
+
+	/**
+	 * @brief Hands out a frame with room for at least size LEDs.
+	 *
+	 * If every slot is still held by the consumer or size exceeds the pool capacity, the frame is
+	 * allocated on the heap instead. Such frames are counted by overflowCount() and still have to be
+	 * given back through release().
+	 *
+	 * @return Pointer to the frame with its size set to the requested value.
+	 */
+	CorsairFrame* acquire(int size);
+
+	/// Returns frame obtained from any FramePool. Compatible with CorsairEffect::freeFrameFunction.
+	static void release(CorsairFrame *frame);
+
+	int frameCount() const { return static_cast<int>(mSlots.size()); }
+	int ledCapacity() const { return mLedCapacity; }
+
+	/// Number of frames that had to be heap allocated because the pool was exhausted.
+	int64_t overflowCount() const { return mOverflowCount.load(std::memory_order_relaxed); }
+
+private:
+	struct Slot
+	{
+		CorsairFrame frame;        /**< Has to stay the first member: frames are mapped back to slots by address */
+		FramePool *owner;          /**< Pool the slot belongs to, null for overflow frames */
+		CorsairLedColor *storage;  /**< LED array the frame was handed out with */
+		std::atomic<bool> inUse;
+	};
+
+	static Slot* slotOf(CorsairFrame *frame);
+
+	int mLedCapacity;
+	int mCursor;
+	std::vector<Slot> mSlots;
+	std::vector<CorsairLedColor> mStorage;
+	std::atomic<int64_t> mOverflowCount;
+};
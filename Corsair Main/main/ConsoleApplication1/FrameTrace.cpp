@@ -0,0 +1,456 @@
+#include "FrameTrace.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	/// Encoded frames are written once this many bytes are pending.
+	const size_t cFlushSize = 64 * 1024;
+
+	void putVarint(std::vector<uint8_t> &buffer, uint64_t value)
+	{
+		while (value >= 0x80) {
+			buffer.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		buffer.push_back(static_cast<uint8_t>(value));
+	}
+
+	bool readVarint(const uint8_t *&p, const uint8_t *end, uint64_t &value)
+	{
+		value = 0;
+		for (auto shift = 0; shift < 64 && p < end; shift += 7) {
+			const auto byte = *p++;
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	uint64_t readLE(const uint8_t *data, int bytes)
+	{
+		uint64_t value = 0;
+		for (auto i = 0; i < bytes; ++i) {
+			value |= static_cast<uint64_t>(data[i]) << (8 * i);
+		}
+		return value;
+	}
+
+	uint64_t zigzag(int64_t value)
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	int64_t unzigzag(uint64_t value)
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+}
+
+FrameTraceEncoder::FrameTraceEncoder()
+	: mTimestampNs(0), mKeyframe(true)
+{
+	mChanged.reserve(Framebuffer::cCapacity);
+	mUnset.reserve(Framebuffer::cCapacity);
+	mRuns.reserve(Framebuffer::cCapacity);
+}
+
+void FrameTraceEncoder::reset()
+{
+	mKeyframe = true;
+}
+
+int FrameTraceEncoder::encode(std::vector<uint8_t> &buffer, int64_t timestampNs, const Framebuffer &frame, bool async)
+{
+	const auto keyframe = mKeyframe;
+	mKeyframe = false;
+	if (keyframe) {
+		mState.clear();
+	}
+
+	const auto red = frame.red();
+	const auto green = frame.green();
+	const auto blue = frame.blue();
+	mChanged.clear();
+	frame.forEachActive([&](CorsairLedId ledId) {
+		if (!mState.isActive(ledId) || mState.red()[ledId] != red[ledId] || mState.green()[ledId] != green[ledId] || mState.blue()[ledId] != blue[ledId]) {
+			mChanged.push_back(ledId);
+			mState.set(ledId, red[ledId], green[ledId], blue[ledId]);
+		}
+	});
+	// A keyframe starts from nothing lit, so only later frames can turn LEDs off.
+	mUnset.clear();
+	mState.forEachActive([&](CorsairLedId ledId) {
+		if (!frame.isActive(ledId)) {
+			mUnset.push_back(ledId);
+		}
+	});
+	for (const auto ledId : mUnset) {
+		mState.deactivate(ledId);
+	}
+
+	// Split the changes into runs of consecutive ids, a repeat run wherever two or more share a color.
+	const auto count = static_cast<int>(mChanged.size());
+	const auto adjacent = [&](int i) { return mChanged[i] == mChanged[i - 1] + 1; };
+	const auto sameColor = [&](int i, int j) {
+		return red[mChanged[i]] == red[mChanged[j]] && green[mChanged[i]] == green[mChanged[j]] && blue[mChanged[i]] == blue[mChanged[j]];
+	};
+	mRuns.clear();
+	for (auto i = 0; i < count;) {
+		auto end = i + 1;
+		while (end < count && adjacent(end) && sameColor(end, i)) {
+			++end;
+		}
+		const auto repeat = end - i > 1;
+		if (!repeat) {
+			while (end < count && adjacent(end) && !(end + 1 < count && adjacent(end + 1) && sameColor(end + 1, end))) {
+				++end;
+			}
+		}
+		mRuns.push_back(Run{ i, end - i, repeat });
+		i = end;
+	}
+
+	buffer.push_back(static_cast<uint8_t>((keyframe ? FTF_Keyframe : 0) | (async ? FTF_Async : 0) | (mUnset.empty() ? 0 : FTF_Unset)));
+	putVarint(buffer, zigzag(keyframe ? timestampNs : timestampNs - mTimestampNs));
+	mTimestampNs = timestampNs;
+	putVarint(buffer, mRuns.size());
+	auto next = 0;
+	for (const auto &run : mRuns) {
+		const auto first = mChanged[run.first];
+		putVarint(buffer, static_cast<uint64_t>(first - next));
+		putVarint(buffer, static_cast<uint64_t>(run.length) << 1 | (run.repeat ? 1 : 0));
+		for (auto i = run.first; i < run.first + (run.repeat ? 1 : run.length); ++i) {
+			buffer.push_back(red[mChanged[i]]);
+			buffer.push_back(green[mChanged[i]]);
+			buffer.push_back(blue[mChanged[i]]);
+		}
+		next = first + run.length;
+	}
+	if (!mUnset.empty()) {
+		putUnsetRuns(buffer);
+	}
+	return count + static_cast<int>(mUnset.size());
+}
+
+void FrameTraceEncoder::putUnsetRuns(std::vector<uint8_t> &buffer) const
+{
+	const auto count = static_cast<int>(mUnset.size());
+	auto runs = 0;
+	for (auto i = 0; i < count; ++i) {
+		runs += i == 0 || mUnset[i] != mUnset[i - 1] + 1;
+	}
+	putVarint(buffer, static_cast<uint64_t>(runs));
+	auto next = 0;
+	for (auto i = 0; i < count;) {
+		auto end = i + 1;
+		while (end < count && mUnset[end] == mUnset[end - 1] + 1) {
+			++end;
+		}
+		putVarint(buffer, static_cast<uint64_t>(mUnset[i] - next));
+		putVarint(buffer, static_cast<uint64_t>(end - i));
+		next = mUnset[i] + (end - i);
+		i = end;
+	}
+}
+
+int FrameTraceEncoder::encode(std::vector<uint8_t> &buffer, int64_t timestampNs, int size, const CorsairLedColor *ledsColors, bool async)
+{
+	// A keyframe holds everything lit so far, not only what this call sets.
+	mScratch = mState;
+	for (auto i = 0; i < size; ++i) {
+		mScratch.set(ledsColors[i]);
+	}
+	return encode(buffer, timestampNs, mScratch, async);
+}
+
+const char FrameTraceWriter::cMagic[8] = { 'C', 'U', 'E', 'T', 'R', 'A', 'C', 'E' };
+
+FrameTraceWriter::FrameTraceWriter(int keyframeInterval)
+	: mFile(nullptr), mFailed(false), mStop(false), mKeyframeInterval(keyframeInterval > 0 ? keyframeInterval : 1), mFramesSinceKeyframe(0), mFrames(0),
+	mSize(0)
+{
+}
+
+FrameTraceWriter::~FrameTraceWriter()
+{
+	close();
+}
+
+bool FrameTraceWriter::open(const std::string &path)
+{
+	close();
+	mFile = std::fopen(path.c_str(), "wb");
+	if (!mFile) {
+		return false;
+	}
+	mFailed = false;
+	mEncoder.reset();
+	mFramesSinceKeyframe = 0;
+	mFrames = 0;
+	mSize = 0;
+	mStop = false;
+	mThread = std::thread(&FrameTraceWriter::run, this);
+	mBuffer.clear();
+	mBuffer.reserve(cFlushSize + Framebuffer::cCapacity * 8);
+	mBuffer.insert(mBuffer.end(), cMagic, cMagic + sizeof(cMagic));
+	for (auto i = 0; i < 4; ++i) {
+		mBuffer.push_back(static_cast<uint8_t>(cVersion >> (8 * i)));
+	}
+	return flush();
+}
+
+bool FrameTraceWriter::close()
+{
+	if (!mFile) {
+		return false;
+	}
+	flush();
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mQueued.notify_one();
+	mThread.join();
+	const auto closed = std::fclose(mFile) == 0;
+	mFile = nullptr;
+	return closed && !mFailed;
+}
+
+bool FrameTraceWriter::writeFrame(int64_t timestampNs, const Framebuffer &frame, bool async)
+{
+	if (!mFile) {
+		return false;
+	}
+	mEncoder.encode(mBuffer, timestampNs, frame, async);
+	return afterFrame();
+}
+
+bool FrameTraceWriter::writeFrame(int64_t timestampNs, int size, const CorsairLedColor *ledsColors, bool async)
+{
+	if (!mFile) {
+		return false;
+	}
+	mEncoder.encode(mBuffer, timestampNs, size, ledsColors, async);
+	return afterFrame();
+}
+
+bool FrameTraceWriter::writeEncoded(const uint8_t *data, size_t size)
+{
+	if (!mFile || !flush()) {
+		return false;
+	}
+	mBuffer.insert(mBuffer.end(), data, data + size);
+	mEncoder.reset();
+	mFramesSinceKeyframe = 0;
+	return flush();
+}
+
+bool FrameTraceWriter::afterFrame()
+{
+	++mFrames;
+	if (++mFramesSinceKeyframe >= mKeyframeInterval) {
+		mEncoder.reset();
+		mFramesSinceKeyframe = 0;
+	}
+	return mBuffer.size() < cFlushSize ? !mFailed : flush();
+}
+
+bool FrameTraceWriter::flush()
+{
+	if (mBuffer.empty()) {
+		return !mFailed;
+	}
+	mSize += static_cast<int64_t>(mBuffer.size());
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mWritten.wait(lock, [this] { return mPending.size() < cMaxPendingChunks; });
+		mPending.push_back(std::move(mBuffer));
+		mBuffer.clear();
+		if (!mSpare.empty()) {
+			mBuffer.swap(mSpare.back());
+			mSpare.pop_back();
+		}
+	}
+	mQueued.notify_one();
+	mBuffer.reserve(cFlushSize + Framebuffer::cCapacity * 8);
+	return !mFailed;
+}
+
+void FrameTraceWriter::run()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	for (;;) {
+		mQueued.wait(lock, [this] { return mStop || !mPending.empty(); });
+		if (mPending.empty()) {
+			return;
+		}
+		auto chunk = std::move(mPending.front());
+		mPending.pop_front();
+		lock.unlock();
+		if (std::fwrite(chunk.data(), 1, chunk.size(), mFile) != chunk.size()) {
+			mFailed = true;
+		}
+		chunk.clear();
+		lock.lock();
+		mSpare.push_back(std::move(chunk));
+		mWritten.notify_one();
+	}
+}
+
+FrameTraceReader::FrameTraceReader()
+	: mPosition(nullptr), mEnd(nullptr), mVersion(0)
+{
+	rewind();
+}
+
+bool FrameTraceReader::open(const std::string &path)
+{
+	close();
+	if (!mFile.open(path)) {
+		return false;
+	}
+	const auto data = mFile.data();
+	const auto valid = mFile.size() >= FrameTraceWriter::cHeaderSize && !std::memcmp(data, FrameTraceWriter::cMagic, sizeof(FrameTraceWriter::cMagic));
+	const auto version = valid ? static_cast<uint32_t>(readLE(data + 8, 4)) : 0;
+	if (version < 1 || version > FrameTraceWriter::cVersion) {
+		mFile.close();
+		return false;
+	}
+	mVersion = version;
+	rewind();
+	return true;
+}
+
+void FrameTraceReader::close()
+{
+	mFile.close();
+	mVersion = 0;
+	rewind();
+}
+
+void FrameTraceReader::rewind()
+{
+	mPosition = mFile.isOpen() ? mFile.data() + FrameTraceWriter::cHeaderSize : nullptr;
+	mEnd = mFile.isOpen() ? mFile.data() + mFile.size() : nullptr;
+	mFailed = false;
+	mFrame.clear();
+	mTimestampNs = 0;
+	mFrameIndex = -1;
+	mChangedLeds = 0;
+	mAsync = false;
+	mKeyframe = false;
+}
+
+bool FrameTraceReader::next()
+{
+	if (mPosition == mEnd || mFailed) {
+		return false;
+	}
+	if (!(mVersion == 1 ? nextRaw() : nextCompact())) {
+		mFailed = true;
+		return false;
+	}
+	++mFrameIndex;
+	return true;
+}
+
+bool FrameTraceReader::nextRaw()
+{
+	const size_t frameHeaderSize = 16;
+	const size_t ledSize = 8;
+	if (static_cast<size_t>(mEnd - mPosition) < frameHeaderSize) {
+		return false;
+	}
+	const auto count = static_cast<int32_t>(readLE(mPosition + 12, 4));
+	if (count < 0 || static_cast<size_t>(mEnd - mPosition - frameHeaderSize) / ledSize < static_cast<size_t>(count)) {
+		return false;
+	}
+	mTimestampNs = static_cast<int64_t>(readLE(mPosition, 8));
+	mAsync = readLE(mPosition + 8, 4) != 0;
+	mKeyframe = false;
+	mChangedLeds = 0;
+	auto led = mPosition + frameHeaderSize;
+	for (auto i = 0; i < count; ++i, led += ledSize) {
+		const auto ledId = static_cast<CorsairLedId>(static_cast<int32_t>(readLE(led, 4)));
+		if (ledId <= CLI_Invalid || ledId > CLI_Last) {
+			continue;
+		}
+		if (!mFrame.isActive(ledId) || mFrame.red()[ledId] != led[4] || mFrame.green()[ledId] != led[5] || mFrame.blue()[ledId] != led[6]) {
+			++mChangedLeds;
+			mFrame.set(ledId, led[4], led[5], led[6]);
+		}
+	}
+	mPosition = led;
+	return true;
+}
+
+bool FrameTraceReader::nextCompact()
+{
+	auto p = mPosition;
+	const auto flags = *p++;
+	uint64_t time;
+	uint64_t runs;
+	if (!readVarint(p, mEnd, time) || !readVarint(p, mEnd, runs)) {
+		return false;
+	}
+	mKeyframe = (flags & FTF_Keyframe) != 0;
+	mAsync = (flags & FTF_Async) != 0;
+	if (mKeyframe) {
+		mFrame.clear();
+		mTimestampNs = unzigzag(time);
+	} else {
+		mTimestampNs += unzigzag(time);
+	}
+
+	mChangedLeds = 0;
+	uint64_t next = 0;
+	for (uint64_t run = 0; run < runs; ++run) {
+		uint64_t gap;
+		uint64_t header;
+		if (!readVarint(p, mEnd, gap) || !readVarint(p, mEnd, header)) {
+			return false;
+		}
+		const auto first = next + gap;
+		const auto length = header >> 1;
+		const auto repeat = (header & 1) != 0;
+		const auto colorBytes = repeat ? 3 : 3 * length;
+		if (gap > CLI_Last || length > CLI_Last || first + length > CLI_Last + 1 || static_cast<uint64_t>(mEnd - p) < colorBytes) {
+			return false;
+		}
+		for (uint64_t i = 0; i < length; ++i) {
+			const auto color = repeat ? p : p + 3 * i;
+			mFrame.set(static_cast<CorsairLedId>(first + i), color[0], color[1], color[2]);
+		}
+		p += colorBytes;
+		next = first + length;
+		mChangedLeds += static_cast<int>(length);
+	}
+
+	uint64_t unsetRuns = 0;
+	if ((flags & FTF_Unset) && !readVarint(p, mEnd, unsetRuns)) {
+		return false;
+	}
+	next = 0;
+	for (uint64_t run = 0; run < unsetRuns; ++run) {
+		uint64_t gap;
+		uint64_t length;
+		if (!readVarint(p, mEnd, gap) || !readVarint(p, mEnd, length)) {
+			return false;
+		}
+		const auto first = next + gap;
+		if (gap > CLI_Last || length > CLI_Last || first + length > CLI_Last + 1) {
+			return false;
+		}
+		for (uint64_t i = 0; i < length; ++i) {
+			mFrame.deactivate(static_cast<CorsairLedId>(first + i));
+		}
+		next = first + length;
+		mChangedLeds += static_cast<int>(length);
+	}
+	mPosition = p;
+	return true;
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "Framebuffer.h"
+#include "MappedFile.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Frame traces start with "CUETRACE" and a uint32 version, little endian.
+ *
+ * Version 1 is what the CUE SDK stand-in records (see CorsairStandInOpenTrace()), every call as sent:
+ *   int64 timestamp in nanoseconds, int32 async, int32 LED count,
+ *   and per LED int32 CorsairLedId, uint8 red, green, blue, 0.
+ *
+ * Version 2 is the compact format. Every frame only holds the LEDs whose color differs from the previous
+ * frame:
+ *   uint8 flags (FrameTraceFlag), varint zigzag timestamp in nanoseconds (absolute in keyframes,
+ *   otherwise the delta to the previous frame), varint run count, runs.
+ * A run starts with a varint gap, the number of LED ids skipped since the end of the previous run (from
+ * id 0 for the first run), then a varint (length << 1 | repeat). A repeat run is length consecutive LEDs
+ * sharing the one RGB triplet that follows, otherwise length triplets follow, one per LED.
+ * Varints are unsigned LEB128.
+ *
+ * Version 3, the one FrameTraceWriter writes, adds FTF_Unset: after the runs of such a frame follow a
+ * varint count and that many (varint gap, varint length) pairs, runs of LEDs that are no longer lit, gaps
+ * counted as above.
+ * Version 2 traces read the same, they never set the flag.
+ */
+
+/// Bits of the flags of a version 2 or 3 frame.
+enum FrameTraceFlag
+{
+	FTF_Keyframe = 1,          /**< Every LED is unset before the runs are applied, so decoding can start here */
+	FTF_Async = 2,             /**< Frame was submitted with CorsairSetLedsColorsAsync() */
+	FTF_Unset = 4              /**< Frame ends with runs of LEDs that turned inactive, version 3 */
+};
+
+/**
+ * @brief Delta encodes frames into the version 3 trace format.
+ *
+ * Keeps the state the previous frames left so every frame is written as its changes; after reset() the
+ * next frame is a keyframe. Encoders are independent, so parts of a trace can be encoded on several
+ * threads as long as each part starts with a keyframe.
+ */
+class FrameTraceEncoder
+{
+public:
+	FrameTraceEncoder();
+
+	/// Makes the next frame a keyframe, as at the start of a trace.
+	void reset();
+
+	/// Appends frame to buffer. Active LEDs of frame are what is lit. Returns number of LEDs written or unset.
+	int encode(std::vector<uint8_t> &buffer, int64_t timestampNs, const Framebuffer &frame, bool async = false);
+	/// Same as above for LEDs set on top of the previous frame, as CorsairSetLedsColors() does.
+	int encode(std::vector<uint8_t> &buffer, int64_t timestampNs, int size, const CorsairLedColor *ledsColors, bool async = false);
+
+private:
+	/// Consecutive changed LEDs mChanged[first..first + length).
+	struct Run
+	{
+		int first;
+		int length;
+		bool repeat;
+	};
+
+	/// Appends the gap and length of every run of consecutive ids in mUnset.
+	void putUnsetRuns(std::vector<uint8_t> &buffer) const;
+
+	Framebuffer mState;
+	Framebuffer mScratch;
+	std::vector<CorsairLedId> mChanged;
+	std::vector<CorsairLedId> mUnset;
+	std::vector<Run> mRuns;
+	int64_t mTimestampNs;
+	bool mKeyframe;
+};
+
+/**
+ * @brief Streams frames to a version 3 trace file.
+ *
+ * Encoded frames are buffered up to a fixed size and then handed to a writer thread, so neither the
+ * encoding thread nor memory depend on the disk however long the session. Only when cMaxPendingChunks
+ * are waiting for the disk does writeFrame() wait for it. A keyframe is inserted every keyframeInterval
+ * frames to bound how far a reader has to decode after a damaged or skipped part.
+ *
+ * Frames are meant to be written from one thread; a failed write shows up in the result of a later call.
+ */
+class FrameTraceWriter
+{
+public:
+	static const char cMagic[8];
+	static const uint32_t cVersion = 3;
+	static const size_t cHeaderSize = 12;
+	static const int cDefaultKeyframeInterval = 4096;
+	static const size_t cMaxPendingChunks = 8;
+
+	explicit FrameTraceWriter(int keyframeInterval = cDefaultKeyframeInterval);
+	~FrameTraceWriter();
+
+	FrameTraceWriter(const FrameTraceWriter&) = delete;
+	FrameTraceWriter& operator=(const FrameTraceWriter&) = delete;
+
+	/// Creates (or truncates) path and writes the file header. Returns false if the file cannot be created.
+	bool open(const std::string &path);
+	/// Writes what is pending and closes the file. Returns false if any write failed.
+	bool close();
+	bool isOpen() const { return mFile != nullptr; }
+
+	bool writeFrame(int64_t timestampNs, const Framebuffer &frame, bool async = false);
+	bool writeFrame(int64_t timestampNs, int size, const CorsairLedColor *ledsColors, bool async = false);
+	/// Appends frames encoded elsewhere; they have to start with a keyframe. The next writeFrame() is a keyframe as well.
+	bool writeEncoded(const uint8_t *data, size_t size);
+	bool writeEncoded(const std::vector<uint8_t> &frames) { return writeEncoded(frames.data(), frames.size()); }
+
+	int64_t frames() const { return mFrames; }
+	/// Bytes written so far, header included, counting those still on their way to the disk.
+	int64_t size() const { return mSize + static_cast<int64_t>(mBuffer.size()); }
+
+private:
+	/// Hands mBuffer to the writer thread.
+	bool flush();
+	bool afterFrame();
+	/// Writer thread: writes pending chunks in order until close().
+	void run();
+
+	FILE *mFile;
+	std::atomic<bool> mFailed;                      /**< Set by the writer thread */
+	FrameTraceEncoder mEncoder;
+	std::vector<uint8_t> mBuffer;
+	std::mutex mMutex;                              /**< Guards mPending, mSpare and mStop */
+	std::condition_variable mQueued;
+	std::condition_variable mWritten;
+	std::deque<std::vector<uint8_t>> mPending;
+	std::vector<std::vector<uint8_t>> mSpare;       /**< Written chunks, reused as mBuffer */
+	bool mStop;
+	std::thread mThread;
+	int mKeyframeInterval;
+	int mFramesSinceKeyframe;
+	int64_t mFrames;
+	int64_t mSize;
+};
+
+/**
+ * @brief Reads traces of every version frame by frame from a mapped file.
+ *
+ * frame() holds the colors of every LED lit so far, as the device would show them after the frame;
+ * changedLeds() counts the ones the frame changed or turned off.
+ */
+class FrameTraceReader
+{
+public:
+	FrameTraceReader();
+
+	/// Maps path and checks the header. Returns false if it is missing or not a trace of a known version.
+	bool open(const std::string &path);
+	void close();
+	/// Goes back before the first frame.
+	void rewind();
+
+	/// Decodes the next frame. Returns false at the end of the trace or if it is truncated, see failed().
+	bool next();
+
+	uint32_t version() const { return mVersion; }
+	/// True if decoding stopped at a truncated or malformed frame.
+	bool failed() const { return mFailed; }
+	/// Size of the trace in bytes.
+	size_t size() const { return mFile.size(); }
+
+	const Framebuffer& frame() const { return mFrame; }
+	int64_t timestampNs() const { return mTimestampNs; }
+	int64_t frameIndex() const { return mFrameIndex; }
+	int changedLeds() const { return mChangedLeds; }
+	bool isAsync() const { return mAsync; }
+	bool isKeyframe() const { return mKeyframe; }
+
+private:
+	bool nextRaw();
+	bool nextCompact();
+
+	MappedFile mFile;
+	const uint8_t *mPosition;
+	const uint8_t *mEnd;
+	uint32_t mVersion;
+	bool mFailed;
+	Framebuffer mFrame;
+	int64_t mTimestampNs;
+	int64_t mFrameIndex;
+	int mChangedLeds;
+	bool mAsync;
+	bool mKeyframe;
+};
@@ -0,0 +1,102 @@
+#include "Framebuffer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+	uint8_t clampChannel(int value)
+	{
+		return static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+	}
+}
+
+Framebuffer::Framebuffer()
+{
+	clear();
+}
+
+void* Framebuffer::operator new(size_t size)
+{
+#ifdef _WIN32
+	const auto memory = _aligned_malloc(size, alignof(Framebuffer));
+#else
+	void *memory = nullptr;
+	if (posix_memalign(&memory, alignof(Framebuffer), size)) {
+		memory = nullptr;
+	}
+#endif
+	if (!memory) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* Framebuffer::operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void Framebuffer::operator delete(void *memory)
+{
+#ifdef _WIN32
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void Framebuffer::operator delete[](void *memory)
+{
+	operator delete(memory);
+}
+
+void Framebuffer::clear()
+{
+	std::memset(mRed, 0, sizeof(mRed));
+	std::memset(mGreen, 0, sizeof(mGreen));
+	std::memset(mBlue, 0, sizeof(mBlue));
+	std::memset(mAlpha, 0, sizeof(mAlpha));
+	std::memset(mActive, 0, sizeof(mActive));
+}
+
+void Framebuffer::set(const CorsairLedColor &ledColor)
+{
+	set(ledColor.ledId, clampChannel(ledColor.r), clampChannel(ledColor.g), clampChannel(ledColor.b));
+}
+
+void Framebuffer::fill(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	// Colors of inactive LEDs are never staged, so whole planes are filled instead of walking the mask.
+	std::memset(mRed, r, sizeof(mRed));
+	std::memset(mGreen, g, sizeof(mGreen));
+	std::memset(mBlue, b, sizeof(mBlue));
+	std::memset(mAlpha, a, sizeof(mAlpha));
+}
+
+int Framebuffer::activeCount() const
+{
+	auto count = 0;
+	for (auto word = 0; word < cMaskWords; ++word) {
+		count += popCount(mActive[word]);
+	}
+	return count;
+}
+
+int Framebuffer::stage(std::vector<CorsairLedColor> &staging) const
+{
+	staging.resize(cCapacity);
+	auto out = staging.data();
+	forEachActive([&](CorsairLedId ledId) {
+		*out++ = CorsairLedColor{ ledId, mRed[ledId], mGreen[ledId], mBlue[ledId] };
+	});
+	const auto count = static_cast<int>(out - staging.data());
+	staging.resize(count);
+	return count;
+}
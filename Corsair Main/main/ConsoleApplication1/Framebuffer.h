@@ -0,0 +1,133 @@
+#pragma once
+
+#include "CUESDK.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Frame of LED colors indexed directly by CorsairLedId.
+ *
+ * Colors are stored as separate 8-bit red, green, blue and alpha planes (structure of arrays), so
+ * whole-frame operations run over contiguous bytes and a complete frame stays well under 1 KB.
+ * A bitmask tracks which LEDs are part of the frame; only those are handed to the SDK.
+ * Conversion to CorsairLedColor happens only at the SDK boundary, through stage().
+ */
+class Framebuffer
+{
+public:
+	/// Number of LED slots per plane: CLI_Last + 1 rounded up to a multiple of 64 so planes can be processed in full vectors.
+	static const int cCapacity = ((CLI_Last + 1) + 63) / 64 * 64;
+	static const int cMaskWords = cCapacity / 64;
+
+	Framebuffer();
+
+	/**
+	 * @brief Heap storage aligned for the planes.
+	 *
+	 * Before C++17 a new-expression ignores alignas beyond alignof(std::max_align_t), so Framebuffers and
+	 * heap objects holding one (e.g. DeviceManager::Device) are allocated through these instead.
+	 */
+	static void* operator new(size_t size);
+	static void* operator new[](size_t size);
+	static void operator delete(void *memory);
+	static void operator delete[](void *memory);
+
+	/// Sets every color to transparent black and deactivates every LED.
+	void clear();
+
+	/// Sets color of specified LED and marks it active. Ids outside [CLI_Invalid + 1..CLI_Last] are ignored.
+	void set(CorsairLedId ledId, uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255)
+	{
+		if (ledId > CLI_Invalid && ledId <= CLI_Last) {
+			mRed[ledId] = r;
+			mGreen[ledId] = g;
+			mBlue[ledId] = b;
+			mAlpha[ledId] = a;
+			activate(ledId);
+		}
+	}
+
+	/// Same as set() with channels clamped from the int representation used by the SDK.
+	void set(const CorsairLedColor &ledColor);
+
+	/// Sets color of every LED slot; which LEDs are active is left unchanged.
+	void fill(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255);
+
+	void activate(CorsairLedId ledId) { mActive[ledId >> 6] |= uint64_t(1) << (ledId & 63); }
+	void deactivate(CorsairLedId ledId) { mActive[ledId >> 6] &= ~(uint64_t(1) << (ledId & 63)); }
+	bool isActive(CorsairLedId ledId) const { return (mActive[ledId >> 6] >> (ledId & 63)) & 1; }
+	int activeCount() const;
+
+	uint8_t* red() { return mRed; }
+	uint8_t* green() { return mGreen; }
+	uint8_t* blue() { return mBlue; }
+	uint8_t* alpha() { return mAlpha; }
+	const uint8_t* red() const { return mRed; }
+	const uint8_t* green() const { return mGreen; }
+	const uint8_t* blue() const { return mBlue; }
+	const uint8_t* alpha() const { return mAlpha; }
+	uint64_t* activeMask() { return mActive; }
+	const uint64_t* activeMask() const { return mActive; }
+
+	/// Calls function(ledId) for every active LED in ascending id order.
+	template <typename Function>
+	void forEachActive(Function function) const
+	{
+		for (auto word = 0; word < cMaskWords; ++word) {
+			for (auto bits = mActive[word]; bits; bits &= bits - 1) {
+				function(static_cast<CorsairLedId>(word * 64 + countTrailingZeros(bits)));
+			}
+		}
+	}
+
+	/**
+	 * @brief Converts active LEDs to the SDK representation.
+	 *
+	 * staging is cleared and refilled; reserve cCapacity entries once and the conversion never allocates.
+	 *
+	 * @return Number of LEDs written to staging.
+	 */
+	int stage(std::vector<CorsairLedColor> &staging) const;
+
+private:
+	static int countTrailingZeros(uint64_t bits)
+	{
+#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return static_cast<int>(index);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, static_cast<unsigned long>(bits))) {
+			return static_cast<int>(index);
+		}
+		_BitScanForward(&index, static_cast<unsigned long>(bits >> 32));
+		return static_cast<int>(index) + 32;
+#else
+		return __builtin_ctzll(bits);
+#endif
+	}
+
+	static int popCount(uint64_t bits)
+	{
+#if defined(_MSC_VER) && defined(_WIN64)
+		return static_cast<int>(__popcnt64(bits));
+#elif defined(_MSC_VER)
+		return static_cast<int>(__popcnt(static_cast<unsigned int>(bits)) + __popcnt(static_cast<unsigned int>(bits >> 32)));
+#else
+		return __builtin_popcountll(bits);
+#endif
+	}
+
+	alignas(32) uint8_t mRed[cCapacity];
+	alignas(32) uint8_t mGreen[cCapacity];
+	alignas(32) uint8_t mBlue[cCapacity];
+	alignas(32) uint8_t mAlpha[cCapacity];
+	uint64_t mActive[cMaskWords];
+};
@@ -0,0 +1,81 @@
+#include "GradientEffect.h"
+#include "ColorChart.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	/// Same rounding as the mix of the SDK effects.
+	uint32_t mix(uint32_t from, uint32_t to, double t)
+	{
+		auto color = 0u;
+		for (auto shift = 0; shift < 24; shift += 8) {
+			const auto a = static_cast<int>(from >> shift & 255);
+			const auto b = static_cast<int>(to >> shift & 255);
+			color |= static_cast<uint32_t>(a + (b - a) * t + .5) << shift;
+		}
+		return color;
+	}
+}
+
+GradientEffect::GradientEffect(CorsairColor startColor)
+	: mStartColor(ColorLut::pack(startColor))
+{
+}
+
+void GradientEffect::addRamp(int duration, CorsairColor endColor, double power)
+{
+	// Ends are kept as ints, so the total duration stops growing at the largest one.
+	duration = std::min(std::max(duration, 0), std::numeric_limits<int>::max() - this->duration());
+	const auto from = mColors.empty() ? mStartColor : mColors.back();
+	const auto to = ColorLut::pack(endColor);
+	const auto steps = std::max(std::min(duration, cMaxSteps), 1);
+	mRamps.push_back(Ramp{ duration, steps, mColors.size() });
+	mEnds.push_back(this->duration() + duration);
+	for (auto step = 0; step <= steps; ++step) {
+		mColors.push_back(mix(from, to, std::min(std::max(shape(static_cast<double>(step) / steps, power), 0.), 1.)));
+	}
+}
+
+uint32_t GradientEffect::colorAt(int offset) const
+{
+	if (offset < 0 || mRamps.empty()) {
+		return mRamps.empty() ? mStartColor : mColors.front();
+	}
+	// First ramp ending after offset; ramps without duration never do.
+	const auto end = std::upper_bound(mEnds.begin(), mEnds.end(), offset);
+	if (end == mEnds.end()) {
+		return mColors.back();
+	}
+	const auto &ramp = mRamps[end - mEnds.begin()];
+	const auto into = static_cast<int64_t>(offset - (*end - ramp.duration));
+	return mColors[ramp.firstColor + static_cast<size_t>((into * ramp.steps + ramp.duration / 2) / ramp.duration)];
+}
+
+bool GradientEffect::render(int offset, const CorsairLedId *ledIds, int count, Framebuffer &frame) const
+{
+	if (offset >= duration()) {
+		return false;
+	}
+	const auto color = colorAt(offset);
+	const auto r = ColorLut::red(color);
+	const auto g = ColorLut::green(color);
+	const auto b = ColorLut::blue(color);
+	for (auto i = 0; i < count; ++i) {
+		frame.set(ledIds[i], r, g, b);
+	}
+	return true;
+}
+
+double GradientEffect::shape(double t, double power)
+{
+	if (power > 0.) {
+		return std::pow(t, power);
+	}
+	if (power < 0.) {
+		return 1. - std::pow(1. - t, -power);
+	}
+	return t;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "Framebuffer.h"
+#include "Shared/LFX.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Native counterpart of CorsairLFXCreateGradientEffect() and CorsairLFXAddRampToGradientEffect().
+ *
+ * The color starts at the start color and goes through the ramps one after the other, each ramp shaped by
+ * its power: t^power for a positive power, the mirrored 1 - (1 - t)^-power for a negative one and linear for 0.
+ *
+ * addRamp() bakes the colors of a ramp into a table of up to cMaxSteps + 1 steps, one per millisecond for
+ * ramps of up to cMaxSteps ms (exact at every offset the SDK can ask for), and keeps the end of every ramp
+ * as a running sum. The color at an offset is then a binary search over the ramps and one table read,
+ * whatever the power; every LED of the effect gets the same color.
+ */
+class GradientEffect
+{
+public:
+	static const int cMaxSteps = 1024;
+
+	explicit GradientEffect(CorsairColor startColor);
+
+	/// Appends a ramp from the color the effect is at to endColor over duration milliseconds, clamped so duration() fits an int.
+	void addRamp(int duration, CorsairColor endColor, double power);
+
+	int rampCount() const { return static_cast<int>(mRamps.size()); }
+	/// Total duration of the ramps in milliseconds.
+	int duration() const { return mEnds.empty() ? 0 : mEnds.back(); }
+
+	/// Color at offset milliseconds from the start, packed as 0x00bbggrr; the end color of the last ramp past the end.
+	uint32_t colorAt(int offset) const;
+
+	/**
+	 * @brief Sets the LEDs to the color at offset milliseconds.
+	 * @return false once offset is past the last ramp, leaving frame untouched, as the SDK effect stops there.
+	 */
+	bool render(int offset, const CorsairLedId *ledIds, int count, Framebuffer &frame) const;
+
+	/// Shape of a ramp of the specified power at t in [0..1].
+	static double shape(double t, double power);
+
+private:
+	struct Ramp
+	{
+		int duration;
+		int steps;
+		size_t firstColor;    /**< Index of the color at t = 0 in mColors */
+	};
+
+	uint32_t mStartColor;
+	std::vector<int> mEnds;
+	std::vector<Ramp> mRamps;
+	std::vector<uint32_t> mColors;
+};
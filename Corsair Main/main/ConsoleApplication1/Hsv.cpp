@@ -0,0 +1,64 @@
+#include "Hsv.h"
+#include "HsvKernels.h"
+
+#include "ColorChart.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	/// Channel whose sextant is offset by shift (5 for red, 3 for green, 1 for blue) from the hue sextant h6.
+	int channel(int h6, int shift, int chroma, int value)
+	{
+		auto k = h6 + (shift << 16);
+		k -= (6 << 16) & -static_cast<int>(k >= 6 << 16);
+		const auto weight = std::min(std::max(std::min(k, (4 << 16) - k), 0), 1 << 16);
+		return value - compositor::div255(chroma * (((weight << 8) - weight + 32768) >> 16));
+	}
+}
+
+void hsv::convertScalar(const uint16_t *hues, int saturation, int value, int count, uint32_t *colors)
+{
+	const auto chroma = compositor::div255(value * saturation);
+	for (auto i = 0; i < count; ++i) {
+		const auto h6 = hues[i] * 6;
+		colors[i] = static_cast<uint32_t>(channel(h6, 5, chroma, value)) | static_cast<uint32_t>(channel(h6, 3, chroma, value)) << 8
+			| static_cast<uint32_t>(channel(h6, 1, chroma, value)) << 16;
+	}
+}
+
+HsvConverter::HsvConverter(Compositor::Isa isa)
+	: mIsa(Compositor::Isa::Scalar), mKernel(&hsv::convertScalar)
+{
+#ifdef CORSAIR_COMPOSITOR_AVX2
+	if (isa == Compositor::Isa::Avx2 && Compositor::isSupported(isa)) {
+		mIsa = isa;
+		mKernel = &hsv::convertAvx2;
+	}
+#endif
+}
+
+void HsvConverter::convert(const uint16_t *hues, uint8_t saturation, uint8_t value, int count, uint32_t *colors) const
+{
+	mKernel(hues, saturation, value, count, colors);
+}
+
+void HsvConverter::apply(const uint16_t *hues, const CorsairLedId *ledIds, int count, uint8_t saturation, uint8_t value, Framebuffer &frame) const
+{
+	ColorLut::applyBlocks(ledIds, count, frame, [&](int start, int block, uint32_t *colors) {
+		convert(hues + start, saturation, value, block, colors);
+	});
+}
+
+uint32_t HsvConverter::toRgb(uint16_t hue, uint8_t saturation, uint8_t value)
+{
+	uint32_t color;
+	hsv::convertScalar(&hue, saturation, value, 1, &color);
+	return color;
+}
+
+uint16_t HsvConverter::hueOf(double turns)
+{
+	return static_cast<uint16_t>(static_cast<int64_t>(std::floor((turns - std::floor(turns)) * cHueTurn + .5)) & (cHueTurn - 1));
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "Compositor.h"
+#include "Framebuffer.h"
+
+#include <cstdint>
+
+/**
+ * @brief Converts batches of hues to RGB for rainbow and hue rotation effects.
+ *
+ * Hues are 16 bit fractions of a turn (cHueTurn is a full turn), so rotating a hue is a wrapping add.
+ * The conversion is integer only: every channel is value - value * saturation * w, with the weight w taken
+ * from min(k, 4 - k) clamped to [0..1] on the hue sextant k shifted for that channel, which selects the
+ * sector without branches. Results are packed as 0x00bbggrr like the entries of ColorLut.
+ *
+ * Kernels exist for AVX2 (16 hues per iteration) besides the plain C++ one; the best one supported by the
+ * CPU is picked at run time.
+ */
+class HsvConverter
+{
+public:
+	using Kernel = void (*)(const uint16_t *hues, int saturation, int value, int count, uint32_t *colors);
+
+	static const int cHueTurn = 65536;
+
+	explicit HsvConverter(Compositor::Isa isa = Compositor::bestIsa());
+
+	Compositor::Isa isa() const { return mIsa; }
+
+	/// Packed colors of count hues into colors, one per hue.
+	void convert(const uint16_t *hues, uint8_t saturation, uint8_t value, int count, uint32_t *colors) const;
+	/// Sets LED ledIds[i] of frame to the color of hues[i].
+	void apply(const uint16_t *hues, const CorsairLedId *ledIds, int count, uint8_t saturation, uint8_t value, Framebuffer &frame) const;
+
+	/// Color of a single hue, same as convert().
+	static uint32_t toRgb(uint16_t hue, uint8_t saturation = 255, uint8_t value = 255);
+	/// Hue of an angle in turns, wrapped to [0..1).
+	static uint16_t hueOf(double turns);
+
+private:
+	Compositor::Isa mIsa;
+	Kernel mKernel;
+};
@@ -0,0 +1,55 @@
+// Compiled with AVX2 code generation enabled (-mavx2); only reached through HsvConverter once the CPU reported AVX2.
+#include "HsvKernels.h"
+
+#ifdef CORSAIR_COMPOSITOR_AVX2
+#include <immintrin.h>
+
+namespace
+{
+	__m256i divide255(__m256i x)
+	{
+		const auto rounded = _mm256_add_epi32(x, _mm256_set1_epi32(128));
+		return _mm256_srli_epi32(_mm256_add_epi32(rounded, _mm256_srli_epi32(rounded, 8)), 8);
+	}
+
+	__m256i channel(__m256i h6, int shift, __m256i chroma, __m256i value)
+	{
+		auto k = _mm256_add_epi32(h6, _mm256_set1_epi32(shift << 16));
+		k = _mm256_sub_epi32(k, _mm256_and_si256(_mm256_cmpgt_epi32(k, _mm256_set1_epi32((6 << 16) - 1)), _mm256_set1_epi32(6 << 16)));
+		auto weight = _mm256_min_epi32(k, _mm256_sub_epi32(_mm256_set1_epi32(4 << 16), k));
+		weight = _mm256_min_epi32(_mm256_max_epi32(weight, _mm256_setzero_si256()), _mm256_set1_epi32(1 << 16));
+		weight = _mm256_srli_epi32(_mm256_add_epi32(_mm256_sub_epi32(_mm256_slli_epi32(weight, 8), weight), _mm256_set1_epi32(32768)), 16);
+		return _mm256_sub_epi32(value, divide255(_mm256_mullo_epi32(chroma, weight)));
+	}
+
+	/// Colors of eight hues widened to 32 bits.
+	__m256i convert8(__m256i hues, __m256i chroma, __m256i value)
+	{
+		const auto h6 = _mm256_add_epi32(_mm256_slli_epi32(hues, 2), _mm256_slli_epi32(hues, 1));
+		const auto r = channel(h6, 5, chroma, value);
+		const auto g = channel(h6, 3, chroma, value);
+		const auto b = channel(h6, 1, chroma, value);
+		return _mm256_or_si256(r, _mm256_or_si256(_mm256_slli_epi32(g, 8), _mm256_slli_epi32(b, 16)));
+	}
+}
+
+void hsv::convertAvx2(const uint16_t *hues, int saturation, int value, int count, uint32_t *colors)
+{
+	const auto values = _mm256_set1_epi32(value);
+	const auto chroma = divide255(_mm256_set1_epi32(value * saturation));
+	auto i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const auto packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hues + i));
+		const auto low = convert8(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(packed)), chroma, values);
+		const auto high = convert8(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(packed, 1)), chroma, values);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(colors + i), low);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(colors + i + 8), high);
+	}
+	if (i + 8 <= count) {
+		const auto low = convert8(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hues + i))), chroma, values);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(colors + i), low);
+		i += 8;
+	}
+	convertScalar(hues + i, saturation, value, count - i, colors + i);
+}
+#endif
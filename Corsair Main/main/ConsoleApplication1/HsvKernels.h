@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CompositorKernels.h"
+
+#include <cstdint>
+
+// Conversion kernels behind HsvConverter, picked like the ones of Compositor. Saturation and value are
+// shared by the whole batch; all kernels run the same integer math and return identical colors.
+
+namespace hsv
+{
+	void convertScalar(const uint16_t *hues, int saturation, int value, int count, uint32_t *colors);
+#ifdef CORSAIR_COMPOSITOR_AVX2
+	void convertAvx2(const uint16_t *hues, int saturation, int value, int count, uint32_t *colors);
+#endif
+}
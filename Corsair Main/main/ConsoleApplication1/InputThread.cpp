@@ -0,0 +1,125 @@
+#include "InputThread.h"
+#include "Profiler.h"
+
+#include "windows.h"
+#include <algorithm>
+#include <utility>
+
+InputThread::InputThread(const std::vector<int> &virtualKeys, Clock::duration pollInterval)
+	: mKeys(virtualKeys),
+	mPressed(virtualKeys.size(), false),
+	mLive(virtualKeys.size(), true),
+	mPollInterval(pollInterval),
+	mDroppedEvents(0),
+	mStop(false)
+{
+}
+
+InputThread::~InputThread()
+{
+	stop();
+}
+
+void InputThread::start()
+{
+	if (mThread.joinable()) {
+		return;
+	}
+	mLive.assign(mKeys.size(), true);
+	mStop.store(false, std::memory_order_relaxed);
+	mThread = std::thread(&InputThread::run, this);
+}
+
+void InputThread::startReplay(std::vector<KeyEvent> events, const std::vector<int> &liveKeys)
+{
+	if (mThread.joinable()) {
+		return;
+	}
+	for (size_t i = 0; i < mKeys.size(); ++i) {
+		mLive[i] = std::find(liveKeys.begin(), liveKeys.end(), mKeys[i]) != liveKeys.end();
+	}
+	mScript = std::move(events);
+	mStop.store(false, std::memory_order_relaxed);
+	mThread = std::thread(&InputThread::runReplay, this);
+}
+
+void InputThread::stop()
+{
+	mStop.store(true, std::memory_order_relaxed);
+	if (mThread.joinable()) {
+		mThread.join();
+	}
+	mScript.clear();
+}
+
+void InputThread::sample()
+{
+	for (size_t i = 0; i < mKeys.size(); ++i) {
+		if (!mLive[i]) {
+			continue;
+		}
+		// The most significant bit of GetAsyncKeyState() tells whether the key is down right now.
+		const bool pressed = (GetAsyncKeyState(mKeys[i]) & 0x8000) != 0;
+		if (pressed == mPressed[i]) {
+			continue;
+		}
+		mPressed[i] = pressed;
+		CORSAIR_PROFILE_INSTANT(pressed ? "key_down" : "key_up");
+		if (!mEvents.tryPush(KeyEvent{ Clock::now(), mKeys[i], pressed })) {
+			mDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+void InputThread::run()
+{
+	CORSAIR_PROFILE_THREAD("input");
+	poll();
+}
+
+void InputThread::poll()
+{
+	auto next = Clock::now();
+	while (!mStop.load(std::memory_order_relaxed)) {
+		sample();
+		// Absolute deadlines keep the sampling rate steady regardless of how long a pass took.
+		next += mPollInterval;
+		const auto now = Clock::now();
+		if (next < now) {
+			next = now;
+		}
+		std::this_thread::sleep_until(next);
+	}
+}
+
+void InputThread::runReplay()
+{
+	CORSAIR_PROFILE_THREAD("input (replay)");
+	const auto live = std::find(mLive.begin(), mLive.end(), true) != mLive.end();
+	auto next = Clock::now();
+	for (const auto &event : mScript) {
+		// Waits at most one poll interval at a time, so neither the live keys nor stop() are held up by a long pause.
+		while (true) {
+			if (mStop.load(std::memory_order_relaxed)) {
+				return;
+			}
+			const auto now = Clock::now();
+			if (live && now >= next) {
+				sample();
+				next = now + mPollInterval;
+			}
+			if (now >= event.timestamp) {
+				break;
+			}
+			const auto wake = live ? next : now + mPollInterval;
+			std::this_thread::sleep_until(event.timestamp < wake ? event.timestamp : wake);
+		}
+		CORSAIR_PROFILE_INSTANT(event.pressed ? "key_down" : "key_up");
+		if (!mEvents.tryPush(event)) {
+			mDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	if (live) {
+		poll();
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "SpscRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/// Press or release of a key, stamped when the input thread saw it.
+struct KeyEvent
+{
+	std::chrono::steady_clock::time_point timestamp;
+	int virtualKey;     /**< Windows virtual key code, as passed to GetAsyncKeyState() */
+	bool pressed;       /**< true for a press, false for a release */
+};
+
+/**
+ * @brief Samples a set of keys on its own thread and queues their presses and releases for the render thread.
+ *
+ * Sampling runs at pollInterval independently of the frame rate, so an event carries the time the key changed
+ * (within one poll interval) rather than the time of the next frame. Events go through an SpscRing: the input
+ * thread is the only producer and whoever calls nextEvent(), normally the render thread, the only consumer.
+ * A replay can take the place of the keyboard, see startReplay().
+ */
+class InputThread
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static const size_t cQueueCapacity = 256;
+
+	explicit InputThread(const std::vector<int> &virtualKeys, Clock::duration pollInterval = std::chrono::milliseconds(1));
+	~InputThread();
+
+	InputThread(const InputThread&) = delete;
+	InputThread& operator=(const InputThread&) = delete;
+
+	void start();
+	void stop();
+
+	/**
+	 * @brief Starts the thread on scripted events instead of the keyboard, e.g. the keyEvents() of a Replay.
+	 *
+	 * Each event is queued once its timestamp has come, carrying that timestamp, so latencies measured from
+	 * it are the same as for live input. events must be sorted by timestamp. Those of the sampled keys that
+	 * are in liveKeys, e.g. VK_ESCAPE, are still sampled from the keyboard, during the script and after it.
+	 */
+	void startReplay(std::vector<KeyEvent> events, const std::vector<int> &liveKeys = std::vector<int>());
+
+	/// Takes the oldest queued event. Consumer side only.
+	bool nextEvent(KeyEvent &event) { return mEvents.tryPop(event); }
+
+	/// Polls every live key once and queues changes. Called by the input thread; call it directly only while the thread is stopped.
+	void sample();
+
+	/// Number of events lost because the consumer fell more than cQueueCapacity events behind.
+	int64_t droppedEvents() const { return mDroppedEvents.load(std::memory_order_relaxed); }
+
+private:
+	void run();
+	void runReplay();
+	/// Samples the live keys every poll interval until stop().
+	void poll();
+
+	std::vector<int> mKeys;
+	std::vector<bool> mPressed;
+	std::vector<bool> mLive;         /**< Keys sample() polls: all of them, or the liveKeys of a replay */
+	Clock::duration mPollInterval;
+	std::vector<KeyEvent> mScript;
+	SpscRing<KeyEvent, cQueueCapacity> mEvents;
+	std::atomic<int64_t> mDroppedEvents;
+	std::atomic<bool> mStop;
+	std::thread mThread;
+};
@@ -0,0 +1,112 @@
+#include "KeyLayoutTable.h"
+#include "Profiler.h"
+
+#include "windows.h"
+
+#include <algorithm>
+
+KeyLayoutTable::KeyLayoutTable()
+	: mCurrent(&emptyTable()), mLayout(CLL_Invalid), mBuilds(0)
+{
+}
+
+const KeyLayoutTable::Table& KeyLayoutTable::emptyTable()
+{
+	static const Table table = [] {
+		Table empty;
+		std::fill(std::begin(empty.leds), std::end(empty.leds), CLI_Invalid);
+		std::fill(std::begin(empty.labels), std::end(empty.labels), '\0');
+		return empty;
+	}();
+	return table;
+}
+
+CorsairLedId KeyLayoutTable::ledOfVirtualKey(int virtualKey) const
+{
+	// Virtual key codes of letters and digits are their uppercase characters, the keys themselves type lowercase.
+	if (virtualKey >= 'A' && virtualKey <= 'Z') {
+		return ledOf(static_cast<char>(virtualKey - 'A' + 'a'));
+	}
+	if (virtualKey >= '0' && virtualKey <= '9') {
+		return ledOf(static_cast<char>(virtualKey));
+	}
+	if (virtualKey == VK_SPACE) {
+		return CLK_Space;
+	}
+	return virtualKey == VK_OEM_1 ? ledOf(';') : CLI_Invalid;
+}
+
+bool KeyLayoutTable::update(CorsairLogicalLayout layout)
+{
+	if (layout <= CLL_Invalid) {
+		return false;
+	}
+	if (select(layout)) {
+		return true;
+	}
+
+	CORSAIR_PROFILE_SCOPE("KeyLayoutTable::build");
+	int32_t leds[cCharacters];
+	for (auto i = 0; i < cCharacters; ++i) {
+		leds[i] = CorsairGetLedIdForKeyName(static_cast<char>(i));
+	}
+	if (!install(layout, leds)) {
+		return false;
+	}
+	++mBuilds;
+	return true;
+}
+
+bool KeyLayoutTable::load(CorsairLogicalLayout layout, const int32_t leds[cCharacters])
+{
+	return layout > CLL_Invalid && (select(layout) || install(layout, leds));
+}
+
+bool KeyLayoutTable::select(CorsairLogicalLayout layout)
+{
+	const auto index = static_cast<size_t>(layout);
+	if (index >= mTables.size() || !mTables[index]) {
+		return false;
+	}
+	mCurrent = mTables[index].get();
+	mLayout = layout;
+	return true;
+}
+
+bool KeyLayoutTable::install(CorsairLogicalLayout layout, const int32_t leds[cCharacters])
+{
+	std::unique_ptr<Table> table(new Table(emptyTable()));
+	auto resolved = false;
+	// Going down from the highest character leaves every label at the lowest one typed on the key.
+	for (auto i = cCharacters - 1; i >= 0; --i) {
+		const auto ledId = static_cast<CorsairLedId>(leds[i]);
+		if (ledId <= CLI_Invalid || ledId > CLI_Last) {
+			continue;
+		}
+		table->leds[i] = ledId;
+		table->labels[ledId] = static_cast<char>(i);
+		resolved = true;
+	}
+	if (!resolved) {
+		return false;
+	}
+	const auto index = static_cast<size_t>(layout);
+	if (index >= mTables.size()) {
+		mTables.resize(index + 1);
+	}
+	mTables[index] = std::move(table);
+	mCurrent = mTables[index].get();
+	mLayout = layout;
+	return true;
+}
+
+bool KeyLayoutTable::updateFromSdk()
+{
+	for (auto deviceIndex = 0; deviceIndex < CorsairGetDeviceCount(); ++deviceIndex) {
+		const auto info = CorsairGetDeviceInfo(deviceIndex);
+		if (info && info->type == CDT_Keyboard) {
+			return update(info->logicalLayout);
+		}
+	}
+	return false;
+}
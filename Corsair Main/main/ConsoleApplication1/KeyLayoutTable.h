@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CUESDK.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Characters to LEDs and back for the keyboard's logical layout, resolved through the SDK once per layout.
+ *
+ * CorsairGetLedIdForKeyName() is a round trip to CUE for every character. update() asks it about all 256
+ * characters once and keeps the result per layout, so the SDK is only asked again when the keyboard is
+ * switched to a layout the table has not seen yet. ledOf() and labelOf() are plain array reads.
+ */
+class KeyLayoutTable
+{
+public:
+	static const int cCharacters = 256;
+
+	KeyLayoutTable();
+
+	KeyLayoutTable(const KeyLayoutTable&) = delete;
+	KeyLayoutTable& operator=(const KeyLayoutTable&) = delete;
+
+	/**
+	 * @brief Switches to the tables of layout, building them through the SDK unless they were built before.
+	 *
+	 * Returns false and keeps the current tables if the SDK resolves no character, e.g. when not connected.
+	 */
+	bool update(CorsairLogicalLayout layout);
+	/// Same as update() with the layout of the first keyboard CUE reports.
+	bool updateFromSdk();
+	/**
+	 * @brief Switches to the tables of layout, building them from the LED of every key name, e.g. DeviceCache::keyLeds().
+	 *
+	 * Does not call the SDK, so works before the handshake. Tables built before for layout are kept.
+	 */
+	bool load(CorsairLogicalLayout layout, const int32_t leds[cCharacters]);
+
+	/// Layout of the current tables, CLL_Invalid before the first update().
+	CorsairLogicalLayout layout() const { return mLayout; }
+
+	/// LED typing keyName, CLI_Invalid if no key does.
+	CorsairLedId ledOf(char keyName) const { return mCurrent->leds[static_cast<unsigned char>(keyName)]; }
+	/// LED of the key with Windows virtual key code virtualKey: letters, digits, Space and ';', CLI_Invalid for others.
+	CorsairLedId ledOfVirtualKey(int virtualKey) const;
+
+	/**
+	 * @brief Label of the LED's key: the lowest character typed on it, 0 if none is.
+	 *
+	 * For letter keys that is the uppercase letter as long as the SDK resolves both cases.
+	 */
+	char labelOf(CorsairLedId ledId) const { return ledId > CLI_Invalid && ledId <= CLI_Last ? mCurrent->labels[ledId] : 0; }
+
+	/// Number of tables built through the SDK so far.
+	int builds() const { return mBuilds; }
+
+private:
+	struct Table
+	{
+		CorsairLedId leds[cCharacters];
+		char labels[CLI_Last + 1];
+	};
+
+	static const Table& emptyTable();
+	/// Builds and switches to the tables of layout from the LED of every character. Returns false if none has one.
+	bool install(CorsairLogicalLayout layout, const int32_t leds[cCharacters]);
+	/// Switches to the tables of layout if they were built before.
+	bool select(CorsairLogicalLayout layout);
+
+	std::vector<std::unique_ptr<Table>> mTables;   /**< Indexed by CorsairLogicalLayout, null for layouts not built yet */
+	const Table *mCurrent;
+	CorsairLogicalLayout mLayout;
+	int mBuilds;
+};
@@ -0,0 +1,40 @@
+#include "KeySplash.h"
+
+#include <algorithm>
+
+KeySplash::KeySplash(Clock::duration duration, uint8_t r, uint8_t g, uint8_t b)
+	: mDuration(duration > Clock::duration::zero() ? duration : Clock::duration(1)), mRed(r), mGreen(g), mBlue(b)
+{
+	mSplashes.reserve(Framebuffer::cCapacity);
+}
+
+void KeySplash::trigger(CorsairLedId ledId, Clock::time_point at)
+{
+	for (auto &splash : mSplashes) {
+		if (splash.ledId == ledId) {
+			splash.start = at;
+			return;
+		}
+	}
+	mSplashes.push_back(Splash{ ledId, at });
+}
+
+void KeySplash::render(Framebuffer &layer, Clock::time_point frameTime)
+{
+	layer.clear();
+	expire(frameTime);
+
+	for (const auto &splash : mSplashes) {
+		// A hit stamped after the deadline (picked up late in the frame) shows at full intensity.
+		const auto elapsed = std::max(frameTime - splash.start, Clock::duration::zero());
+		const auto remaining = 1. - static_cast<double>(elapsed.count()) / mDuration.count();
+		layer.set(splash.ledId, mRed, mGreen, mBlue, static_cast<uint8_t>(remaining * 255. + .5));
+	}
+}
+
+void KeySplash::expire(Clock::time_point now)
+{
+	mSplashes.erase(std::remove_if(mSplashes.begin(), mSplashes.end(), [&](const Splash &splash) {
+		return now - splash.start >= mDuration;
+	}), mSplashes.end());
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "Framebuffer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Reactive effect lighting up a LED when its key is hit and fading it out linearly.
+ *
+ * The fade is evaluated against the time of the key event, not the frame it was picked up in, so a hit
+ * that happened half a frame before the deadline already shows half a frame of decay.
+ */
+class KeySplash
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit KeySplash(Clock::duration duration = std::chrono::milliseconds(300), uint8_t r = 255, uint8_t g = 255, uint8_t b = 255);
+
+	/// Starts (or restarts) the splash of a LED at the time of the hit.
+	void trigger(CorsairLedId ledId, Clock::time_point at);
+
+	/**
+	 * @brief Renders splashes as they are at frameTime into layer, which is meant for BlendMode::Alpha.
+	 *
+	 * layer is cleared first; splashing LEDs become active with the remaining intensity in the alpha plane.
+	 * Finished splashes are dropped.
+	 */
+	void render(Framebuffer &layer, Clock::time_point frameTime);
+
+	/// Drops splashes that are over at now without rendering, e.g. to checkpoint the effect between frames.
+	void expire(Clock::time_point now);
+
+	int activeCount() const { return static_cast<int>(mSplashes.size()); }
+	Clock::duration duration() const { return mDuration; }
+
+private:
+	struct Splash
+	{
+		CorsairLedId ledId;
+		Clock::time_point start;
+	};
+
+	Clock::duration mDuration;
+	uint8_t mRed;
+	uint8_t mGreen;
+	uint8_t mBlue;
+	std::vector<Splash> mSplashes;
+};
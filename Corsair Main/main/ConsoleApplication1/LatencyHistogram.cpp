@@ -0,0 +1,107 @@
+#include "LatencyHistogram.h"
+
+#include <sstream>
+
+namespace
+{
+	int highestBit(uint64_t value)
+	{
+		auto bit = 0;
+		while (value >>= 1) {
+			bit++;
+		}
+		return bit;
+	}
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+	reset();
+}
+
+void LatencyHistogram::record(int64_t microseconds)
+{
+	if (microseconds < 0) {
+		microseconds = 0;
+	}
+	mBuckets[bucketOf(microseconds)].fetch_add(1, std::memory_order_relaxed);
+	mCount.fetch_add(1, std::memory_order_relaxed);
+	mSum.fetch_add(microseconds, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::reset()
+{
+	for (auto &bucket : mBuckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	mCount.store(0, std::memory_order_relaxed);
+	mSum.store(0, std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::count() const
+{
+	return mCount.load(std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::max() const
+{
+	for (auto bucket = cBuckets - 1; bucket >= 0; --bucket) {
+		if (mBuckets[bucket].load(std::memory_order_relaxed)) {
+			return bucketUpperBound(bucket);
+		}
+	}
+	return 0;
+}
+
+double LatencyHistogram::mean() const
+{
+	const auto samples = count();
+	return samples ? static_cast<double>(mSum.load(std::memory_order_relaxed)) / samples : 0.;
+}
+
+int64_t LatencyHistogram::percentile(double percent) const
+{
+	const auto samples = count();
+	if (!samples) {
+		return 0;
+	}
+	auto rank = static_cast<int64_t>(samples * percent / 100. + .5);
+	rank = rank < 1 ? 1 : (rank > samples ? samples : rank);
+	int64_t seen = 0;
+	for (auto bucket = 0; bucket < cBuckets; ++bucket) {
+		seen += mBuckets[bucket].load(std::memory_order_relaxed);
+		if (seen >= rank) {
+			return bucketUpperBound(bucket);
+		}
+	}
+	return max();
+}
+
+std::string LatencyHistogram::summary() const
+{
+	std::ostringstream out;
+	out << "n=" << count() << " mean=" << static_cast<int64_t>(mean() + .5) << "us p50=" << percentile(50)
+		<< "us p90=" << percentile(90) << "us p99=" << percentile(99) << "us max=" << max() << "us";
+	return out.str();
+}
+
+int LatencyHistogram::bucketOf(int64_t microseconds)
+{
+	const auto value = static_cast<uint64_t>(microseconds);
+	if (value < static_cast<uint64_t>(cSubBuckets)) {
+		return static_cast<int>(value);
+	}
+	const auto exponent = highestBit(value);
+	const auto bucket = (exponent - cSubBucketBits + 1) * cSubBuckets + static_cast<int>((value >> (exponent - cSubBucketBits)) & (cSubBuckets - 1));
+	return bucket < cBuckets ? bucket : cBuckets - 1;
+}
+
+int64_t LatencyHistogram::bucketUpperBound(int bucket)
+{
+	if (bucket < cSubBuckets) {
+		return bucket;
+	}
+	const auto exponent = bucket / cSubBuckets + cSubBucketBits - 1;
+	const auto subBucket = bucket % cSubBuckets;
+	return ((static_cast<int64_t>(cSubBuckets + subBucket + 1)) << (exponent - cSubBucketBits)) - 1;
+}
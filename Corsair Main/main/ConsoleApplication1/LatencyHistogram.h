@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Log-linear histogram of durations in microseconds.
+ *
+ * Every power of two is split into cSubBuckets buckets, so a recorded value is off by at most 1/cSubBuckets
+ * of itself, less than 1%; values below 2^cRangeBits, about nine minutes, are tracked, longer ones land in
+ * the last bucket. record() is wait-free, three atomic adds, and may be called from any thread while
+ * another one reads; max() is the upper bound of the highest bucket in use rather than tracked exactly.
+ */
+class LatencyHistogram
+{
+public:
+	static const int cSubBucketBits = 7;
+	static const int cSubBuckets = 1 << cSubBucketBits;
+	static const int cRangeBits = 29;
+	static const int cBuckets = (cRangeBits - cSubBucketBits + 1) * cSubBuckets;
+
+	LatencyHistogram();
+
+	LatencyHistogram(const LatencyHistogram&) = delete;
+	LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+	void record(int64_t microseconds);
+	void reset();
+
+	int64_t count() const;
+	/// Largest value of the highest bucket a value was recorded in, zero if nothing was recorded.
+	int64_t max() const;
+	int64_t sum() const { return mSum.load(std::memory_order_relaxed); }
+	/// Number of values recorded in the bucket.
+	int64_t bucketCount(int bucket) const { return mBuckets[bucket].load(std::memory_order_relaxed); }
+	double mean() const;
+
+	/// Upper bound of the bucket holding the given percentile [0..100], zero if nothing was recorded.
+	int64_t percentile(double percent) const;
+
+	/// One line with count, mean, p50, p90, p99 and max, e.g. for the console.
+	std::string summary() const;
+
+	static int bucketOf(int64_t microseconds);
+	/// Largest value that falls into specified bucket.
+	static int64_t bucketUpperBound(int bucket);
+
+private:
+	std::atomic<int64_t> mBuckets[cBuckets];
+	std::atomic<int64_t> mCount;
+	std::atomic<int64_t> mSum;
+};
@@ -0,0 +1,178 @@
+#include "LedGeometry.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+	const float cPi = 3.14159265358979f;
+
+	float median(std::vector<float> values, float fallback)
+	{
+		if (values.empty()) {
+			return fallback;
+		}
+		const auto middle = values.begin() + values.size() / 2;
+		std::nth_element(values.begin(), middle, values.end());
+		return *middle > 0.f ? *middle : fallback;
+	}
+}
+
+LedGeometry::LedGeometry()
+{
+	clear();
+}
+
+void LedGeometry::clear()
+{
+	mLedIds.clear();
+	mCenterX.clear();
+	mCenterY.clear();
+	mNormalizedX.clear();
+	mNormalizedY.clear();
+	mRows.clear();
+	mColumns.clear();
+	std::fill(std::begin(mIndexOfLed), std::end(mIndexOfLed), static_cast<int16_t>(-1));
+	mBounds = LedBounds{ 0.f, 0.f, 0.f, 0.f };
+	mRowCount = 0;
+	mColumnCount = 0;
+	mCellSize = static_cast<float>(cKeyPitchMm);
+	mGridColumns = 0;
+	mGridRows = 0;
+	mCellStart.clear();
+	mCellLeds.clear();
+	mOrigins.clear();
+}
+
+bool LedGeometry::load(const CorsairLedPositions *positions, float cellSizeMm)
+{
+	clear();
+	if (!positions || positions->numberOfLed <= 0 || !positions->pLedPosition) {
+		return false;
+	}
+
+	std::vector<float> heights;
+	for (auto i = 0; i < positions->numberOfLed; ++i) {
+		const auto &position = positions->pLedPosition[i];
+		if (position.ledId <= CLI_Invalid || position.ledId >= Framebuffer::cCapacity || mIndexOfLed[position.ledId] >= 0) {
+			continue;
+		}
+		const auto right = static_cast<float>(position.left + position.width);
+		const auto bottom = static_cast<float>(position.top + position.height);
+		if (mLedIds.empty()) {
+			mBounds = LedBounds{ static_cast<float>(position.left), static_cast<float>(position.top), right, bottom };
+		} else {
+			mBounds.left = std::min(mBounds.left, static_cast<float>(position.left));
+			mBounds.top = std::min(mBounds.top, static_cast<float>(position.top));
+			mBounds.right = std::max(mBounds.right, right);
+			mBounds.bottom = std::max(mBounds.bottom, bottom);
+		}
+		mIndexOfLed[position.ledId] = static_cast<int16_t>(mLedIds.size());
+		mLedIds.push_back(position.ledId);
+		mCenterX.push_back(static_cast<float>(position.left + position.width / 2));
+		mCenterY.push_back(static_cast<float>(position.top + position.height / 2));
+		heights.push_back(static_cast<float>(position.height));
+	}
+	if (mLedIds.empty()) {
+		return false;
+	}
+
+	const auto width = std::max(mBounds.width(), 1.f);
+	const auto height = std::max(mBounds.height(), 1.f);
+	for (auto i = 0; i < count(); ++i) {
+		mNormalizedX.push_back((mCenterX[i] - mBounds.left) / width);
+		mNormalizedY.push_back((mCenterY[i] - mBounds.top) / height);
+	}
+
+	clusterRows(median(heights, static_cast<float>(cKeyPitchMm)));
+	buildGrid(cellSizeMm > 0.f ? cellSizeMm : static_cast<float>(cKeyPitchMm));
+	return true;
+}
+
+bool LedGeometry::loadFromSdk()
+{
+	return load(CorsairGetLedPositions());
+}
+
+bool LedGeometry::loadFromDevice(int deviceIndex)
+{
+	return load(CorsairGetLedPositionsByDeviceIndex(deviceIndex));
+}
+
+void LedGeometry::clusterRows(float keyHeight)
+{
+	std::vector<int> order(count());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [this](int a, int b) { return mCenterY[a] < mCenterY[b]; });
+
+	mRows.assign(count(), 0);
+	auto row = 0;
+	for (size_t i = 1; i < order.size(); ++i) {
+		if (mCenterY[order[i]] - mCenterY[order[i - 1]] > keyHeight / 2) {
+			row++;
+		}
+		mRows[order[i]] = static_cast<int16_t>(row);
+	}
+	mRowCount = row + 1;
+
+	// The horizontal key pitch is the typical distance between neighbors within a row.
+	std::sort(order.begin(), order.end(), [this](int a, int b) {
+		return mRows[a] != mRows[b] ? mRows[a] < mRows[b] : mCenterX[a] < mCenterX[b];
+	});
+	std::vector<float> gaps;
+	for (size_t i = 1; i < order.size(); ++i) {
+		if (mRows[order[i]] == mRows[order[i - 1]]) {
+			gaps.push_back(mCenterX[order[i]] - mCenterX[order[i - 1]]);
+		}
+	}
+	const auto pitch = median(gaps, static_cast<float>(cKeyPitchMm));
+
+	mColumns.assign(count(), 0);
+	mColumnCount = 0;
+	for (auto i = 0; i < count(); ++i) {
+		mColumns[i] = static_cast<int16_t>((mCenterX[i] - mBounds.left) / pitch);
+		mColumnCount = std::max(mColumnCount, mColumns[i] + 1);
+	}
+}
+
+void LedGeometry::buildGrid(float cellSize)
+{
+	mCellSize = cellSize;
+	mGridColumns = std::max(1, static_cast<int>(std::ceil(mBounds.width() / cellSize)));
+	mGridRows = std::max(1, static_cast<int>(std::ceil(mBounds.height() / cellSize)));
+
+	// Counting sort of the LEDs by cell.
+	std::vector<int> cells(count());
+	mCellStart.assign(mGridColumns * mGridRows + 1, 0);
+	for (auto i = 0; i < count(); ++i) {
+		cells[i] = cellRow(mCenterY[i]) * mGridColumns + cellColumn(mCenterX[i]);
+		mCellStart[cells[i] + 1]++;
+	}
+	std::partial_sum(mCellStart.begin(), mCellStart.end(), mCellStart.begin());
+	mCellLeds.assign(count(), 0);
+	auto next = mCellStart;
+	for (auto i = 0; i < count(); ++i) {
+		mCellLeds[next[cells[i]]++] = static_cast<int16_t>(i);
+	}
+}
+
+int LedGeometry::addOrigin(float normalizedX, float normalizedY)
+{
+	const auto x = mBounds.left + normalizedX * mBounds.width();
+	const auto y = mBounds.top + normalizedY * mBounds.height();
+	Origin origin;
+	origin.distances.resize(count());
+	origin.angles.resize(count());
+	origin.maxDistance = 0.f;
+	for (auto i = 0; i < count(); ++i) {
+		const auto dx = mCenterX[i] - x;
+		const auto dy = mCenterY[i] - y;
+		origin.distances[i] = std::sqrt(dx * dx + dy * dy);
+		origin.maxDistance = std::max(origin.maxDistance, origin.distances[i]);
+		auto angle = std::atan2(dy, dx) / (2 * cPi);
+		angle = angle < 0.f ? angle + 1.f : angle;
+		origin.angles[i] = angle < 1.f ? angle : 0.f;
+	}
+	mOrigins.push_back(std::move(origin));
+	return originCount() - 1;
+}
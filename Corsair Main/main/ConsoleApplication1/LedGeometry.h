@@ -0,0 +1,143 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "Framebuffer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/// Axis aligned rectangle in millimeters.
+struct LedBounds
+{
+	float left;
+	float top;
+	float right;
+	float bottom;
+
+	float width() const { return right - left; }
+	float height() const { return bottom - top; }
+};
+
+/**
+ * @brief Geometry of a set of LEDs, computed once from CorsairGetLedPositions() and queried per frame.
+ *
+ * LEDs are stored in the order the SDK returned them; index i of every array refers to the same LED and
+ * indexOf() maps a CorsairLedId to its index in O(1). Per LED the cache holds centers in millimeters and
+ * normalized to the bounding box, the row and column the key belongs to, and for every origin added with
+ * addOrigin() its distance and angle. A uniform grid of cells answers neighborhood queries.
+ *
+ * Rows are found by splitting the vertically sorted centers wherever the gap exceeds half a key. Keys of
+ * neighboring rows are staggered, so columns are the horizontal key pitch the center falls into instead.
+ */
+class LedGeometry
+{
+public:
+	/// Median key pitch of Corsair keyboards, the default grid cell size.
+	static const int cKeyPitchMm = 19;
+
+	LedGeometry();
+
+	/// Rebuilds the cache from specified positions. Returns false and leaves the cache empty if there are none.
+	bool load(const CorsairLedPositions *positions, float cellSizeMm = static_cast<float>(cKeyPitchMm));
+	/// Same as load() with CorsairGetLedPositions().
+	bool loadFromSdk();
+	/// Same as load() with CorsairGetLedPositionsByDeviceIndex().
+	bool loadFromDevice(int deviceIndex);
+
+	int count() const { return static_cast<int>(mLedIds.size()); }
+	bool empty() const { return mLedIds.empty(); }
+
+	/// Index of the LED in the arrays below, or -1 if the LED is not part of the geometry.
+	int indexOf(CorsairLedId ledId) const
+	{
+		return ledId > CLI_Invalid && ledId < Framebuffer::cCapacity ? mIndexOfLed[ledId] : -1;
+	}
+
+	const CorsairLedId* ledIds() const { return mLedIds.data(); }
+	/// Centers in millimeters.
+	const float* centerX() const { return mCenterX.data(); }
+	const float* centerY() const { return mCenterY.data(); }
+	/// Centers relative to the bounding box, [0..1] on both axes.
+	const float* normalizedX() const { return mNormalizedX.data(); }
+	const float* normalizedY() const { return mNormalizedY.data(); }
+	const int16_t* rows() const { return mRows.data(); }
+	const int16_t* columns() const { return mColumns.data(); }
+	const LedBounds& bounds() const { return mBounds; }
+	int rowCount() const { return mRowCount; }
+	int columnCount() const { return mColumnCount; }
+
+	/**
+	 * @brief Precomputes distance and angle of every LED around a point given in normalized coordinates.
+	 * @return Index of the origin for distances() and angles().
+	 */
+	int addOrigin(float normalizedX, float normalizedY);
+	int originCount() const { return static_cast<int>(mOrigins.size()); }
+	/// Distances from the origin in millimeters.
+	const float* distances(int origin) const { return mOrigins[origin].distances.data(); }
+	/// Largest of distances(origin), handy to turn a distance into a [0..1] phase.
+	float maxDistance(int origin) const { return mOrigins[origin].maxDistance; }
+	/// Angles around the origin in turns [0..1), 0 pointing right and growing clockwise (y grows downwards).
+	const float* angles(int origin) const { return mOrigins[origin].angles.data(); }
+
+	/// Calls function(index) for every LED whose center lies within radius millimeters of (x, y).
+	template <typename Function>
+	void forEachNear(float x, float y, float radius, Function function) const
+	{
+		if (empty()) {
+			return;
+		}
+		const auto firstColumn = cellColumn(x - radius);
+		const auto lastColumn = cellColumn(x + radius);
+		const auto firstRow = cellRow(y - radius);
+		const auto lastRow = cellRow(y + radius);
+		for (auto row = firstRow; row <= lastRow; ++row) {
+			for (auto column = firstColumn; column <= lastColumn; ++column) {
+				const auto cell = row * mGridColumns + column;
+				for (auto entry = mCellStart[cell]; entry < mCellStart[cell + 1]; ++entry) {
+					const auto index = mCellLeds[entry];
+					const auto dx = mCenterX[index] - x;
+					const auto dy = mCenterY[index] - y;
+					if (dx * dx + dy * dy <= radius * radius) {
+						function(index);
+					}
+				}
+			}
+		}
+	}
+
+private:
+	struct Origin
+	{
+		std::vector<float> distances;
+		std::vector<float> angles;
+		float maxDistance;
+	};
+
+	void clear();
+	void clusterRows(float keyHeight);
+	void buildGrid(float cellSize);
+	int cellColumn(float x) const { return clampCell(static_cast<int>(std::floor((x - mBounds.left) / mCellSize)), mGridColumns); }
+	int cellRow(float y) const { return clampCell(static_cast<int>(std::floor((y - mBounds.top) / mCellSize)), mGridRows); }
+	static int clampCell(int cell, int cells) { return cell < 0 ? 0 : (cell >= cells ? cells - 1 : cell); }
+
+	std::vector<CorsairLedId> mLedIds;
+	std::vector<float> mCenterX;
+	std::vector<float> mCenterY;
+	std::vector<float> mNormalizedX;
+	std::vector<float> mNormalizedY;
+	std::vector<int16_t> mRows;
+	std::vector<int16_t> mColumns;
+	int16_t mIndexOfLed[Framebuffer::cCapacity];
+	LedBounds mBounds;
+	int mRowCount;
+	int mColumnCount;
+
+	float mCellSize;
+	int mGridColumns;
+	int mGridRows;
+	std::vector<int> mCellStart;     /**< Cell c holds mCellLeds[mCellStart[c]..mCellStart[c + 1]) */
+	std::vector<int16_t> mCellLeds;
+
+	std::vector<Origin> mOrigins;
+};
@@ -0,0 +1,374 @@
+#include "LightingTimeline.h"
+
+#include "Beatmap.h"
+#include "CompositorKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+	const char cMagic[4] = { 'C', 'L', 'T', 'L' };
+	/// Beats closer than this are merged, so a broken red line cannot produce a keyframe per millisecond.
+	const double cMinBeatSpacing = 60.;
+
+	LightingColor scale(const LightingColor &color, uint8_t brightness)
+	{
+		return LightingColor{
+			static_cast<uint8_t>(compositor::div255(color.red * brightness)),
+			static_cast<uint8_t>(compositor::div255(color.green * brightness)),
+			static_cast<uint8_t>(compositor::div255(color.blue * brightness))
+		};
+	}
+
+	TimelineKeyframe keyframe(int time, const LightingColor &color, uint8_t flags)
+	{
+		return TimelineKeyframe{ time, color.red, color.green, color.blue, flags };
+	}
+
+	uint8_t lerp(uint8_t from, uint8_t to, int weight)
+	{
+		return static_cast<uint8_t>(from + compositor::div255((to - from) * weight));
+	}
+
+	void hashBytes(uint32_t &hash, const void *data, size_t size)
+	{
+		const auto bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			hash = (hash ^ bytes[i]) * 16777619u;
+		}
+	}
+
+	void hashColor(uint32_t &hash, const LightingColor &color)
+	{
+		const uint8_t channels[] = { color.red, color.green, color.blue };
+		hashBytes(hash, channels, sizeof(channels));
+	}
+
+	bool insideBreak(const std::vector<BeatmapBreak> &breaks, int time)
+	{
+		for (const auto &pause : breaks) {
+			if (time > pause.start && time < pause.end) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+LightingProfile::LightingProfile()
+	: base{ 0, 48, 255 }
+	, kiai{ 255, 64, 0 }
+	, breakColor{ 8, 8, 32 }
+	, beatFloor(64)
+	, offbeatPeak(160)
+	, beatDecay(.6f)
+	, flashMs(250)
+	, spotWidth(48)
+	, useBeatmapColours(true)
+	, comboColors{ { 255, 192, 0 }, { 0, 202, 0 }, { 18, 124, 255 }, { 242, 24, 57 } }
+{
+}
+
+uint32_t LightingProfile::hash() const
+{
+	auto hash = 2166136261u;
+	hashColor(hash, base);
+	hashColor(hash, kiai);
+	hashColor(hash, breakColor);
+	const uint8_t levels[] = { beatFloor, offbeatPeak, spotWidth, static_cast<uint8_t>(useBeatmapColours) };
+	hashBytes(hash, levels, sizeof(levels));
+	const auto decay = static_cast<int32_t>(beatDecay * 1000.f);
+	hashBytes(hash, &decay, sizeof(decay));
+	hashBytes(hash, &flashMs, sizeof(flashMs));
+	for (const auto &color : comboColors) {
+		hashColor(hash, color);
+	}
+	return hash;
+}
+
+LightingTimeline::LightingTimeline()
+{
+	clear();
+}
+
+void LightingTimeline::clear()
+{
+	mImage.clear();
+	mHeader = nullptr;
+	mKeyframes = nullptr;
+	mTriggers = nullptr;
+}
+
+bool LightingTimeline::compile(const Beatmap &beatmap, const uint8_t beatmapHash[Md5::cDigestSize], const LightingProfile &profile)
+{
+	clear();
+	const auto objectCount = beatmap.objectCount();
+	if (!objectCount) {
+		return false;
+	}
+	const auto fade = std::min(std::max(profile.flashMs, 0), 65535);
+	const auto lastEnd = beatmap.maxEndTimes()[objectCount - 1] + fade;
+	const auto timingPointCount = beatmap.timingPointCount();
+	auto breaks = beatmap.breaks();
+	std::sort(breaks.begin(), breaks.end(), [](const BeatmapBreak &a, const BeatmapBreak &b) { return a.start < b.start; });
+
+	// Keyboard color: a pulse on every beat of every red line, colored by kiai time, held during breaks.
+	std::vector<TimelineKeyframe> keyframes;
+	for (auto point = 0; point < timingPointCount; ++point) {
+		const auto beatLength = beatmap.beatLengths()[point];
+		if (!(beatmap.timingFlags()[point] & TPF_Uninherited) || !(beatLength > 0.)) {
+			continue;
+		}
+		auto segmentEnd = lastEnd;
+		for (auto next = point + 1; next < timingPointCount; ++next) {
+			if (beatmap.timingFlags()[next] & TPF_Uninherited) {
+				segmentEnd = beatmap.timingTimes()[next];
+				break;
+			}
+		}
+		const auto stride = std::max(1., std::ceil(cMinBeatSpacing / beatLength));
+		const auto spacing = beatLength * stride;
+		const auto meter = beatmap.meters()[point] ? beatmap.meters()[point] : 4;
+		const auto redLine = beatmap.timingTimes()[point];
+		for (auto beat = 0; redLine + beat * spacing < segmentEnd; ++beat) {
+			const auto time = static_cast<int>(std::lround(redLine + beat * spacing));
+			const auto current = beatmap.timingPointAt(time);
+			const auto &color = beatmap.timingFlags()[current] & TPF_Kiai ? profile.kiai : profile.base;
+			const auto downbeat = static_cast<int64_t>(beat * stride) % meter == 0;
+			const auto peak = downbeat ? static_cast<uint8_t>(255) : std::max(profile.offbeatPeak, profile.beatFloor);
+			keyframes.push_back(keyframe(time, scale(color, peak), 0));
+			if (profile.beatFloor < peak) {
+				const auto decay = std::max(1, static_cast<int>(std::lround(spacing * profile.beatDecay)));
+				keyframes.push_back(keyframe(time + decay, scale(color, profile.beatFloor), TKF_Step));
+			}
+		}
+	}
+	if (keyframes.empty()) {
+		keyframes.push_back(keyframe(std::min(0, beatmap.times()[0]), scale(profile.base, profile.beatFloor), TKF_Step));
+	}
+	for (const auto &pause : breaks) {
+		keyframes.push_back(keyframe(pause.start, profile.breakColor, TKF_Step));
+	}
+	keyframes.push_back(keyframe(lastEnd, LightingColor{ 0, 0, 0 }, TKF_Step));
+
+	// Later keyframes win over earlier ones at the same time, so a break or the end overrides a beat.
+	std::stable_sort(keyframes.begin(), keyframes.end(), [](const TimelineKeyframe &a, const TimelineKeyframe &b) { return a.time < b.time; });
+	std::vector<TimelineKeyframe> merged;
+	merged.reserve(keyframes.size());
+	for (const auto &key : keyframes) {
+		if (key.time > lastEnd || insideBreak(breaks, key.time)) {
+			continue;
+		}
+		if (!merged.empty() && merged.back().time == key.time) {
+			merged.back() = key;
+		} else {
+			merged.push_back(key);
+		}
+	}
+
+	// Spots where the objects are, in their combo colour, sustained over sliders and holds.
+	auto colors = profile.comboColors;
+	if (profile.useBeatmapColours && !beatmap.comboColours().empty()) {
+		colors.clear();
+		for (const auto &colour : beatmap.comboColours()) {
+			colors.push_back(LightingColor{ colour.red, colour.green, colour.blue });
+		}
+	}
+	std::vector<TimelineTrigger> triggers(objectCount);
+	uint32_t maxSpan = 0;
+	auto endTime = lastEnd;
+	for (auto i = 0; i < objectCount; ++i) {
+		auto &trigger = triggers[i];
+		trigger.time = beatmap.times()[i];
+		trigger.sustain = static_cast<uint16_t>(std::min(beatmap.endTimes()[i] - beatmap.times()[i], 65535));
+		trigger.fade = static_cast<uint16_t>(fade);
+		const auto spinner = (beatmap.types()[i] & HOT_Spinner) != 0;
+		trigger.kind = spinner ? TTK_Full : TTK_Spot;
+		trigger.position = static_cast<uint8_t>(std::min(std::max(beatmap.x()[i] * 255 / 512, 0), 255));
+		trigger.width = spinner ? 255 : std::max<uint8_t>(profile.spotWidth, 1);
+		const auto color = colors.empty() ? LightingColor{ 255, 255, 255 } : colors[beatmap.comboIndices()[i] % colors.size()];
+		trigger.red = color.red;
+		trigger.green = color.green;
+		trigger.blue = color.blue;
+		trigger.reserved = 0;
+		maxSpan = std::max<uint32_t>(maxSpan, trigger.sustain + trigger.fade);
+		endTime = std::max(endTime, trigger.time + trigger.sustain + trigger.fade);
+	}
+
+	TimelineHeader header;
+	std::memcpy(header.magic, cMagic, sizeof(cMagic));
+	header.version = cFormatVersion;
+	header.headerSize = sizeof(TimelineHeader);
+	std::memcpy(header.beatmapHash, beatmapHash, Md5::cDigestSize);
+	header.profileHash = profile.hash();
+	header.startTime = merged.front().time;
+	header.endTime = endTime;
+	header.keyframeCount = static_cast<uint32_t>(merged.size());
+	header.keyframeOffset = sizeof(TimelineHeader);
+	header.triggerCount = static_cast<uint32_t>(triggers.size());
+	header.triggerOffset = header.keyframeOffset + header.keyframeCount * sizeof(TimelineKeyframe);
+	header.maxTriggerSpan = maxSpan;
+
+	std::vector<uint8_t> image(header.triggerOffset + header.triggerCount * sizeof(TimelineTrigger));
+	std::memcpy(image.data(), &header, sizeof(header));
+	std::memcpy(image.data() + header.keyframeOffset, merged.data(), merged.size() * sizeof(TimelineKeyframe));
+	std::memcpy(image.data() + header.triggerOffset, triggers.data(), triggers.size() * sizeof(TimelineTrigger));
+	mImage.assign(std::move(image));
+	return attach();
+}
+
+bool LightingTimeline::open(const std::string &path)
+{
+	clear();
+	if (!mImage.open(path) || !attach()) {
+		clear();
+		return false;
+	}
+	return true;
+}
+
+bool LightingTimeline::attach()
+{
+	const auto header = mImage.header<TimelineHeader>(cMagic, cFormatVersion);
+	if (!header || !header->keyframeCount) {
+		return false;
+	}
+	const auto keyframes = mImage.records<TimelineKeyframe>(header->keyframeOffset, header->keyframeCount, sizeof(TimelineHeader));
+	const auto triggers = mImage.records<TimelineTrigger>(header->triggerOffset, header->triggerCount, sizeof(TimelineHeader));
+	if (!keyframes || !triggers) {
+		return false;
+	}
+	// colorAt() interpolates over the time between two keyframes.
+	for (uint32_t i = 1; i < header->keyframeCount; ++i) {
+		if (keyframes[i].time <= keyframes[i - 1].time) {
+			return false;
+		}
+	}
+	mHeader = header;
+	mKeyframes = keyframes;
+	mTriggers = triggers;
+	return true;
+}
+
+int LightingTimeline::keyframeAt(int time) const
+{
+	const auto count = keyframeCount();
+	if (!count) {
+		return -1;
+	}
+	const auto next = std::upper_bound(mKeyframes, mKeyframes + count, time,
+		[](int value, const TimelineKeyframe &key) { return value < key.time; });
+	return next == mKeyframes ? 0 : static_cast<int>(next - mKeyframes) - 1;
+}
+
+LightingColor LightingTimeline::colorAt(int time) const
+{
+	return colorAt(time, keyframeAt(time));
+}
+
+LightingColor LightingTimeline::colorAt(int time, int keyframe) const
+{
+	if (keyframe < 0) {
+		return LightingColor{ 0, 0, 0 };
+	}
+	const auto &key = mKeyframes[keyframe];
+	const LightingColor color{ key.red, key.green, key.blue };
+	if (time <= key.time || (key.flags & TKF_Step) || keyframe + 1 >= keyframeCount()) {
+		return color;
+	}
+	const auto &next = mKeyframes[keyframe + 1];
+	const auto weight = static_cast<int>(static_cast<int64_t>(time - key.time) * 255 / (next.time - key.time));
+	return LightingColor{ lerp(key.red, next.red, weight), lerp(key.green, next.green, weight), lerp(key.blue, next.blue, weight) };
+}
+
+TimelineCursor::TimelineCursor(const LightingTimeline &timeline)
+	: mTimeline(timeline)
+{
+	seek(0);
+}
+
+void TimelineCursor::seek(int time)
+{
+	mTime = time;
+	mKeyframe = mTimeline.keyframeAt(time);
+	const auto triggers = mTimeline.triggers();
+	const auto count = mTimeline.triggerCount();
+	if (!count) {
+		mFirstCandidate = 0;
+		mNextTrigger = 0;
+		return;
+	}
+	const auto lookback = static_cast<int64_t>(time) - mTimeline.header().maxTriggerSpan;
+	mNextTrigger = static_cast<int>(std::upper_bound(triggers, triggers + count, time,
+		[](int value, const TimelineTrigger &trigger) { return value < trigger.time; }) - triggers);
+	mFirstCandidate = static_cast<int>(std::lower_bound(triggers, triggers + mNextTrigger, lookback,
+		[](const TimelineTrigger &trigger, int64_t value) { return trigger.time < value; }) - triggers);
+}
+
+void TimelineCursor::advance(int time)
+{
+	if (time < mTime) {
+		seek(time);
+		return;
+	}
+	mTime = time;
+	const auto keyframes = mTimeline.keyframes();
+	while (mKeyframe + 1 < mTimeline.keyframeCount() && keyframes[mKeyframe + 1].time <= time) {
+		++mKeyframe;
+	}
+	const auto triggers = mTimeline.triggers();
+	const auto count = mTimeline.triggerCount();
+	while (mNextTrigger < count && triggers[mNextTrigger].time <= time) {
+		++mNextTrigger;
+	}
+	if (count) {
+		const auto lookback = static_cast<int64_t>(time) - mTimeline.header().maxTriggerSpan;
+		while (mFirstCandidate < mNextTrigger && triggers[mFirstCandidate].time < lookback) {
+			++mFirstCandidate;
+		}
+	}
+}
+
+void TimelineCursor::render(Framebuffer &frame, const LedGeometry &geometry) const
+{
+	if (mTimeline.empty()) {
+		return;
+	}
+	const auto base = mTimeline.colorAt(mTime, mKeyframe);
+	frame.fill(base.red, base.green, base.blue);
+
+	const auto red = frame.red();
+	const auto green = frame.green();
+	const auto blue = frame.blue();
+	const auto ledIds = geometry.ledIds();
+	const auto normalizedX = geometry.normalizedX();
+	const auto triggers = mTimeline.triggers();
+	for (auto i = mFirstCandidate; i < mNextTrigger; ++i) {
+		const auto &trigger = triggers[i];
+		const auto elapsed = mTime - trigger.time;
+		const auto span = trigger.sustain + trigger.fade;
+		if (elapsed >= span && !(elapsed == 0 && span == 0)) {
+			continue;
+		}
+		const auto intensity = elapsed <= trigger.sustain ? 255 : (span - elapsed) * 255 / trigger.fade;
+		const auto center = trigger.position / 255.f;
+		const auto halfWidth = trigger.width / 255.f;
+		for (auto led = 0; led < geometry.count(); ++led) {
+			auto weight = intensity;
+			if (trigger.kind == TTK_Spot) {
+				const auto distance = std::fabs(normalizedX[led] - center);
+				if (distance >= halfWidth) {
+					continue;
+				}
+				weight = static_cast<int>(intensity * (1.f - distance / halfWidth));
+			}
+			const auto id = ledIds[led];
+			red[id] = lerp(red[id], trigger.red, weight);
+			green[id] = lerp(green[id], trigger.green, weight);
+			blue[id] = lerp(blue[id], trigger.blue, weight);
+		}
+	}
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "Framebuffer.h"
+#include "LedGeometry.h"
+#include "MappedImage.h"
+#include "Md5.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Beatmap;
+
+struct LightingColor
+{
+	uint8_t red;
+	uint8_t green;
+	uint8_t blue;
+};
+
+/// Decides how a beatmap is turned into light. Part of the cache key of compiled timelines.
+struct LightingProfile
+{
+	LightingProfile();
+
+	/// Hash of every field, stored in compiled timelines so a changed profile is not served from the cache.
+	uint32_t hash() const;
+
+	LightingColor base;           /**< Keyboard color on beats outside kiai time */
+	LightingColor kiai;           /**< Keyboard color on beats during kiai time */
+	LightingColor breakColor;     /**< Keyboard color during breaks */
+	uint8_t beatFloor;            /**< Brightness the keyboard decays to between beats, 255 disables the pulse */
+	uint8_t offbeatPeak;          /**< Brightness of beats that do not start a measure */
+	float beatDecay;              /**< Part of a beat [0..1] the decay from peak to floor takes */
+	int flashMs;                  /**< Fade out time of the spot lit by a hit object */
+	uint8_t spotWidth;            /**< Half width of a spot relative to the keyboard width, 255 = whole keyboard */
+	bool useBeatmapColours;       /**< Colors spots with the combo colours of the map when it has some */
+	std::vector<LightingColor> comboColors; /**< Spot colors by combo, used without beatmap colours */
+};
+
+/// Bits of TimelineKeyframe::flags.
+enum TimelineKeyframeFlag
+{
+	TKF_Step = 1               /**< Color holds until the next keyframe instead of fading into it */
+};
+
+/// Kinds of TimelineTrigger.
+enum TimelineTriggerKind
+{
+	TTK_Spot = 0,              /**< Lights LEDs around a horizontal position, brightest in the middle */
+	TTK_Full = 1               /**< Lights the whole keyboard */
+};
+
+/*
+ * Layout of a compiled timeline, little endian as written by the compiler:
+ *   TimelineHeader, then keyframeCount TimelineKeyframes at keyframeOffset,
+ *   then triggerCount TimelineTriggers at triggerOffset, both sorted by time.
+ * Every record is naturally aligned so a mapped file is used in place.
+ */
+
+struct TimelineHeader
+{
+	char magic[4];              /**< "CLTL" */
+	uint16_t version;           /**< LightingTimeline::cFormatVersion */
+	uint16_t headerSize;        /**< sizeof(TimelineHeader) */
+	uint8_t beatmapHash[Md5::cDigestSize];
+	uint32_t profileHash;       /**< LightingProfile::hash() of the profile compiled with */
+	int32_t startTime;          /**< Time of the first keyframe in milliseconds */
+	int32_t endTime;            /**< Time the last trigger is over */
+	uint32_t keyframeCount;
+	uint32_t keyframeOffset;
+	uint32_t triggerCount;
+	uint32_t triggerOffset;
+	uint32_t maxTriggerSpan;    /**< Longest sustain + fade of any trigger, bounds the lookback for active triggers */
+};
+
+/// Color of every LED at a time.
+struct TimelineKeyframe
+{
+	int32_t time;
+	uint8_t red;
+	uint8_t green;
+	uint8_t blue;
+	uint8_t flags;
+};
+
+/// Light started by a hit object: full for sustain milliseconds, then fading out over fade milliseconds.
+struct TimelineTrigger
+{
+	int32_t time;
+	uint16_t sustain;
+	uint16_t fade;
+	uint8_t kind;
+	uint8_t position;           /**< Horizontal center, 0 = left edge, 255 = right edge of the keyboard */
+	uint8_t width;              /**< Half width, same scale as position */
+	uint8_t red;
+	uint8_t green;
+	uint8_t blue;
+	uint16_t reserved;
+};
+
+/**
+ * @brief Lighting of a whole beatmap, precomputed as keyframes and triggers in a compact binary image.
+ *
+ * compile() evaluates hit objects, timing points, kiai time and breaks once; the image can be saved and
+ * later opened by mapping the file, which validates the header and uses the records in place. At run time
+ * TimelineCursor only interpolates between keyframes and fades the triggers active at the current time.
+ */
+class LightingTimeline
+{
+public:
+	static const uint16_t cFormatVersion = 1;
+
+	LightingTimeline();
+
+	/// Builds the timeline in memory. Returns false if the beatmap has no hit objects.
+	bool compile(const Beatmap &beatmap, const uint8_t beatmapHash[Md5::cDigestSize], const LightingProfile &profile);
+	/// Maps a saved timeline. Returns false if it is missing, truncated, of another format version or its keyframe times do not increase.
+	bool open(const std::string &path);
+	/// Saves the compiled image, see MappedImage::save().
+	bool save(const std::string &path) const { return !empty() && mImage.save(path); }
+	void clear();
+
+	bool empty() const { return !mHeader; }
+	bool isMapped() const { return mImage.isMapped(); }
+	const TimelineHeader& header() const { return *mHeader; }
+	const TimelineKeyframe* keyframes() const { return mKeyframes; }
+	const TimelineTrigger* triggers() const { return mTriggers; }
+	int keyframeCount() const { return mHeader ? static_cast<int>(mHeader->keyframeCount) : 0; }
+	int triggerCount() const { return mHeader ? static_cast<int>(mHeader->triggerCount) : 0; }
+	/// Size of the binary image in bytes.
+	size_t size() const { return mHeader ? mImage.size() : 0; }
+
+	/// Index of the last keyframe at or before time, O(log n). 0 before the first one, -1 without keyframes.
+	int keyframeAt(int time) const;
+	/// Interpolated keyboard color at time.
+	LightingColor colorAt(int time) const;
+	LightingColor colorAt(int time, int keyframe) const;
+
+private:
+	/// Points the members into mImage if it holds a valid timeline.
+	bool attach();
+
+	MappedImage mImage;
+	const TimelineHeader *mHeader;
+	const TimelineKeyframe *mKeyframes;
+	const TimelineTrigger *mTriggers;
+};
+
+/**
+ * @brief Plays a LightingTimeline into frames, moving forward with playback like BeatmapCursor.
+ *
+ * advance() costs O(1) amortized when time only grows; going backwards seeks with binary searches.
+ */
+class TimelineCursor
+{
+public:
+	explicit TimelineCursor(const LightingTimeline &timeline);
+
+	void seek(int time);
+	void advance(int time);
+	int time() const { return mTime; }
+
+	/// Triggers that may be active are in [firstCandidate(), nextTrigger()).
+	int firstCandidate() const { return mFirstCandidate; }
+	int nextTrigger() const { return mNextTrigger; }
+
+	/**
+	 * @brief Renders the timeline at the current time into frame.
+	 *
+	 * Fills frame with the keyframe color, keeping its active set, then blends active triggers over the
+	 * LEDs of geometry they cover.
+	 */
+	void render(Framebuffer &frame, const LedGeometry &geometry) const;
+
+private:
+	const LightingTimeline &mTimeline;
+	int mTime;
+	int mKeyframe;
+	int mFirstCandidate;
+	int mNextTrigger;
+};
@@ -0,0 +1,319 @@
+#include "Lzma.h"
+
+#include <algorithm>
+
+namespace
+{
+	const int cHeaderSize = 13;
+	const int cProbabilityBits = 11;
+	const int cMoveBits = 5;
+	const uint16_t cInitialProbability = (1 << cProbabilityBits) / 2;
+	const int cStates = 12;
+	const int cMaxPositionBits = 4;
+	const int cLengthToPositionStates = 4;
+	const int cEndPositionModelIndex = 14;
+	const int cFullDistances = 1 << (cEndPositionModelIndex >> 1);
+	const int cAlignBits = 4;
+	const int cMinMatchLength = 2;
+	/// Sizes a corrupt header may claim are not reserved up front beyond this.
+	const uint64_t cMaxReserve = 64 << 20;
+
+	class RangeDecoder
+	{
+	public:
+		RangeDecoder(const uint8_t *data, const uint8_t *end)
+			: mData(data)
+			, mEnd(end)
+			, mRange(0xFFFFFFFF)
+			, mCode(0)
+			, mCorrupted(false)
+		{
+		}
+
+		bool init()
+		{
+			const auto first = nextByte();
+			for (auto i = 0; i < 4; ++i) {
+				mCode = (mCode << 8) | nextByte();
+			}
+			return first == 0 && mCode != mRange && !mCorrupted;
+		}
+
+		int decodeBit(uint16_t &probability)
+		{
+			const auto bound = (mRange >> cProbabilityBits) * probability;
+			int bit;
+			if (mCode < bound) {
+				probability += ((1 << cProbabilityBits) - probability) >> cMoveBits;
+				mRange = bound;
+				bit = 0;
+			} else {
+				probability -= probability >> cMoveBits;
+				mCode -= bound;
+				mRange -= bound;
+				bit = 1;
+			}
+			normalize();
+			return bit;
+		}
+
+		uint32_t decodeDirectBits(int count)
+		{
+			uint32_t result = 0;
+			for (; count > 0; --count) {
+				mRange >>= 1;
+				mCode -= mRange;
+				const auto mask = 0 - (mCode >> 31);
+				mCode += mRange & mask;
+				mCorrupted |= mCode == mRange;
+				normalize();
+				result = (result << 1) + mask + 1;
+			}
+			return result;
+		}
+
+		uint32_t decodeTree(uint16_t *probabilities, int bits)
+		{
+			uint32_t symbol = 1;
+			for (auto i = 0; i < bits; ++i) {
+				symbol = (symbol << 1) + decodeBit(probabilities[symbol]);
+			}
+			return symbol - (1u << bits);
+		}
+
+		uint32_t decodeReverseTree(uint16_t *probabilities, int bits)
+		{
+			uint32_t node = 1;
+			uint32_t symbol = 0;
+			for (auto i = 0; i < bits; ++i) {
+				const auto bit = decodeBit(probabilities[node]);
+				node = (node << 1) + bit;
+				symbol |= bit << i;
+			}
+			return symbol;
+		}
+
+		bool corrupted() const { return mCorrupted; }
+		bool finishedCleanly() const { return mCode == 0 && !mCorrupted; }
+
+	private:
+		uint8_t nextByte()
+		{
+			if (mData == mEnd) {
+				mCorrupted = true;
+				return 0;
+			}
+			return *mData++;
+		}
+
+		void normalize()
+		{
+			if (mRange < (1u << 24)) {
+				mRange <<= 8;
+				mCode = (mCode << 8) | nextByte();
+			}
+		}
+
+		const uint8_t *mData;
+		const uint8_t *mEnd;
+		uint32_t mRange;
+		uint32_t mCode;
+		bool mCorrupted;
+	};
+
+	struct LengthDecoder
+	{
+		LengthDecoder()
+		{
+			choice = choice2 = cInitialProbability;
+			std::fill(&low[0][0], &low[0][0] + sizeof(low) / sizeof(uint16_t), cInitialProbability);
+			std::fill(&mid[0][0], &mid[0][0] + sizeof(mid) / sizeof(uint16_t), cInitialProbability);
+			std::fill(high, high + 256, cInitialProbability);
+		}
+
+		uint32_t decode(RangeDecoder &decoder, uint32_t positionState)
+		{
+			if (!decoder.decodeBit(choice)) {
+				return decoder.decodeTree(low[positionState], 3);
+			}
+			if (!decoder.decodeBit(choice2)) {
+				return 8 + decoder.decodeTree(mid[positionState], 3);
+			}
+			return 16 + decoder.decodeTree(high, 8);
+		}
+
+		uint16_t choice;
+		uint16_t choice2;
+		uint16_t low[1 << cMaxPositionBits][1 << 3];
+		uint16_t mid[1 << cMaxPositionBits][1 << 3];
+		uint16_t high[1 << 8];
+	};
+
+	/// Probability models of the whole stream, laid out as in the LZMA specification.
+	struct Model
+	{
+		explicit Model(int literalBits)
+			: literals(0x300u << literalBits, cInitialProbability)
+		{
+			std::fill(&positionSlots[0][0], &positionSlots[0][0] + sizeof(positionSlots) / sizeof(uint16_t), cInitialProbability);
+			std::fill(positions, positions + sizeof(positions) / sizeof(uint16_t), cInitialProbability);
+			std::fill(align, align + sizeof(align) / sizeof(uint16_t), cInitialProbability);
+			std::fill(isMatch, isMatch + sizeof(isMatch) / sizeof(uint16_t), cInitialProbability);
+			std::fill(isRep, isRep + cStates, cInitialProbability);
+			std::fill(isRepG0, isRepG0 + cStates, cInitialProbability);
+			std::fill(isRepG1, isRepG1 + cStates, cInitialProbability);
+			std::fill(isRepG2, isRepG2 + cStates, cInitialProbability);
+			std::fill(isRep0Long, isRep0Long + sizeof(isRep0Long) / sizeof(uint16_t), cInitialProbability);
+		}
+
+		std::vector<uint16_t> literals;
+		uint16_t positionSlots[cLengthToPositionStates][1 << 6];
+		uint16_t positions[1 + cFullDistances - cEndPositionModelIndex];
+		uint16_t align[1 << cAlignBits];
+		uint16_t isMatch[cStates << cMaxPositionBits];
+		uint16_t isRep[cStates];
+		uint16_t isRepG0[cStates];
+		uint16_t isRepG1[cStates];
+		uint16_t isRepG2[cStates];
+		uint16_t isRep0Long[cStates << cMaxPositionBits];
+		LengthDecoder lengths;
+		LengthDecoder repLengths;
+	};
+
+	uint32_t decodeDistance(RangeDecoder &decoder, Model &model, uint32_t length)
+	{
+		const auto lengthState = std::min<uint32_t>(length, cLengthToPositionStates - 1);
+		const auto slot = decoder.decodeTree(model.positionSlots[lengthState], 6);
+		if (slot < 4) {
+			return slot;
+		}
+		const auto directBits = static_cast<int>((slot >> 1) - 1);
+		auto distance = (2 | (slot & 1)) << directBits;
+		if (slot < cEndPositionModelIndex) {
+			return distance + decoder.decodeReverseTree(model.positions + distance - slot, directBits);
+		}
+		distance += decoder.decodeDirectBits(directBits - cAlignBits) << cAlignBits;
+		return distance + decoder.decodeReverseTree(model.align, cAlignBits);
+	}
+}
+
+namespace lzma
+{
+	bool decompress(const uint8_t *data, size_t size, std::vector<uint8_t> &output)
+	{
+		output.clear();
+		if (size < cHeaderSize || data[0] >= 9 * 5 * 5) {
+			return false;
+		}
+		const auto literalContextBits = data[0] % 9;
+		const auto literalPositionBits = data[0] / 9 % 5;
+		const auto positionBits = data[0] / 45;
+		uint64_t unpackedSize = 0;
+		for (auto i = 0; i < 8; ++i) {
+			unpackedSize |= static_cast<uint64_t>(data[5 + i]) << (8 * i);
+		}
+		const auto sizeKnown = unpackedSize != ~uint64_t(0);
+		output.reserve(static_cast<size_t>(sizeKnown ? std::min(unpackedSize, cMaxReserve) : size * 4));
+
+		RangeDecoder decoder(data + cHeaderSize, data + size);
+		if (!decoder.init()) {
+			return false;
+		}
+		Model model(literalContextBits + literalPositionBits);
+		const auto positionMask = (1u << positionBits) - 1;
+		const auto literalPositionMask = (1u << literalPositionBits) - 1;
+		uint32_t reps[4] = { 0, 0, 0, 0 };
+		uint32_t state = 0;
+
+		while (!decoder.corrupted()) {
+			if (sizeKnown && output.size() == unpackedSize) {
+				// An end marker may still follow, but everything announced has been decoded.
+				return true;
+			}
+			const auto positionState = static_cast<uint32_t>(output.size()) & positionMask;
+
+			if (!decoder.decodeBit(model.isMatch[(state << cMaxPositionBits) + positionState])) {
+				const uint32_t previous = output.empty() ? 0 : output.back();
+				const auto context = ((static_cast<uint32_t>(output.size()) & literalPositionMask) << literalContextBits)
+					+ (previous >> (8 - literalContextBits));
+				const auto probabilities = &model.literals[0x300 * context];
+				uint32_t symbol = 1;
+				if (state >= 7) {
+					// After a match the literal is coded relative to the byte at the last distance.
+					uint32_t matchByte = output[output.size() - reps[0] - 1];
+					do {
+						const auto matchBit = (matchByte >> 7) & 1;
+						matchByte <<= 1;
+						const auto bit = decoder.decodeBit(probabilities[((1 + matchBit) << 8) + symbol]);
+						symbol = (symbol << 1) | bit;
+						if (matchBit != static_cast<uint32_t>(bit)) {
+							break;
+						}
+					} while (symbol < 0x100);
+				}
+				while (symbol < 0x100) {
+					symbol = (symbol << 1) | decoder.decodeBit(probabilities[symbol]);
+				}
+				output.push_back(static_cast<uint8_t>(symbol - 0x100));
+				state = state < 4 ? 0 : (state < 10 ? state - 3 : state - 6);
+				continue;
+			}
+
+			uint32_t length;
+			if (decoder.decodeBit(model.isRep[state])) {
+				if (output.empty()) {
+					return false;
+				}
+				if (!decoder.decodeBit(model.isRepG0[state])) {
+					if (!decoder.decodeBit(model.isRep0Long[(state << cMaxPositionBits) + positionState])) {
+						// Short rep: a single byte from the last distance.
+						state = state < 7 ? 9 : 11;
+						output.push_back(output[output.size() - reps[0] - 1]);
+						continue;
+					}
+				} else {
+					uint32_t distance;
+					if (!decoder.decodeBit(model.isRepG1[state])) {
+						distance = reps[1];
+					} else {
+						if (!decoder.decodeBit(model.isRepG2[state])) {
+							distance = reps[2];
+						} else {
+							distance = reps[3];
+							reps[3] = reps[2];
+						}
+						reps[2] = reps[1];
+					}
+					reps[1] = reps[0];
+					reps[0] = distance;
+				}
+				length = model.repLengths.decode(decoder, positionState);
+				state = state < 7 ? 8 : 11;
+			} else {
+				reps[3] = reps[2];
+				reps[2] = reps[1];
+				reps[1] = reps[0];
+				length = model.lengths.decode(decoder, positionState);
+				state = state < 7 ? 7 : 10;
+				reps[0] = decodeDistance(decoder, model, length);
+				if (reps[0] == 0xFFFFFFFF) {
+					return decoder.finishedCleanly() && (!sizeKnown || output.size() == unpackedSize);
+				}
+				if (reps[0] >= output.size()) {
+					return false;
+				}
+			}
+
+			length += cMinMatchLength;
+			if (sizeKnown && length > unpackedSize - output.size()) {
+				return false;
+			}
+			// Byte by byte, since a match may overlap the bytes it produces.
+			auto source = output.size() - reps[0] - 1;
+			for (uint32_t i = 0; i < length; ++i) {
+				output.push_back(output[source++]);
+			}
+		}
+		return false;
+	}
+}
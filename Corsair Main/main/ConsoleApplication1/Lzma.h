@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lzma
+{
+	/**
+	 * @brief Decompresses a stream in the .lzma ("LZMA alone") format, as osu! stores replay frames.
+	 *
+	 * The stream starts with 5 bytes of properties and a 64 bit little endian size, all ones when the
+	 * size is unknown and the stream ends with an end marker instead. The whole output is kept in memory
+	 * and doubles as the dictionary. Returns false if the stream is truncated or corrupt; output then
+	 * holds what was decoded up to the error.
+	 */
+	bool decompress(const uint8_t *data, size_t size, std::vector<uint8_t> &output);
+}
@@ -0,0 +1,106 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+	: mData(nullptr)
+	, mSize(0)
+#ifdef _WIN32
+	, mFile(INVALID_HANDLE_VALUE)
+	, mMapping(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &path)
+{
+	close();
+	mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (mFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(mFile, &size) || !size.QuadPart) {
+		close();
+		return false;
+	}
+	mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mMapping) {
+		close();
+		return false;
+	}
+	mData = static_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+	if (!mData) {
+		close();
+		return false;
+	}
+	mSize = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mData) {
+		UnmapViewOfFile(mData);
+	}
+	if (mMapping) {
+		CloseHandle(mMapping);
+	}
+	if (mFile != INVALID_HANDLE_VALUE) {
+		CloseHandle(mFile);
+	}
+	mData = nullptr;
+	mSize = 0;
+	mMapping = nullptr;
+	mFile = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::open(const std::string &path)
+{
+	close();
+	const auto file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+	struct stat status;
+	if (fstat(file, &status) || status.st_size <= 0) {
+		::close(file);
+		return false;
+	}
+	// The mapping stays valid after the descriptor is closed.
+	const auto data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (data == MAP_FAILED) {
+		return false;
+	}
+	mData = static_cast<const uint8_t*>(data);
+	mSize = static_cast<size_t>(status.st_size);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mData) {
+		munmap(const_cast<uint8_t*>(mData), mSize);
+	}
+	mData = nullptr;
+	mSize = 0;
+}
+
+#endif
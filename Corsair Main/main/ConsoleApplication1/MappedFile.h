@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Pages are loaded by the OS on first access, so opening a file costs the same regardless of its size
+ * and data can be used in place without reading or parsing it first.
+ */
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/// Maps the file, unmapping the previous one. Returns false if it cannot be opened or is empty.
+	bool open(const std::string &path);
+	void close();
+
+	bool isOpen() const { return mData != nullptr; }
+	const uint8_t* data() const { return mData; }
+	size_t size() const { return mSize; }
+
+private:
+	const uint8_t *mData;
+	size_t mSize;
+#ifdef _WIN32
+	void *mFile;
+	void *mMapping;
+#endif
+};
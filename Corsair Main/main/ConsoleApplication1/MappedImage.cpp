@@ -0,0 +1,83 @@
+#include "MappedImage.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+void MappedImage::assign(std::vector<uint8_t> image)
+{
+	mFile.close();
+	mMemory = std::move(image);
+}
+
+bool MappedImage::open(const std::string &path)
+{
+	mMemory.clear();
+	return mFile.open(path);
+}
+
+bool MappedImage::save(const std::string &path) const
+{
+	if (!size()) {
+		return false;
+	}
+	const auto temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file.write(reinterpret_cast<const char*>(data()), size())) {
+			std::remove(temporary.c_str());
+			return false;
+		}
+	}
+	// rename() does not replace an existing file on Windows.
+	std::remove(path.c_str());
+	if (std::rename(temporary.c_str(), path.c_str())) {
+		std::remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+void MappedImage::clear()
+{
+	mFile.close();
+	mMemory.clear();
+}
+
+void MappedImage::makeDirectory(const std::string &path)
+{
+	// Parents first, then path itself; the ones that exist already just fail.
+	for (auto end = path.find_first_of("/\\", 1);; end = path.find_first_of("/\\", end + 1)) {
+		const auto directory = path.substr(0, end);
+#ifdef _WIN32
+		_mkdir(directory.c_str());
+#else
+		mkdir(directory.c_str(), 0755);
+#endif
+		if (end == std::string::npos) {
+			break;
+		}
+	}
+}
+
+std::string MappedImage::userCacheDirectory(const std::string &name)
+{
+#ifdef _WIN32
+	const auto base = std::getenv("LOCALAPPDATA");
+	return base && *base ? std::string(base) + "\\OsuCorsairRgb\\" + name : name;
+#else
+	if (const auto base = std::getenv("XDG_CACHE_HOME")) {
+		if (*base) {
+			return std::string(base) + "/osu-corsair-rgb/" + name;
+		}
+	}
+	const auto home = std::getenv("HOME");
+	return home && *home ? std::string(home) + "/.cache/osu-corsair-rgb/" + name : name;
+#endif
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Binary image of a compiled file format, built in memory or mapped from a file.
+ *
+ * The formats (LightingTimeline, DeviceCache) start with a header whose first fields are a magic, a
+ * format version and the header size, followed by arrays of records at offsets the header gives. Every
+ * record is naturally aligned so a mapped file is used in place; header() and records() check that
+ * before handing out pointers into the image.
+ */
+class MappedImage
+{
+public:
+	MappedImage() = default;
+	MappedImage(const MappedImage&) = delete;
+	MappedImage& operator=(const MappedImage&) = delete;
+
+	/// Takes over an image built in memory, unmapping the previous one.
+	void assign(std::vector<uint8_t> image);
+	/// Maps the file at path. Returns false if it cannot be opened or is empty.
+	bool open(const std::string &path);
+	/// Writes the image next to path and renames it into place, so readers never see a partial file.
+	bool save(const std::string &path) const;
+	void clear();
+
+	/// Creates the directory a cache of images is saved in and its parents, if they do not exist yet.
+	static void makeDirectory(const std::string &path);
+	/**
+	 * @brief Default directory of the cache called name, per user so caches stay out of the working directory.
+	 *
+	 * Under %LOCALAPPDATA% on Windows and $XDG_CACHE_HOME (or ~/.cache) elsewhere. Falls back to name in the
+	 * working directory if neither is set.
+	 */
+	static std::string userCacheDirectory(const std::string &name);
+
+	bool isMapped() const { return mFile.isOpen(); }
+	const uint8_t* data() const { return mFile.isOpen() ? mFile.data() : mMemory.data(); }
+	size_t size() const { return mFile.isOpen() ? mFile.size() : mMemory.size(); }
+
+	/// Header at the start of the image, nullptr if the image is shorter or has another magic, version or header size.
+	template<typename Header>
+	const Header* header(const char (&magic)[4], uint16_t version) const
+	{
+		if (size() < sizeof(Header)) {
+			return nullptr;
+		}
+		const auto header = reinterpret_cast<const Header*>(data());
+		if (std::memcmp(header->magic, magic, sizeof(magic)) || header->version != version || header->headerSize != sizeof(Header)) {
+			return nullptr;
+		}
+		return header;
+	}
+
+	/// count records at offset, nullptr if they are misaligned, overlap the header or run past the end of the image.
+	template<typename Record>
+	const Record* records(uint32_t offset, uint32_t count, size_t headerSize) const
+	{
+		if (offset < headerSize || offset % alignof(Record) || offset + static_cast<uint64_t>(count) * sizeof(Record) > size()) {
+			return nullptr;
+		}
+		return reinterpret_cast<const Record*>(data() + offset);
+	}
+
+private:
+	std::vector<uint8_t> mMemory;
+	MappedFile mFile;
+};
@@ -0,0 +1,142 @@
+#include "Md5.h"
+
+#include <cstring>
+
+namespace
+{
+	const uint32_t cSines[64] = {
+		0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+		0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+		0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+		0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+		0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+		0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+		0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+		0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+	};
+
+	const int cShifts[64] = {
+		7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+		5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+		4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+		6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+	};
+
+	uint32_t rotateLeft(uint32_t value, int bits)
+	{
+		return (value << bits) | (value >> (32 - bits));
+	}
+}
+
+Md5::Md5()
+{
+	reset();
+}
+
+void Md5::reset()
+{
+	mState[0] = 0x67452301;
+	mState[1] = 0xefcdab89;
+	mState[2] = 0x98badcfe;
+	mState[3] = 0x10325476;
+	mLength = 0;
+}
+
+void Md5::update(const void *data, size_t size)
+{
+	auto bytes = static_cast<const uint8_t*>(data);
+	auto buffered = static_cast<size_t>(mLength % 64);
+	mLength += size;
+	if (buffered) {
+		const auto count = size < 64 - buffered ? size : 64 - buffered;
+		std::memcpy(mBuffer + buffered, bytes, count);
+		bytes += count;
+		size -= count;
+		if (buffered + count < 64) {
+			return;
+		}
+		transform(mBuffer);
+	}
+	for (; size >= 64; bytes += 64, size -= 64) {
+		transform(bytes);
+	}
+	std::memcpy(mBuffer, bytes, size);
+}
+
+void Md5::finish(uint8_t digest[cDigestSize])
+{
+	const auto bits = mLength * 8;
+	const uint8_t padding = 0x80;
+	update(&padding, 1);
+	const uint8_t zero = 0;
+	while (mLength % 64 != 56) {
+		update(&zero, 1);
+	}
+	uint8_t length[8];
+	for (auto i = 0; i < 8; ++i) {
+		length[i] = static_cast<uint8_t>(bits >> (8 * i));
+	}
+	update(length, 8);
+
+	for (auto i = 0; i < cDigestSize; ++i) {
+		digest[i] = static_cast<uint8_t>(mState[i / 4] >> (8 * (i % 4)));
+	}
+	reset();
+}
+
+void Md5::transform(const uint8_t block[64])
+{
+	uint32_t words[16];
+	for (auto i = 0; i < 16; ++i) {
+		words[i] = block[i * 4] | (block[i * 4 + 1] << 8) | (block[i * 4 + 2] << 16) | (static_cast<uint32_t>(block[i * 4 + 3]) << 24);
+	}
+
+	auto a = mState[0];
+	auto b = mState[1];
+	auto c = mState[2];
+	auto d = mState[3];
+	for (auto i = 0; i < 64; ++i) {
+		uint32_t f;
+		int word;
+		if (i < 16) {
+			f = (b & c) | (~b & d);
+			word = i;
+		} else if (i < 32) {
+			f = (d & b) | (~d & c);
+			word = (5 * i + 1) % 16;
+		} else if (i < 48) {
+			f = b ^ c ^ d;
+			word = (3 * i + 5) % 16;
+		} else {
+			f = c ^ (b | ~d);
+			word = (7 * i) % 16;
+		}
+		const auto next = d;
+		d = c;
+		c = b;
+		b += rotateLeft(a + f + cSines[i] + words[word], cShifts[i]);
+		a = next;
+	}
+	mState[0] += a;
+	mState[1] += b;
+	mState[2] += c;
+	mState[3] += d;
+}
+
+void Md5::hash(const void *data, size_t size, uint8_t digest[cDigestSize])
+{
+	Md5 md5;
+	md5.update(data, size);
+	md5.finish(digest);
+}
+
+std::string Md5::toHex(const uint8_t digest[cDigestSize])
+{
+	const char digits[] = "0123456789abcdef";
+	std::string hex(cDigestSize * 2, '0');
+	for (auto i = 0; i < cDigestSize; ++i) {
+		hex[i * 2] = digits[digest[i] >> 4];
+		hex[i * 2 + 1] = digits[digest[i] & 15];
+	}
+	return hex;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief MD5 (RFC 1321), the hash osu! identifies beatmap files and replays by.
+ *
+ * Only used to recognize files, not for anything security related.
+ */
+class Md5
+{
+public:
+	static const int cDigestSize = 16;
+
+	Md5();
+
+	void update(const void *data, size_t size);
+	/// Writes the digest of everything passed to update() and resets the hash.
+	void finish(uint8_t digest[cDigestSize]);
+
+	/// Digest of a buffer in one go.
+	static void hash(const void *data, size_t size, uint8_t digest[cDigestSize]);
+	/// Lowercase hexadecimal form, as stored in osu!.db and replays.
+	static std::string toHex(const uint8_t digest[cDigestSize]);
+
+private:
+	void reset();
+	void transform(const uint8_t block[64]);
+
+	uint32_t mState[4];
+	uint64_t mLength;
+	uint8_t mBuffer[64];
+};
@@ -0,0 +1,171 @@
+#include "Metrics.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+	/// Exposed histograms have a bucket ending right below every power of two, the last one is followed by +Inf.
+	bool isExposed(int bucket)
+	{
+		const auto bound = LatencyHistogram::bucketUpperBound(bucket);
+		return bound > 0 && !(bound & (bound + 1)) && bucket < LatencyHistogram::cBuckets - 1;
+	}
+
+	/// Label value with backslashes, quotes and line feeds escaped, as the text format asks.
+	std::string labelValue(const std::string &value)
+	{
+		std::string escaped;
+		for (const auto c : value) {
+			if (c == '\\' || c == '"') {
+				escaped += '\\';
+				escaped += c;
+			} else if (c == '\n') {
+				escaped += "\\n";
+			} else {
+				escaped += c;
+			}
+		}
+		return escaped;
+	}
+
+	void writeSeconds(std::ostream &stream, int64_t microseconds)
+	{
+		const auto fraction = std::to_string(1000000 + microseconds % 1000000);
+		stream << microseconds / 1000000 << '.' << fraction.substr(1);
+	}
+
+	void writeName(std::ostream &stream, const std::string &name, const std::string &labels)
+	{
+		stream << name;
+		if (!labels.empty()) {
+			stream << '{' << labels << '}';
+		}
+	}
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string &name, const std::string &help, const std::string &labels)
+{
+	return *find(name, help, labels, false).counter;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string &name, const std::string &help, const std::string &labels)
+{
+	return *find(name, help, labels, true).histogram;
+}
+
+MetricsRegistry::Metric& MetricsRegistry::find(const std::string &name, const std::string &help, const std::string &labels, bool histogram)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (const auto &metric : mMetrics) {
+		if (metric->name == name && metric->labels == labels && !metric->histogram == !histogram) {
+			return *metric;
+		}
+	}
+	// Metrics of one name are written out together, so a new label set goes right after the last one.
+	auto position = mMetrics.end();
+	for (auto it = mMetrics.begin(); it != mMetrics.end(); ++it) {
+		if ((*it)->name == name) {
+			position = it + 1;
+		}
+	}
+	std::unique_ptr<Metric> metric(new Metric{ name, help, labels, nullptr, nullptr });
+	if (histogram) {
+		metric->histogram.reset(new LatencyHistogram());
+	} else {
+		metric->counter.reset(new MetricCounter());
+	}
+	return **mMetrics.insert(position, std::move(metric));
+}
+
+void MetricsRegistry::writePrometheus(std::ostream &stream) const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	const std::string *previous = nullptr;
+	for (const auto &metric : mMetrics) {
+		if (!previous || *previous != metric->name) {
+			stream << "# HELP " << metric->name << ' ' << metric->help << '\n';
+			stream << "# TYPE " << metric->name << (metric->histogram ? " histogram\n" : " counter\n");
+			previous = &metric->name;
+		}
+		if (metric->counter) {
+			writeName(stream, metric->name, metric->labels);
+			stream << ' ' << metric->counter->value() << '\n';
+			continue;
+		}
+
+		// Buckets are read one by one while others record, the count is their sum so the two always agree.
+		const auto &histogram = *metric->histogram;
+		const auto labels = metric->labels.empty() ? std::string() : metric->labels + ",";
+		int64_t count = 0;
+		for (auto bucket = 0; bucket < LatencyHistogram::cBuckets; ++bucket) {
+			count += histogram.bucketCount(bucket);
+			if (isExposed(bucket)) {
+				stream << metric->name << "_bucket{" << labels << "le=\"";
+				writeSeconds(stream, LatencyHistogram::bucketUpperBound(bucket));
+				stream << "\"} " << count << '\n';
+			}
+		}
+		stream << metric->name << "_bucket{" << labels << "le=\"+Inf\"} " << count << '\n';
+		writeName(stream, metric->name + "_sum", metric->labels);
+		stream << ' ';
+		writeSeconds(stream, histogram.sum());
+		stream << '\n';
+		writeName(stream, metric->name + "_count", metric->labels);
+		stream << ' ' << count << '\n';
+	}
+}
+
+bool MetricsRegistry::writePrometheus(const std::string &path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	writePrometheus(file);
+	return static_cast<bool>(file.flush());
+}
+
+std::string MetricsRegistry::prometheusText() const
+{
+	std::ostringstream stream;
+	writePrometheus(stream);
+	return stream.str();
+}
+
+FrameMetrics::FrameMetrics(MetricsRegistry &registry)
+	: framesRendered(registry.counter("corsair_frames_rendered_total", "Frames rendered by the render loop.")),
+	framesLate(registry.counter("corsair_frames_dropped_total", "Frames not shown.", "reason=\"late\"")),
+	framesDisconnected(registry.counter("corsair_frames_dropped_total", "Frames not shown.", "reason=\"disconnected\"")),
+	inputToSubmit(registry.histogram("corsair_input_to_submit_seconds", "From a key press to the submission of the frame showing it.")),
+	registry(registry)
+{
+}
+
+LatencyHistogram& FrameMetrics::effect(const std::string &name)
+{
+	return registry.histogram("corsair_effect_duration_seconds", "Evaluation time of an effect per frame.", "effect=\"" + labelValue(name) + "\"");
+}
+
+DeviceMetrics& FrameMetrics::device(int index, const std::string &model)
+{
+	const auto labels = "device=\"" + labelValue(model) + "\",index=\"" + std::to_string(index) + "\"";
+	std::lock_guard<std::mutex> lock(mDevicesMutex);
+	for (const auto &device : mDevices) {
+		if (device->labels == labels) {
+			return *device;
+		}
+	}
+	mDevices.emplace_back(new DeviceMetrics(registry, labels));
+	return *mDevices.back();
+}
+
+DeviceMetrics::DeviceMetrics(MetricsRegistry &registry, const std::string &labels)
+	: labels(labels),
+	ledsSent(registry.counter("corsair_leds_sent_total", "LED colors handed to the SDK.", labels)),
+	submissionsFailed(registry.counter("corsair_submissions_failed_total", "SDK submissions that were rejected or failed.", labels)),
+	setLedsColors(registry.histogram("corsair_sdk_call_duration_seconds", "Time spent in SDK calls.", labels + ",call=\"CorsairSetLedsColors\"")),
+	setLedsColorsAsync(registry.histogram("corsair_sdk_call_duration_seconds", "Time spent in SDK calls.", labels + ",call=\"CorsairSetLedsColorsAsync\"")),
+	asyncAck(registry.histogram("corsair_async_ack_duration_seconds", "From CorsairSetLedsColorsAsync() to its acknowledgement.", labels))
+{
+}
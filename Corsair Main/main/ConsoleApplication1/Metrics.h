@@ -0,0 +1,117 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// Monotonic counter of a MetricsRegistry.
+class MetricCounter
+{
+public:
+	MetricCounter()
+		: mValue(0)
+	{
+	}
+
+	MetricCounter(const MetricCounter&) = delete;
+	MetricCounter& operator=(const MetricCounter&) = delete;
+
+	/// Wait-free, may be called from any thread.
+	void add(int64_t value = 1) { mValue.fetch_add(value, std::memory_order_relaxed); }
+	int64_t value() const { return mValue.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<int64_t> mValue;
+};
+
+/**
+ * @brief Named counters and latency histograms, written out in the Prometheus text exposition format.
+ *
+ * Metrics are registered up front, which takes a lock, and updated through the returned references, which
+ * does not: a counter is one atomic add, a histogram record() three, so updates are wait-free from any
+ * thread. References stay valid as long as the registry.
+ *
+ * Histograms hold microseconds and are exposed in seconds, as Prometheus expects. Several metrics may share
+ * a name with different labels, e.g. counter("corsair_frames_dropped_total", help, "reason=\"late\"").
+ */
+class MetricsRegistry
+{
+public:
+	MetricsRegistry() = default;
+
+	MetricsRegistry(const MetricsRegistry&) = delete;
+	MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+	/// Counter with name and labels, registered on first use. help is taken from the first metric of a name.
+	MetricCounter& counter(const std::string &name, const std::string &help, const std::string &labels = std::string());
+	/// Same as above for a histogram of durations in microseconds.
+	LatencyHistogram& histogram(const std::string &name, const std::string &help, const std::string &labels = std::string());
+
+	/// Writes every metric in the Prometheus text format, version 0.0.4. May run while metrics are updated.
+	void writePrometheus(std::ostream &stream) const;
+	/// Same as above into the file at path. Returns false if it cannot be written.
+	bool writePrometheus(const std::string &path) const;
+	/// Same as above as a string, e.g. for the body of an HTTP response.
+	std::string prometheusText() const;
+
+private:
+	struct Metric
+	{
+		std::string name;
+		std::string help;
+		std::string labels;
+		std::unique_ptr<MetricCounter> counter;      /**< Set for counters */
+		std::unique_ptr<LatencyHistogram> histogram; /**< Set for histograms */
+	};
+
+	Metric& find(const std::string &name, const std::string &help, const std::string &labels, bool histogram);
+
+	mutable std::mutex mMutex;
+	std::vector<std::unique_ptr<Metric>> mMetrics;
+};
+
+/// SDK calls of one device output, labelled device="<model>",index="<SDK device index>".
+struct DeviceMetrics
+{
+	DeviceMetrics(MetricsRegistry &registry, const std::string &labels);
+
+	const std::string labels;
+	MetricCounter &ledsSent;
+	MetricCounter &submissionsFailed;
+	LatencyHistogram &setLedsColors;      /**< Duration of CorsairSetLedsColors() */
+	LatencyHistogram &setLedsColorsAsync; /**< Duration of CorsairSetLedsColorsAsync() until it returned */
+	LatencyHistogram &asyncAck;           /**< From CorsairSetLedsColorsAsync() to its callback */
+};
+
+/**
+ * @brief Metrics of the frame pipeline, registered in a MetricsRegistry.
+ *
+ * DeviceManager::setMetrics() hands the device() metrics to the device outputs for the SDK calls, so a slow
+ * headset does not hide in the latencies of the keyboard; the render loop records frames, input latency
+ * and effect times itself.
+ */
+struct FrameMetrics
+{
+	explicit FrameMetrics(MetricsRegistry &registry);
+
+	MetricCounter &framesRendered;
+	MetricCounter &framesLate;            /**< Frame slots skipped because the previous frame overran */
+	MetricCounter &framesDisconnected;    /**< Frames rendered but not sent while reconnecting to CUE */
+	LatencyHistogram &inputToSubmit;      /**< From a key press to the submission of the frame showing it */
+	MetricsRegistry &registry;            /**< For effect() and device(), which register on first use */
+
+	/// Evaluation time of the named effect, e.g. "timeline".
+	LatencyHistogram& effect(const std::string &name);
+	/// SDK calls of the device at index, the same metrics again when the devices are enumerated anew.
+	DeviceMetrics& device(int index, const std::string &model);
+
+private:
+	std::mutex mDevicesMutex;
+	std::vector<std::unique_ptr<DeviceMetrics>> mDevices;
+};
@@ -0,0 +1,198 @@
+#include "MetricsServer.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "ws2_32.lib")
+#endif
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <string>
+
+namespace
+{
+#ifdef _WIN32
+	using Socket = SOCKET;
+	const Socket cInvalidSocket = INVALID_SOCKET;
+	const int cSendFlags = 0;
+
+	void closeSocket(Socket socket)
+	{
+		closesocket(socket);
+	}
+
+	/// Winsock is reference counted: every startSockets() that succeeded is paired with one stopSockets().
+	bool startSockets()
+	{
+		WSADATA data;
+		return !WSAStartup(MAKEWORD(2, 2), &data);
+	}
+
+	void stopSockets()
+	{
+		WSACleanup();
+	}
+#else
+	using Socket = int;
+	const Socket cInvalidSocket = -1;
+	// A scraper hanging up early must not take the process down with SIGPIPE.
+	const int cSendFlags = MSG_NOSIGNAL;
+
+	void closeSocket(Socket socket)
+	{
+		close(socket);
+	}
+
+	bool startSockets()
+	{
+		return true;
+	}
+
+	void stopSockets()
+	{
+	}
+#endif
+
+	/// How often the accept loop checks for stop(), and how long a client may take to send its request.
+	const int cPollIntervalMs = 100;
+	const int cRequestTimeoutMs = 1000;
+	const size_t cMaxRequestSize = 8192;
+
+	bool waitReadable(Socket socket, int timeoutMs)
+	{
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(socket, &readable);
+		timeval timeout = { timeoutMs / 1000, timeoutMs % 1000 * 1000 };
+		return select(static_cast<int>(socket) + 1, &readable, nullptr, nullptr, &timeout) > 0;
+	}
+
+	bool sendAll(Socket socket, const std::string &data)
+	{
+		size_t sent = 0;
+		while (sent < data.size()) {
+			const auto result = send(socket, data.data() + sent, static_cast<int>(data.size() - sent), cSendFlags);
+			if (result <= 0) {
+				return false;
+			}
+			sent += static_cast<size_t>(result);
+		}
+		return true;
+	}
+
+	std::string response(const char *status, const char *contentType, const std::string &body)
+	{
+		return std::string("HTTP/1.1 ") + status + "\r\nContent-Type: " + contentType + "\r\nContent-Length: " + std::to_string(body.size())
+			+ "\r\nConnection: close\r\n\r\n" + body;
+	}
+}
+
+MetricsServer::MetricsServer(const MetricsRegistry &registry)
+	: mRegistry(registry),
+	mSocket(static_cast<intptr_t>(cInvalidSocket)),
+	mPort(0),
+	mStop(false),
+	mRequests(0)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+	stop();
+}
+
+bool MetricsServer::start(int port)
+{
+	if (isRunning()) {
+		return false;
+	}
+	if (!startSockets()) {
+		return false;
+	}
+	const auto listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener == cInvalidSocket) {
+		stopSockets();
+		return false;
+	}
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(static_cast<unsigned short>(port));
+	socklen_t length = sizeof(address);
+	if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) || listen(listener, 4)
+		|| getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length)) {
+		closeSocket(listener);
+		stopSockets();
+		return false;
+	}
+	mSocket = static_cast<intptr_t>(listener);
+	mPort = ntohs(address.sin_port);
+	mStop.store(false, std::memory_order_relaxed);
+	mThread = std::thread(&MetricsServer::run, this);
+	return true;
+}
+
+void MetricsServer::stop()
+{
+	if (!isRunning()) {
+		return;
+	}
+	mStop.store(true, std::memory_order_relaxed);
+	mThread.join();
+	closeSocket(static_cast<Socket>(mSocket));
+	mSocket = static_cast<intptr_t>(cInvalidSocket);
+	mPort = 0;
+	stopSockets();
+}
+
+void MetricsServer::run()
+{
+	const auto listener = static_cast<Socket>(mSocket);
+	while (!mStop.load(std::memory_order_relaxed)) {
+		if (!waitReadable(listener, cPollIntervalMs)) {
+			continue;
+		}
+		const auto client = accept(listener, nullptr, nullptr);
+		if (client == cInvalidSocket) {
+			continue;
+		}
+		serve(static_cast<intptr_t>(client));
+		closeSocket(client);
+	}
+}
+
+void MetricsServer::serve(intptr_t client)
+{
+	const auto socket = static_cast<Socket>(client);
+	std::string request;
+	char buffer[1024];
+	while (request.find("\r\n\r\n") == std::string::npos && request.size() < cMaxRequestSize) {
+		if (!waitReadable(socket, cRequestTimeoutMs)) {
+			return;
+		}
+		const auto received = recv(socket, buffer, sizeof(buffer), 0);
+		if (received <= 0) {
+			return;
+		}
+		request.append(buffer, static_cast<size_t>(received));
+	}
+
+	const auto line = request.substr(0, request.find("\r\n"));
+	if (line.compare(0, 4, "GET ")) {
+		sendAll(socket, response("405 Method Not Allowed", "text/plain", "Only GET is supported\n"));
+	} else if (line.compare(0, 13, "GET /metrics ") && line.compare(0, 6, "GET / ")) {
+		sendAll(socket, response("404 Not Found", "text/plain", "Metrics are at /metrics\n"));
+	} else {
+		sendAll(socket, response("200 OK", "text/plain; version=0.0.4; charset=utf-8", mRegistry.prometheusText()));
+	}
+	mRequests.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Metrics.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+/**
+ * @brief Serves a MetricsRegistry to Prometheus over HTTP on the loopback interface.
+ *
+ * Answers GET /metrics (and GET /) with the registry in the text exposition format, one request per
+ * connection, from a thread of its own. Only listens on 127.0.0.1, so the numbers stay on the machine
+ * unless something there forwards them.
+ */
+class MetricsServer
+{
+public:
+	explicit MetricsServer(const MetricsRegistry &registry);
+	~MetricsServer();
+
+	MetricsServer(const MetricsServer&) = delete;
+	MetricsServer& operator=(const MetricsServer&) = delete;
+
+	/// Listens on port of 127.0.0.1, a free one if zero. Returns false if the port cannot be bound.
+	bool start(int port);
+	/// Closes the socket and waits for the thread, a request being answered is finished first.
+	void stop();
+
+	bool isRunning() const { return mThread.joinable(); }
+	/// Port actually listened on, zero when not running.
+	int port() const { return mPort; }
+	/// Number of requests answered so far.
+	int64_t requests() const { return mRequests.load(std::memory_order_relaxed); }
+
+private:
+	void run();
+	void serve(intptr_t client);
+
+	const MetricsRegistry &mRegistry;
+	intptr_t mSocket;
+	int mPort;
+	std::atomic<bool> mStop;
+	std::atomic<int64_t> mRequests;
+	std::thread mThread;
+};
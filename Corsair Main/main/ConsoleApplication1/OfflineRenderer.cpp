@@ -0,0 +1,171 @@
+#include "OfflineRenderer.h"
+
+#include "Compositor.h"
+#include "FrameTrace.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+	int64_t frameTimeNs(int64_t frame, int frameRate)
+	{
+		return frame * 1000000000 / frameRate;
+	}
+
+	KeySplash::Clock::time_point atNs(int64_t ns)
+	{
+		return KeySplash::Clock::time_point(std::chrono::duration_cast<KeySplash::Clock::duration>(std::chrono::nanoseconds(ns)));
+	}
+
+	KeySplash::Clock::time_point atMs(int ms)
+	{
+		return KeySplash::Clock::time_point(std::chrono::duration_cast<KeySplash::Clock::duration>(std::chrono::milliseconds(ms)));
+	}
+}
+
+OfflineRenderer::OfflineRenderer(const LightingTimeline &timeline, const LedGeometry &geometry)
+	: mTimeline(timeline), mGeometry(geometry), mChunkFrames(cDefaultChunkFrames), mStats(), mLastError(ORE_Success)
+{
+}
+
+void OfflineRenderer::setHits(std::vector<OfflineHit> hits)
+{
+	std::stable_sort(hits.begin(), hits.end(), [](const OfflineHit &a, const OfflineHit &b) { return a.time < b.time; });
+	mHits = std::move(hits);
+}
+
+int64_t OfflineRenderer::frameCount(int frameRate) const
+{
+	if (mTimeline.empty() || frameRate <= 0) {
+		return 0;
+	}
+	int64_t end = mTimeline.header().endTime;
+	if (!mHits.empty()) {
+		const auto splashMs = std::chrono::duration_cast<std::chrono::milliseconds>(mSplash.duration()).count() + 1;
+		end = std::max<int64_t>(end, mHits.back().time + splashMs);
+	}
+	return end < 0 ? 0 : end * frameRate / 1000 + 1;
+}
+
+bool OfflineRenderer::render(int frameRate, ThreadPool &pool, std::vector<std::vector<uint8_t>> &chunks)
+{
+	const auto start = std::chrono::steady_clock::now();
+	mStats = OfflineRenderStats();
+	mLastError = ORE_Success;
+	const auto frames = frameCount(frameRate);
+	if (!frames || mGeometry.empty()) {
+		mLastError = ORE_NothingToRender;
+		chunks.clear();
+		return false;
+	}
+	const auto chunkCount = static_cast<int>((frames + mChunkFrames - 1) / mChunkFrames);
+
+	// Splash state at the first frame of every chunk, as a sequential render would have it.
+	std::vector<Checkpoint> checkpoints;
+	checkpoints.reserve(chunkCount);
+	Checkpoint state = { mSplash, 0 };
+	for (auto chunk = 0; chunk < chunkCount; ++chunk) {
+		const auto at = atNs(frameTimeNs(static_cast<int64_t>(chunk) * mChunkFrames, frameRate));
+		for (; state.nextHit < mHits.size() && atMs(mHits[state.nextHit].time) <= at; ++state.nextHit) {
+			state.splash.trigger(mHits[state.nextHit].ledId, atMs(mHits[state.nextHit].time));
+		}
+		state.splash.expire(at);
+		checkpoints.push_back(state);
+	}
+
+	chunks.resize(chunkCount);
+	pool.run(chunkCount, [&](int chunk) {
+		const auto first = static_cast<int64_t>(chunk) * mChunkFrames;
+		renderChunk(first, std::min(first + mChunkFrames, frames), frameRate, checkpoints[chunk], chunks[chunk]);
+	});
+
+	mStats.frames = frames;
+	mStats.chunks = chunkCount;
+	mStats.threads = pool.threadCount();
+	for (const auto &chunk : chunks) {
+		mStats.traceBytes += chunk.size();
+	}
+	mStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return true;
+}
+
+bool OfflineRenderer::render(int frameRate, ThreadPool &pool, const std::string &tracePath)
+{
+	std::vector<std::vector<uint8_t>> chunks;
+	if (!render(frameRate, pool, chunks)) {
+		return false;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	FrameTraceWriter trace;
+	if (!trace.open(tracePath)) {
+		mLastError = ORE_CannotCreateTrace;
+		return false;
+	}
+	for (const auto &chunk : chunks) {
+		trace.writeEncoded(chunk);
+	}
+	if (!trace.close()) {
+		mLastError = ORE_CannotWriteTrace;
+		return false;
+	}
+	mStats.traceBytes += FrameTraceWriter::cHeaderSize;
+	mStats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return true;
+}
+
+void OfflineRenderer::renderChunk(int64_t firstFrame, int64_t endFrame, int frameRate, const Checkpoint &checkpoint, std::vector<uint8_t> &out) const
+{
+	auto splash = checkpoint.splash;
+	auto nextHit = checkpoint.nextHit;
+	Framebuffer frame;
+	for (auto i = 0; i < mGeometry.count(); ++i) {
+		frame.activate(mGeometry.ledIds()[i]);
+	}
+	// Keys splashed outside the geometry stay lit between hits, so every frame has the same LEDs.
+	for (const auto &hit : mHits) {
+		if (hit.ledId > CLI_Invalid && hit.ledId <= CLI_Last) {
+			frame.activate(hit.ledId);
+		}
+	}
+	TimelineCursor cursor(mTimeline);
+	cursor.seek(static_cast<int>(frameTimeNs(firstFrame, frameRate) / 1000000));
+	Compositor compositor;
+	Framebuffer splashLayer;
+	Framebuffer composed;
+	FrameTraceEncoder encoder;
+
+	out.clear();
+	for (auto index = firstFrame; index < endFrame; ++index) {
+		const auto timeNs = frameTimeNs(index, frameRate);
+		const auto at = atNs(timeNs);
+		for (; nextHit < mHits.size() && atMs(mHits[nextHit].time) <= at; ++nextHit) {
+			splash.trigger(mHits[nextHit].ledId, atMs(mHits[nextHit].time));
+		}
+		cursor.advance(static_cast<int>(timeNs / 1000000));
+		cursor.render(frame, mGeometry);
+		splash.render(splashLayer, at);
+		const CompositeLayer layers[] = {
+			{ &frame, BlendMode::Over, 255 },
+			{ &splashLayer, BlendMode::Alpha, 255 }
+		};
+		compositor.composite(composed, layers, 2);
+		encoder.encode(out, timeNs, composed);
+	}
+}
+
+const char* OfflineRenderer::errorText(OfflineRenderError error)
+{
+	switch (error) {
+	case ORE_Success:
+		return "Success";
+	case ORE_NothingToRender:
+		return "Nothing to render";
+	case ORE_CannotCreateTrace:
+		return "Cannot create trace";
+	case ORE_CannotWriteTrace:
+		return "Cannot write trace";
+	default:
+		return "Unknown error";
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "KeySplash.h"
+#include "LedGeometry.h"
+#include "LightingTimeline.h"
+#include "ThreadPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Key hit played by the offline renderer, in milliseconds from the start of the beatmap.
+struct OfflineHit
+{
+	int time;
+	CorsairLedId ledId;
+};
+
+/// Reason the last OfflineRenderer::render() failed.
+enum OfflineRenderError
+{
+	ORE_Success,               /**< Nothing failed */
+	ORE_NothingToRender,       /**< Timeline is empty and there is no hit, or the geometry has no LED */
+	ORE_CannotCreateTrace,     /**< Trace file could not be created */
+	ORE_CannotWriteTrace       /**< Writing the trace file failed */
+};
+
+struct OfflineRenderStats
+{
+	int64_t frames;
+	int chunks;
+	int threads;
+	size_t traceBytes;
+	double seconds;           /**< Wall clock time the render took */
+};
+
+/**
+ * @brief Renders the whole lighting of a beatmap at a fixed virtual frame rate, as fast as the CPU allows.
+ *
+ * The effect stack is the one of the live app: the LightingTimeline on the LEDs of the geometry with
+ * KeySplash on top, driven by hits (usually from a replay) instead of the keyboard. Frame i is evaluated
+ * at i / frameRate seconds; no clock is read, so the output only depends on the inputs.
+ *
+ * Frames are split into chunks rendered on a ThreadPool. The timeline is stateless and seeked to the start
+ * of every chunk; key splashes are not, so before rendering a sequential pass checkpoints their state at
+ * every chunk boundary, which costs one step per hit and chunk. Every chunk delta encodes its frames into
+ * its own trace buffer starting with a keyframe (see FrameTraceEncoder), the buffers are concatenated in order.
+ */
+class OfflineRenderer
+{
+public:
+	static const int cDefaultChunkFrames = 1024;
+
+	OfflineRenderer(const LightingTimeline &timeline, const LedGeometry &geometry);
+
+	/// Hits to splash, in any order.
+	void setHits(std::vector<OfflineHit> hits);
+	void setSplash(const KeySplash &splash) { mSplash = splash; }
+	void setChunkFrames(int frames) { mChunkFrames = frames > 0 ? frames : 1; }
+
+	/// Frames from 0 until the timeline and the last splash are over.
+	int64_t frameCount(int frameRate) const;
+
+	/// Renders every frame into chunks of encoded trace frames, without the file header. Returns false if there is nothing to render.
+	bool render(int frameRate, ThreadPool &pool, std::vector<std::vector<uint8_t>> &chunks);
+	/// Same as above, writing a complete trace to path. Returns false on failure, see lastError().
+	bool render(int frameRate, ThreadPool &pool, const std::string &tracePath);
+
+	/// Figures of the last render().
+	const OfflineRenderStats& stats() const { return mStats; }
+	/// Why the last render() failed, ORE_Success if it did not.
+	OfflineRenderError lastError() const { return mLastError; }
+
+	static const char* errorText(OfflineRenderError error);
+
+private:
+	/// Effect state at the first frame of a chunk.
+	struct Checkpoint
+	{
+		KeySplash splash;
+		size_t nextHit;
+	};
+
+	void renderChunk(int64_t firstFrame, int64_t endFrame, int frameRate, const Checkpoint &checkpoint, std::vector<uint8_t> &out) const;
+
+	const LightingTimeline &mTimeline;
+	const LedGeometry &mGeometry;
+	std::vector<OfflineHit> mHits;
+	KeySplash mSplash;
+	int mChunkFrames;
+	OfflineRenderStats mStats;
+	OfflineRenderError mLastError;
+};
@@ -0,0 +1,30 @@
+#include "PooledEffect.h"
+#include "Profiler.h"
+
+PooledEffect::PooledEffect(int ledCapacity, int ringSize)
+	: mPool(ringSize, ledCapacity)
+{
+	mEffect.effectId = reinterpret_cast<Guid>(this);
+	mEffect.getFrameFunction = getFrame;
+	mEffect.freeFrameFunction = freeFrame;
+}
+
+CorsairFrame* PooledEffect::getFrame(Guid effectId, int offset)
+{
+	CORSAIR_PROFILE_SCOPE("PooledEffect::getFrame");
+	if (!effectId)
+		return nullptr;
+
+	auto effect = reinterpret_cast<PooledEffect*>(effectId);
+	auto frame = effect->mPool.acquire(effect->mPool.ledCapacity());
+	if (!effect->renderFrame(offset, *frame)) {
+		FramePool::release(frame);
+		return nullptr;
+	}
+	return frame;
+}
+
+void PooledEffect::freeFrame(CorsairFrame *frame)
+{
+	FramePool::release(frame);
+}
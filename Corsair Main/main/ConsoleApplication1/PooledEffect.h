@@ -0,0 +1,46 @@
+#pragma once
+
+#include "FramePool.h"
+#include "Shared/LFX.h"
+
+/**
+ * @brief Base class for custom effects that serves frames out of a per-effect FramePool ring.
+ *
+ * Derived classes only fill a preallocated frame in renderFrame(); the CorsairEffect returned by
+ * effect() wires the getFrameFunction/freeFrameFunction contract to the pool, so the effect can be
+ * handed to CorsairLayersPlayEffect() or any other consumer of that contract unchanged.
+ */
+class PooledEffect
+{
+public:
+	static const int cDefaultRingSize = 4;
+
+	explicit PooledEffect(int ledCapacity, int ringSize = cDefaultRingSize);
+	virtual ~PooledEffect() {}
+
+	PooledEffect(const PooledEffect&) = delete;
+	PooledEffect& operator=(const PooledEffect&) = delete;
+
+	CorsairEffect* effect() { return &mEffect; }
+	const FramePool& framePool() const { return mPool; }
+
+protected:
+	/**
+	 * @brief Fills the frame for specified offset.
+	 *
+	 * The frame comes with frame.size set to the LED capacity of the effect and ledsColors pointing
+	 * to that many entries. Implementations may lower frame.size (including to 0 for an empty frame).
+	 *
+	 * @param offset Offset in milliseconds.
+	 * @param frame  Frame to fill.
+	 * @return false if the effect is finished at specified offset.
+	 */
+	virtual bool renderFrame(int offset, CorsairFrame &frame) = 0;
+
+private:
+	static CorsairFrame* getFrame(Guid effectId, int offset);
+	static void freeFrame(CorsairFrame *frame);
+
+	FramePool mPool;
+	CorsairEffect mEffect;
+};
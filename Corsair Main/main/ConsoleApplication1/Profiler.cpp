@@ -0,0 +1,223 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	const int64_t cInstant = -1;
+	const int64_t cHeldEvents = Profiler::cThreadCapacity - 1;
+
+	/// Fields are relaxed atomics so a concurrent writeChromeTrace() reads stale events, never torn ones.
+	struct Event
+	{
+		std::atomic<const char*> name;
+		std::atomic<int64_t> start;      /**< Nanoseconds since the origin */
+		std::atomic<int64_t> duration;   /**< Nanoseconds, cInstant for instant events */
+	};
+
+	struct EventCopy
+	{
+		const char *name;
+		int64_t start;
+		int64_t duration;
+	};
+
+	struct ThreadBuffer
+	{
+		explicit ThreadBuffer(int id)
+			: id(id), name(nullptr), written(0), events(new Event[Profiler::cThreadCapacity])
+		{
+		}
+
+		const int id;
+		std::atomic<const char*> name;
+		std::atomic<int64_t> written;    /**< Events recorded since reset(), the ring holds the last cHeldEvents of them */
+		std::unique_ptr<Event[]> events;
+	};
+
+	struct Registry
+	{
+		Registry()
+			: origin(Profiler::Clock::now())
+		{
+		}
+
+		const Profiler::Clock::time_point origin;
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	};
+
+	/// Never destroyed, threads may still record while static destructors run.
+	Registry& registry()
+	{
+		static auto instance = new Registry();
+		return *instance;
+	}
+
+	ThreadBuffer& threadBuffer()
+	{
+		thread_local ThreadBuffer *buffer = nullptr;
+		if (!buffer) {
+			auto &instance = registry();
+			std::lock_guard<std::mutex> lock(instance.mutex);
+			instance.buffers.emplace_back(new ThreadBuffer(static_cast<int>(instance.buffers.size()) + 1));
+			buffer = instance.buffers.back().get();
+		}
+		return *buffer;
+	}
+
+	int64_t sinceOrigin(Profiler::Clock::time_point time)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(time - registry().origin).count();
+	}
+
+	void append(const char *name, int64_t start, int64_t duration)
+	{
+		auto &buffer = threadBuffer();
+		const auto written = buffer.written.load(std::memory_order_relaxed);
+		auto &event = buffer.events[written & (Profiler::cThreadCapacity - 1)];
+		// Pairs with the fence in writeChromeTrace(): whoever sees these stores also sees written, so knows the slot is reused.
+		std::atomic_thread_fence(std::memory_order_release);
+		event.name.store(name, std::memory_order_relaxed);
+		event.start.store(start, std::memory_order_relaxed);
+		event.duration.store(duration, std::memory_order_relaxed);
+		buffer.written.store(written + 1, std::memory_order_release);
+	}
+
+	int64_t heldEvents(const ThreadBuffer &buffer)
+	{
+		return std::min<int64_t>(buffer.written.load(std::memory_order_acquire), cHeldEvents);
+	}
+
+	void writeString(std::ostream &stream, const char *text)
+	{
+		stream << '"';
+		for (; *text; ++text) {
+			if (*text == '"' || *text == '\\') {
+				stream << '\\';
+			}
+			stream << *text;
+		}
+		stream << '"';
+	}
+
+	void writeMicroseconds(std::ostream &stream, int64_t nanoseconds)
+	{
+		// Spans recorded with a start from before the first use of the profiler are negative.
+		if (nanoseconds < 0) {
+			stream << '-';
+			nanoseconds = -nanoseconds;
+		}
+		stream << nanoseconds / 1000 << '.' << static_cast<char>('0' + nanoseconds / 100 % 10)
+			<< static_cast<char>('0' + nanoseconds / 10 % 10) << static_cast<char>('0' + nanoseconds % 10);
+	}
+}
+
+void Profiler::record(const char *name, Clock::time_point start, Clock::time_point end)
+{
+	const auto from = sinceOrigin(start);
+	append(name, from, std::max<int64_t>(sinceOrigin(end) - from, 0));
+}
+
+void Profiler::instant(const char *name)
+{
+	append(name, sinceOrigin(Clock::now()), cInstant);
+}
+
+void Profiler::setThreadName(const char *name)
+{
+	threadBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+int64_t Profiler::eventCount()
+{
+	auto &instance = registry();
+	std::lock_guard<std::mutex> lock(instance.mutex);
+	int64_t count = 0;
+	for (const auto &buffer : instance.buffers) {
+		count += heldEvents(*buffer);
+	}
+	return count;
+}
+
+int64_t Profiler::overwrittenEvents()
+{
+	auto &instance = registry();
+	std::lock_guard<std::mutex> lock(instance.mutex);
+	int64_t count = 0;
+	for (const auto &buffer : instance.buffers) {
+		count += buffer->written.load(std::memory_order_acquire) - heldEvents(*buffer);
+	}
+	return count;
+}
+
+void Profiler::reset()
+{
+	auto &instance = registry();
+	std::lock_guard<std::mutex> lock(instance.mutex);
+	for (const auto &buffer : instance.buffers) {
+		buffer->written.store(0, std::memory_order_relaxed);
+	}
+}
+
+void Profiler::writeChromeTrace(std::ostream &stream)
+{
+	auto &instance = registry();
+	std::lock_guard<std::mutex> lock(instance.mutex);
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	auto first = true;
+	const auto separate = [&] {
+		stream << (first ? "\n" : ",\n");
+		first = false;
+	};
+	for (const auto &buffer : instance.buffers) {
+		if (const auto name = buffer->name.load(std::memory_order_relaxed)) {
+			separate();
+			stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":";
+			writeString(stream, name);
+			stream << "}}";
+		}
+
+		// Copies the events first: those the thread overwrote in the meantime are only known afterwards.
+		const auto end = buffer->written.load(std::memory_order_acquire);
+		const auto begin = std::max<int64_t>(end - cHeldEvents, 0);
+		std::vector<EventCopy> events;
+		events.reserve(static_cast<size_t>(end - begin));
+		for (auto i = begin; i < end; ++i) {
+			const auto &event = buffer->events[i & (cThreadCapacity - 1)];
+			events.push_back(EventCopy{ event.name.load(std::memory_order_relaxed), event.start.load(std::memory_order_relaxed),
+				event.duration.load(std::memory_order_relaxed) });
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const auto overwritten = buffer->written.load(std::memory_order_relaxed) - cHeldEvents;
+		for (auto i = std::max<int64_t>(begin, overwritten); i < end; ++i) {
+			const auto &event = events[static_cast<size_t>(i - begin)];
+			separate();
+			stream << "{\"name\":";
+			writeString(stream, event.name);
+			stream << ",\"ph\":\"" << (event.duration == cInstant ? "i\",\"s\":\"t" : "X") << "\",\"pid\":1,\"tid\":" << buffer->id << ",\"ts\":";
+			writeMicroseconds(stream, event.start);
+			if (event.duration != cInstant) {
+				stream << ",\"dur\":";
+				writeMicroseconds(stream, event.duration);
+			}
+			stream << '}';
+		}
+	}
+	stream << "\n]}\n";
+}
+
+bool Profiler::writeChromeTrace(const std::string &path)
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	writeChromeTrace(file);
+	return static_cast<bool>(file.flush());
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/*
+ * Scoped trace markers of the frame pipeline, written out as Chrome trace event JSON (chrome://tracing,
+ * ui.perfetto.dev).
+ *
+ * The CORSAIR_PROFILE_* macros below only record anything when the build defines CORSAIR_PROFILING=1
+ * (cmake -DCORSAIR_PROFILING=ON); otherwise they expand to nothing and the instrumented code is the same
+ * as without them. Profiler and ProfileScope themselves are always available.
+ */
+#ifndef CORSAIR_PROFILING
+#define CORSAIR_PROFILING 0
+#endif
+
+/**
+ * @brief Records trace events into one lock-free buffer per thread.
+ *
+ * Every thread that records gets its own ring of the last cThreadCapacity events on its first event; only
+ * that thread writes to it, so recording is a clock read and a few relaxed stores. Buffers outlive their
+ * threads, so the events of finished threads are written out as well.
+ *
+ * Event names must outlive the profiler, string literals in practice. writeChromeTrace() may run while
+ * other threads record, the events they overwrite meanwhile are left out then; reset() must not.
+ */
+class Profiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Slots of the ring of every thread, a bit over a minute of the render thread.
+	 *
+	 * The ring holds the last cThreadCapacity - 1 events; the slot after them is the one a concurrent
+	 * writeChromeTrace() has to assume is being overwritten.
+	 */
+	static const int cThreadCapacity = 1 << 16;
+
+	/// Records a complete event of the calling thread from start to end.
+	static void record(const char *name, Clock::time_point start, Clock::time_point end);
+	/// Records an instant event of the calling thread, e.g. an input event or an SDK callback.
+	static void instant(const char *name);
+	/// Names the calling thread in the trace, threads are numbered in the order they first recorded otherwise.
+	static void setThreadName(const char *name);
+
+	/// Number of events currently held by all threads.
+	static int64_t eventCount();
+	/// Number of events overwritten because a thread recorded more than its ring holds since reset().
+	static int64_t overwrittenEvents();
+	/// Drops every recorded event. No thread may record meanwhile.
+	static void reset();
+
+	/// Writes every recorded event as Chrome trace event JSON, timestamps in microseconds since the first use.
+	static void writeChromeTrace(std::ostream &stream);
+	/// Same as above into the file at path. Returns false if it cannot be written.
+	static bool writeChromeTrace(const std::string &path);
+};
+
+/// Records a complete event from construction to destruction.
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char *name)
+		: mName(name), mStart(Profiler::Clock::now())
+	{
+	}
+
+	~ProfileScope()
+	{
+		Profiler::record(mName, mStart, Profiler::Clock::now());
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char *mName;
+	Profiler::Clock::time_point mStart;
+};
+
+#if CORSAIR_PROFILING
+#define CORSAIR_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CORSAIR_PROFILE_CONCAT(a, b) CORSAIR_PROFILE_CONCAT_IMPL(a, b)
+/// Records the rest of the enclosing scope as an event called name.
+#define CORSAIR_PROFILE_SCOPE(name) ProfileScope CORSAIR_PROFILE_CONCAT(profileScope, __LINE__)(name)
+/// Records an event of the calling thread between two Profiler::Clock time points, e.g. an async call up to its callback.
+#define CORSAIR_PROFILE_SPAN(name, start, end) Profiler::record(name, start, end)
+#define CORSAIR_PROFILE_INSTANT(name) Profiler::instant(name)
+#define CORSAIR_PROFILE_THREAD(name) Profiler::setThreadName(name)
+#else
+#define CORSAIR_PROFILE_SCOPE(name) ((void)0)
+#define CORSAIR_PROFILE_SPAN(name, start, end) ((void)0)
+#define CORSAIR_PROFILE_INSTANT(name) ((void)0)
+#define CORSAIR_PROFILE_THREAD(name) ((void)0)
+#endif
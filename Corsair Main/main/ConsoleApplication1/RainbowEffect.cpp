@@ -0,0 +1,68 @@
+#include "RainbowEffect.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	/// Hues are rotated in blocks of this many LEDs before they are converted.
+	const int cRenderBlock = 64;
+
+	const double cPi = 3.14159265358979323846;
+}
+
+RainbowEffect::RainbowEffect(const LedGeometry &geometry, int cycle, bool reversed, Compositor::Isa isa)
+	: mLedIds(geometry.ledIds(), geometry.ledIds() + geometry.count()), mBaseHues(geometry.count()), mCycle(std::max(cycle, 1)),
+	mReversed(reversed), mValue(255), mConverter(isa)
+{
+}
+
+RainbowEffect RainbowEffect::spiral(const LedGeometry &geometry, CorsairLightingEffectSpeed speed, CorsairLightingEffectCircularDirection direction,
+	Compositor::Isa isa)
+{
+	RainbowEffect effect(geometry, cycleDuration(speed), direction == CLECD_Clockwise, isa);
+	for (auto i = 0; i < geometry.count(); ++i) {
+		const auto angle = std::atan2(geometry.normalizedY()[i] - .5, geometry.normalizedX()[i] - .5) / (2 * cPi);
+		effect.mBaseHues[i] = HsvConverter::hueOf(angle);
+	}
+	return effect;
+}
+
+RainbowEffect RainbowEffect::wave(const LedGeometry &geometry, CorsairLightingEffectSpeed speed, CorsairLightingEffectLinearDirection direction,
+	Compositor::Isa isa)
+{
+	RainbowEffect effect(geometry, cycleDuration(speed), false, isa);
+	for (auto i = 0; i < geometry.count(); ++i) {
+		const double x = geometry.normalizedX()[i];
+		const double y = geometry.normalizedY()[i];
+		const auto along = direction == CLELD_Left ? 1. - x : direction == CLELD_Up ? 1. - y : direction == CLELD_Down ? y : x;
+		effect.mBaseHues[i] = HsvConverter::hueOf(-along);
+	}
+	return effect;
+}
+
+int RainbowEffect::cycleDuration(CorsairLightingEffectSpeed speed)
+{
+	switch (speed) {
+	case CLES_Slow:
+		return 6000;
+	case CLES_Fast:
+		return 1500;
+	default:
+		return 3000;
+	}
+}
+
+void RainbowEffect::render(int offset, Framebuffer &frame) const
+{
+	auto rotation = static_cast<uint16_t>(static_cast<int64_t>(offset % mCycle + mCycle) % mCycle * HsvConverter::cHueTurn / mCycle);
+	rotation = mReversed ? static_cast<uint16_t>(-rotation) : rotation;
+	uint16_t hues[cRenderBlock];
+	for (auto start = 0; start < count(); start += cRenderBlock) {
+		const auto block = std::min(cRenderBlock, count() - start);
+		for (auto i = 0; i < block; ++i) {
+			hues[i] = static_cast<uint16_t>(mBaseHues[start + i] + rotation);
+		}
+		mConverter.apply(hues, mLedIds.data() + start, block, 255, mValue, frame);
+	}
+}
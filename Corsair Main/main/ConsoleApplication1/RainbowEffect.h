@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CUELFX/CUELFX.h"
+#include "CUESDK.h"
+#include "Compositor.h"
+#include "Framebuffer.h"
+#include "Hsv.h"
+#include "LedGeometry.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Native counterparts of CUELFXCreateSpiralRainbowEffect() and CUELFXCreateRainbowWaveEffect().
+ *
+ * The hue of every LED at offset 0 is computed once from the geometry: its angle around the center for
+ * the spiral, its position along the direction for the wave. A frame then only adds the hue rotation of
+ * the offset to every LED and converts the whole batch with HsvConverter, writing into a Framebuffer
+ * instead of allocating an SDK frame per tick.
+ */
+class RainbowEffect
+{
+public:
+	/// Hues turn around the center of the geometry once per cycle.
+	static RainbowEffect spiral(const LedGeometry &geometry, CorsairLightingEffectSpeed speed, CorsairLightingEffectCircularDirection direction,
+		Compositor::Isa isa = Compositor::bestIsa());
+	/// Hues travel across the geometry in specified direction, a full turn of hues from one side to the other.
+	static RainbowEffect wave(const LedGeometry &geometry, CorsairLightingEffectSpeed speed, CorsairLightingEffectLinearDirection direction,
+		Compositor::Isa isa = Compositor::bestIsa());
+
+	/// Milliseconds per cycle at the speeds of the SDK effects.
+	static int cycleDuration(CorsairLightingEffectSpeed speed);
+
+	int count() const { return static_cast<int>(mLedIds.size()); }
+	/// Hues at offset 0, one per LED of the geometry.
+	const uint16_t* baseHues() const { return mBaseHues.data(); }
+	Compositor::Isa isa() const { return mConverter.isa(); }
+
+	/// Brightness of the rainbow, full by default.
+	void setValue(uint8_t value) { mValue = value; }
+
+	/// Sets the LEDs of the geometry to their colors at offset milliseconds.
+	void render(int offset, Framebuffer &frame) const;
+
+private:
+	RainbowEffect(const LedGeometry &geometry, int cycle, bool reversed, Compositor::Isa isa);
+
+	std::vector<CorsairLedId> mLedIds;
+	std::vector<uint16_t> mBaseHues;
+	int mCycle;
+	bool mReversed;          /**< Hues rotate backwards, as for a clockwise spiral */
+	uint8_t mValue;
+	HsvConverter mConverter;
+};
@@ -0,0 +1,258 @@
+#include "Replay.h"
+
+#include "Lzma.h"
+#include "TextParsing.h"
+
+#include "windows.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	const int cMaxManiaKeys = 9;
+	/// Default osu!mania keys for 1 to cMaxManiaKeys columns, left to right. ';' is VK_OEM_1.
+	const char *const cManiaKeys[cMaxManiaKeys] = { " ", "FJ", "F J", "DFJK", "DF JK", "SDFJKL", "SDF JKL", "ASDFJKL;", "ASDF JKL;" };
+	/// Frames with this time delta carry the RNG seed instead of input.
+	const int cSeedFrame = -12345;
+	/// From this version on the online score id is 64 bits wide.
+	const int cLongScoreIdVersion = 20140721;
+
+	/// Little endian reader over the header, in the encoding .NET's BinaryWriter uses.
+	class Reader
+	{
+	public:
+		Reader(const uint8_t *data, size_t size)
+			: mData(data)
+			, mEnd(data + size)
+			, mFailed(false)
+		{
+		}
+
+		bool failed() const { return mFailed; }
+		size_t remaining() const { return static_cast<size_t>(mEnd - mData); }
+
+		const uint8_t* take(size_t size)
+		{
+			if (mFailed || remaining() < size) {
+				mFailed = true;
+				return nullptr;
+			}
+			const auto data = mData;
+			mData += size;
+			return data;
+		}
+
+		uint64_t readInteger(int bytes)
+		{
+			const auto data = take(bytes);
+			uint64_t value = 0;
+			for (auto i = 0; data && i < bytes; ++i) {
+				value |= static_cast<uint64_t>(data[i]) << (8 * i);
+			}
+			return value;
+		}
+
+		uint8_t readByte() { return static_cast<uint8_t>(readInteger(1)); }
+		int16_t readShort() { return static_cast<int16_t>(readInteger(2)); }
+		int32_t readInt() { return static_cast<int32_t>(readInteger(4)); }
+		int64_t readLong() { return static_cast<int64_t>(readInteger(8)); }
+
+		/// 0x00 for no string, or 0x0b followed by the ULEB128 length and UTF-8 bytes.
+		std::string readString()
+		{
+			const auto marker = readByte();
+			if (marker == 0x00 || mFailed) {
+				return std::string();
+			}
+			if (marker != 0x0b) {
+				mFailed = true;
+				return std::string();
+			}
+			uint64_t length = 0;
+			for (auto shift = 0; shift < 64; shift += 7) {
+				const auto byte = readByte();
+				length |= static_cast<uint64_t>(byte & 0x7f) << shift;
+				if (!(byte & 0x80)) {
+					break;
+				}
+			}
+			const auto text = take(static_cast<size_t>(length));
+			return text ? std::string(reinterpret_cast<const char*>(text), static_cast<size_t>(length)) : std::string();
+		}
+
+	private:
+		const uint8_t *mData;
+		const uint8_t *mEnd;
+		bool mFailed;
+	};
+
+	/// Moves p past the next separator, returning false at the end of the frame.
+	bool skipTo(const char *&p, const char *end, char separator)
+	{
+		while (p < end && *p != separator && *p != ',') {
+			++p;
+		}
+		if (p < end && *p == separator) {
+			++p;
+			return true;
+		}
+		return false;
+	}
+}
+
+Replay::Replay()
+{
+	clear();
+}
+
+void Replay::clear()
+{
+	mMode = 0;
+	mGameVersion = 0;
+	mBeatmapHash.clear();
+	mPlayerName.clear();
+	mReplayHash.clear();
+	std::fill(mCounts, mCounts + 6, 0);
+	mScore = 0;
+	mMaxCombo = 0;
+	mPerfect = false;
+	mMods = 0;
+	mTimestamp = 0;
+	mOnlineScoreId = 0;
+	mSeed = 0;
+	mFrames.clear();
+}
+
+bool Replay::loadFile(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		clear();
+		return false;
+	}
+	const auto size = static_cast<size_t>(file.tellg());
+	mFileBuffer.resize(size);
+	file.seekg(0);
+	if (size && !file.read(reinterpret_cast<char*>(mFileBuffer.data()), size)) {
+		clear();
+		return false;
+	}
+	return parse(mFileBuffer.data(), size);
+}
+
+bool Replay::parse(const uint8_t *data, size_t size)
+{
+	clear();
+	Reader reader(data, size);
+	mMode = reader.readByte();
+	mGameVersion = reader.readInt();
+	mBeatmapHash = reader.readString();
+	mPlayerName = reader.readString();
+	mReplayHash = reader.readString();
+	for (auto &count : mCounts) {
+		count = static_cast<uint16_t>(reader.readShort());
+	}
+	mScore = reader.readInt();
+	mMaxCombo = static_cast<uint16_t>(reader.readShort());
+	mPerfect = reader.readByte() != 0;
+	mMods = static_cast<uint32_t>(reader.readInt());
+	reader.readString();
+	mTimestamp = reader.readLong();
+	const auto compressedSize = reader.readInt();
+	const auto compressed = compressedSize >= 0 ? reader.take(static_cast<size_t>(compressedSize)) : nullptr;
+	if (reader.failed() || !compressed || mMode < 0 || mMode > cManiaMode) {
+		clear();
+		return false;
+	}
+	// Old replays end after the frames.
+	if (reader.remaining()) {
+		mOnlineScoreId = mGameVersion >= cLongScoreIdVersion ? reader.readLong() : reader.readInt();
+	}
+
+	if (!lzma::decompress(compressed, static_cast<size_t>(compressedSize), mFrameText)) {
+		clear();
+		return false;
+	}
+	parseFrames(mFrameText.data(), mFrameText.size());
+	return true;
+}
+
+void Replay::parseFrames(const uint8_t *text, size_t size)
+{
+	mFrames.reserve(size / 16);
+	auto p = reinterpret_cast<const char*>(text);
+	const auto end = p + size;
+	int32_t time = 0;
+	auto index = 0;
+	while (p < end) {
+		const auto delta = static_cast<int32_t>(parsing::parseNumber(p, end));
+		const auto complete = skipTo(p, end, '|');
+		const auto x = static_cast<float>(parsing::parseNumber(p, end));
+		skipTo(p, end, '|');
+		const auto y = static_cast<float>(parsing::parseNumber(p, end));
+		skipTo(p, end, '|');
+		const auto keys = static_cast<int32_t>(parsing::parseNumber(p, end));
+		skipTo(p, end, ',');
+		if (!complete) {
+			// Trailing separator or garbage without fields.
+			continue;
+		}
+		if (delta == cSeedFrame) {
+			mSeed = keys;
+			continue;
+		}
+		time += delta;
+		// osu! starts every replay with two frames at (256, -500) that carry no input; in osu!mania x would read as pressed columns.
+		if (index++ < 2 && x == 256.f && y == -500.f) {
+			continue;
+		}
+		const auto pressed = static_cast<uint32_t>(mMode == cManiaMode ? static_cast<int32_t>(x) : keys);
+		mFrames.push_back(ReplayFrame{ time, pressed, x, y });
+	}
+}
+
+std::vector<KeyEvent> Replay::keyEvents(InputThread::Clock::time_point start, const std::vector<int> &maniaKeys) const
+{
+	std::vector<int> keys;
+	if (mMode == cManiaMode) {
+		keys = maniaKeys;
+	} else {
+		keys = { 'Z', 'X', VK_LBUTTON, VK_RBUTTON };
+	}
+	const auto keyCount = std::min<size_t>(keys.size(), 32);
+
+	std::vector<KeyEvent> events;
+	uint32_t previous = 0;
+	for (const auto &frame : mFrames) {
+		auto held = frame.keys;
+		if (mMode != cManiaMode) {
+			// K1 and K2 set the mouse button bits as well; a mouse button only counts when pressed on its own.
+			const auto k1 = (frame.keys & RK_K1) != 0;
+			const auto k2 = (frame.keys & RK_K2) != 0;
+			held = (k1 ? 1u : 0u) | (k2 ? 2u : 0u) | ((frame.keys & RK_M1) && !k1 ? 4u : 0u) | ((frame.keys & RK_M2) && !k2 ? 8u : 0u);
+		}
+		const auto changed = held ^ previous;
+		previous = held;
+		for (size_t key = 0; changed && key < keyCount; ++key) {
+			if (changed & (1u << key)) {
+				events.push_back(KeyEvent{ start + std::chrono::milliseconds(frame.time), keys[key], (held & (1u << key)) != 0 });
+			}
+		}
+	}
+	// Frames may step back in time (negative deltas), the queue wants them in order.
+	std::stable_sort(events.begin(), events.end(), [](const KeyEvent &a, const KeyEvent &b) { return a.timestamp < b.timestamp; });
+	return events;
+}
+
+std::vector<int> Replay::maniaKeys(int columns)
+{
+	std::vector<int> keys;
+	if (columns < 1 || columns > cMaxManiaKeys) {
+		return keys;
+	}
+	for (auto key = cManiaKeys[columns - 1]; *key; ++key) {
+		keys.push_back(*key == ';' ? VK_OEM_1 : *key);
+	}
+	return keys;
+}
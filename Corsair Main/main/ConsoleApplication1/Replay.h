@@ -0,0 +1,103 @@
+#pragma once
+
+#include "InputThread.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Bits of ReplayFrame::keys in osu!standard. Pressing K1 or K2 also sets M1 or M2.
+enum ReplayKey
+{
+	RK_M1 = 1,
+	RK_M2 = 2,
+	RK_K1 = 4,
+	RK_K2 = 8,
+	RK_Smoke = 16
+};
+
+/// Input state at one instant of a replay.
+struct ReplayFrame
+{
+	int32_t time;       /**< Milliseconds from the start of the beatmap */
+	uint32_t keys;      /**< ReplayKey bits; in osu!mania the pressed columns, bit 0 being the leftmost */
+	float x;            /**< Cursor position in osu! pixels (512 x 384 playfield) */
+	float y;
+};
+
+/**
+ * @brief Reads osu! replays (.osr): the score header and the LZMA compressed stream of input frames.
+ *
+ * Frames are decoded into one flat array ordered as recorded, with times made absolute. keyEvents()
+ * turns the frames into the KeyEvents the live app gets from InputThread, so a replay can drive the
+ * same lighting as a player would.
+ */
+class Replay
+{
+public:
+	/// mode() of osu!mania replays.
+	static const int cManiaMode = 3;
+
+	Replay();
+
+	/// Reads and parses a .osr file. Returns false if it cannot be read or is not a valid replay.
+	bool loadFile(const std::string &path);
+	bool parse(const uint8_t *data, size_t size);
+	void clear();
+
+	int mode() const { return mMode; }
+	int gameVersion() const { return mGameVersion; }
+	/// MD5 of the .osu file the replay was played on, in hexadecimal.
+	const std::string& beatmapHash() const { return mBeatmapHash; }
+	const std::string& playerName() const { return mPlayerName; }
+	const std::string& replayHash() const { return mReplayHash; }
+	int count300() const { return mCounts[0]; }
+	int count100() const { return mCounts[1]; }
+	int count50() const { return mCounts[2]; }
+	int countGeki() const { return mCounts[3]; }
+	int countKatu() const { return mCounts[4]; }
+	int countMiss() const { return mCounts[5]; }
+	int score() const { return mScore; }
+	int maxCombo() const { return mMaxCombo; }
+	bool perfect() const { return mPerfect; }
+	uint32_t mods() const { return mMods; }
+	/// Time the replay was set, in .NET ticks (100 ns since 0001-01-01).
+	int64_t timestamp() const { return mTimestamp; }
+	int64_t onlineScoreId() const { return mOnlineScoreId; }
+	/// Seed of the random number generator osu! stores as the last frame, 0 if there is none.
+	int seed() const { return mSeed; }
+
+	const std::vector<ReplayFrame>& frames() const { return mFrames; }
+
+	/**
+	 * @brief Presses and releases in the replay, timestamped from start, sorted by time.
+	 *
+	 * In osu!standard K1 and K2 become 'Z' and 'X' and mouse buttons VK_LBUTTON and VK_RBUTTON. In
+	 * osu!mania column i becomes maniaKeys[i]; columns without a key are left out.
+	 */
+	std::vector<KeyEvent> keyEvents(InputThread::Clock::time_point start, const std::vector<int> &maniaKeys = std::vector<int>()) const;
+
+	/// osu!'s default keys of an osu!mania map with columns columns (its Beatmap::circleSize()), empty beyond 9 columns.
+	static std::vector<int> maniaKeys(int columns);
+
+private:
+	void parseFrames(const uint8_t *text, size_t size);
+
+	int mMode;
+	int mGameVersion;
+	std::string mBeatmapHash;
+	std::string mPlayerName;
+	std::string mReplayHash;
+	int mCounts[6];
+	int mScore;
+	int mMaxCombo;
+	bool mPerfect;
+	uint32_t mMods;
+	int64_t mTimestamp;
+	int64_t mOnlineScoreId;
+	int mSeed;
+	std::vector<ReplayFrame> mFrames;
+	std::vector<uint8_t> mFileBuffer;
+	std::vector<uint8_t> mFrameText;
+};
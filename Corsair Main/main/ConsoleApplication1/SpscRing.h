@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * tryPush() may only be called from the producer and tryPop() only from the consumer; neither blocks
+ * or allocates. Each side keeps a cached copy of the other side's index so the shared cache line is
+ * only touched when the ring looks full (producer) or empty (consumer).
+ */
+template <typename T, size_t Capacity>
+class SpscRing
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	SpscRing()
+		: mHead(0), mTailCache(0), mTail(0), mHeadCache(0)
+	{
+	}
+
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+
+	static size_t capacity() { return Capacity; }
+
+	/// Appends value; returns false and drops it if the ring is full.
+	bool tryPush(const T &value)
+	{
+		const auto tail = mTail.load(std::memory_order_relaxed);
+		if (tail - mHeadCache == Capacity) {
+			mHeadCache = mHead.load(std::memory_order_acquire);
+			if (tail - mHeadCache == Capacity) {
+				return false;
+			}
+		}
+		mItems[tail & (Capacity - 1)] = value;
+		mTail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Takes the oldest value; returns false if the ring is empty.
+	bool tryPop(T &value)
+	{
+		const auto head = mHead.load(std::memory_order_relaxed);
+		if (head == mTailCache) {
+			mTailCache = mTail.load(std::memory_order_acquire);
+			if (head == mTailCache) {
+				return false;
+			}
+		}
+		value = mItems[head & (Capacity - 1)];
+		mHead.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Number of queued values; exact only when called from one of the two sides while the other is idle.
+	size_t size() const
+	{
+		return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+	}
+
+private:
+	// Consumer and producer indices live on separate cache lines so the two threads do not fight over them.
+	alignas(64) std::atomic<size_t> mHead;
+	size_t mTailCache;
+	alignas(64) std::atomic<size_t> mTail;
+	size_t mHeadCache;
+	alignas(64) T mItems[Capacity];
+};
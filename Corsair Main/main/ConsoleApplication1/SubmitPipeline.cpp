@@ -0,0 +1,232 @@
+#include "SubmitPipeline.h"
+#include "Profiler.h"
+
+namespace
+{
+	int64_t microsecondsBetween(SubmitPipeline::Clock::time_point from, SubmitPipeline::Clock::time_point to)
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+	}
+}
+
+SubmitPipeline::SubmitPipeline(int maxInFlight)
+	: mInFlight(0),
+	mHasPending(false),
+	mConnection(0),
+	mCompletionHandler(nullptr),
+	mCompletionContext(nullptr),
+	mMetrics(nullptr)
+{
+	maxInFlight = maxInFlight < 1 ? 1 : (maxInFlight > cMaxInFlight ? cMaxInFlight : maxInFlight);
+	for (auto i = 0; i < maxInFlight; ++i) {
+		std::unique_ptr<Slot> slot(new Slot());
+		slot->owner = this;
+		slot->connection = 0;
+		slot->inFlight = false;
+		slot->colors.reserve(Framebuffer::cCapacity);
+		mSlots.push_back(std::move(slot));
+	}
+	resetStats();
+}
+
+SubmitPipeline::~SubmitPipeline()
+{
+	for (auto &slot : mSlots) {
+		// Waits for a callback running on the slot, later ones find it detached.
+		std::lock_guard<std::mutex> ownerLock(slot->ownerMutex);
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (slot->inFlight) {
+			slot->owner = nullptr;
+			slot.release();
+		}
+	}
+}
+
+bool SubmitPipeline::submit(int size, const CorsairLedColor *ledsColors)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mStats.frames++;
+	if (size <= 0) {
+		return true;
+	}
+	if (mHasPending) {
+		mStats.coalescedFrames++;
+	} else {
+		mPendingSince = Clock::now();
+		mHasPending = true;
+	}
+	for (auto i = 0; i < size; ++i) {
+		mPending.set(ledsColors[i]);
+	}
+	return dispatch(lock);
+}
+
+bool SubmitPipeline::submit(const Framebuffer &frame)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mStats.frames++;
+	if (!frame.activeCount()) {
+		return true;
+	}
+	if (mHasPending) {
+		mStats.coalescedFrames++;
+	} else {
+		mPendingSince = Clock::now();
+		mHasPending = true;
+	}
+	const auto red = frame.red();
+	const auto green = frame.green();
+	const auto blue = frame.blue();
+	frame.forEachActive([&](CorsairLedId ledId) {
+		mPending.set(ledId, red[ledId], green[ledId], blue[ledId]);
+	});
+	return dispatch(lock);
+}
+
+void SubmitPipeline::setCompletionHandler(void (*handler)(void *context, int size, const CorsairLedColor *ledsColors, bool result, bool current), void *context)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCompletionHandler = handler;
+	mCompletionContext = context;
+}
+
+void SubmitPipeline::newConnection()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mConnection++;
+}
+
+void SubmitPipeline::setMetrics(DeviceMetrics *metrics)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mMetrics = metrics;
+}
+
+int SubmitPipeline::inFlight() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mInFlight;
+}
+
+bool SubmitPipeline::hasPending() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mHasPending;
+}
+
+bool SubmitPipeline::waitIdle(std::chrono::milliseconds timeout)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	return mIdle.wait_for(lock, timeout, [this] { return !mHasPending && !mInFlight; });
+}
+
+SubmitPipelineStats SubmitPipeline::stats() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStats;
+}
+
+void SubmitPipeline::resetStats()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mStats = SubmitPipelineStats();
+	mSubmitToAck.reset();
+	mSendToAck.reset();
+}
+
+void SubmitPipeline::onCompleted(void *context, bool result, CorsairError /*error*/)
+{
+	auto slot = static_cast<Slot*>(context);
+	std::unique_lock<std::mutex> ownerLock(slot->ownerMutex);
+	if (slot->owner) {
+		slot->owner->complete(*slot, result);
+		return;
+	}
+	// The pipeline was destroyed while the frame was in flight and left the slot to this callback.
+	ownerLock.unlock();
+	delete slot;
+}
+
+void SubmitPipeline::complete(Slot &slot, bool result)
+{
+	const auto now = Clock::now();
+	// Recorded on the SDK callback thread, from the call to its acknowledgement.
+	CORSAIR_PROFILE_SPAN("async_in_flight", slot.sent, now);
+	std::unique_lock<std::mutex> lock(mMutex);
+	mSubmitToAck.record(microsecondsBetween(slot.submitted, now));
+	mSendToAck.record(microsecondsBetween(slot.sent, now));
+	if (mMetrics) {
+		mMetrics->asyncAck.record(microsecondsBetween(slot.sent, now));
+	}
+	slot.inFlight = false;
+	mInFlight--;
+	mStats.completedFrames++;
+	finish(slot, result);
+	// Whatever piled up while every slot was busy goes out right away instead of waiting for the next submit().
+	dispatch(lock);
+	mIdle.notify_all();
+}
+
+bool SubmitPipeline::dispatch(std::unique_lock<std::mutex> &lock)
+{
+	while (mHasPending && mInFlight < maxInFlight()) {
+		Slot *slot = nullptr;
+		for (const auto &candidate : mSlots) {
+			if (!candidate->inFlight) {
+				slot = candidate.get();
+				break;
+			}
+		}
+
+		mPending.stage(slot->colors);
+		mPending.clear();
+		mHasPending = false;
+		if (slot->colors.empty()) {
+			break;
+		}
+		const auto sent = Clock::now();
+		slot->submitted = mPendingSince;
+		slot->sent = sent;
+		slot->connection = mConnection;
+		slot->inFlight = true;
+		mInFlight++;
+
+		// The callback may run before the call returns, so the slot belongs to the SDK from here on: only
+		// locals are read until the lock is taken again.
+		const auto metrics = mMetrics;
+		const auto ledCount = static_cast<int>(slot->colors.size());
+		lock.unlock();
+		auto result = false;
+		{
+			CORSAIR_PROFILE_SCOPE("CorsairSetLedsColorsAsync");
+			result = CorsairSetLedsColorsAsync(ledCount, slot->colors.data(), &SubmitPipeline::onCompleted, slot);
+		}
+		if (metrics) {
+			metrics->setLedsColorsAsync.record(microsecondsBetween(sent, Clock::now()));
+			if (result) {
+				metrics->ledsSent.add(ledCount);
+			}
+		}
+		lock.lock();
+		if (!result) {
+			slot->inFlight = false;
+			mInFlight--;
+			finish(*slot, false);
+			mIdle.notify_all();
+			return false;
+		}
+		mStats.sentFrames++;
+	}
+	return true;
+}
+
+void SubmitPipeline::finish(const Slot &slot, bool result)
+{
+	const auto current = slot.connection == mConnection;
+	if (!result) {
+		(current ? mStats.failedSubmissions : mStats.staleFailures)++;
+	}
+	if (mCompletionHandler) {
+		mCompletionHandler(mCompletionContext, static_cast<int>(slot.colors.size()), slot.colors.data(), result, current);
+	}
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "CUESDK.h"
+#include "Framebuffer.h"
+#include "LatencyHistogram.h"
+#include "Metrics.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// Contains counters collected by SubmitPipeline.
+struct SubmitPipelineStats
+{
+	int64_t frames;            /**< Number of frames passed to submit() */
+	int64_t sentFrames;        /**< Number of CorsairSetLedsColorsAsync() calls the SDK accepted */
+	int64_t coalescedFrames;   /**< Number of frames merged into a frame that was still waiting for a free slot */
+	int64_t completedFrames;   /**< Number of acknowledgements received through the async callback */
+	int64_t failedSubmissions; /**< Number of rejected calls plus acknowledgements reporting an error, on the current connection */
+	int64_t staleFailures;     /**< Number of acknowledgements reporting an error for frames sent on an earlier connection */
+};
+
+/**
+ * @brief Hands frames to CorsairSetLedsColorsAsync() with a bounded number of them in flight.
+ *
+ * Every in-flight frame owns its buffer until the SDK acknowledges it through the async callback, so the
+ * caller may reuse its own buffers right after submit(). When maxInFlight frames are outstanding, submitted
+ * frames are merged into a single pending frame (LEDs of newer frames win) that is sent from the callback
+ * as soon as a slot frees up. Rendering can therefore run ahead of the SDK without tearing and without an
+ * unbounded queue: memory is maxInFlight + 1 frames. One in flight is double buffering, two is triple.
+ *
+ * Latency from submit() to the acknowledgement is recorded per sent frame; for a merged frame it counts
+ * from the oldest submit() it contains.
+ *
+ * Every frame remembers the connection it was sent on, see newConnection(), so acknowledgements arriving
+ * late from a connection already given up on are not taken for failures of the current one.
+ */
+class SubmitPipeline
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static const int cDefaultMaxInFlight = 2;
+	static const int cMaxInFlight = 8;
+
+	/// maxInFlight is clamped to [1..cMaxInFlight].
+	explicit SubmitPipeline(int maxInFlight = cDefaultMaxInFlight);
+
+	/**
+	 * @brief Drops the pending frame without waiting for outstanding acknowledgements.
+	 *
+	 * The SDK keeps reading the LEDs of in-flight frames until it acknowledges them, so their slots are
+	 * left to the callbacks, which free them without calling back into the pipeline or the completion
+	 * handler. Call waitIdle() first for the frames to be shown.
+	 */
+	~SubmitPipeline();
+
+	SubmitPipeline(const SubmitPipeline&) = delete;
+	SubmitPipeline& operator=(const SubmitPipeline&) = delete;
+
+	/**
+	 * @brief Sends the LEDs, or merges them into the pending frame if maxInFlight frames are outstanding.
+	 *
+	 * LEDs with ids outside [CLI_Invalid + 1..CLI_Last] are dropped.
+	 * @return false if the SDK rejected the call made for this frame.
+	 */
+	bool submit(int size, const CorsairLedColor *ledsColors);
+	bool submit(const Framebuffer &frame);
+
+	/**
+	 * @brief Sets function called with the LEDs of every sent frame once its outcome is known.
+	 *
+	 * result is true when the SDK acknowledged the frame and false when it rejected the call or reported an
+	 * error, e.g. to commit the LEDs to a shadow of the device state or forget them. current is false for
+	 * frames sent before the last newConnection(). Frames merged into the pending one are reported as part
+	 * of the frame that carries their LEDs. It runs on the thread that noticed the outcome, which may be the
+	 * SDK callback thread, with the pipeline locked; it must not call back into the pipeline.
+	 */
+	void setCompletionHandler(void (*handler)(void *context, int size, const CorsairLedColor *ledsColors, bool result, bool current), void *context);
+
+	/**
+	 * @brief Starts a new connection to CUE, e.g. once the current one is lost.
+	 *
+	 * Frames in flight belong to the previous connection from here on: their failures count as staleFailures
+	 * instead of failedSubmissions. The pending frame is sent on the new one.
+	 */
+	void newConnection();
+
+	/// Records SDK call durations, acknowledgement latencies and LEDs sent to metrics, nullptr stops recording.
+	void setMetrics(DeviceMetrics *metrics);
+
+	int maxInFlight() const { return static_cast<int>(mSlots.size()); }
+	int inFlight() const;
+	bool hasPending() const;
+
+	/// Waits until the pending frame is sent and every sent frame is acknowledged. Returns false on timeout.
+	bool waitIdle(std::chrono::milliseconds timeout);
+
+	SubmitPipelineStats stats() const;
+	void resetStats();
+
+	/// From submit() to the acknowledgement, including time spent waiting as the pending frame.
+	const LatencyHistogram& submitToAckLatency() const { return mSubmitToAck; }
+	/// From the CorsairSetLedsColorsAsync() call to the acknowledgement.
+	const LatencyHistogram& sendToAckLatency() const { return mSendToAck; }
+
+private:
+	struct Slot
+	{
+		std::mutex ownerMutex;      /**< Held by the callback while it completes, and by the destructor to detach the slot */
+		SubmitPipeline *owner;      /**< nullptr once the pipeline is destroyed */
+		std::vector<CorsairLedColor> colors;
+		Clock::time_point submitted;
+		Clock::time_point sent;
+		unsigned connection;        /**< Connection the frame was sent on, see newConnection() */
+		bool inFlight;
+	};
+
+	static void onCompleted(void *context, bool result, CorsairError error);
+
+	void complete(Slot &slot, bool result);
+	/// Sends the pending frame while slots are free. Returns false if the SDK rejected it.
+	bool dispatch(std::unique_lock<std::mutex> &lock);
+	/// Reports the outcome of the frame in slot to the completion handler.
+	void finish(const Slot &slot, bool result);
+
+	mutable std::mutex mMutex;
+	std::condition_variable mIdle;
+	std::vector<std::unique_ptr<Slot>> mSlots;
+	int mInFlight;
+	Framebuffer mPending;
+	Clock::time_point mPendingSince;
+	bool mHasPending;
+	unsigned mConnection;
+	void (*mCompletionHandler)(void *context, int size, const CorsairLedColor *ledsColors, bool result, bool current);
+	void *mCompletionContext;
+	DeviceMetrics *mMetrics;
+	SubmitPipelineStats mStats;
+	LatencyHistogram mSubmitToAck;
+	LatencyHistogram mSendToAck;
+};
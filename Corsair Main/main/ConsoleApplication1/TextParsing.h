@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cmath>
+
+// Number parsing shared by the .osu reader and the replay frame stream, both of which are plain ASCII.
+
+namespace parsing
+{
+	inline bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	/// Parses a decimal number at p and moves p past it. Much faster than strtod and independent of the locale.
+	inline double parseNumber(const char *&p, const char *end)
+	{
+		while (p < end && isSpace(*p)) {
+			++p;
+		}
+		auto negative = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			negative = *p++ == '-';
+		}
+		double value = 0.;
+		while (p < end && *p >= '0' && *p <= '9') {
+			value = value * 10. + (*p++ - '0');
+		}
+		if (p < end && *p == '.') {
+			++p;
+			auto scale = .1;
+			while (p < end && *p >= '0' && *p <= '9') {
+				value += (*p++ - '0') * scale;
+				scale *= .1;
+			}
+		}
+		if (p < end && (*p == 'e' || *p == 'E')) {
+			++p;
+			auto exponentNegative = false;
+			if (p < end && (*p == '-' || *p == '+')) {
+				exponentNegative = *p++ == '-';
+			}
+			auto exponent = 0;
+			while (p < end && *p >= '0' && *p <= '9') {
+				exponent = exponent * 10 + (*p++ - '0');
+			}
+			value *= std::pow(10., exponentNegative ? -exponent : exponent);
+		}
+		return negative ? -value : value;
+	}
+
+	inline int parseInt(const char *&p, const char *end)
+	{
+		return static_cast<int>(parseNumber(p, end));
+	}
+}
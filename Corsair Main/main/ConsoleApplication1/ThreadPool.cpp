@@ -0,0 +1,77 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads)
+	: mTask(nullptr), mCount(0), mNext(0), mBusy(0), mGeneration(0), mStopping(false)
+{
+	if (threads <= 0) {
+		threads = static_cast<int>(std::thread::hardware_concurrency());
+	}
+	for (auto i = 1; i < threads; ++i) {
+		mWorkers.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mWake.notify_all();
+	for (auto &worker : mWorkers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::run(int count, const std::function<void(int)> &task)
+{
+	if (count <= 0) {
+		return;
+	}
+	{
+		// A worker that woke up late for the previous job may still be looking at it.
+		std::unique_lock<std::mutex> lock(mMutex);
+		mIdle.wait(lock, [this] { return mBusy == 0; });
+		mTask = &task;
+		mCount = count;
+		mNext = 0;
+		++mGeneration;
+	}
+	mWake.notify_all();
+	drain();
+
+	// Every index is taken; the ones still running belong to busy workers.
+	std::unique_lock<std::mutex> lock(mMutex);
+	mIdle.wait(lock, [this] { return mBusy == 0; });
+	mTask = nullptr;
+}
+
+void ThreadPool::work()
+{
+	auto seen = 0u;
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true) {
+		mWake.wait(lock, [&] { return mStopping || mGeneration != seen; });
+		if (mStopping) {
+			return;
+		}
+		seen = mGeneration;
+		if (!mTask) {
+			continue;
+		}
+		++mBusy;
+		lock.unlock();
+		drain();
+		lock.lock();
+		if (--mBusy == 0) {
+			mIdle.notify_all();
+		}
+	}
+}
+
+void ThreadPool::drain()
+{
+	for (auto index = mNext++; index < mCount; index = mNext++) {
+		(*mTask)(index);
+	}
+}
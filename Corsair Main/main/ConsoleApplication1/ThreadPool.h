@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads running the indices of a job in parallel.
+ *
+ * run() hands out indices in ascending order to whichever thread is free, the calling thread included,
+ * and returns once every one of them has been processed. Workers sleep between jobs.
+ */
+class ThreadPool
+{
+public:
+	/// Uses threads threads including the caller of run(); 0 or less picks one per hardware thread.
+	explicit ThreadPool(int threads = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// Threads taking part in run(), the calling one included.
+	int threadCount() const { return static_cast<int>(mWorkers.size()) + 1; }
+
+	/// Calls task(index) for every index in [0..count) and waits for all of them. Not reentrant.
+	void run(int count, const std::function<void(int)> &task);
+
+private:
+	void work();
+	void drain();
+
+	std::vector<std::thread> mWorkers;
+	std::mutex mMutex;
+	std::condition_variable mWake;
+	std::condition_variable mIdle;
+	const std::function<void(int)> *mTask;
+	int mCount;
+	std::atomic<int> mNext;
+	int mBusy;                     /**< Workers draining the current job */
+	unsigned mGeneration;          /**< Incremented by every run() to wake the workers */
+	bool mStopping;
+};
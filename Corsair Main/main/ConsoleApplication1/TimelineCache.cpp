@@ -0,0 +1,63 @@
+#include "TimelineCache.h"
+
+#include "Beatmap.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+TimelineCache::TimelineCache(std::string directory)
+	: mDirectory(std::move(directory))
+	, mHits(0)
+	, mMisses(0)
+{
+}
+
+std::string TimelineCache::pathOf(const uint8_t beatmapHash[Md5::cDigestSize]) const
+{
+	return mDirectory + "/" + Md5::toHex(beatmapHash) + ".cltl";
+}
+
+bool TimelineCache::open(const uint8_t beatmapHash[Md5::cDigestSize], const LightingProfile &profile, LightingTimeline &timeline)
+{
+	if (timeline.open(pathOf(beatmapHash)) && !std::memcmp(timeline.header().beatmapHash, beatmapHash, Md5::cDigestSize)
+		&& timeline.header().profileHash == profile.hash()) {
+		mHits++;
+		return true;
+	}
+	timeline.clear();
+	mMisses++;
+	return false;
+}
+
+bool TimelineCache::load(const std::string &beatmapPath, const LightingProfile &profile, LightingTimeline &timeline)
+{
+	std::ifstream file(beatmapPath, std::ios::binary | std::ios::ate);
+	if (!file) {
+		std::cerr << "Cannot open beatmap " << beatmapPath << std::endl;
+		return false;
+	}
+	mFileBuffer.resize(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	if (!mFileBuffer.empty() && !file.read(mFileBuffer.data(), mFileBuffer.size())) {
+		std::cerr << "Cannot read beatmap " << beatmapPath << std::endl;
+		return false;
+	}
+	uint8_t hash[Md5::cDigestSize];
+	Md5::hash(mFileBuffer.data(), mFileBuffer.size(), hash);
+	if (open(hash, profile, timeline)) {
+		return true;
+	}
+
+	Beatmap beatmap;
+	if (!beatmap.parse(mFileBuffer.data(), mFileBuffer.size()) || !timeline.compile(beatmap, hash, profile)) {
+		std::cerr << "No lighting for beatmap " << beatmapPath << std::endl;
+		return false;
+	}
+	MappedImage::makeDirectory(mDirectory);
+	if (!timeline.save(pathOf(hash))) {
+		std::cerr << "Cannot store lighting timeline in " << mDirectory << std::endl;
+	}
+	return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "LightingTimeline.h"
+#include "Md5.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Directory of compiled LightingTimelines named after the MD5 of their beatmap.
+ *
+ * A timeline is only served if it was compiled with the same format version and lighting profile, anything
+ * else counts as a miss and is recompiled over the stale file.
+ */
+class TimelineCache
+{
+public:
+	explicit TimelineCache(std::string directory);
+
+	/// Maps the cached timeline of a beatmap, without reading the beatmap itself. Returns false on a miss.
+	bool open(const uint8_t beatmapHash[Md5::cDigestSize], const LightingProfile &profile, LightingTimeline &timeline);
+	/**
+	 * @brief Opens the cached timeline of a .osu file, compiling and storing it on a miss.
+	 *
+	 * Returns false if the file cannot be read or has no hit objects. A timeline that cannot be stored
+	 * is still compiled and returned, only the cache stays cold.
+	 */
+	bool load(const std::string &beatmapPath, const LightingProfile &profile, LightingTimeline &timeline);
+
+	/// Path the timeline of a beatmap is cached at.
+	std::string pathOf(const uint8_t beatmapHash[Md5::cDigestSize]) const;
+	const std::string& directory() const { return mDirectory; }
+
+	int64_t hits() const { return mHits; }
+	int64_t misses() const { return mMisses; }
+
+private:
+	std::string mDirectory;
+	std::vector<char> mFileBuffer;
+	int64_t mHits;
+	int64_t mMisses;
+};
@@ -1,28 +1,407 @@
+#include "Beatmap.h"
 #include "CUESDK.h"
+#include "Compositor.h"
+#include "ConnectionSupervisor.h"
+#include "DeviceManager.h"
+#include "Easing.h"
+#include "FrameClock.h"
+#include "FrameTrace.h"
+#include "Framebuffer.h"
+#include "InputThread.h"
+#include "KeyLayoutTable.h"
+#include "KeySplash.h"
+#include "Profiler.h"
+#include "LatencyHistogram.h"
+#include "LedGeometry.h"
+#include "LightingTimeline.h"
+#include "MappedImage.h"
+#include "Metrics.h"
+#include "MetricsServer.h"
+#include "Replay.h"
+#include "TimelineCache.h"
 
 #include "windows.h"
 #include <iostream>
 #include <thread>
 #include <future>
 #include <vector>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <chrono>
+
+/// Keys osu! is played with by default, each splashing the LED of its key.
+const int cHitKeys[] = { 'Z', 'X' };
 
 const char* toString(CorsairError error) {
-	switch (error)
-	{
-		switch (error) {
-		case CE_Success:
-			return "CE_Success";
-		case CE_ServerNotFound:
-			return "CE_ServerNotFound";
-		case CE_NoControl:
-			return "CE_NoControl";
-		case CE_ProtocolHandshakeMissing:
-			return "CE_ProtocolHandshakeMissing";
-		case CE_IncompatibleProtocol:
-			return "CE_IncompatibleProtocol";
-		case CE_InvalidArguments:
-			return "CE_InvalidArguments";
+	switch (error) {
+	case CE_Success:
+		return "CE_Success";
+	case CE_ServerNotFound:
+		return "CE_ServerNotFound";
+	case CE_NoControl:
+		return "CE_NoControl";
+	case CE_ProtocolHandshakeMissing:
+		return "CE_ProtocolHandshakeMissing";
+	case CE_IncompatibleProtocol:
+		return "CE_IncompatibleProtocol";
+	case CE_InvalidArguments:
+		return "CE_InvalidArguments";
+	default:
+		return "unknown error";
+	}
+}
+
+int parseFrameRate(int argc, char *argv[])
+{
+	if (argc > 1) {
+		switch (std::atoi(argv[1])) {
+		case FR_120Hz:
+			return FR_120Hz;
+		case FR_240Hz:
+			return FR_240Hz;
 		default:
-			return "unknown error";
+			std::cerr << "Unsupported frame rate, use 60, 120 or 240\n";
+		case FR_60Hz:
+			break;
+		}
+	}
+	return FR_60Hz;
+}
+
+/// Directory compiled lighting timelines are cached in, CORSAIR_TIMELINE_CACHE if set.
+std::string timelineCacheDirectory()
+{
+	const auto directory = std::getenv("CORSAIR_TIMELINE_CACHE");
+	return directory ? directory : MappedImage::userCacheDirectory("TimelineCache");
+}
+
+/// Directory the devices are cached in per model and layout, CORSAIR_DEVICE_CACHE if set.
+std::string deviceCacheDirectory()
+{
+	const auto directory = std::getenv("CORSAIR_DEVICE_CACHE");
+	return directory ? directory : MappedImage::userCacheDirectory("DeviceCache");
+}
+
+int64_t microsecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Geometry of the first keyboard, empty without one.
+LedGeometry keyboardGeometry(const DeviceManager &devices)
+{
+	for (auto i = 0; i < devices.deviceCount(); ++i) {
+		if (devices.device(i).type == CDT_Keyboard) {
+			return devices.device(i).geometry;
+		}
+	}
+	return LedGeometry();
+}
+
+/// Logical layout of the first keyboard, CLL_Invalid without one.
+CorsairLogicalLayout keyboardLayout(const DeviceManager &devices)
+{
+	for (auto i = 0; i < devices.deviceCount(); ++i) {
+		if (devices.device(i).type == CDT_Keyboard) {
+			return devices.device(i).logicalLayout;
+		}
+	}
+	return CLL_Invalid;
+}
+
+/// Frame with every LED of the devices, the keyboard's geometry and its key names, from the cache before the handshake.
+void setUpDevices(const DeviceManager &devices, Framebuffer &frame, LedGeometry &geometry, KeyLayoutTable &keyLayout)
+{
+	frame = devices.availableLeds();
+	geometry = keyboardGeometry(devices);
+	if (const auto keyLeds = devices.cache().keyLeds()) {
+		keyLayout.load(keyboardLayout(devices), keyLeds);
+	}
+}
+
+/// First frame of the lighting as playLighting() starts it: the timeline at its start or the idle pulse.
+void renderFirstFrame(Framebuffer &frame, const LightingTimeline &timeline, const LedGeometry &geometry)
+{
+	if (!timeline.empty() && !geometry.empty()) {
+		TimelineCursor cursor(timeline);
+		cursor.render(frame, geometry);
+	} else {
+		frame.fill(0, 0, Easing::level(EasingCurve::Quad, 0));
+	}
+}
+
+/// Body of the render thread: the beatmap's timeline (or an idle pulse) with key splashes on top until Escape is pressed.
+void playLighting(Framebuffer &frame, FrameClock &frameClock, const DeviceManager &devices, ConnectionSupervisor &connection, KeyLayoutTable &keyLayout,
+	InputThread &input, FrameMetrics &metrics, const LightingTimeline &timeline, const LedGeometry &geometry)
+{
+	const auto pulseDuration = 1000;
+	PhaseAccumulator pulse(2 * pulseDuration);
+	auto pulseOffset = 0;
+	TimelineCursor cursor(timeline);
+	Compositor compositor;
+	KeySplash splash;
+	Framebuffer splashLayer;
+	Framebuffer composed;
+	std::vector<InputThread::Clock::time_point> hits;
+	hits.reserve(InputThread::cQueueCapacity);
+	auto reenumerations = connection.stats().reenumerations;
+	// Registered up front, so the loop only does atomic adds on them.
+	auto &timelineTime = metrics.effect("timeline");
+	auto &pulseTime = metrics.effect("idle_pulse");
+	auto &splashTime = metrics.effect("key_splash");
+	auto &compositeTime = metrics.effect("composite");
+	CORSAIR_PROFILE_THREAD("render");
+	while (true) {
+		// The time between two frame events is spent waiting for the next frame.
+		const auto tick = frameClock.waitForNextFrame();
+		CORSAIR_PROFILE_SCOPE("frame");
+		metrics.framesLate.add(tick.skipped);
+
+		// Everything that happened since the previous frame, each with the time it actually happened.
+		hits.clear();
+		KeyEvent event;
+		while (input.nextEvent(event)) {
+			if (!event.pressed) {
+				continue;
+			}
+			if (event.virtualKey == VK_ESCAPE) {
+				return;
+			}
+			const auto ledId = keyLayout.ledOfVirtualKey(event.virtualKey);
+			if (ledId != CLI_Invalid) {
+				CORSAIR_PROFILE_INSTANT("hit");
+				splash.trigger(ledId, event.timestamp);
+				hits.push_back(event.timestamp);
+			}
+		}
+
+		auto stageStart = std::chrono::steady_clock::now();
+		if (!timeline.empty()) {
+			CORSAIR_PROFILE_SCOPE("TimelineCursor::render");
+			cursor.advance(tick.offset);
+			cursor.render(frame, geometry);
+			timelineTime.record(microsecondsSince(stageStart));
+		} else {
+			CORSAIR_PROFILE_SCOPE("idle_pulse");
+			pulse.advance(tick.offset - pulseOffset);
+			pulseOffset = tick.offset;
+			frame.fill(0, 0, Easing::level(EasingCurve::Quad, pulse.phase()));
+			pulseTime.record(microsecondsSince(stageStart));
+		}
+		{
+			CORSAIR_PROFILE_SCOPE("KeySplash::render");
+			stageStart = std::chrono::steady_clock::now();
+			splash.render(splashLayer, tick.deadline);
+			splashTime.record(microsecondsSince(stageStart));
+		}
+		const CompositeLayer layers[] = {
+			{ &frame, BlendMode::Over, 255 },
+			{ &splashLayer, BlendMode::Alpha, 255 }
+		};
+		{
+			CORSAIR_PROFILE_SCOPE("Compositor::composite");
+			stageStart = std::chrono::steady_clock::now();
+			compositor.composite(composed, layers, 2);
+			compositeTime.record(microsecondsSince(stageStart));
+		}
+		// CUE restarting or another client taking control only pauses the lighting until the supervisor reconnects.
+		const auto wasConnected = connection.isConnected();
+		auto submitted = false;
+		{
+			CORSAIR_PROFILE_SCOPE("submit");
+			submitted = connection.submitAsync(composed);
+		}
+		metrics.framesRendered.add();
+		if (!submitted) {
+			metrics.framesDisconnected.add();
+		}
+		if (!submitted && wasConnected) {
+			std::cerr << "Lost connection to CUE (" << toString(connection.lastError()) << "), reconnecting..." << std::endl;
+		}
+		// The keyboard may come back with another layout, the hit keys then splash the LEDs typing them there.
+		if (connection.stats().reenumerations != reenumerations) {
+			reenumerations = connection.stats().reenumerations;
+			keyLayout.update(keyboardLayout(devices));
+		}
+
+		const auto submittedAt = InputThread::Clock::now();
+		for (const auto hit : hits) {
+			metrics.inputToSubmit.record(std::chrono::duration_cast<std::chrono::microseconds>(submittedAt - hit).count());
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const auto launched = std::chrono::steady_clock::now();
+	CORSAIR_PROFILE_THREAD("main");
+	// Health numbers of the session, served to Prometheus on CORSAIR_METRICS_PORT of 127.0.0.1 and written
+	// to CORSAIR_METRICS on exit. Declared first, the device outputs record to them until they are gone.
+	MetricsRegistry registry;
+	FrameMetrics metrics(registry);
+	MetricsServer metricsServer(registry);
+	if (const auto port = std::getenv("CORSAIR_METRICS_PORT")) {
+		if (metricsServer.start(std::atoi(port))) {
+			std::cout << "Serving metrics on http://127.0.0.1:" << metricsServer.port() << "/metrics\n";
+		} else {
+			std::cerr << "Cannot serve metrics on port " << port << std::endl;
+		}
+	}
+
+	// With the devices of the previous launch known, the first frame is set up and rendered from their
+	// cache while the handshake and the check of the cache run. Without a cache, or when it turns out
+	// stale, the devices are enumerated and the frame is set up again.
+	DeviceManager devices;
+	devices.setMetrics(&metrics);
+	devices.setCacheDirectory(deviceCacheDirectory());
+	ConnectionSupervisor connection(devices);
+	const auto cached = devices.loadLastCache();
+	const auto cachedBuilds = devices.builds();
+	Framebuffer frame;
+	LedGeometry geometry;
+	KeyLayoutTable keyLayout;
+	// Read before connecting, which may enumerate the devices again on its own thread.
+	if (cached) {
+		setUpDevices(devices, frame, geometry, keyLayout);
+	}
+	auto connected = std::async(cached ? std::launch::async : std::launch::deferred, [&connection] { return connection.connect(); });
+
+	// A beatmap given after the frame rate is played from its compiled timeline, compiled on first use only.
+	LightingTimeline timeline;
+	if (argc > 2) {
+		TimelineCache cache(timelineCacheDirectory());
+		if (!cache.load(argv[2], LightingProfile(), timeline)) {
+			timeline.clear();
+		}
+	}
+	if (cached) {
+		renderFirstFrame(frame, timeline, geometry);
+	}
+
+	if (!connected.get()) {
+		if (const auto error = connection.lastError()) {
+			std::cerr << "Handshake failed: " << toString(error) << std::endl;
+			getchar();
+		} else {
+			std::cerr << "No devices found" << std::endl;
+		}
+		return -1;
+	}
+	if (devices.builds() != cachedBuilds) {
+		setUpDevices(devices, frame, geometry, keyLayout);
+		renderFirstFrame(frame, timeline, geometry);
+	}
+	if (!keyLayout.update(keyboardLayout(devices))) {
+		std::cerr << "Cannot resolve the hit keys, playing without key splashes" << std::endl;
+	}
+	if (argc > 2) {
+		if (timeline.empty() || geometry.empty()) {
+			timeline.clear();
+			std::cerr << "Playing the idle pulse instead" << std::endl;
+		} else {
+			std::cout << "Lighting timeline " << (timeline.isMapped() ? "loaded from cache" : "compiled") << ": "
+				<< timeline.keyframeCount() << " keyframes, " << timeline.triggerCount() << " triggers\n";
+		}
+	}
+	// The devices show the first frame right away, the render loop takes over from the next one.
+	devices.submitAsync(frame);
+	std::cout << devices.deviceCount() << " devices " << (devices.isCached() ? "loaded from cache" : "enumerated") << ", ready after "
+		<< std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - launched).count() << " ms\n";
+
+	FrameClock frameClock(parseFrameRate(argc, argv));
+	// Everything sent to the SDK is recorded to CORSAIR_TRACE if set, see corsair_trace.
+	FrameTraceWriter trace;
+	if (const auto tracePath = std::getenv("CORSAIR_TRACE")) {
+		if (trace.open(tracePath)) {
+			devices.setTrace(&trace);
+		} else {
+			std::cerr << "Cannot create trace " << tracePath << std::endl;
+		}
+	}
+	std::cout << "Playing at " << frameClock.rate() << " Hz...\nPress Escape to close program...\n";
+
+	// Keys are sampled on their own thread so hits are timed independently of the frame rate.
+	std::vector<int> keys = { VK_ESCAPE };
+	for (const auto key : cHitKeys) {
+		keys.push_back(key);
+	}
+	InputThread input(keys);
+
+	// A replay given after the beatmap stands in for the keyboard, starting with the map and ending a second after it.
+	// Escape is still read from the keyboard.
+	Replay replay;
+	if (argc > 3 && replay.loadFile(argv[3])) {
+		if (!timeline.empty() && replay.beatmapHash() != Md5::toHex(timeline.header().beatmapHash)) {
+			std::cerr << "Replay was played on another beatmap" << std::endl;
+		}
+		std::vector<int> maniaKeys;
+		Beatmap beatmap;
+		if (replay.mode() == Replay::cManiaMode && beatmap.loadFile(argv[2])) {
+			maniaKeys = Replay::maniaKeys(static_cast<int>(beatmap.circleSize()));
+		}
+		frameClock.restart();
+		const auto start = InputThread::Clock::now();
+		auto events = replay.keyEvents(start, maniaKeys);
+		// Frames may step back in time, the events are sorted.
+		const auto end = events.empty() ? start : events.back().timestamp;
+		std::cout << "Replaying " << events.size() << " key events of " << replay.playerName() << std::endl;
+		events.push_back(KeyEvent{ end + std::chrono::seconds(1), VK_ESCAPE, true });
+		input.startReplay(std::move(events), { VK_ESCAPE });
+	} else {
+		if (argc > 3) {
+			std::cerr << "Cannot read replay " << argv[3] << std::endl;
+		}
+		input.start();
+	}
+	auto renderer = std::async(std::launch::async, [&] { playLighting(frame, frameClock, devices, connection, keyLayout, input, metrics, timeline, geometry); });
+	renderer.wait();
+	input.stop();
+	devices.waitIdle(std::chrono::milliseconds(500));
+
+	const auto &stats = frameClock.stats();
+	if (stats.frames)
+		std::cout << "Frames: " << stats.frames << ", skipped: " << stats.skippedFrames
+			<< ", jitter min/mean/max (us): " << stats.minJitterNs / 1000 << '/'
+			<< static_cast<int64_t>(stats.meanJitterNs) / 1000 << '/' << stats.maxJitterNs / 1000 << std::endl;
+
+	const auto outputStats = devices.stats();
+	if (outputStats.frames)
+		std::cout << "LEDs submitted: " << outputStats.submittedLeds << ", suppressed: " << outputStats.suppressedLeds
+			<< ", full refreshes: " << outputStats.fullRefreshes << ", unchanged frames: " << outputStats.skippedFrames << std::endl;
+
+	const auto &connectionStats = connection.stats();
+	if (connectionStats.disconnects)
+		std::cout << "Connection lost " << connectionStats.disconnects << " times, CUE restarted " << connectionStats.handshakes - 1
+			<< " times, recovery time: " << connection.recoveryTime().summary() << std::endl;
+
+	if (metrics.inputToSubmit.count())
+		std::cout << "Hit to submit latency: " << metrics.inputToSubmit.summary() << std::endl;
+
+	if (trace.isOpen()) {
+		devices.setTrace(nullptr);
+		std::cout << "Trace: " << trace.frames() << " frames, " << trace.size() << " bytes" << std::endl;
+		if (!trace.close()) {
+			std::cerr << "Failed to write the trace" << std::endl;
+		}
+	}
+
+	if (const auto metricsPath = std::getenv("CORSAIR_METRICS")) {
+		if (!registry.writePrometheus(metricsPath)) {
+			std::cerr << "Cannot write metrics " << metricsPath << std::endl;
+		}
+	}
+
+	// Trace markers of the session as Chrome trace event JSON, to be opened in ui.perfetto.dev.
+	if (const auto profilePath = std::getenv("CORSAIR_PROFILE")) {
+		if (!CORSAIR_PROFILING) {
+			std::cerr << "Built without CORSAIR_PROFILING, the profile holds no events" << std::endl;
+		}
+		if (Profiler::writeChromeTrace(profilePath)) {
+			std::cout << "Profile: " << Profiler::eventCount() << " events, " << Profiler::overwrittenEvents() << " overwritten" << std::endl;
+		} else {
+			std::cerr << "Cannot write profile " << profilePath << std::endl;
 		}
-}
\ No newline at end of file
+	}
+	return 0;
+}
@@ -0,0 +1,100 @@
+#include "TestHarness.h"
+
+#include "Beatmap.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::string fixture(const char *name)
+	{
+		return std::string(CORSAIR_FIXTURE_DIR) + "/beatmaps/" + name;
+	}
+
+	std::vector<int> activeAt(const Beatmap &beatmap, int time)
+	{
+		std::vector<int> active;
+		for (auto i = 0; i < beatmap.objectCount(); ++i) {
+			if (beatmap.times()[i] == time || (beatmap.times()[i] <= time && beatmap.endTimes()[i] > time)) {
+				active.push_back(i);
+			}
+		}
+		return active;
+	}
+}
+
+TEST_CASE(beatmapParsesSectionsIntoArrays)
+{
+	Beatmap beatmap;
+	CHECK(!beatmap.loadFile(fixture("broken.osu")));
+	CHECK(!beatmap.loadFile(fixture("missing.osu")));
+	REQUIRE(beatmap.loadFile(fixture("standard.osu")));
+
+	CHECK(beatmap.formatVersion() == 14);
+	CHECK(beatmap.audioFilename() == "audio.mp3");
+	CHECK(beatmap.backgroundFilename() == "bg.jpg");
+	CHECK(beatmap.previewTime() == 1500);
+	CHECK(beatmap.sliderMultiplier() == 1.5);
+	REQUIRE(beatmap.breaks().size() == 1);
+	CHECK(beatmap.breaks()[0].start == 6000 && beatmap.breaks()[0].end == 9000);
+	REQUIRE(beatmap.comboColours().size() == 1);
+	CHECK(beatmap.comboColours()[0].red == 255 && beatmap.comboColours()[0].green == 128 && beatmap.comboColours()[0].blue == 0);
+
+	REQUIRE(beatmap.timingPointCount() == 4);
+	CHECK(beatmap.timingFlags()[0] == TPF_Uninherited);
+	CHECK(beatmap.timingFlags()[1] == TPF_Kiai);
+	CHECK(beatmap.sliderVelocities()[1] == 2.f && beatmap.beatLengths()[1] == 500.);
+	CHECK(beatmap.meters()[3] == 3 && beatmap.redLineTimes()[2] == 1000);
+
+	REQUIRE(beatmap.objectCount() == 8);
+	const int endTimes[] = { 1000, 1500, 2500, 3250, 4800, 5000, 5000, 10000 };
+	const int comboIndices[] = { 0, 0, 0, 1, 2, 3, 3, 5 };
+	const int comboNumbers[] = { 1, 2, 3, 1, 1, 1, 2, 1 };
+	for (auto i = 0; i < 8; ++i) {
+		CHECK(beatmap.endTimes()[i] == endTimes[i]);
+		CHECK(beatmap.comboIndices()[i] == comboIndices[i]);
+		CHECK(beatmap.comboNumbers()[i] == comboNumbers[i]);
+	}
+	CHECK(beatmap.x()[7] == 400 && beatmap.y()[7] == 300);
+	CHECK(beatmap.types()[4] & HOT_Spinner);
+}
+
+TEST_CASE(beatmapCursorTracksActiveObjectsAndTiming)
+{
+	Beatmap beatmap;
+	REQUIRE(beatmap.loadFile(fixture("standard.osu")));
+	BeatmapCursor cursor(beatmap);
+
+	cursor.advance(3500);
+	CHECK(cursor.kiai());
+	cursor.advance(5500);
+	CHECK(!cursor.kiai() && cursor.beatLength() == 500.);
+	cursor.advance(10200);
+	CHECK(cursor.kiai() && cursor.beatLength() == 400.);
+	CHECK(cursor.beatPhase() == .5);
+	cursor.advance(3250);
+	CHECK(cursor.timingPoint() == 1 && cursor.beatPhase() == .5);
+
+	// Forward steps and seeks agree with a brute force scan, including overlapping mania holds.
+	for (const auto name : { "standard.osu", "mania.osu" }) {
+		REQUIRE(beatmap.loadFile(fixture(name)));
+		BeatmapCursor forward(beatmap);
+		BeatmapCursor seeking(beatmap);
+		for (auto time = 0; time <= 11000; time += 50) {
+			forward.advance(time);
+			seeking.seek(time);
+			std::vector<int> fromForward, fromSeek;
+			forward.forEachActive([&](int i) { fromForward.push_back(i); });
+			seeking.forEachActive([&](int i) { fromSeek.push_back(i); });
+			CHECK(fromForward == activeAt(beatmap, time));
+			CHECK(fromSeek == fromForward);
+		}
+	}
+	REQUIRE(beatmap.loadFile(fixture("mania.osu")));
+	CHECK(beatmap.circleSize() == 4.);
+	cursor.seek(1900);
+	auto active = 0;
+	cursor.forEachActive([&](int) { active++; });
+	CHECK(active == 2);
+}
@@ -0,0 +1,99 @@
+#include "TestHarness.h"
+
+#include "ColorChart.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	bool sameColor(const CorsairColor &color, int r, int g, int b)
+	{
+		return color.r == r && color.g == g && color.b == b;
+	}
+}
+
+TEST_CASE(colorChartInterpolatesBetweenPoints)
+{
+	ColorChart chart;
+	CHECK(sameColor(chart.evaluate(.5), 0, 0, 0));
+	chart.addPoint(.75, CorsairColor{ 0, 0, 255 });
+	chart.addPoint(.25, CorsairColor{ 255, 0, 0 });
+	chart.addPoint(1.5, CorsairColor{ 0, 255, 0 });
+	CHECK(chart.pointCount() == 3);
+
+	CHECK(sameColor(chart.evaluate(0.), 255, 0, 0));
+	CHECK(sameColor(chart.evaluate(.25), 255, 0, 0));
+	CHECK(sameColor(chart.evaluate(.5), 128, 0, 128));
+	CHECK(sameColor(chart.evaluate(.875), 0, 128, 128));
+	CHECK(sameColor(chart.evaluate(1.), 0, 255, 0));
+	CHECK(sameColor(chart.evaluate(2.), 0, 255, 0));
+}
+
+TEST_CASE(colorChartBakesOneLutPerVersion)
+{
+	ColorChart chart(ColorChart::cLargeLutSize);
+	chart.addPoint(0., CorsairColor{ 0, 0, 0 });
+	chart.addPoint(1., CorsairColor{ 255, 100, 300 });
+	const auto lut = chart.lut();
+	CHECK(lut->size() == 1024 && lut->version() == chart.version());
+	CHECK(chart.lut() == lut);
+
+	// Entries are the chart at their own positions; lookups round to the nearest one.
+	CHECK(lut->entries()[0] == 0);
+	CHECK(lut->entries()[1023] == (255u | 100u << 8 | 255u << 16));
+	const auto middle = chart.evaluate(512. / 1023);
+	CHECK(ColorLut::red(lut->entries()[512]) == middle.r && ColorLut::green(lut->entries()[512]) == middle.g);
+	CHECK(lut->indexOf(.5f) == 512 && lut->indexOf(-1.f) == 0 && lut->indexOf(7.f) == 1023);
+	CHECK(lut->indexOf(std::numeric_limits<float>::quiet_NaN()) == 0);
+
+	// An edit bakes a new LUT, holders of the old one keep it.
+	chart.addPoint(.5, CorsairColor{ 0, 255, 0 });
+	const auto edited = chart.lut();
+	CHECK(edited != lut && edited->version() == chart.version() && lut->version() != chart.version());
+	CHECK(ColorLut::green(edited->at(.5f)) == 255 && ColorLut::green(lut->at(.5f)) == 50);
+}
+
+TEST_CASE(colorLutKernelsAgree)
+{
+	ColorChart chart(ColorChart::cDefaultLutSize, Compositor::Isa::Scalar);
+	chart.addPoint(0., CorsairColor{ 10, 20, 30 });
+	chart.addPoint(.3, CorsairColor{ 200, 0, 90 });
+	chart.addPoint(1., CorsairColor{ 0, 255, 255 });
+	const auto scalar = chart.lut();
+	CHECK(scalar->isa() == Compositor::Isa::Scalar);
+	const ColorLut vector(std::vector<uint32_t>(scalar->entries(), scalar->entries() + scalar->size()), 1, Compositor::Isa::Avx2);
+
+	std::vector<float> positions;
+	for (auto i = -20; i < 1100; ++i) {
+		positions.push_back(i / 1000.f);
+	}
+	positions.push_back(std::numeric_limits<float>::quiet_NaN());
+	positions.push_back(std::numeric_limits<float>::infinity());
+	std::vector<uint32_t> expected(positions.size());
+	std::vector<uint32_t> colors(positions.size());
+	scalar->sample(positions.data(), static_cast<int>(positions.size()), expected.data());
+	vector.sample(positions.data(), static_cast<int>(positions.size()), colors.data());
+	CHECK(colors == expected);
+	for (size_t i = 0; i < positions.size(); ++i) {
+		CHECK(expected[i] == scalar->at(positions[i]));
+	}
+
+	// apply() goes through the same lookups for any number of LEDs.
+	std::vector<CorsairLedId> leds;
+	std::vector<float> ledPositions;
+	for (auto led = static_cast<int>(CLK_Escape); led <= static_cast<int>(CLK_Fn); ++led) {
+		leds.push_back(static_cast<CorsairLedId>(led));
+		ledPositions.push_back(static_cast<float>(led % 17) / 16);
+	}
+	Framebuffer frame;
+	vector.apply(ledPositions.data(), leds.data(), static_cast<int>(leds.size()), frame);
+	CHECK(frame.activeCount() == static_cast<int>(leds.size()));
+	auto same = true;
+	for (size_t i = 0; i < leds.size(); ++i) {
+		const auto color = scalar->at(ledPositions[i]);
+		same = same && frame.red()[leds[i]] == ColorLut::red(color) && frame.blue()[leds[i]] == ColorLut::blue(color);
+	}
+	CHECK(same);
+}
@@ -0,0 +1,89 @@
+#include "TestHarness.h"
+
+#include "Compositor.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	const BlendMode cModes[] = { BlendMode::Over, BlendMode::Alpha, BlendMode::Additive, BlendMode::Multiply, BlendMode::Max };
+
+	void randomize(Framebuffer &frame, unsigned seed)
+	{
+		std::srand(seed);
+		frame.clear();
+		for (auto led = 1; led <= CLI_Last; ++led) {
+			if (std::rand() % 3) {
+				frame.set(static_cast<CorsairLedId>(led), std::rand() & 0xff, std::rand() & 0xff, std::rand() & 0xff, std::rand() & 0xff);
+			}
+		}
+	}
+
+	bool samePlanes(const Framebuffer &a, const Framebuffer &b)
+	{
+		return !std::memcmp(a.red(), b.red(), Framebuffer::cCapacity)
+			&& !std::memcmp(a.green(), b.green(), Framebuffer::cCapacity)
+			&& !std::memcmp(a.blue(), b.blue(), Framebuffer::cCapacity)
+			&& !std::memcmp(a.alpha(), b.alpha(), Framebuffer::cCapacity)
+			&& !std::memcmp(a.activeMask(), b.activeMask(), sizeof(uint64_t) * Framebuffer::cMaskWords);
+	}
+}
+
+TEST_CASE(compositorBlendModes)
+{
+	Compositor compositor(Compositor::Isa::Scalar);
+	Framebuffer below, layer;
+	below.set(CLK_A, 200, 100, 0);
+	layer.set(CLK_A, 100, 200, 255, 128);
+
+	auto check = [&](BlendMode mode, uint8_t opacity, int r, int g, int b) {
+		auto target = below;
+		compositor.blend(target, layer, mode, opacity);
+		CHECK(target.red()[CLK_A] == r && target.green()[CLK_A] == g && target.blue()[CLK_A] == b);
+	};
+	check(BlendMode::Over, 255, 100, 200, 255);
+	check(BlendMode::Alpha, 255, 150, 150, 128);
+	check(BlendMode::Additive, 255, 255, 255, 255);
+	check(BlendMode::Multiply, 255, 78, 78, 0);
+	check(BlendMode::Max, 255, 200, 200, 255);
+	check(BlendMode::Over, 0, 200, 100, 0);
+	check(BlendMode::Over, 51, 180, 120, 51);
+}
+
+TEST_CASE(compositorLeavesInactiveLedsAlone)
+{
+	Compositor compositor;
+	Framebuffer target, layer;
+	target.set(CLK_B, 1, 2, 3);
+	layer.set(CLK_C, 9, 9, 9);
+	layer.red()[CLK_B] = 200;
+	compositor.blend(target, layer, BlendMode::Max);
+	CHECK(target.red()[CLK_B] == 1);
+	CHECK(target.isActive(CLK_B) && target.isActive(CLK_C));
+	CHECK(target.red()[CLK_C] == 9 && target.alpha()[CLK_C] == 255);
+}
+
+TEST_CASE(compositorVectorKernelsMatchScalar)
+{
+	const Compositor::Isa isas[] = { Compositor::Isa::Sse2, Compositor::Isa::Avx2 };
+	Compositor scalar(Compositor::Isa::Scalar);
+	Framebuffer layer, expected, actual;
+	for (auto isa : isas) {
+		if (!Compositor::isSupported(isa)) {
+			continue;
+		}
+		Compositor vector(isa);
+		REQUIRE(vector.isa() == isa);
+		for (auto mode : cModes) {
+			for (auto opacity : { 0, 1, 77, 254, 255 }) {
+				randomize(expected, 1);
+				randomize(layer, 2 + opacity);
+				actual = expected;
+				scalar.blend(expected, layer, mode, static_cast<uint8_t>(opacity));
+				vector.blend(actual, layer, mode, static_cast<uint8_t>(opacity));
+				CHECK(samePlanes(expected, actual));
+			}
+		}
+	}
+}
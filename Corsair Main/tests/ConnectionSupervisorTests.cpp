@@ -0,0 +1,170 @@
+#include "TestHarness.h"
+
+#include "CUESDK.h"
+#include "CUESDKStandIn.h"
+#include "ConnectionSupervisor.h"
+#include "DeviceManager.h"
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	/// Polls until connected, at most for a second.
+	bool pollUntilConnected(ConnectionSupervisor &connection)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+		while (!connection.poll()) {
+			if (std::chrono::steady_clock::now() > deadline) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	bool showsColor(CorsairLedId ledId, int r, int g, int b)
+	{
+		const auto color = CorsairStandInGetLedColor(ledId);
+		return color.r == r && color.g == g && color.b == b;
+	}
+}
+
+TEST_CASE(connectionSupervisorConnectsAndEnumerates)
+{
+	CorsairStandInReset(1);
+
+	DeviceManager devices;
+	ConnectionSupervisor connection(devices);
+	REQUIRE(connection.connect());
+	CHECK(connection.isConnected());
+	CHECK(connection.lastError() == CE_Success);
+	CHECK(devices.deviceCount() == 4);
+	CHECK(connection.stats().handshakes == 1);
+	CHECK(connection.stats().disconnects == 0);
+	CHECK(connection.recoveryTime().count() == 0);
+}
+
+TEST_CASE(connectionSupervisorTakesControlBackAndReplays)
+{
+	CorsairStandInReset(1);
+
+	DeviceManager devices;
+	ConnectionSupervisor connection(devices);
+	REQUIRE(connection.connect());
+	auto frame = devices.availableLeds();
+	frame.set(CLK_Escape, 10, 20, 30);
+	frame.set(CLH_LeftLogo, 40, 50, 60);
+	REQUIRE(connection.submitAsync(frame));
+	REQUIRE(devices.waitIdle(std::chrono::seconds(1)));
+
+	// Another client takes control, the acknowledgement of the next frame reports the failure.
+	CorsairStandInRevokeControl();
+	frame.set(CLK_Escape, 70, 80, 90);
+	connection.submitAsync(frame);
+	REQUIRE(devices.waitIdle(std::chrono::seconds(1)));
+	CHECK(showsColor(CLK_Escape, 10, 20, 30));
+
+	REQUIRE(connection.poll());
+	REQUIRE(devices.waitIdle(std::chrono::seconds(1)));
+	CHECK(connection.stats().disconnects == 1);
+	CHECK(connection.stats().handshakes == 1);
+	CHECK(connection.recoveryTime().count() == 1);
+	CHECK(showsColor(CLK_Escape, 70, 80, 90));
+	CHECK(showsColor(CLH_LeftLogo, 40, 50, 60));
+}
+
+TEST_CASE(connectionSupervisorSurvivesServerRestart)
+{
+	CorsairStandInReset(1);
+
+	DeviceManager devices;
+	ConnectionSupervisor connection(devices, std::chrono::milliseconds(1), std::chrono::milliseconds(4));
+	REQUIRE(connection.connect());
+	auto frame = devices.availableLeds();
+	REQUIRE(connection.submitAsync(frame));
+	REQUIRE(devices.waitIdle(std::chrono::seconds(1)));
+	const auto keyboard = &devices.device(devices.deviceOf(CLK_Escape));
+
+	CorsairStandInSetServerAvailable(0);
+	frame.set(CLK_A, 255, 0, 0);
+	CHECK(!connection.submitAsync(frame));
+	CHECK(!connection.isConnected());
+	CHECK(connection.lastError() == CE_ServerNotFound);
+
+	// Retries back off up to the maximum while CUE is away, frames keep being routed.
+	for (auto i = 0; i < 10; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		frame.set(CLK_B, 0, static_cast<uint8_t>(i + 1), 0);
+		CHECK(!connection.submitAsync(frame));
+	}
+	CHECK(connection.backoff() == std::chrono::milliseconds(4));
+	CHECK(connection.stats().attempts > 2);
+	CHECK(connection.stats().droppedFrames > 0);
+
+	CorsairStandInSetServerAvailable(1);
+	REQUIRE(pollUntilConnected(connection));
+	REQUIRE(devices.waitIdle(std::chrono::seconds(1)));
+	CHECK(connection.stats().handshakes == 2);
+	CHECK(connection.stats().reenumerations == 0);
+	CHECK(&devices.device(devices.deviceOf(CLK_Escape)) == keyboard);
+	CHECK(connection.recoveryTime().count() == 1);
+	CHECK(showsColor(CLK_A, 255, 0, 0));
+	CHECK(showsColor(CLK_B, 0, 10, 0));
+}
+
+TEST_CASE(connectionSupervisorIgnoresLateAcknowledgementsOfALostConnection)
+{
+	CorsairStandInReset(1);
+
+	DeviceManager devices;
+	ConnectionSupervisor connection(devices, std::chrono::milliseconds(1), std::chrono::milliseconds(4));
+	REQUIRE(connection.connect());
+	auto frame = devices.availableLeds();
+	frame.set(CLK_A, 0, 0, 255);
+	REQUIRE(connection.submitAsync(frame));
+	REQUIRE(devices.waitIdle(std::chrono::seconds(1)));
+
+	// A frame is still in flight when CUE goes away; it fails long after the connection is back.
+	CorsairStandInSetLatency(200000, 0);
+	frame.set(CLK_A, 255, 0, 0);
+	REQUIRE(connection.submitAsync(frame));
+	CorsairStandInSetServerAvailable(0);
+	frame.set(CLK_B, 0, 255, 0);
+	CHECK(!connection.submitAsync(frame));
+	CorsairStandInSetServerAvailable(1);
+	REQUIRE(pollUntilConnected(connection));
+	REQUIRE(devices.waitIdle(std::chrono::seconds(2)));
+	CorsairStandInSetLatency(0, 0);
+
+	CHECK(connection.poll());
+	CHECK(connection.stats().disconnects == 1);
+	CHECK(connection.stats().handshakes == 2);
+	CHECK(showsColor(CLK_A, 255, 0, 0));
+	CHECK(showsColor(CLK_B, 0, 255, 0));
+}
+
+TEST_CASE(connectionSupervisorEnumeratesChangedDevices)
+{
+	CorsairStandInReset(1);
+
+	DeviceManager devices;
+	ConnectionSupervisor connection(devices, std::chrono::milliseconds(1), std::chrono::milliseconds(4));
+	REQUIRE(connection.connect());
+	auto frame = devices.availableLeds();
+	frame.set(CLM_1, 0, 0, 255);
+	REQUIRE(connection.submitAsync(frame));
+	REQUIRE(devices.waitIdle(std::chrono::seconds(1)));
+
+	CorsairStandInSetServerAvailable(0);
+	frame.set(CLM_1, 0, 255, 0);
+	CHECK(!connection.submitAsync(frame));
+	CorsairStandInSetLogicalLayout(0, CLL_UK);
+	CorsairStandInSetServerAvailable(1);
+	REQUIRE(pollUntilConnected(connection));
+	REQUIRE(devices.waitIdle(std::chrono::seconds(1)));
+
+	CHECK(connection.stats().reenumerations == 1);
+	CHECK(devices.device(devices.deviceOf(CLK_Escape)).logicalLayout == CLL_UK);
+	CHECK(showsColor(CLM_1, 0, 255, 0));
+}
@@ -0,0 +1,191 @@
+#include "TestHarness.h"
+
+#include "CUESDK.h"
+#include "CUESDKStandIn.h"
+#include "DeltaOutput.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::vector<CorsairLedColor> darkFrame()
+	{
+		std::vector<CorsairLedColor> frame;
+		for (auto ledId = CLK_Escape; ledId <= CLK_Z; ledId = static_cast<CorsairLedId>(ledId + 1)) {
+			frame.push_back(CorsairLedColor{ ledId, 0, 0, 0 });
+		}
+		return frame;
+	}
+
+	int lastRecordedSize()
+	{
+		CorsairStandInFrame frame;
+		const auto count = CorsairStandInGetRecordedFrameCount();
+		return count && CorsairStandInGetRecordedFrame(count - 1, &frame) ? frame.size : -1;
+	}
+}
+
+TEST_CASE(deltaOutputSendsOnlyChangedLeds)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+
+	DeltaOutput output(0);
+	auto frame = darkFrame();
+	REQUIRE(output.submit(static_cast<int>(frame.size()), frame.data()));
+	CHECK(lastRecordedSize() == static_cast<int>(frame.size()));
+
+	frame[3].r = 255;
+	frame[7].b = 10;
+	REQUIRE(output.submit(static_cast<int>(frame.size()), frame.data()));
+	CHECK(lastRecordedSize() == 2);
+
+	REQUIRE(output.submit(static_cast<int>(frame.size()), frame.data()));
+	CHECK(CorsairStandInGetTotalFrameCount() == 2);
+
+	const auto stats = output.stats();
+	CHECK(stats.frames == 3);
+	CHECK(stats.skippedFrames == 1);
+	CHECK(stats.submittedLeds == static_cast<int64_t>(frame.size()) + 2);
+	CHECK(stats.suppressedLeds == 2 * static_cast<int64_t>(frame.size()) - 2);
+}
+
+TEST_CASE(deltaOutputRefreshesPeriodicallyAndAfterFailures)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+
+	DeltaOutput output(3);
+	auto frame = darkFrame();
+	const auto size = static_cast<int>(frame.size());
+	// The first frame goes out in full, the fourth one is the first periodic refresh.
+	for (auto i = 0; i < 4; ++i) {
+		output.submit(size, frame.data());
+	}
+	CHECK(CorsairStandInGetTotalFrameCount() == 2);
+	CHECK(lastRecordedSize() == size);
+	CHECK(output.stats().fullRefreshes == 2);
+
+	CorsairStandInRevokeControl();
+	frame[0].g = 1;
+	CHECK(!output.submit(size, frame.data()));
+	CorsairRequestControl(CAM_ExclusiveLightingControl);
+	CHECK(output.submit(size, frame.data()));
+	CHECK(lastRecordedSize() == size);
+	CHECK(output.stats().failedSubmissions == 1);
+}
+
+TEST_CASE(deltaOutputRecordsWhatItSends)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	const auto standInPath = std::string(CORSAIR_TEST_OUTPUT_DIR) + "/delta_output_stand_in.trace";
+	const auto path = std::string(CORSAIR_TEST_OUTPUT_DIR) + "/delta_output.trace";
+	REQUIRE(CorsairStandInOpenTrace(standInPath.c_str()));
+	FrameTraceWriter trace;
+	REQUIRE(trace.open(path));
+
+	DeltaOutput output(0);
+	output.setTrace(&trace);
+	auto frame = darkFrame();
+	for (auto i = 0; i < 5; ++i) {
+		frame[i].r = 10 * i;
+		output.submit(static_cast<int>(frame.size()), frame.data());
+	}
+	output.submit(static_cast<int>(frame.size()), frame.data());
+	output.setTrace(nullptr);
+	frame[0].g = 1;
+	output.submit(static_cast<int>(frame.size()), frame.data());
+	CorsairStandInCloseTrace();
+	REQUIRE(trace.close());
+
+	// The unchanged frame is in the trace but never reached the SDK, the last one is not traced.
+	FrameTraceReader recorded;
+	FrameTraceReader standIn;
+	REQUIRE(recorded.open(path) && standIn.open(standInPath));
+	auto frames = 0;
+	while (recorded.next()) {
+		frames++;
+		if (recorded.changedLeds()) {
+			REQUIRE(standIn.next());
+			CHECK(standIn.changedLeds() == recorded.changedLeds());
+			CHECK(standIn.frame().activeCount() == recorded.frame().activeCount());
+		}
+	}
+	CHECK(frames == 6 && standIn.next() && !standIn.next());
+	CHECK(recorded.frame().activeCount() == static_cast<int>(frame.size()) && recorded.frame().red()[frame[4].ledId] == 40);
+	CHECK(recorded.frame().green()[frame[0].ledId] == 0);
+}
+
+TEST_CASE(deltaOutputRecordsMetrics)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	MetricsRegistry registry;
+	FrameMetrics frameMetrics(registry);
+	auto &metrics = frameMetrics.device(0, "K95");
+	CHECK(&frameMetrics.device(0, "K95") == &metrics);
+
+	DeltaOutput output(0);
+	output.setMetrics(&metrics);
+	auto frame = darkFrame();
+	const auto size = static_cast<int>(frame.size());
+	REQUIRE(output.submit(size, frame.data()));
+	frame[2].r = 1;
+	REQUIRE(output.submitAsync(size, frame.data()));
+	REQUIRE(output.pipeline().waitIdle(std::chrono::milliseconds(1000)));
+	CHECK(metrics.ledsSent.value() == size + 1);
+	CHECK(metrics.setLedsColors.count() == 1);
+	CHECK(metrics.setLedsColorsAsync.count() == 1);
+	CHECK(metrics.asyncAck.count() == 1);
+
+	CorsairStandInRevokeControl();
+	frame[2].r = 2;
+	CHECK(!output.submit(size, frame.data()));
+	CHECK(metrics.submissionsFailed.value() == 1);
+	CHECK(metrics.ledsSent.value() == size + 1);
+	output.setMetrics(nullptr);
+	CorsairRequestControl(CAM_ExclusiveLightingControl);
+	CHECK(output.submit(size, frame.data()));
+	CHECK(metrics.setLedsColors.count() == 2);
+}
+
+TEST_CASE(deltaOutputCommitsColorsOnAcknowledgement)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	CorsairStandInSetLatency(20000, 0);
+
+	DeltaOutput output(0);
+	auto frame = darkFrame();
+	const auto size = static_cast<int>(frame.size());
+	REQUIRE(output.submitAsync(size, frame.data()));
+	REQUIRE(output.pipeline().waitIdle(std::chrono::milliseconds(1000)));
+
+	// Changed and changed back while the first change is still in flight: both go out, the last one wins.
+	frame[3].r = 255;
+	REQUIRE(output.submitAsync(size, frame.data()));
+	frame[3].r = 0;
+	REQUIRE(output.submitAsync(size, frame.data()));
+	REQUIRE(output.pipeline().waitIdle(std::chrono::milliseconds(1000)));
+	CHECK(CorsairStandInGetTotalFrameCount() == 3);
+	CHECK(CorsairStandInGetLedColor(frame[3].ledId).r == 0);
+
+	// Acknowledged colors are known, so the same frame is not sent again.
+	REQUIRE(output.submitAsync(size, frame.data()));
+	CHECK(!output.pipeline().hasPending() && !output.pipeline().inFlight());
+
+	// A frame the SDK fails is not taken for shown: its LEDs and the rest of the frame go out again.
+	CorsairStandInRevokeControl();
+	frame[5].g = 7;
+	REQUIRE(output.submitAsync(size, frame.data()));
+	REQUIRE(output.pipeline().waitIdle(std::chrono::milliseconds(1000)));
+	CHECK(output.stats().failedSubmissions == 1);
+	CorsairRequestControl(CAM_ExclusiveLightingControl);
+	CorsairStandInSetLatency(0, 0);
+	REQUIRE(output.submitAsync(size, frame.data()));
+	REQUIRE(output.pipeline().waitIdle(std::chrono::milliseconds(1000)));
+	CHECK(lastRecordedSize() == size);
+	CHECK(CorsairStandInGetLedColor(frame[5].ledId).g == 7);
+}
@@ -0,0 +1,185 @@
+#include "TestHarness.h"
+
+#include "CUESDK.h"
+#include "CUESDKStandIn.h"
+#include "ConnectionSupervisor.h"
+#include "DeviceCache.h"
+#include "DeviceManager.h"
+#include "KeyLayoutTable.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::string output(const char *name)
+	{
+		return std::string(CORSAIR_TEST_OUTPUT_DIR) + "/" + name;
+	}
+}
+
+TEST_CASE(deviceCacheRoundTripsThroughMappedFile)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+
+	DeviceCache captured;
+	REQUIRE(captured.capture());
+	REQUIRE(captured.deviceCount() == 4);
+	CHECK(captured.header().sdkDeviceCount == 4u);
+	CHECK(captured.device(0).type == CDT_Keyboard);
+	CHECK(captured.positions(0).numberOfLed == CorsairGetLedPositionsByDeviceIndex(0)->numberOfLed);
+	CHECK(captured.positions(1).numberOfLed == 0);
+	CHECK(captured.positions(3).numberOfLed == 15);
+	const auto path = output("devices.cldc");
+	REQUIRE(captured.save(path));
+
+	DeviceCache mapped;
+	REQUIRE(mapped.open(path));
+	CHECK(mapped.isMapped());
+	REQUIRE(mapped.size() == captured.size());
+	CHECK(!std::memcmp(&mapped.header(), &captured.header(), captured.size()));
+	CHECK(!std::strcmp(mapped.device(0).model, CorsairGetDeviceInfo(0)->model));
+	const auto positions = mapped.positions(0);
+	const auto live = CorsairGetLedPositionsByDeviceIndex(0);
+	REQUIRE(positions.numberOfLed == live->numberOfLed);
+	CHECK(positions.pLedPosition[10].ledId == live->pLedPosition[10].ledId && positions.pLedPosition[10].left == live->pLedPosition[10].left);
+
+	// A cache cut short while being written, or left by another version, is not used.
+	std::vector<char> image(reinterpret_cast<const char*>(&captured.header()), reinterpret_cast<const char*>(&captured.header()) + captured.size());
+	const auto broken = output("broken.cldc");
+	std::ofstream(broken, std::ios::binary).write(image.data(), image.size() - 1);
+	CHECK(!mapped.open(broken));
+	CHECK(mapped.empty());
+	image[4] = 99;
+	std::ofstream(broken, std::ios::binary).write(image.data(), image.size());
+	CHECK(!mapped.open(broken));
+	CHECK(!mapped.open(output("missing.cldc")));
+	std::remove(broken.c_str());
+	std::remove(path.c_str());
+}
+
+TEST_CASE(deviceManagerLoadsCacheWithoutSdk)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	const auto path = output("devices.cldc");
+	DeviceManager enumerated;
+	REQUIRE(enumerated.enumerate());
+	CHECK(!enumerated.isCached());
+	REQUIRE(enumerated.saveCache(path));
+
+	CorsairStandInSetServerAvailable(0);
+	DeviceManager cached;
+	REQUIRE(cached.loadCache(path));
+	CHECK(cached.isCached());
+	REQUIRE(cached.deviceCount() == enumerated.deviceCount());
+	for (auto i = 0; i < cached.deviceCount(); ++i) {
+		CHECK(cached.device(i).model == enumerated.device(i).model);
+		CHECK(cached.device(i).ledIds == enumerated.device(i).ledIds);
+	}
+	const auto keyboard = cached.deviceOf(CLK_Escape);
+	REQUIRE(keyboard >= 0);
+	CHECK(cached.device(keyboard).geometry.count() == enumerated.device(keyboard).geometry.count());
+	CHECK(cached.device(keyboard).geometry.rowCount() == enumerated.device(keyboard).geometry.rowCount());
+	CHECK(cached.availableLeds().activeCount() == enumerated.availableLeds().activeCount());
+	CHECK(!cached.loadCache(output("missing.cldc")));
+	CHECK(!cached.deviceCount());
+	std::remove(path.c_str());
+}
+
+TEST_CASE(connectionSupervisorReconcilesCachedDevices)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	const auto path = output("devices.cldc");
+	{
+		DeviceManager devices;
+		REQUIRE(devices.enumerate());
+		REQUIRE(devices.saveCache(path));
+	}
+
+	// A current cache is only revalidated, the devices stay the mapped ones.
+	{
+		DeviceManager devices;
+		ConnectionSupervisor connection(devices);
+		REQUIRE(devices.loadCache(path));
+		REQUIRE(connection.connect());
+		CHECK(devices.isCached());
+	}
+
+	// Another layout makes it stale, the devices are enumerated again.
+	CorsairStandInSetLogicalLayout(0, CLL_UK);
+	DeviceManager devices;
+	ConnectionSupervisor connection(devices);
+	REQUIRE(devices.loadCache(path));
+	REQUIRE(connection.connect());
+	CHECK(!devices.isCached());
+	CHECK(devices.device(devices.deviceOf(CLK_Escape)).logicalLayout == CLL_UK);
+	REQUIRE(devices.saveCache(path));
+	std::remove(path.c_str());
+}
+
+TEST_CASE(deviceCacheResolvesKeyNamesWithoutSdk)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	CorsairStandInSetLogicalLayout(0, CLL_FR);
+	DeviceCache captured;
+	REQUIRE(captured.capture());
+	REQUIRE(captured.keyLeds());
+	KeyLayoutTable live;
+	REQUIRE(live.update(CLL_FR));
+
+	CorsairStandInSetServerAvailable(0);
+	KeyLayoutTable cached;
+	REQUIRE(cached.load(CLL_FR, captured.keyLeds()));
+	CHECK(cached.builds() == 0);
+	CHECK(cached.layout() == CLL_FR);
+	for (auto i = 0; i < KeyLayoutTable::cCharacters; ++i) {
+		CHECK(cached.ledOf(static_cast<char>(i)) == live.ledOf(static_cast<char>(i)));
+	}
+	// Switching to the layout later does not ask the SDK either.
+	CHECK(cached.update(CLL_FR));
+	CHECK(cached.builds() == 0);
+	CorsairStandInSetServerAvailable(1);
+}
+
+TEST_CASE(deviceManagerKeepsCachePerModelAndLayout)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	const auto directory = output("device_cache");
+	const auto usKey = DeviceCache::currentKey();
+	CorsairStandInSetLogicalLayout(0, CLL_UK);
+	const auto ukKey = DeviceCache::currentKey();
+	CHECK(ukKey != usKey);
+
+	// Every layout is enumerated once and saved under its own key.
+	DeviceManager devices;
+	devices.setCacheDirectory(directory);
+	REQUIRE(devices.enumerate());
+	CHECK(!devices.isCached());
+	CHECK(devices.cache().key() == ukKey);
+	CorsairStandInSetLogicalLayout(0, CLL_US_Int);
+	REQUIRE(devices.enumerate());
+	CHECK(!devices.isCached());
+	CHECK(devices.cache().key() == usKey);
+
+	// Switching back finds the cache of the layout, the last one enumerated is what the next launch loads.
+	CorsairStandInSetLogicalLayout(0, CLL_UK);
+	REQUIRE(devices.enumerate());
+	CHECK(devices.isCached());
+	CHECK(devices.device(devices.deviceOf(CLK_Escape)).logicalLayout == CLL_UK);
+	DeviceManager next;
+	next.setCacheDirectory(directory);
+	REQUIRE(next.loadLastCache());
+	CHECK(next.cache().key() == ukKey);
+
+	std::remove(devices.cachePathOf(usKey).c_str());
+	std::remove(devices.cachePathOf(ukKey).c_str());
+	std::remove((directory + "/last").c_str());
+}
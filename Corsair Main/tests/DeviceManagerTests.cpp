@@ -0,0 +1,155 @@
+#include "TestHarness.h"
+
+#include "CUESDK.h"
+#include "CUESDKStandIn.h"
+#include "DeviceManager.h"
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	int lastRecordedSize()
+	{
+		CorsairStandInFrame frame;
+		const auto count = CorsairStandInGetRecordedFrameCount();
+		return count && CorsairStandInGetRecordedFrame(count - 1, &frame) ? frame.size : -1;
+	}
+
+	int findDevice(const DeviceManager &devices, CorsairDeviceType type)
+	{
+		for (auto i = 0; i < devices.deviceCount(); ++i) {
+			if (devices.device(i).type == type) {
+				return i;
+			}
+		}
+		return -1;
+	}
+}
+
+TEST_CASE(deviceManagerEnumeratesEveryLightingDevice)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+
+	DeviceManager devices;
+	REQUIRE(devices.enumerate());
+	CHECK(devices.deviceCount() == 4);
+
+	const auto keyboard = findDevice(devices, CDT_Keyboard);
+	const auto mouse = findDevice(devices, CDT_Mouse);
+	const auto headset = findDevice(devices, CDT_Headset);
+	const auto mousemat = findDevice(devices, CDT_MouseMat);
+	REQUIRE(keyboard >= 0 && mouse >= 0 && headset >= 0 && mousemat >= 0);
+
+	CHECK(devices.device(keyboard).geometry.count() == static_cast<int>(devices.device(keyboard).ledIds.size()));
+	CHECK(devices.device(mouse).ledIds.size() == 4u);
+	CHECK(devices.device(headset).ledIds.size() == 2u);
+	CHECK(devices.device(mousemat).ledIds.size() == 15u);
+
+	CHECK(devices.deviceOf(CLK_Escape) == keyboard);
+	CHECK(devices.deviceOf(CLM_1) == mouse);
+	CHECK(devices.deviceOf(CLH_RightLogo) == headset);
+	CHECK(devices.deviceOf(CLMM_Zone15) == mousemat);
+	CHECK(devices.deviceOf(CLI_Invalid) == -1);
+
+	auto total = 0;
+	for (auto i = 0; i < devices.deviceCount(); ++i) {
+		total += static_cast<int>(devices.device(i).ledIds.size());
+		CHECK(devices.device(i).dirty);
+	}
+	CHECK(devices.availableLeds().activeCount() == total);
+}
+
+TEST_CASE(deviceManagerSubmitsOnlyChangedDevices)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+
+	DeviceManager devices;
+	REQUIRE(devices.enumerate());
+	auto frame = devices.availableLeds();
+
+	// The first frame reaches every device, with each call carrying one device's LEDs.
+	REQUIRE(devices.submitAsync(frame));
+	REQUIRE(devices.waitIdle(std::chrono::seconds(2)));
+	CHECK(CorsairStandInGetTotalFrameCount() == devices.deviceCount());
+
+	REQUIRE(devices.submitAsync(frame));
+	REQUIRE(devices.waitIdle(std::chrono::seconds(2)));
+	CHECK(CorsairStandInGetTotalFrameCount() == devices.deviceCount());
+
+	frame.set(CLH_LeftLogo, 255, 0, 0);
+	devices.route(frame);
+	const auto headset = devices.deviceOf(CLH_LeftLogo);
+	for (auto i = 0; i < devices.deviceCount(); ++i) {
+		CHECK(devices.device(i).dirty == (i == headset));
+	}
+	REQUIRE(devices.submitAsync());
+	REQUIRE(devices.waitIdle(std::chrono::seconds(2)));
+	CHECK(CorsairStandInGetTotalFrameCount() == devices.deviceCount() + 1);
+	CHECK(lastRecordedSize() == 1);
+	CHECK(CorsairStandInGetLedColor(CLH_LeftLogo).r == 255);
+	CHECK(!devices.device(devices.deviceOf(CLK_Escape)).frame.isActive(CLH_LeftLogo));
+}
+
+TEST_CASE(deviceManagerRecordsLatencyPerDevice)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+
+	DeviceManager devices;
+	REQUIRE(devices.enumerate());
+	const auto keyboard = devices.deviceOf(CLK_Escape);
+	const auto headset = devices.deviceOf(CLH_LeftLogo);
+	const auto headsetLatencyUs = 20000;
+	CorsairStandInSetDeviceLatency(devices.device(headset).index, headsetLatencyUs);
+
+	auto frame = devices.availableLeds();
+	REQUIRE(devices.submitAsync(frame));
+	REQUIRE(devices.waitIdle(std::chrono::seconds(2)));
+	for (auto i = 0; i < 5; ++i) {
+		frame.set(CLK_Escape, static_cast<uint8_t>(i + 1), 0, 0);
+		REQUIRE(devices.submitAsync(frame));
+		REQUIRE(devices.waitIdle(std::chrono::seconds(2)));
+	}
+
+	const auto &keyboardLatency = devices.device(keyboard).output.pipeline().sendToAckLatency();
+	const auto &headsetLatency = devices.device(headset).output.pipeline().sendToAckLatency();
+	CHECK(headsetLatency.count() == 1);
+	CHECK(headsetLatency.max() >= headsetLatencyUs);
+	CHECK(keyboardLatency.count() == 6);
+	CHECK(keyboardLatency.percentile(50) < headsetLatencyUs);
+}
+
+TEST_CASE(deviceManagerKeepsKeyboardGoingPastSlowHeadset)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+
+	DeviceManager devices;
+	REQUIRE(devices.enumerate());
+	const auto keyboard = devices.deviceOf(CLK_Escape);
+	const auto headset = devices.deviceOf(CLH_LeftLogo);
+	const auto headsetLatencyUs = 20000;
+	CorsairStandInSetDeviceLatency(devices.device(headset).index, headsetLatencyUs);
+
+	// Both change every 2 ms for 50 frames, the headset acknowledges one of them every 20 ms.
+	const auto frames = 50;
+	auto frame = devices.availableLeds();
+	for (auto i = 0; i < frames; ++i) {
+		frame.set(CLK_Escape, static_cast<uint8_t>(i + 1), 0, 0);
+		frame.set(CLH_LeftLogo, 0, static_cast<uint8_t>(i + 1), 0);
+		REQUIRE(devices.submitAsync(frame));
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+	REQUIRE(devices.waitIdle(std::chrono::seconds(2)));
+
+	const auto &keyboardLatency = devices.device(keyboard).output.pipeline().sendToAckLatency();
+	const auto &headsetLatency = devices.device(headset).output.pipeline().sendToAckLatency();
+	CHECK(headsetLatency.count() < frames / 2);
+	CHECK(keyboardLatency.count() > frames * 3 / 4);
+	CHECK(keyboardLatency.percentile(90) < headsetLatencyUs / 4);
+	CHECK(CorsairStandInGetLedColor(CLK_Escape).r == frames);
+	CHECK(CorsairStandInGetLedColor(CLH_LeftLogo).g == frames);
+}
@@ -0,0 +1,69 @@
+#include "TestHarness.h"
+
+#include "Easing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+	const double cPi = 3.14159265358979323846;
+
+	double bump(double time, double start, double length)
+	{
+		if (time < start || time >= start + length) {
+			return 0.;
+		}
+		const auto s = std::sin(cPi * (time - start) / length);
+		return s * s;
+	}
+
+	/// Largest difference in levels between a table and the curve computed in double precision, 1 when both round at .5.
+	template <typename Curve>
+	int maxLevelError(EasingCurve curve, Curve expected)
+	{
+		auto error = 0;
+		for (auto i = 0; i < Easing::cTableSize; ++i) {
+			const auto phase = static_cast<uint32_t>(i) << (32 - Easing::cTableBits);
+			const auto level = static_cast<int>(expected(static_cast<double>(i) / Easing::cTableSize) * 255 + .5);
+			error = std::max(error, std::abs(Easing::level(curve, phase) - level));
+		}
+		return error;
+	}
+}
+
+TEST_CASE(easingTablesMatchTheCurves)
+{
+	CHECK(maxLevelError(EasingCurve::Sine, [](double t) { return std::sin(cPi * t); }) <= 1);
+	CHECK(maxLevelError(EasingCurve::Quad, [](double t) { return 1 - std::pow(2 * t - 1, 2); }) <= 1);
+	CHECK(maxLevelError(EasingCurve::Cubic, [](double t) { return 1 - std::pow(std::abs(2 * t - 1), 3); }) <= 1);
+	CHECK(maxLevelError(EasingCurve::Triangle, [](double t) { return 1 - std::abs(2 * t - 1); }) <= 1);
+	CHECK(maxLevelError(EasingCurve::Pulse, [](double t) { return t < .3 ? 1. : 0.; }) <= 1);
+	CHECK(maxLevelError(EasingCurve::Heartbeat, [](double t) { return std::max(bump(t * 1000, 0, 150), .6 * bump(t * 1000, 250, 150)); }) <= 1);
+	CHECK(maxLevelError(EasingCurve::Breathe, [](double t) { return bump(t, 0, 1); }) <= 1);
+
+	CHECK(Easing::at(EasingCurve::Quad, 0) == 0 && Easing::at(EasingCurve::Quad, 0x80000000u) == Easing::cOne);
+	CHECK(Easing::level(EasingCurve::Heartbeat, 0x80000000u) == 0);
+}
+
+TEST_CASE(phaseAccumulatorCountsPeriods)
+{
+	PhaseAccumulator phase(600);
+	CHECK(phase.advance(300) == 0);
+	CHECK(Easing::level(EasingCurve::Triangle, phase.phase()) == 255);
+	CHECK(phase.advance(299) == 0);
+	CHECK(phase.advance(1) == 1);
+	CHECK(phase.phase() < 0x10000u);
+
+	// Changing the period keeps the phase, the rest of the period goes at the new speed.
+	phase.reset(0x40000000u);
+	phase.setPeriod(100);
+	CHECK(phase.periodMs() == 100 && phase.phase() == 0x40000000u);
+	CHECK(phase.advance(74) == 0 && phase.advance(1) == 1);
+	CHECK(phase.advance(1000) == 10);
+
+	PhaseAccumulator fastest(0);
+	CHECK(fastest.periodMs() == 1 && fastest.advance(3) == 3 && fastest.phase() == 0);
+	CHECK(fastest.advance(-5) == 0);
+}
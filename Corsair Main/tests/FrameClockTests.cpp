@@ -0,0 +1,29 @@
+#include "TestHarness.h"
+
+#include "FrameClock.h"
+
+#include <thread>
+
+TEST_CASE(frameClockAdvancesOnePeriodPerFrame)
+{
+	FrameClock clock(FR_240Hz);
+	auto previous = clock.waitForNextFrame();
+	for (auto i = 0; i < 8; ++i) {
+		const auto tick = clock.waitForNextFrame();
+		CHECK(tick.index == previous.index + 1 + tick.skipped);
+		CHECK(tick.offset >= previous.offset);
+		CHECK(tick.jitterNs >= 0);
+		previous = tick;
+	}
+	CHECK(clock.stats().frames == 9);
+}
+
+TEST_CASE(frameClockSkipsMissedFrames)
+{
+	FrameClock clock(FR_240Hz);
+	clock.waitForNextFrame();
+	std::this_thread::sleep_for(std::chrono::milliseconds(30));
+	const auto tick = clock.waitForNextFrame();
+	CHECK(tick.skipped > 0);
+	CHECK(clock.stats().skippedFrames == tick.skipped);
+}
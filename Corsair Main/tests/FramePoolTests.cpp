@@ -0,0 +1,33 @@
+#include "TestHarness.h"
+
+#include "FramePool.h"
+
+TEST_CASE(framePoolRecyclesSlots)
+{
+	FramePool pool(2, 16);
+	auto first = pool.acquire(16);
+	auto second = pool.acquire(8);
+	REQUIRE(first && second);
+	CHECK(first != second);
+	CHECK(second->size == 8);
+	FramePool::release(first);
+	auto third = pool.acquire(4);
+	CHECK(third == first);
+	CHECK(pool.overflowCount() == 0);
+	FramePool::release(second);
+	FramePool::release(third);
+}
+
+TEST_CASE(framePoolOverflowsToHeap)
+{
+	FramePool pool(1, 4);
+	auto pooled = pool.acquire(4);
+	auto exhausted = pool.acquire(4);
+	auto oversized = pool.acquire(32);
+	REQUIRE(pooled && exhausted && oversized);
+	CHECK(oversized->size == 32);
+	CHECK(pool.overflowCount() == 2);
+	FramePool::release(oversized);
+	FramePool::release(exhausted);
+	FramePool::release(pooled);
+}
@@ -0,0 +1,217 @@
+#include "TestHarness.h"
+
+#include "FrameTrace.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::string output(const char *name)
+	{
+		return std::string(CORSAIR_TEST_OUTPUT_DIR) + "/" + name;
+	}
+
+	bool sameLeds(const Framebuffer &a, const Framebuffer &b)
+	{
+		auto same = a.activeCount() == b.activeCount();
+		a.forEachActive([&](CorsairLedId ledId) {
+			same = same && b.isActive(ledId) && a.red()[ledId] == b.red()[ledId] && a.green()[ledId] == b.green()[ledId] && a.blue()[ledId] == b.blue()[ledId];
+		});
+		return same;
+	}
+
+	/// Keyboard pulsing in one color with a gradient over the number row every eighth frame.
+	void pulseFrame(Framebuffer &frame, int index)
+	{
+		const auto level = static_cast<uint8_t>(index * 7);
+		for (auto led = static_cast<int>(CLK_Escape); led <= static_cast<int>(CLK_Fn); ++led) {
+			frame.set(static_cast<CorsairLedId>(led), 0, level / 2, level);
+		}
+		if (index % 8 == 0) {
+			for (auto led = static_cast<int>(CLK_1); led <= static_cast<int>(CLK_0); ++led) {
+				frame.set(static_cast<CorsairLedId>(led), static_cast<uint8_t>(led * 20 + index), 0, 0);
+			}
+		}
+	}
+
+	void putLE(std::vector<uint8_t> &buffer, uint64_t value, int bytes)
+	{
+		for (auto i = 0; i < bytes; ++i) {
+			buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	void writeFile(const std::string &path, const std::vector<uint8_t> &bytes)
+	{
+		std::ofstream file(path, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	}
+}
+
+TEST_CASE(frameTraceRoundTripsFramesAndPartialUpdates)
+{
+	const auto path = output("round_trip.trace");
+	FrameTraceWriter writer(16);
+	REQUIRE(writer.open(path));
+	const std::unique_ptr<Framebuffer[]> frames(new Framebuffer[40]);
+	for (auto i = 0; i < 30; ++i) {
+		pulseFrame(frames[i], i);
+		REQUIRE(writer.writeFrame(1000000 + i * 8333333LL, frames[i], i == 5));
+	}
+	// CorsairSetLedsColors() style updates land on top of what was lit before.
+	for (auto i = 30; i < 40; ++i) {
+		const CorsairLedColor leds[] = { { CLK_A, i, 2, 3 }, { CLK_B, 300, -4, 5 } };
+		frames[i] = frames[i - 1];
+		frames[i].set(leds[0]);
+		frames[i].set(leds[1]);
+		REQUIRE(writer.writeFrame(1000000 + i * 8333333LL, 2, leds));
+	}
+	CHECK(writer.frames() == 40);
+	const auto size = writer.size();
+	REQUIRE(writer.close());
+
+	FrameTraceReader reader;
+	REQUIRE(reader.open(path));
+	CHECK(reader.version() == FrameTraceWriter::cVersion && static_cast<int64_t>(reader.size()) == size);
+	for (auto i = 0; i < 40; ++i) {
+		REQUIRE(reader.next());
+		CHECK(reader.frameIndex() == i);
+		CHECK(reader.timestampNs() == 1000000 + i * 8333333LL);
+		CHECK(reader.isKeyframe() == (i % 16 == 0));
+		CHECK(reader.isAsync() == (i == 5));
+		CHECK(sameLeds(reader.frame(), frames[i]));
+	}
+	CHECK(!reader.next() && !reader.failed());
+
+	// Only the changes are counted: the whole keyboard first, then the pulse, then the two keys of the partial updates.
+	reader.rewind();
+	reader.next();
+	CHECK(reader.changedLeds() == frames[0].activeCount());
+	for (auto i = 0; i < 30; ++i) {
+		reader.next();
+	}
+	CHECK(reader.changedLeds() == 2 && reader.frame().red()[CLK_B] == 255 && reader.frame().green()[CLK_B] == 0);
+	reader.next();
+	CHECK(reader.changedLeds() == 1);
+}
+
+TEST_CASE(frameTraceRecordsLedsTurningOff)
+{
+	// Every LED gets its own color so the trace spans many chunks of the writer, and a growing range goes dark.
+	const auto path = output("unset.trace");
+	FrameTraceWriter writer;
+	REQUIRE(writer.open(path));
+	const auto frameCount = 1500;
+	const std::unique_ptr<Framebuffer[]> frames(new Framebuffer[frameCount]);
+	for (auto i = 0; i < frameCount; ++i) {
+		for (auto led = static_cast<int>(CLK_Escape); led <= static_cast<int>(CLK_Fn); ++led) {
+			if (led < CLK_Escape + i % 40 || led % 9 != i % 9) {
+				frames[i].set(static_cast<CorsairLedId>(led), static_cast<uint8_t>(led + i), static_cast<uint8_t>(led * 3), static_cast<uint8_t>(i));
+			}
+		}
+		REQUIRE(writer.writeFrame(i * 1000LL, frames[i]));
+	}
+	CHECK(writer.size() > 4 * 64 * 1024);
+	REQUIRE(writer.close());
+
+	FrameTraceReader reader;
+	REQUIRE(reader.open(path));
+	for (auto i = 0; i < frameCount; ++i) {
+		REQUIRE(reader.next());
+		CHECK(reader.timestampNs() == i * 1000LL);
+		CHECK(sameLeds(reader.frame(), frames[i]));
+	}
+	CHECK(!reader.next() && !reader.failed());
+	std::remove(path.c_str());
+}
+
+TEST_CASE(frameTraceKeepsHourLongSessionsSmall)
+{
+	// An hour of a 60 Hz pulse over the whole keyboard, encoded in memory.
+	FrameTraceEncoder encoder;
+	std::vector<uint8_t> buffer;
+	Framebuffer frame;
+	int64_t size = 0;
+	for (auto i = 0; i < 60 * 60 * 60; ++i) {
+		pulseFrame(frame, i);
+		encoder.encode(buffer, i * 16666667LL, frame);
+		size += static_cast<int64_t>(buffer.size());
+		buffer.clear();
+	}
+	CHECK(size < 8 * 1024 * 1024);
+}
+
+TEST_CASE(frameTraceReadsStandInTraces)
+{
+	// Two calls as the stand-in records them, the second one updating one LED.
+	std::vector<uint8_t> bytes = { 'C', 'U', 'E', 'T', 'R', 'A', 'C', 'E' };
+	putLE(bytes, 1, 4);
+	putLE(bytes, 500, 8);
+	putLE(bytes, 0, 4);
+	putLE(bytes, 2, 4);
+	putLE(bytes, CLK_Q, 4);
+	bytes.insert(bytes.end(), { 10, 20, 30, 0 });
+	putLE(bytes, CLK_W, 4);
+	bytes.insert(bytes.end(), { 40, 50, 60, 0 });
+	putLE(bytes, 900, 8);
+	putLE(bytes, 1, 4);
+	putLE(bytes, 2, 4);
+	putLE(bytes, CLK_W, 4);
+	bytes.insert(bytes.end(), { 41, 50, 60, 0 });
+	putLE(bytes, CLK_Q, 4);
+	bytes.insert(bytes.end(), { 10, 20, 30, 0 });
+	const auto path = output("stand_in.trace");
+	writeFile(path, bytes);
+
+	FrameTraceReader reader;
+	REQUIRE(reader.open(path));
+	CHECK(reader.version() == 1);
+	REQUIRE(reader.next());
+	CHECK(reader.timestampNs() == 500 && reader.changedLeds() == 2 && !reader.isAsync());
+	REQUIRE(reader.next());
+	CHECK(reader.timestampNs() == 900 && reader.changedLeds() == 1 && reader.isAsync());
+	CHECK(reader.frame().activeCount() == 2 && reader.frame().red()[CLK_W] == 41 && reader.frame().blue()[CLK_Q] == 30);
+	CHECK(!reader.next() && !reader.failed());
+
+	// A frame cut short is reported, not read past the end of the mapping.
+	bytes.resize(bytes.size() - 3);
+	writeFile(path, bytes);
+	REQUIRE(reader.open(path));
+	CHECK(reader.next() && !reader.next() && reader.failed());
+
+	bytes[8] = FrameTraceWriter::cVersion + 1;
+	writeFile(path, bytes);
+	CHECK(!reader.open(path));
+	CHECK(!reader.open(output("missing.trace")));
+}
+
+TEST_CASE(frameTraceDetectsTruncatedCompactFrames)
+{
+	const auto path = output("truncated.trace");
+	FrameTraceWriter writer;
+	REQUIRE(writer.open(path));
+	Framebuffer frame;
+	for (auto i = 0; i < 3; ++i) {
+		pulseFrame(frame, i * 8);
+		writer.writeFrame(i, frame);
+	}
+	REQUIRE(writer.close());
+
+	std::vector<uint8_t> bytes;
+	{
+		std::ifstream file(path, std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	bytes.resize(bytes.size() - 1);
+	writeFile(path, bytes);
+	FrameTraceReader reader;
+	REQUIRE(reader.open(path));
+	CHECK(reader.next() && reader.next());
+	CHECK(!reader.next() && reader.failed() && reader.frameIndex() == 1);
+	std::remove(path.c_str());
+}
@@ -0,0 +1,38 @@
+#include "TestHarness.h"
+
+#include "Framebuffer.h"
+
+#include <vector>
+
+TEST_CASE(framebufferStagesActiveLedsInIdOrder)
+{
+	Framebuffer frame;
+	CHECK(frame.activeCount() == 0);
+	frame.set(CLK_Z, 1, 2, 3);
+	frame.set(CLK_Escape, 10, 20, 30);
+	frame.set(CLMM_Zone15, 255, 0, 0);
+	frame.set(CLI_Invalid, 1, 1, 1);
+	CHECK(frame.activeCount() == 3);
+
+	std::vector<CorsairLedColor> staging;
+	staging.reserve(Framebuffer::cCapacity);
+	REQUIRE(frame.stage(staging) == 3);
+	CHECK(staging[0].ledId == CLK_Escape && staging[0].g == 20);
+	CHECK(staging[1].ledId == CLK_Z && staging[1].b == 3);
+	CHECK(staging[2].ledId == CLMM_Zone15 && staging[2].r == 255);
+}
+
+TEST_CASE(framebufferFillKeepsActiveSet)
+{
+	Framebuffer frame;
+	frame.activate(CLK_A);
+	frame.activate(CLK_B);
+	frame.fill(0, 128, 0);
+	CHECK(frame.green()[CLK_A] == 128 && frame.green()[CLK_B] == 128);
+	CHECK(frame.green()[CLK_C] == 128 && !frame.isActive(CLK_C));
+	frame.deactivate(CLK_A);
+	CHECK(!frame.isActive(CLK_A) && frame.isActive(CLK_B));
+
+	frame.set(CorsairLedColor{ CLK_C, 300, -5, 7 });
+	CHECK(frame.red()[CLK_C] == 255 && frame.green()[CLK_C] == 0 && frame.blue()[CLK_C] == 7);
+}
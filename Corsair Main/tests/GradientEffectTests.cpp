@@ -0,0 +1,102 @@
+#include "TestHarness.h"
+
+#include "ColorChart.h"
+#include "GradientEffect.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+	/// The four ramps of the corsair_layers_all_effects example.
+	GradientEffect exampleGradient()
+	{
+		GradientEffect gradient(CorsairColor{ 0, 0, 0 });
+		gradient.addRamp(2500, CorsairColor{ 255, 255, 255 }, 3.);
+		gradient.addRamp(2000, CorsairColor{ 125, 125, 0 }, .2);
+		gradient.addRamp(1000, CorsairColor{ 0, 0, 0 }, -1.);
+		gradient.addRamp(3000, CorsairColor{ 0, 0, 255 }, 1.);
+		return gradient;
+	}
+
+	/// Color as the SDK effect computes it, with a pow per evaluation.
+	CorsairColor naiveColor(int offset)
+	{
+		const int durations[] = { 2500, 2000, 1000, 3000 };
+		const CorsairColor colors[] = { { 0, 0, 0 }, { 255, 255, 255 }, { 125, 125, 0 }, { 0, 0, 0 }, { 0, 0, 255 } };
+		const double powers[] = { 3., .2, -1., 1. };
+		auto ramp = 0;
+		for (; ramp < 3 && offset >= durations[ramp]; ++ramp) {
+			offset -= durations[ramp];
+		}
+		const auto t = GradientEffect::shape(static_cast<double>(offset) / durations[ramp], powers[ramp]);
+		const auto &from = colors[ramp];
+		const auto &to = colors[ramp + 1];
+		return CorsairColor{ static_cast<int>(from.r + (to.r - from.r) * t + .5), static_cast<int>(from.g + (to.g - from.g) * t + .5),
+			static_cast<int>(from.b + (to.b - from.b) * t + .5) };
+	}
+
+	int channelError(uint32_t color, const CorsairColor &expected)
+	{
+		return std::max({ std::abs(ColorLut::red(color) - expected.r), std::abs(ColorLut::green(color) - expected.g),
+			std::abs(ColorLut::blue(color) - expected.b) });
+	}
+}
+
+TEST_CASE(gradientEffectFollowsRamps)
+{
+	const auto gradient = exampleGradient();
+	CHECK(gradient.rampCount() == 4 && gradient.duration() == 8500);
+
+	CHECK(gradient.colorAt(-5) == 0 && gradient.colorAt(0) == 0);
+	CHECK(gradient.colorAt(2500) == 0xffffffu);
+	CHECK(gradient.colorAt(4500) == 0x7d7du);
+	CHECK(gradient.colorAt(9000) == 0xff0000u);
+
+	// Ramps of up to cMaxSteps ms are baked per millisecond, longer ones to the nearest of cMaxSteps steps.
+	auto exact = true;
+	for (auto offset = 4500; offset < 5500; ++offset) {
+		exact = exact && channelError(gradient.colorAt(offset), naiveColor(offset)) == 0;
+	}
+	CHECK(exact);
+	auto maxError = 0;
+	for (auto offset = 0; offset < 8500; offset += 16) {
+		maxError = std::max(maxError, channelError(gradient.colorAt(offset), naiveColor(offset)));
+	}
+	CHECK(maxError <= 3);
+}
+
+TEST_CASE(gradientEffectRendersUntilItsEnd)
+{
+	GradientEffect gradient(CorsairColor{ 10, 20, 30 });
+	gradient.addRamp(0, CorsairColor{ 255, 0, 0 }, 1.);
+	gradient.addRamp(100, CorsairColor{ 0, 0, 0 }, 0.);
+	CHECK(gradient.colorAt(0) == 255u && gradient.colorAt(50) == 128u);
+
+	const CorsairLedId leds[] = { CLK_A, CLK_S, CLK_D };
+	Framebuffer frame;
+	CHECK(gradient.render(50, leds, 3, frame));
+	CHECK(frame.activeCount() == 3 && frame.red()[CLK_D] == 128 && frame.green()[CLK_D] == 0);
+	CHECK(!gradient.render(100, leds, 3, frame));
+	CHECK(frame.red()[CLK_A] == 128);
+
+	const GradientEffect empty(CorsairColor{ 1, 2, 3 });
+	CHECK(!empty.render(0, leds, 3, frame) && empty.colorAt(0) == 0x030201u);
+}
+
+TEST_CASE(gradientEffectClampsItsDuration)
+{
+	GradientEffect gradient(CorsairColor{ 0, 0, 0 });
+	gradient.addRamp(-5, CorsairColor{ 1, 1, 1 }, 0.);
+	gradient.addRamp(std::numeric_limits<int>::max() - 10, CorsairColor{ 255, 0, 0 }, 0.);
+	gradient.addRamp(100, CorsairColor{ 0, 255, 0 }, 0.);
+	gradient.addRamp(std::numeric_limits<int>::max(), CorsairColor{ 0, 0, 255 }, 0.);
+	CHECK(gradient.rampCount() == 4);
+	CHECK(gradient.duration() == std::numeric_limits<int>::max());
+	CHECK(gradient.colorAt(0) == 0x010101u);
+	CHECK(gradient.colorAt(std::numeric_limits<int>::max() - 10) == 0x0000ffu);
+	CHECK(gradient.colorAt(std::numeric_limits<int>::max() - 1) == 0x00e61au);
+	CHECK(gradient.colorAt(std::numeric_limits<int>::max()) == 0xff0000u);
+}
@@ -0,0 +1,81 @@
+#include "TestHarness.h"
+
+#include "ColorChart.h"
+#include "Hsv.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+	/// HSV to RGB in double precision, rounded like the SDK effects.
+	int expectedChannel(double hue, double saturation, double value, int shift)
+	{
+		auto k = std::fmod(hue * 6 + shift, 6.);
+		const auto weight = std::min(std::max(std::min(k, 4 - k), 0.), 1.);
+		return static_cast<int>((value - value * saturation * weight) * 255 + .5);
+	}
+
+	int channelError(uint32_t color, int hue, int saturation, int value)
+	{
+		const auto h = static_cast<double>(hue) / HsvConverter::cHueTurn;
+		const auto s = saturation / 255.;
+		const auto v = value / 255.;
+		return std::max({ std::abs(ColorLut::red(color) - expectedChannel(h, s, v, 5)), std::abs(ColorLut::green(color) - expectedChannel(h, s, v, 3)),
+			std::abs(ColorLut::blue(color) - expectedChannel(h, s, v, 1)) });
+	}
+}
+
+TEST_CASE(hsvConverterMatchesDoubleConversion)
+{
+	CHECK(HsvConverter::toRgb(0) == 0x0000ffu);
+	CHECK(HsvConverter::toRgb(HsvConverter::hueOf(1. / 3)) == 0x00ff00u);
+	CHECK(HsvConverter::toRgb(HsvConverter::hueOf(2. / 3)) == 0xff0000u);
+	CHECK(HsvConverter::toRgb(HsvConverter::hueOf(1. / 6)) == 0x00ffffu);
+	CHECK(HsvConverter::toRgb(1234, 0, 200) == 0xc8c8c8u);
+	CHECK(HsvConverter::toRgb(40000, 255, 0) == 0);
+	CHECK(HsvConverter::hueOf(-.25) == 49152 && HsvConverter::hueOf(1.) == 0);
+
+	auto maxError = 0;
+	const int levels[] = { 0, 1, 77, 128, 200, 254, 255 };
+	for (auto hue = 0; hue < HsvConverter::cHueTurn; hue += 7) {
+		for (const auto saturation : levels) {
+			for (const auto value : levels) {
+				const auto color = HsvConverter::toRgb(static_cast<uint16_t>(hue), static_cast<uint8_t>(saturation), static_cast<uint8_t>(value));
+				maxError = std::max(maxError, channelError(color, hue, saturation, value));
+			}
+		}
+	}
+	CHECK(maxError <= 1);
+}
+
+TEST_CASE(hsvKernelsAgree)
+{
+	const HsvConverter scalar(Compositor::Isa::Scalar);
+	const HsvConverter vector(Compositor::Isa::Avx2);
+	CHECK(scalar.isa() == Compositor::Isa::Scalar);
+
+	// 16 at a time, then 8, then the scalar tail.
+	std::vector<uint16_t> hues;
+	for (auto hue = 0; hue < HsvConverter::cHueTurn; hue += 13) {
+		hues.push_back(static_cast<uint16_t>(hue));
+	}
+	hues.resize(hues.size() / 16 * 16 + 11);
+	std::vector<uint32_t> expected(hues.size());
+	std::vector<uint32_t> colors(hues.size());
+	const uint8_t levels[] = { 0, 99, 255 };
+	for (const auto saturation : levels) {
+		for (const auto value : levels) {
+			scalar.convert(hues.data(), saturation, value, static_cast<int>(hues.size()), expected.data());
+			vector.convert(hues.data(), saturation, value, static_cast<int>(hues.size()), colors.data());
+			CHECK(colors == expected);
+		}
+	}
+
+	const CorsairLedId leds[] = { CLK_Q, CLK_W, CLK_E };
+	Framebuffer frame;
+	vector.apply(hues.data(), leds, 3, 255, 255, frame);
+	CHECK(frame.activeCount() == 3 && frame.red()[CLK_Q] == 255 && frame.green()[CLK_Q] == 0);
+}
@@ -0,0 +1,91 @@
+#include "TestHarness.h"
+
+#include "CUESDKStandIn.h"
+#include "InputThread.h"
+
+#include "windows.h"
+#include <thread>
+#include <vector>
+
+TEST_CASE(inputThreadQueuesTimestampedEdges)
+{
+	CorsairStandInReset(1);
+	InputThread input({ 'Z', 'X' });
+	KeyEvent event;
+
+	input.sample();
+	CHECK(!input.nextEvent(event));
+
+	const auto before = InputThread::Clock::now();
+	CorsairStandInSetKeyState('X', 1);
+	input.sample();
+	input.sample();
+	REQUIRE(input.nextEvent(event));
+	CHECK(event.virtualKey == 'X' && event.pressed);
+	CHECK(event.timestamp >= before);
+	CHECK(!input.nextEvent(event));
+
+	CorsairStandInSetKeyState('X', 0);
+	input.start();
+	const auto deadline = InputThread::Clock::now() + std::chrono::seconds(2);
+	auto released = false;
+	while (!released && InputThread::Clock::now() < deadline) {
+		released = input.nextEvent(event);
+	}
+	input.stop();
+	REQUIRE(released);
+	CHECK(event.virtualKey == 'X' && !event.pressed);
+	CHECK(input.droppedEvents() == 0);
+}
+
+TEST_CASE(inputThreadReplaysScriptedEventsOnTime)
+{
+	InputThread input({ 'Z', 'X' });
+	const auto start = InputThread::Clock::now();
+	input.startReplay({
+		KeyEvent{ start + std::chrono::milliseconds(20), 'Z', true },
+		KeyEvent{ start + std::chrono::milliseconds(20), 'X', true },
+		KeyEvent{ start + std::chrono::milliseconds(40), 'Z', false }
+	});
+
+	std::vector<KeyEvent> received;
+	const auto deadline = start + std::chrono::seconds(2);
+	while (received.size() < 3 && InputThread::Clock::now() < deadline) {
+		KeyEvent event;
+		if (input.nextEvent(event)) {
+			// Events carry their scripted time and are never queued before it.
+			CHECK(InputThread::Clock::now() >= event.timestamp);
+			received.push_back(event);
+		}
+	}
+	input.stop();
+	REQUIRE(received.size() == 3);
+	CHECK(received[0].virtualKey == 'Z' && received[1].virtualKey == 'X' && !received[2].pressed);
+	CHECK(received[2].timestamp == start + std::chrono::milliseconds(40));
+	CHECK(input.droppedEvents() == 0);
+}
+
+TEST_CASE(inputThreadSamplesLiveKeysDuringReplay)
+{
+	CorsairStandInReset(1);
+	InputThread input({ VK_ESCAPE, 'Z' });
+	const auto start = InputThread::Clock::now();
+	input.startReplay({ KeyEvent{ start + std::chrono::seconds(10), 'Z', true } }, { VK_ESCAPE });
+
+	// Escape is read from the keyboard long before the scripted press, Z is left to the script.
+	CorsairStandInSetKeyState('Z', 1);
+	CorsairStandInSetKeyState(VK_ESCAPE, 1);
+	KeyEvent event;
+	auto received = false;
+	const auto deadline = start + std::chrono::seconds(2);
+	while (!received && InputThread::Clock::now() < deadline) {
+		received = input.nextEvent(event);
+	}
+	REQUIRE(received);
+	CHECK(event.virtualKey == VK_ESCAPE && event.pressed);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	input.stop();
+	CHECK(!input.nextEvent(event));
+	CorsairStandInSetKeyState('Z', 0);
+	CorsairStandInSetKeyState(VK_ESCAPE, 0);
+}
@@ -0,0 +1,66 @@
+#include "TestHarness.h"
+
+#include "CUESDK.h"
+#include "CUESDKStandIn.h"
+#include "KeyLayoutTable.h"
+
+#include "windows.h"
+
+TEST_CASE(keyLayoutTableMatchesSdkForEveryCharacter)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+
+	KeyLayoutTable keys;
+	CHECK(keys.layout() == CLL_Invalid);
+	CHECK(keys.ledOf('a') == CLI_Invalid);
+	REQUIRE(keys.updateFromSdk());
+	CHECK(keys.layout() == CorsairGetDeviceInfo(0)->logicalLayout);
+	CHECK(keys.builds() == 1);
+	for (auto i = 0; i < KeyLayoutTable::cCharacters; ++i) {
+		const auto keyName = static_cast<char>(i);
+		CHECK(keys.ledOf(keyName) == CorsairGetLedIdForKeyName(keyName));
+	}
+	CHECK(keys.labelOf(CLK_A) == 'A');
+	CHECK(keys.labelOf(CLK_Z) == 'Z');
+	CHECK(keys.labelOf(CLK_Escape) == 0);
+	CHECK(keys.labelOf(CLI_Invalid) == 0);
+
+	// Virtual keys of letters and digits are their uppercase characters.
+	CHECK(keys.ledOfVirtualKey('Z') == keys.ledOf('z'));
+	CHECK(keys.ledOfVirtualKey('7') == keys.ledOf('7'));
+	CHECK(keys.ledOfVirtualKey(VK_SPACE) == CLK_Space);
+	CHECK(keys.ledOfVirtualKey(VK_OEM_1) == keys.ledOf(';'));
+	CHECK(keys.ledOfVirtualKey(VK_LBUTTON) == CLI_Invalid);
+}
+
+TEST_CASE(keyLayoutTableIsOnlyBuiltForNewLayouts)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	KeyLayoutTable keys;
+	REQUIRE(keys.update(CLL_US_Int));
+	CHECK(keys.ledOf('z') == CLK_Z);
+
+	CorsairStandInSetLogicalLayout(0, CLL_DE);
+	REQUIRE(keys.update(CLL_DE));
+	CHECK(keys.builds() == 2);
+	CHECK(keys.ledOf('z') == CLK_Y);
+	CHECK(keys.ledOf('y') == CLK_Z);
+	CHECK(keys.labelOf(CLK_Y) == 'Z');
+
+	// Layouts seen before come from the stored tables, even without CUE.
+	CorsairStandInSetServerAvailable(0);
+	REQUIRE(keys.update(CLL_US_Int));
+	CHECK(keys.builds() == 2);
+	CHECK(keys.ledOf('z') == CLK_Z);
+	CHECK(keys.update(CLL_DE));
+	CHECK(keys.ledOf('z') == CLK_Y);
+
+	// A new layout the SDK cannot resolve keeps the current tables.
+	CHECK(!keys.update(CLL_FR));
+	CHECK(keys.layout() == CLL_DE);
+	CHECK(keys.ledOf('z') == CLK_Y);
+	CHECK(!keys.update(CLL_Invalid));
+	CorsairStandInSetServerAvailable(1);
+}
@@ -0,0 +1,35 @@
+#include "TestHarness.h"
+
+#include "KeySplash.h"
+
+TEST_CASE(keySplashFadesFromTheHitTime)
+{
+	const auto hit = KeySplash::Clock::now();
+	KeySplash splash(std::chrono::milliseconds(100));
+	Framebuffer layer;
+	splash.trigger(CLK_Z, hit);
+	splash.trigger(CLK_X, hit + std::chrono::milliseconds(50));
+
+	// A frame 25 ms after the first hit: a quarter of its fade is gone, the second one has not started yet.
+	splash.render(layer, hit + std::chrono::milliseconds(25));
+	CHECK(layer.activeCount() == 2);
+	CHECK(layer.alpha()[CLK_Z] == 191);
+	CHECK(layer.alpha()[CLK_X] == 255);
+	CHECK(layer.red()[CLK_Z] == 255);
+
+	splash.render(layer, hit + std::chrono::milliseconds(120));
+	CHECK(splash.activeCount() == 1);
+	CHECK(!layer.isActive(CLK_Z) && layer.alpha()[CLK_X] == 77);
+}
+
+TEST_CASE(keySplashExpiresWithoutRendering)
+{
+	const auto hit = KeySplash::Clock::now();
+	KeySplash splash(std::chrono::milliseconds(100));
+	splash.trigger(CLK_Z, hit);
+	splash.trigger(CLK_X, hit + std::chrono::milliseconds(50));
+	splash.expire(hit + std::chrono::milliseconds(99));
+	CHECK(splash.activeCount() == 2);
+	splash.expire(hit + std::chrono::milliseconds(100));
+	CHECK(splash.activeCount() == 1);
+}
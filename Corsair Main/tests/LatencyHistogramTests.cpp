@@ -0,0 +1,30 @@
+#include "TestHarness.h"
+
+#include "LatencyHistogram.h"
+
+TEST_CASE(latencyHistogramBucketsBoundRelativeError)
+{
+	for (int64_t value = 0; value < 1000000; value = value * 5 / 4 + 1) {
+		const auto bucket = LatencyHistogram::bucketOf(value);
+		CHECK(LatencyHistogram::bucketUpperBound(bucket) >= value);
+		CHECK(LatencyHistogram::bucketUpperBound(bucket) - value <= value / LatencyHistogram::cSubBuckets);
+		CHECK(bucket == 0 || LatencyHistogram::bucketUpperBound(bucket - 1) < value);
+	}
+}
+
+TEST_CASE(latencyHistogramPercentiles)
+{
+	LatencyHistogram histogram;
+	CHECK(histogram.percentile(50) == 0);
+	for (auto i = 1; i <= 100; ++i) {
+		histogram.record(i * 100);
+	}
+	CHECK(histogram.count() == 100);
+	// max() is the bound of the highest bucket in use, as close to the value as any bucket.
+	CHECK(histogram.max() >= 10000 && histogram.max() <= 10000 + 10000 / LatencyHistogram::cSubBuckets);
+	CHECK(histogram.mean() == 5050.);
+	CHECK(histogram.percentile(50) >= 5000 && histogram.percentile(50) <= 5000 + 5000 / LatencyHistogram::cSubBuckets);
+	CHECK(histogram.percentile(100) == histogram.max());
+	histogram.reset();
+	CHECK(histogram.count() == 0 && histogram.max() == 0);
+}
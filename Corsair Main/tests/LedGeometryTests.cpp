@@ -0,0 +1,72 @@
+#include "TestHarness.h"
+
+#include "LedGeometry.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	/// Two staggered rows of 18 mm keys on a 19 mm pitch: Q W E above A S.
+	std::vector<CorsairLedPosition> twoRows()
+	{
+		return {
+			{ CLK_Q, 0., 0., 18., 18. },
+			{ CLK_W, 0., 19., 18., 18. },
+			{ CLK_E, 0., 38., 18., 18. },
+			{ CLK_A, 19., 9.5, 18., 18. },
+			{ CLK_S, 19., 28.5, 18., 18. }
+		};
+	}
+}
+
+TEST_CASE(ledGeometryIndexesCentersRowsAndColumns)
+{
+	auto positions = twoRows();
+	CorsairLedPositions ledPositions{ static_cast<int>(positions.size()), positions.data() };
+	LedGeometry geometry;
+	CHECK(!geometry.load(nullptr));
+	REQUIRE(geometry.load(&ledPositions));
+
+	CHECK(geometry.count() == 5);
+	CHECK(geometry.bounds().width() == 56.f && geometry.bounds().height() == 37.f);
+	const auto s = geometry.indexOf(CLK_S);
+	REQUIRE(s == 4);
+	CHECK(geometry.indexOf(CLK_Z) == -1);
+	CHECK(geometry.centerX()[s] == 37.5f && geometry.centerY()[s] == 28.f);
+	CHECK(std::fabs(geometry.normalizedX()[s] - 37.5f / 56.f) < 1e-6f);
+
+	CHECK(geometry.rowCount() == 2);
+	CHECK(geometry.rows()[geometry.indexOf(CLK_E)] == 0 && geometry.rows()[s] == 1);
+	CHECK(geometry.columnCount() == 3);
+	CHECK(geometry.columns()[geometry.indexOf(CLK_Q)] == 0 && geometry.columns()[geometry.indexOf(CLK_A)] == 0);
+	CHECK(geometry.columns()[s] == 1 && geometry.columns()[geometry.indexOf(CLK_E)] == 2);
+}
+
+TEST_CASE(ledGeometryAnswersNeighborhoodAndPolarQueries)
+{
+	auto positions = twoRows();
+	CorsairLedPositions ledPositions{ static_cast<int>(positions.size()), positions.data() };
+	LedGeometry geometry;
+	REQUIRE(geometry.load(&ledPositions, 10.f));
+
+	// Around W: Q and E are 19 mm away, A and S about 21 mm diagonally.
+	auto found = 0;
+	geometry.forEachNear(28.f, 9.f, 15.f, [&](int) { found++; });
+	CHECK(found == 1);
+	found = 0;
+	geometry.forEachNear(28.f, 9.f, 19.5f, [&](int) { found++; });
+	CHECK(found == 3);
+	found = 0;
+	geometry.forEachNear(28.f, 9.f, 22.f, [&](int) { found++; });
+	CHECK(found == 5);
+
+	const auto origin = geometry.addOrigin(0.f, 0.f);
+	const auto e = geometry.indexOf(CLK_E);
+	const auto a = geometry.indexOf(CLK_A);
+	CHECK(std::fabs(geometry.distances(origin)[e] - std::sqrt(47.f * 47.f + 9.f * 9.f)) < 1e-3f);
+	CHECK(std::fabs(geometry.angles(origin)[e] - std::atan2(9.f, 47.f) / (2 * 3.14159265f)) < 1e-5f);
+	const auto center = geometry.addOrigin(.5f, .5f);
+	CHECK(geometry.angles(center)[a] > .25f && geometry.angles(center)[a] < .5f);
+	CHECK(geometry.maxDistance(center) > 0.f);
+}
@@ -0,0 +1,194 @@
+#include "TestHarness.h"
+
+#include "Beatmap.h"
+#include "LightingTimeline.h"
+#include "TimelineCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const uint8_t cHash[Md5::cDigestSize] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+
+	std::string fixture(const char *name)
+	{
+		return std::string(CORSAIR_FIXTURE_DIR) + "/beatmaps/" + name;
+	}
+
+	std::string output(const char *name)
+	{
+		return std::string(CORSAIR_TEST_OUTPUT_DIR) + "/" + name;
+	}
+
+	bool sameColor(const LightingColor &color, uint8_t red, uint8_t green, uint8_t blue)
+	{
+		return color.red == red && color.green == green && color.blue == blue;
+	}
+
+	/// Five keys in a row, the first at the left edge, the third in the middle.
+	std::vector<CorsairLedPosition> row()
+	{
+		return {
+			{ CLK_Q, 0., 0., 18., 18. },
+			{ CLK_W, 0., 19., 18., 18. },
+			{ CLK_E, 0., 38., 18., 18. },
+			{ CLK_R, 0., 57., 18., 18. },
+			{ CLK_T, 0., 76., 18., 18. }
+		};
+	}
+}
+
+TEST_CASE(lightingTimelineCompilesBeatsBreaksAndTriggers)
+{
+	Beatmap beatmap;
+	REQUIRE(beatmap.loadFile(fixture("standard.osu")));
+	LightingTimeline timeline;
+	CHECK(!timeline.compile(Beatmap(), cHash, LightingProfile()));
+	REQUIRE(timeline.compile(beatmap, cHash, LightingProfile()));
+	CHECK(!timeline.isMapped());
+
+	const auto &header = timeline.header();
+	CHECK(!std::memcmp(header.beatmapHash, cHash, sizeof(cHash)));
+	CHECK(header.profileHash == LightingProfile().hash());
+	CHECK(header.startTime == 1000 && header.endTime == 10250);
+	CHECK(header.maxTriggerSpan == 1050);
+
+	// Downbeat at full brightness, decaying to the floor and holding it until the off beat.
+	CHECK(sameColor(timeline.colorAt(1000), 0, 48, 255));
+	const auto fading = timeline.colorAt(1150);
+	CHECK(fading.green < 48 && fading.green > 12 && fading.blue < 255 && fading.blue > 64);
+	CHECK(sameColor(timeline.colorAt(1400), 0, 12, 64));
+	CHECK(sameColor(timeline.colorAt(1500), 0, 30, 160));
+	CHECK(sameColor(timeline.colorAt(3000), 255, 64, 0));
+	CHECK(sameColor(timeline.colorAt(7000), 8, 8, 32));
+	CHECK(sameColor(timeline.colorAt(9000), 0, 48, 255));
+	CHECK(sameColor(timeline.colorAt(10000), 255, 64, 0));
+	CHECK(sameColor(timeline.colorAt(20000), 0, 0, 0));
+	for (auto i = 1; i < timeline.keyframeCount(); ++i) {
+		CHECK(timeline.keyframes()[i - 1].time < timeline.keyframes()[i].time);
+	}
+
+	REQUIRE(timeline.triggerCount() == 8);
+	const auto &circle = timeline.triggers()[0];
+	CHECK(circle.kind == TTK_Spot && circle.position == 127 && circle.sustain == 0 && circle.fade == 250);
+	CHECK(circle.red == 255 && circle.green == 128 && circle.blue == 0);
+	CHECK(timeline.triggers()[2].sustain == 500);
+	CHECK(timeline.triggers()[4].kind == TTK_Full && timeline.triggers()[4].sustain == 800);
+}
+
+TEST_CASE(timelineCursorRendersSpotsOverTheKeyframeColor)
+{
+	Beatmap beatmap;
+	REQUIRE(beatmap.loadFile(fixture("standard.osu")));
+	LightingTimeline timeline;
+	REQUIRE(timeline.compile(beatmap, cHash, LightingProfile()));
+	auto positions = row();
+	CorsairLedPositions ledPositions{ static_cast<int>(positions.size()), positions.data() };
+	LedGeometry geometry;
+	REQUIRE(geometry.load(&ledPositions));
+
+	Framebuffer frame;
+	TimelineCursor cursor(timeline);
+	cursor.seek(1000);
+	cursor.render(frame, geometry);
+	CHECK(frame.red()[CLK_Q] == 0 && frame.green()[CLK_Q] == 48 && frame.blue()[CLK_Q] == 255);
+	CHECK(frame.red()[CLK_E] > 230 && frame.blue()[CLK_E] < 30);
+	CHECK(!frame.isActive(CLK_E));
+
+	// The spinner lights every key at full intensity while it lasts.
+	cursor.advance(4400);
+	cursor.render(frame, geometry);
+	for (const auto &position : positions) {
+		CHECK(frame.red()[position.ledId] == 255 && frame.green()[position.ledId] == 128 && frame.blue()[position.ledId] == 0);
+	}
+
+	// Moving forward gives the same window as seeking there.
+	TimelineCursor seeking(timeline);
+	for (auto time = -500; time < 11000; time += 7) {
+		cursor.advance(time);
+		seeking.seek(time);
+		CHECK(cursor.firstCandidate() == seeking.firstCandidate() && cursor.nextTrigger() == seeking.nextTrigger());
+	}
+}
+
+TEST_CASE(lightingTimelineRoundTripsThroughMappedFile)
+{
+	Beatmap beatmap;
+	REQUIRE(beatmap.loadFile(fixture("standard.osu")));
+	LightingTimeline compiled;
+	REQUIRE(compiled.compile(beatmap, cHash, LightingProfile()));
+	const auto path = output("standard.cltl");
+	REQUIRE(compiled.save(path));
+
+	LightingTimeline mapped;
+	REQUIRE(mapped.open(path));
+	CHECK(mapped.isMapped());
+	REQUIRE(mapped.size() == compiled.size());
+	CHECK(!std::memcmp(&mapped.header(), &compiled.header(), compiled.size()));
+	CHECK(sameColor(mapped.colorAt(3000), 255, 64, 0));
+
+	// Truncated files and other format versions are rejected.
+	std::vector<char> image(reinterpret_cast<const char*>(&compiled.header()), reinterpret_cast<const char*>(&compiled.header()) + compiled.size());
+	const auto broken = output("broken.cltl");
+	std::ofstream(broken, std::ios::binary).write(image.data(), image.size() - 1);
+	CHECK(!mapped.open(broken));
+	CHECK(mapped.empty());
+	image[4] = 99;
+	std::ofstream(broken, std::ios::binary).write(image.data(), image.size());
+	CHECK(!mapped.open(broken));
+	CHECK(!mapped.open(output("missing.cltl")));
+
+	// So are keyframes out of order, colorAt() divides by the time between two of them.
+	image[4] = static_cast<char>(LightingTimeline::cFormatVersion);
+	REQUIRE(compiled.keyframeCount() > 2);
+	TimelineKeyframe second;
+	std::memcpy(&second, &image[compiled.header().keyframeOffset + sizeof(TimelineKeyframe)], sizeof(second));
+	second.time = compiled.keyframes()[0].time;
+	std::memcpy(&image[compiled.header().keyframeOffset + sizeof(TimelineKeyframe)], &second, sizeof(second));
+	std::ofstream(broken, std::ios::binary).write(image.data(), image.size());
+	CHECK(!mapped.open(broken));
+	std::remove(broken.c_str());
+	std::remove(path.c_str());
+}
+
+TEST_CASE(timelineCacheCompilesOnMissAndMapsOnHit)
+{
+	TimelineCache cache(output("timeline-cache"));
+	uint8_t hash[Md5::cDigestSize];
+	{
+		std::ifstream file(fixture("standard.osu"), std::ios::binary);
+		const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		Md5::hash(text.data(), text.size(), hash);
+	}
+	std::remove(cache.pathOf(hash).c_str());
+
+	LightingProfile profile;
+	LightingTimeline timeline;
+	CHECK(!cache.open(hash, profile, timeline));
+	REQUIRE(cache.load(fixture("standard.osu"), profile, timeline));
+	CHECK(!timeline.isMapped());
+	CHECK(cache.misses() == 2 && cache.hits() == 0);
+
+	LightingTimeline cached;
+	REQUIRE(cache.load(fixture("standard.osu"), profile, cached));
+	CHECK(cached.isMapped());
+	CHECK(cache.hits() == 1);
+	CHECK(cached.size() == timeline.size());
+
+	// Another profile does not get the stale timeline.
+	profile.kiai = LightingColor{ 0, 255, 0 };
+	REQUIRE(cache.load(fixture("standard.osu"), profile, cached));
+	CHECK(!cached.isMapped());
+	CHECK(cache.misses() == 3);
+	CHECK(sameColor(cached.colorAt(3000), 0, 255, 0));
+	CHECK(cache.open(hash, profile, cached));
+
+	CHECK(!cache.load(fixture("missing.osu"), profile, cached));
+	CHECK(!cache.load(fixture("broken.osu"), profile, cached));
+	std::remove(cache.pathOf(hash).c_str());
+}
@@ -0,0 +1,48 @@
+#include "TestHarness.h"
+
+#include "Md5.h"
+
+#include <cstring>
+#include <string>
+
+namespace
+{
+	std::string hexOf(const std::string &text)
+	{
+		uint8_t digest[Md5::cDigestSize];
+		Md5::hash(text.data(), text.size(), digest);
+		return Md5::toHex(digest);
+	}
+}
+
+TEST_CASE(md5MatchesRfc1321Vectors)
+{
+	CHECK(hexOf("") == "d41d8cd98f00b204e9800998ecf8427e");
+	CHECK(hexOf("abc") == "900150983cd24fb0d6963f7d28e17f72");
+	CHECK(hexOf("message digest") == "f96b697d7cb7938d525a2f31aaf161d0");
+	CHECK(hexOf("abcdefghijklmnopqrstuvwxyz") == "c3fcd3d76192e4007dfb496cca67e13b");
+	CHECK(hexOf("12345678901234567890123456789012345678901234567890123456789012345678901234567890") == "57edf4a22be3c955ac49da2e2107b67a");
+}
+
+TEST_CASE(md5IncrementalUpdatesMatchOneShot)
+{
+	std::string text;
+	for (auto i = 0; i < 1000; ++i) {
+		text += static_cast<char>(i * 31);
+	}
+	uint8_t expected[Md5::cDigestSize];
+	Md5::hash(text.data(), text.size(), expected);
+
+	Md5 md5;
+	for (size_t offset = 0, chunk = 1; offset < text.size(); offset += chunk, chunk = chunk * 3 % 97 + 1) {
+		md5.update(text.data() + offset, std::min(chunk, text.size() - offset));
+	}
+	uint8_t digest[Md5::cDigestSize];
+	md5.finish(digest);
+	CHECK(!std::memcmp(digest, expected, Md5::cDigestSize));
+
+	// finish() resets, so the same object hashes the next input from scratch.
+	md5.update("abc", 3);
+	md5.finish(digest);
+	CHECK(Md5::toHex(digest) == "900150983cd24fb0d6963f7d28e17f72");
+}
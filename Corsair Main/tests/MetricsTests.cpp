@@ -0,0 +1,124 @@
+#include "TestHarness.h"
+
+#include "Metrics.h"
+#include "MetricsServer.h"
+
+#include <string>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	int occurrences(const std::string &text, const std::string &pattern)
+	{
+		auto count = 0;
+		for (auto position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1)) {
+			count++;
+		}
+		return count;
+	}
+
+#ifndef _WIN32
+	std::string httpGet(int port, const std::string &request)
+	{
+		const auto client = socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in address = sockaddr_in();
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(static_cast<unsigned short>(port));
+		std::string response;
+		if (!connect(client, reinterpret_cast<const sockaddr*>(&address), sizeof(address))
+			&& send(client, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size())) {
+			char buffer[4096];
+			ssize_t received;
+			while ((received = recv(client, buffer, sizeof(buffer), 0)) > 0) {
+				response.append(buffer, static_cast<size_t>(received));
+			}
+		}
+		close(client);
+		return response;
+	}
+#endif
+}
+
+TEST_CASE(metricsRegistryWritesPrometheusText)
+{
+	MetricsRegistry registry;
+	auto &frames = registry.counter("corsair_frames_rendered_total", "Frames rendered.");
+	auto &late = registry.counter("corsair_frames_dropped_total", "Frames not shown.", "reason=\"late\"");
+	auto &latency = registry.histogram("corsair_input_to_submit_seconds", "Key press to submission.");
+	auto &disconnected = registry.counter("corsair_frames_dropped_total", "Frames not shown.", "reason=\"disconnected\"");
+	CHECK(&registry.counter("corsair_frames_rendered_total", "Frames rendered.") == &frames);
+	frames.add(3);
+	late.add();
+	disconnected.add(2);
+	latency.record(5);
+	latency.record(1500);
+	latency.record(2000000);
+
+	const auto text = registry.prometheusText();
+	CHECK(text.find("# HELP corsair_frames_rendered_total Frames rendered.\n# TYPE corsair_frames_rendered_total counter\ncorsair_frames_rendered_total 3\n") != std::string::npos);
+	// Label sets of one name share their HELP and TYPE lines, whatever the order they were registered in.
+	CHECK(occurrences(text, "# TYPE corsair_frames_dropped_total counter") == 1);
+	CHECK(text.find("corsair_frames_dropped_total{reason=\"late\"} 1\ncorsair_frames_dropped_total{reason=\"disconnected\"} 2\n") != std::string::npos);
+	CHECK(text.find("# TYPE corsair_input_to_submit_seconds histogram") != std::string::npos);
+	CHECK(text.find("corsair_input_to_submit_seconds_bucket{le=\"0.000007\"} 1\n") != std::string::npos);
+	CHECK(text.find("corsair_input_to_submit_seconds_bucket{le=\"0.001023\"} 1\n") != std::string::npos);
+	CHECK(text.find("corsair_input_to_submit_seconds_bucket{le=\"0.002047\"} 2\n") != std::string::npos);
+	CHECK(text.find("corsair_input_to_submit_seconds_bucket{le=\"+Inf\"} 3\n") != std::string::npos);
+	CHECK(text.find("corsair_input_to_submit_seconds_sum 2.001505\n") != std::string::npos);
+	CHECK(text.find("corsair_input_to_submit_seconds_count 3\n") != std::string::npos);
+	// One bucket per power of two up to the range of the histogram, and +Inf.
+	CHECK(text.find("corsair_input_to_submit_seconds_bucket{le=\"0.000001\"} 0\n") != std::string::npos);
+	CHECK(occurrences(text, "corsair_input_to_submit_seconds_bucket") == LatencyHistogram::cRangeBits);
+}
+
+TEST_CASE(frameMetricsLabelEffectTimes)
+{
+	MetricsRegistry registry;
+	FrameMetrics metrics(registry);
+	auto &timeline = metrics.effect("timeline");
+	CHECK(&metrics.effect("timeline") == &timeline);
+	CHECK(&metrics.effect("key_splash") != &timeline);
+	timeline.record(120);
+	metrics.device(0, "K95 \"RGB\"").setLedsColors.record(40);
+	metrics.device(2, "VOID").setLedsColors.record(9000);
+	const auto text = registry.prometheusText();
+	CHECK(text.find("corsair_effect_duration_seconds_count{effect=\"timeline\"} 1\n") != std::string::npos);
+	CHECK(text.find("corsair_effect_duration_seconds_count{effect=\"key_splash\"} 0\n") != std::string::npos);
+	// Every device has its own latencies, a slow headset does not show in those of the keyboard.
+	CHECK(text.find("corsair_sdk_call_duration_seconds_bucket{device=\"K95 \\\"RGB\\\"\",index=\"0\",call=\"CorsairSetLedsColors\",le=\"0.000063\"} 1\n") != std::string::npos);
+	CHECK(text.find("corsair_sdk_call_duration_seconds_count{device=\"K95 \\\"RGB\\\"\",index=\"0\",call=\"CorsairSetLedsColors\"} 1\n") != std::string::npos);
+	CHECK(text.find("corsair_sdk_call_duration_seconds_bucket{device=\"VOID\",index=\"2\",call=\"CorsairSetLedsColors\",le=\"0.008191\"} 0\n") != std::string::npos);
+	CHECK(text.find("corsair_sdk_call_duration_seconds_bucket{device=\"VOID\",index=\"2\",call=\"CorsairSetLedsColors\",le=\"0.016383\"} 1\n") != std::string::npos);
+	CHECK(occurrences(text, "# TYPE corsair_sdk_call_duration_seconds histogram") == 1);
+}
+
+#ifndef _WIN32
+TEST_CASE(metricsServerAnswersScrapes)
+{
+	MetricsRegistry registry;
+	registry.counter("corsair_frames_rendered_total", "Frames rendered.").add(7);
+	MetricsServer server(registry);
+	REQUIRE(server.start(0));
+	CHECK(server.isRunning());
+	REQUIRE(server.port() > 0);
+
+	const auto response = httpGet(server.port(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	CHECK(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+	CHECK(response.find("Content-Type: text/plain; version=0.0.4") != std::string::npos);
+	CHECK(response.find("\r\n\r\n" + registry.prometheusText()) != std::string::npos);
+	CHECK(httpGet(server.port(), "GET /other HTTP/1.1\r\n\r\n").compare(0, 12, "HTTP/1.1 404") == 0);
+	CHECK(httpGet(server.port(), "POST /metrics HTTP/1.1\r\n\r\n").compare(0, 12, "HTTP/1.1 405") == 0);
+	CHECK(server.requests() == 3);
+
+	server.stop();
+	CHECK(!server.isRunning());
+	CHECK(server.port() == 0);
+}
+#endif
@@ -0,0 +1,102 @@
+#include "TestHarness.h"
+
+#include "Beatmap.h"
+#include "FrameTrace.h"
+#include "LightingTimeline.h"
+#include "OfflineRenderer.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	const uint8_t cHash[Md5::cDigestSize] = {};
+
+	std::vector<CorsairLedPosition> row()
+	{
+		return {
+			{ CLK_Q, 0., 0., 18., 18. },
+			{ CLK_W, 0., 19., 18., 18. },
+			{ CLK_E, 0., 38., 18., 18. },
+			{ CLK_R, 0., 57., 18., 18. },
+			{ CLK_T, 0., 76., 18., 18. }
+		};
+	}
+
+	bool sameLeds(const Framebuffer &a, const Framebuffer &b)
+	{
+		auto same = a.activeCount() == b.activeCount();
+		a.forEachActive([&](CorsairLedId ledId) {
+			same = same && b.isActive(ledId) && a.red()[ledId] == b.red()[ledId] && a.green()[ledId] == b.green()[ledId] && a.blue()[ledId] == b.blue()[ledId];
+		});
+		return same;
+	}
+}
+
+TEST_CASE(offlineRendererMatchesSequentialRender)
+{
+	Beatmap beatmap;
+	REQUIRE(beatmap.loadFile(std::string(CORSAIR_FIXTURE_DIR) + "/beatmaps/standard.osu"));
+	LightingTimeline timeline;
+	REQUIRE(timeline.compile(beatmap, cHash, LightingProfile()));
+	auto positions = row();
+	CorsairLedPositions ledPositions{ static_cast<int>(positions.size()), positions.data() };
+	LedGeometry geometry;
+	REQUIRE(geometry.load(&ledPositions));
+
+	// Hits splashing across chunk boundaries, the last one outlasting the timeline.
+	OfflineRenderer renderer(timeline, geometry);
+	std::vector<OfflineHit> hits;
+	for (auto time = 900; time < 10400; time += 37) {
+		hits.push_back(OfflineHit{ time, time % 2 ? CLK_W : CLK_Z });
+	}
+	renderer.setHits(hits);
+	const auto frames = renderer.frameCount(120);
+	CHECK(frames == (hits.back().time + 301) * 120 / 1000 + 1);
+
+	ThreadPool sequential(1);
+	renderer.setChunkFrames(1 << 20);
+	const auto expectedPath = std::string(CORSAIR_TEST_OUTPUT_DIR) + "/offline_sequential.trace";
+	REQUIRE(renderer.render(120, sequential, expectedPath));
+	CHECK(renderer.stats().frames == frames && renderer.stats().chunks == 1);
+
+	ThreadPool pool(3);
+	renderer.setChunkFrames(7);
+	const auto path = std::string(CORSAIR_TEST_OUTPUT_DIR) + "/offline.trace";
+	REQUIRE(renderer.render(120, pool, path));
+	CHECK(renderer.stats().chunks == static_cast<int>((frames + 6) / 7) && renderer.stats().threads == 3);
+
+	// Chunks start with keyframes, otherwise the frames are the same.
+	FrameTraceReader expected;
+	FrameTraceReader trace;
+	REQUIRE(expected.open(expectedPath) && trace.open(path));
+	CHECK(trace.version() == FrameTraceWriter::cVersion);
+	auto same = true;
+	while (expected.next()) {
+		same = same && trace.next() && trace.timestampNs() == expected.timestampNs() && sameLeds(trace.frame(), expected.frame());
+		same = same && trace.isKeyframe() == (trace.frameIndex() % 7 == 0);
+	}
+	CHECK(same && !trace.next() && !trace.failed() && !expected.failed());
+	CHECK(expected.frameIndex() + 1 == frames);
+
+	// Frame 3 is at 25 ms of virtual time; the splashed Z is lit besides the row.
+	expected.rewind();
+	for (auto frame = 0; frame <= 3; ++frame) {
+		expected.next();
+	}
+	CHECK(expected.timestampNs() == 25000000);
+	CHECK(expected.frame().activeCount() == 6 && expected.frame().isActive(CLK_Z));
+
+	std::vector<std::vector<uint8_t>> chunks;
+	REQUIRE(renderer.render(120, pool, chunks));
+	CHECK(static_cast<int>(chunks.size()) == renderer.stats().chunks);
+
+	const LightingTimeline none;
+	OfflineRenderer empty(none, geometry);
+	CHECK(empty.frameCount(120) == 0);
+	CHECK(!empty.render(120, pool, chunks));
+	CHECK(empty.lastError() == ORE_NothingToRender);
+	CHECK(renderer.lastError() == ORE_Success);
+	CHECK(!renderer.render(120, pool, std::string(CORSAIR_TEST_OUTPUT_DIR) + "/missing/offline.trace"));
+	CHECK(renderer.lastError() == ORE_CannotCreateTrace);
+}
@@ -0,0 +1,73 @@
+#include "TestHarness.h"
+
+#include "Profiler.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+	int occurrences(const std::string &text, const std::string &pattern)
+	{
+		auto count = 0;
+		for (auto position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1)) {
+			count++;
+		}
+		return count;
+	}
+}
+
+TEST_CASE(profilerWritesChromeTraceEventsPerThread)
+{
+	Profiler::reset();
+	Profiler::setThreadName("test \"main\"");
+	{
+		ProfileScope scope("frame");
+		Profiler::instant("key_press");
+	}
+	const auto start = Profiler::Clock::now();
+	Profiler::record("async_ack", start, start + std::chrono::microseconds(1500));
+	std::thread([] {
+		Profiler::setThreadName("worker");
+		ProfileScope scope("render");
+	}).join();
+	CHECK(Profiler::eventCount() == 4);
+
+	std::ostringstream stream;
+	Profiler::writeChromeTrace(stream);
+	const auto trace = stream.str();
+	CHECK(trace.compare(0, 2, "{\"") == 0);
+	CHECK(trace.find("\n]}") != std::string::npos);
+	CHECK(trace.find("\"args\":{\"name\":\"test \\\"main\\\"\"}") != std::string::npos);
+	CHECK(trace.find("\"args\":{\"name\":\"worker\"}") != std::string::npos);
+	CHECK(occurrences(trace, "\"ph\":\"X\"") == 3);
+	CHECK(occurrences(trace, "\"ph\":\"i\",\"s\":\"t\"") == 1);
+	CHECK(trace.find("\"name\":\"async_ack\"") != std::string::npos);
+	CHECK(trace.find("\"dur\":1500.000}") != std::string::npos);
+	CHECK(trace.find("\"name\":\"render\"") != std::string::npos);
+
+	// The key press happened inside the frame, so it is recorded first and closes before it.
+	CHECK(trace.find("\"name\":\"key_press\"") < trace.find("\"name\":\"frame\""));
+	Profiler::reset();
+	CHECK(Profiler::eventCount() == 0);
+}
+
+TEST_CASE(profilerKeepsTheLatestEventsOfEveryThread)
+{
+	Profiler::reset();
+	std::thread([] {
+		for (auto i = 0; i < Profiler::cThreadCapacity + 10; ++i) {
+			Profiler::instant(i < 11 ? "old" : "new");
+		}
+	}).join();
+	CHECK(Profiler::eventCount() == Profiler::cThreadCapacity - 1);
+	CHECK(Profiler::overwrittenEvents() == 11);
+
+	std::ostringstream stream;
+	Profiler::writeChromeTrace(stream);
+	CHECK(stream.str().find("\"old\"") == std::string::npos);
+	CHECK(occurrences(stream.str(), "\"new\"") == Profiler::cThreadCapacity - 1);
+	Profiler::reset();
+	CHECK(Profiler::overwrittenEvents() == 0);
+}
@@ -0,0 +1,89 @@
+#include "TestHarness.h"
+
+#include "RainbowEffect.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+	const double cPi = 3.14159265358979323846;
+
+	/// Three rows of four 18 mm keys on a 19 mm pitch.
+	std::vector<CorsairLedPosition> grid()
+	{
+		std::vector<CorsairLedPosition> positions;
+		const CorsairLedId leds[] = { CLK_1, CLK_2, CLK_3, CLK_4, CLK_Q, CLK_W, CLK_E, CLK_R, CLK_A, CLK_S, CLK_D, CLK_F };
+		for (auto i = 0; i < 12; ++i) {
+			positions.push_back(CorsairLedPosition{ leds[i], 19. * (i / 4), 19. * (i % 4), 18., 18. });
+		}
+		return positions;
+	}
+
+	/// hueColor() of the CUELFX stand-in.
+	int expectedChannel(double hue, int shift)
+	{
+		hue -= std::floor(hue);
+		const auto k = std::fmod(hue * 6 + shift, 6.);
+		return static_cast<int>((1 - std::min(std::max(std::min(k, 4 - k), 0.), 1.)) * 255 + .5);
+	}
+
+	/// Largest channel difference between frame and the hue given for every LED of the geometry.
+	template <typename Hue>
+	int maxError(const LedGeometry &geometry, const Framebuffer &frame, Hue hueOf)
+	{
+		auto error = 0;
+		for (auto i = 0; i < geometry.count(); ++i) {
+			const auto ledId = geometry.ledIds()[i];
+			const auto hue = hueOf(geometry.normalizedX()[i], geometry.normalizedY()[i]);
+			error = std::max({ error, std::abs(frame.red()[ledId] - expectedChannel(hue, 5)), std::abs(frame.green()[ledId] - expectedChannel(hue, 3)),
+				std::abs(frame.blue()[ledId] - expectedChannel(hue, 1)) });
+		}
+		return error;
+	}
+}
+
+TEST_CASE(rainbowSpiralTurnsAroundTheCenter)
+{
+	auto positions = grid();
+	CorsairLedPositions ledPositions{ static_cast<int>(positions.size()), positions.data() };
+	LedGeometry geometry;
+	REQUIRE(geometry.load(&ledPositions));
+
+	const auto counterClockwise = RainbowEffect::spiral(geometry, CLES_Medium, CLECD_CounterClockwise);
+	const auto clockwise = RainbowEffect::spiral(geometry, CLES_Fast, CLECD_Clockwise);
+	CHECK(counterClockwise.count() == 12 && RainbowEffect::cycleDuration(CLES_Slow) == 6000);
+	Framebuffer frame;
+	for (const auto offset : { 0, 750, 2999, 4100 }) {
+		counterClockwise.render(offset, frame);
+		CHECK(frame.activeCount() == 12);
+		CHECK(maxError(geometry, frame, [offset](double x, double y) { return std::atan2(y - .5, x - .5) / (2 * cPi) + offset / 3000.; }) <= 2);
+		clockwise.render(offset, frame);
+		CHECK(maxError(geometry, frame, [offset](double x, double y) { return std::atan2(y - .5, x - .5) / (2 * cPi) - offset / 1500.; }) <= 2);
+	}
+}
+
+TEST_CASE(rainbowWaveTravelsAlongItsDirection)
+{
+	auto positions = grid();
+	CorsairLedPositions ledPositions{ static_cast<int>(positions.size()), positions.data() };
+	LedGeometry geometry;
+	REQUIRE(geometry.load(&ledPositions));
+
+	auto right = RainbowEffect::wave(geometry, CLES_Slow, CLELD_Right, Compositor::Isa::Scalar);
+	const auto up = RainbowEffect::wave(geometry, CLES_Slow, CLELD_Up);
+	CHECK(right.isa() == Compositor::Isa::Scalar);
+	Framebuffer frame;
+	for (const auto offset : { 0, 1000, 5999, 7000 }) {
+		right.render(offset, frame);
+		CHECK(maxError(geometry, frame, [offset](double x, double) { return offset / 6000. - x; }) <= 2);
+		up.render(offset, frame);
+		CHECK(maxError(geometry, frame, [offset](double, double y) { return offset / 6000. - (1 - y); }) <= 2);
+	}
+
+	right.setValue(0);
+	right.render(1000, frame);
+	CHECK(frame.red()[CLK_1] == 0 && frame.green()[CLK_F] == 0 && frame.blue()[CLK_S] == 0);
+}
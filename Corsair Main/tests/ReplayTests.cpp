@@ -0,0 +1,115 @@
+#include "TestHarness.h"
+
+#include "Lzma.h"
+#include "Replay.h"
+
+#include "windows.h"
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::string fixture(const char *name)
+	{
+		return std::string(CORSAIR_FIXTURE_DIR) + "/replays/" + name;
+	}
+
+	int64_t millisecondsAfter(InputThread::Clock::time_point start, const KeyEvent &event)
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(event.timestamp - start).count();
+	}
+
+	/// "hello hello hello hello, lighting lighting lighting!" as written by xz's LZMA alone encoder, size unknown.
+	const uint8_t cHello[] = {
+		0x5d, 0x00, 0x00, 0x80, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x34, 0x19,
+		0x49, 0xee, 0x8d, 0xe9, 0x56, 0x0a, 0xe7, 0x79, 0x9a, 0x16, 0x29, 0x03, 0x0b, 0x10, 0x5a, 0xd6,
+		0x3c, 0x4c, 0x39, 0x73, 0x43, 0x66, 0x7b, 0xff, 0xff, 0xb1, 0x1a, 0x00, 0x00
+	};
+}
+
+TEST_CASE(lzmaDecompressesAloneStreams)
+{
+	std::vector<uint8_t> output;
+	REQUIRE(lzma::decompress(cHello, sizeof(cHello), output));
+	CHECK(std::string(output.begin(), output.end()) == "hello hello hello hello, lighting lighting lighting!");
+
+	CHECK(!lzma::decompress(cHello, sizeof(cHello) - 6, output));
+	CHECK(!lzma::decompress(cHello, 12, output));
+	auto badProperties = std::vector<uint8_t>(cHello, cHello + sizeof(cHello));
+	badProperties[0] = 225;
+	CHECK(!lzma::decompress(badProperties.data(), badProperties.size(), output));
+}
+
+TEST_CASE(replayDecodesHeaderAndFrames)
+{
+	Replay replay;
+	CHECK(!replay.loadFile(fixture("missing.osr")));
+	REQUIRE(replay.loadFile(fixture("stream.osr")));
+
+	CHECK(replay.mode() == 0 && replay.gameVersion() == 20230326);
+	CHECK(replay.beatmapHash() == "6c3516f26f2bc13d54db4017cdf4ea85");
+	CHECK(replay.playerName() == "Corsair");
+	CHECK(replay.count300() == 400 && replay.count100() == 1 && replay.countGeki() == 40 && replay.countMiss() == 0);
+	CHECK(replay.score() == 1234567 && replay.maxCombo() == 401 && !replay.perfect());
+	CHECK(replay.onlineScoreId() == 4242424242LL);
+	CHECK(replay.seed() == 1337);
+
+	// The two leading (256, -500) frames and the seed frame are not input.
+	const auto &frames = replay.frames();
+	REQUIRE(frames.size() == 901);
+	CHECK(frames.front().time == 16 && frames.back().time == 11600);
+	CHECK(frames.back().keys == 0);
+
+	// A 300 BPM stream alternating K1 and K2, then a click with the mouse alone.
+	const auto start = InputThread::Clock::now();
+	const auto events = replay.keyEvents(start);
+	REQUIRE(events.size() == 402);
+	CHECK(events[0].virtualKey == 'Z' && events[0].pressed && millisecondsAfter(start, events[0]) == 1000);
+	CHECK(events[1].virtualKey == 'Z' && !events[1].pressed && millisecondsAfter(start, events[1]) == 1030);
+	CHECK(events[2].virtualKey == 'X' && events[2].pressed && millisecondsAfter(start, events[2]) == 1050);
+	CHECK(events[400].virtualKey == VK_LBUTTON && events[400].pressed && millisecondsAfter(start, events[400]) == 11500);
+	CHECK(events[401].virtualKey == VK_LBUTTON && !events[401].pressed);
+}
+
+TEST_CASE(replayMapsManiaColumnsToKeys)
+{
+	Replay replay;
+	REQUIRE(replay.loadFile(fixture("mania.osr")));
+	CHECK(replay.mode() == 3 && replay.seed() == 7);
+	REQUIRE(replay.frames().size() == 7);
+	CHECK(replay.frames()[2].keys == 6);
+
+	const auto start = InputThread::Clock::now();
+	CHECK(replay.keyEvents(start).empty());
+	const auto events = replay.keyEvents(start, { 'D', 'F', 'J', 'K' });
+	REQUIRE(events.size() == 8);
+	CHECK(events[0].virtualKey == 'D' && events[0].pressed);
+	CHECK(events[2].virtualKey == 'F' && events[3].virtualKey == 'J' && millisecondsAfter(start, events[3]) == 1200);
+	CHECK(events[4].virtualKey == 'J' && !events[4].pressed && millisecondsAfter(start, events[4]) == 1300);
+	CHECK(events[7].virtualKey == 'K' && !events[7].pressed);
+
+	// Without keys of its own a mania replay is played with osu!'s defaults for the map's columns.
+	CHECK(Replay::maniaKeys(4) == std::vector<int>({ 'D', 'F', 'J', 'K' }));
+	CHECK(Replay::maniaKeys(7) == std::vector<int>({ 'S', 'D', 'F', VK_SPACE, 'J', 'K', 'L' }));
+	CHECK(Replay::maniaKeys(9).back() == VK_OEM_1);
+	CHECK(Replay::maniaKeys(0).empty() && Replay::maniaKeys(10).empty());
+}
+
+TEST_CASE(replayRejectsTruncatedFiles)
+{
+	Replay replay;
+	REQUIRE(replay.loadFile(fixture("stream.osr")));
+	std::vector<uint8_t> bytes;
+	{
+		std::ifstream file(fixture("stream.osr"), std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	CHECK(!replay.parse(bytes.data(), 30));
+	CHECK(replay.frames().empty());
+	CHECK(!replay.parse(bytes.data(), bytes.size() - 200));
+	bytes[0] = 9;
+	CHECK(!replay.parse(bytes.data(), bytes.size()));
+}
@@ -0,0 +1,53 @@
+#include "TestHarness.h"
+
+#include "SpscRing.h"
+
+#include <cstdint>
+#include <thread>
+
+TEST_CASE(spscRingKeepsOrderAndRejectsWhenFull)
+{
+	SpscRing<int, 4> ring;
+	for (auto i = 0; i < 4; ++i) {
+		CHECK(ring.tryPush(i));
+	}
+	CHECK(!ring.tryPush(4));
+	CHECK(ring.size() == 4);
+
+	int value = -1;
+	REQUIRE(ring.tryPop(value));
+	CHECK(value == 0);
+	CHECK(ring.tryPush(4));
+	for (auto expected = 1; expected <= 4; ++expected) {
+		REQUIRE(ring.tryPop(value));
+		CHECK(value == expected);
+	}
+	CHECK(!ring.tryPop(value));
+}
+
+TEST_CASE(spscRingHandsOverAcrossThreads)
+{
+	const int64_t count = 200000;
+	SpscRing<int64_t, 64> ring;
+	std::thread producer([&] {
+		for (int64_t i = 0; i < count; ++i) {
+			while (!ring.tryPush(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	int64_t expected = 0;
+	auto ordered = true;
+	while (expected < count) {
+		int64_t value;
+		if (!ring.tryPop(value)) {
+			std::this_thread::yield();
+			continue;
+		}
+		ordered = ordered && value == expected;
+		expected++;
+	}
+	producer.join();
+	CHECK(ordered);
+}
@@ -0,0 +1,73 @@
+#include "TestHarness.h"
+
+#include "CUESDK.h"
+#include "CUESDKStandIn.h"
+
+TEST_CASE(standInRecordsFrames)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	REQUIRE(CorsairGetLastError() == CE_Success);
+	CHECK(CorsairGetDeviceCount() == 4);
+
+	CorsairLedColor colors[] = { { CLK_A, 255, 0, 0 }, { CLK_B, 0, 255, 0 } };
+	CHECK(CorsairSetLedsColors(2, colors));
+	REQUIRE(CorsairStandInGetRecordedFrameCount() == 1);
+
+	CorsairStandInFrame frame;
+	REQUIRE(CorsairStandInGetRecordedFrame(0, &frame));
+	CHECK(frame.size == 2 && !frame.async);
+	CHECK(CorsairStandInGetLedColor(CLK_B).g == 255);
+}
+
+TEST_CASE(standInInjectsErrors)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	CorsairLedColor color = { CLK_Escape, 1, 2, 3 };
+
+	CorsairStandInRevokeControl();
+	CHECK(!CorsairSetLedsColors(1, &color));
+	CHECK(CorsairGetLastError() == CE_NoControl);
+	CHECK(CorsairRequestControl(CAM_ExclusiveLightingControl));
+
+	CorsairStandInSetServerAvailable(0);
+	CHECK(!CorsairSetLedsColors(1, &color));
+	CHECK(CorsairGetLastError() == CE_ServerNotFound);
+	CHECK(!CorsairSetLedsColorsAsync(1, &color, nullptr, nullptr));
+	CHECK(CorsairGetLastError() == CE_ServerNotFound);
+	CorsairStandInSetServerAvailable(1);
+	CHECK(!CorsairSetLedsColors(1, &color));
+	CHECK(CorsairGetLastError() == CE_ProtocolHandshakeMissing);
+	CHECK(!CorsairSetLedsColorsAsync(1, &color, nullptr, nullptr));
+	CHECK(CorsairGetLastError() == CE_ProtocolHandshakeMissing);
+	CorsairPerformProtocolHandshake();
+	CHECK(CorsairSetLedsColors(1, &color));
+}
+
+namespace
+{
+	void countCallback(void *context, bool result, CorsairError /*error*/)
+	{
+		if (result) {
+			++*static_cast<int*>(context);
+		}
+	}
+}
+
+TEST_CASE(standInRunsAsyncSubmissionsInOrder)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	CorsairStandInSetLatency(200, 100);
+
+	auto completed = 0;
+	for (auto i = 0; i < 5; ++i) {
+		CorsairLedColor color = { CLK_Escape, i, 0, 0 };
+		CHECK(CorsairSetLedsColorsAsync(1, &color, &countCallback, &completed));
+	}
+	CorsairStandInWaitForIdle();
+	CHECK(completed == 5);
+	CHECK(CorsairStandInGetLedColor(CLK_Escape).r == 4);
+	CHECK(CorsairStandInGetTotalFrameCount() == 5);
+}
@@ -0,0 +1,93 @@
+#include "TestHarness.h"
+
+#include "CUESDK.h"
+#include "CUESDKStandIn.h"
+#include "SubmitPipeline.h"
+
+#include <chrono>
+
+TEST_CASE(submitPipelineCoalescesWhileSlotsAreBusy)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	CorsairStandInSetLatency(20000, 0);
+
+	SubmitPipeline pipeline(1);
+	CorsairLedColor color{ CLK_A, 0, 0, 0 };
+	for (auto i = 1; i <= 5; ++i) {
+		color.r = i;
+		REQUIRE(pipeline.submit(1, &color));
+	}
+	CorsairLedColor other{ CLK_B, 7, 7, 7 };
+	REQUIRE(pipeline.submit(1, &other));
+	CHECK(pipeline.inFlight() == 1);
+	CHECK(pipeline.hasPending());
+
+	REQUIRE(pipeline.waitIdle(std::chrono::milliseconds(2000)));
+	CorsairStandInWaitForIdle();
+	CorsairStandInSetLatency(0, 0);
+
+	const auto stats = pipeline.stats();
+	CHECK(stats.frames == 6);
+	CHECK(stats.sentFrames == 2);
+	CHECK(stats.coalescedFrames == 4);
+	CHECK(stats.completedFrames == 2);
+	CHECK(stats.failedSubmissions == 0);
+	CHECK(CorsairStandInGetLedColor(CLK_A).r == 5);
+	CHECK(CorsairStandInGetLedColor(CLK_B).g == 7);
+
+	CHECK(pipeline.sendToAckLatency().count() == 2);
+	CHECK(pipeline.sendToAckLatency().percentile(50) >= 20000 * 7 / 8);
+	CHECK(pipeline.submitToAckLatency().max() >= pipeline.sendToAckLatency().max());
+}
+
+TEST_CASE(submitPipelineReportsFailures)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+
+	auto failures = 0;
+	SubmitPipeline pipeline;
+	pipeline.setCompletionHandler([](void *context, int, const CorsairLedColor*, bool result, bool) { *static_cast<int*>(context) += !result; }, &failures);
+
+	CorsairStandInRevokeControl();
+	CorsairLedColor color{ CLK_A, 1, 2, 3 };
+	pipeline.submit(1, &color);
+	REQUIRE(pipeline.waitIdle(std::chrono::milliseconds(2000)));
+	CHECK(failures == 1);
+	CHECK(pipeline.stats().failedSubmissions == 1);
+
+	// A frame left to a connection given up on is still reported, but not counted against the new one.
+	CorsairStandInSetLatency(20000, 0);
+	REQUIRE(pipeline.submit(1, &color));
+	pipeline.newConnection();
+	REQUIRE(pipeline.waitIdle(std::chrono::milliseconds(2000)));
+	CHECK(failures == 2);
+	CHECK(pipeline.stats().failedSubmissions == 1 && pipeline.stats().staleFailures == 1);
+	CorsairStandInSetLatency(0, 0);
+	CorsairRequestControl(CAM_ExclusiveLightingControl);
+}
+
+TEST_CASE(submitPipelineLeavesInFlightFramesToTheCallbacks)
+{
+	CorsairStandInReset(1);
+	CorsairPerformProtocolHandshake();
+	CorsairStandInSetLatency(50000, 0);
+
+	auto failures = 0;
+	const auto start = std::chrono::steady_clock::now();
+	{
+		SubmitPipeline pipeline(2);
+		pipeline.setCompletionHandler([](void *context, int, const CorsairLedColor*, bool result, bool) { *static_cast<int*>(context) += !result; }, &failures);
+		CorsairLedColor color{ CLK_A, 9, 0, 0 };
+		REQUIRE(pipeline.submit(1, &color));
+		CHECK(pipeline.inFlight() == 1);
+		CorsairStandInRevokeControl();
+	}
+	// Destroyed without waiting for the acknowledgement, which arrives afterwards and frees the slot.
+	CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(50));
+	CorsairStandInWaitForIdle();
+	CorsairStandInSetLatency(0, 0);
+	CorsairRequestControl(CAM_ExclusiveLightingControl);
+	CHECK(failures == 0);
+}
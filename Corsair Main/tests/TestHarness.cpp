@@ -0,0 +1,54 @@
+#include "TestHarness.h"
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	struct TestCase
+	{
+		const char *name;
+		TestFunction function;
+	};
+
+	std::vector<TestCase>& testCases()
+	{
+		static std::vector<TestCase> cases;
+		return cases;
+	}
+
+	int gFailures = 0;
+}
+
+TestRegistration::TestRegistration(const char *name, TestFunction function)
+{
+	testCases().push_back(TestCase{ name, function });
+}
+
+void reportFailure(const char *file, int line, const std::string &expression)
+{
+	std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+	gFailures++;
+}
+
+int runTests(const std::string &filter)
+{
+	auto failedCases = 0;
+	auto run = 0;
+	for (const auto &testCase : testCases()) {
+		if (std::string(testCase.name).find(filter) == std::string::npos) {
+			continue;
+		}
+		const auto failuresBefore = gFailures;
+		testCase.function();
+		run++;
+		if (gFailures != failuresBefore) {
+			std::cerr << "FAILED " << testCase.name << std::endl;
+			failedCases++;
+		} else {
+			std::cout << "passed " << testCase.name << std::endl;
+		}
+	}
+	std::cout << run - failedCases << "/" << run << " test cases passed" << std::endl;
+	return failedCases;
+}
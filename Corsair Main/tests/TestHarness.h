@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+/**
+ * @brief Minimal self-registering test cases.
+ *
+ * TEST_CASE(name) defines a test that is run by corsair_tests. CHECK() records a failure and
+ * continues, REQUIRE() records a failure and leaves the test case.
+ */
+using TestFunction = void (*)();
+
+struct TestRegistration
+{
+	TestRegistration(const char *name, TestFunction function);
+};
+
+void reportFailure(const char *file, int line, const std::string &expression);
+
+/// Runs every test case whose name contains filter. Returns number of failed test cases.
+int runTests(const std::string &filter);
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static const TestRegistration name##Registration(#name, &name); \
+	static void name()
+
+#define CHECK(expression) \
+	do { \
+		if (!(expression)) { \
+			reportFailure(__FILE__, __LINE__, #expression); \
+		} \
+	} while (false)
+
+#define REQUIRE(expression) \
+	do { \
+		if (!(expression)) { \
+			reportFailure(__FILE__, __LINE__, #expression); \
+			return; \
+		} \
+	} while (false)
@@ -0,0 +1,32 @@
+#include "TestHarness.h"
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <vector>
+
+TEST_CASE(threadPoolRunsEveryIndexOnce)
+{
+	ThreadPool pool(4);
+	CHECK(pool.threadCount() == 4);
+	CHECK(ThreadPool().threadCount() >= 1);
+
+	// Jobs back to back reuse the same workers.
+	for (auto job = 0; job < 50; ++job) {
+		std::vector<std::atomic<int>> runs(97);
+		for (auto &count : runs) {
+			count = 0;
+		}
+		pool.run(static_cast<int>(runs.size()), [&](int index) { ++runs[index]; });
+		auto once = true;
+		for (const auto &count : runs) {
+			once = once && count == 1;
+		}
+		CHECK(once);
+	}
+
+	auto calls = 0;
+	pool.run(0, [&](int) { ++calls; });
+	ThreadPool(1).run(3, [&](int) { ++calls; });
+	CHECK(calls == 3);
+}
@@ -0,0 +1,6 @@
+#include "TestHarness.h"
+
+int main(int argc, char *argv[])
+{
+	return runTests(argc > 1 ? argv[1] : "") ? 1 : 0;
+}
@@ -0,0 +1,108 @@
+#include "Beatmap.h"
+#include "CUESDK.h"
+#include "KeyLayoutTable.h"
+#include "LedGeometry.h"
+#include "LightingTimeline.h"
+#include "MappedImage.h"
+#include "OfflineRenderer.h"
+#include "Replay.h"
+#include "ThreadPool.h"
+#include "TimelineCache.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Renders the lighting of a whole beatmap into a frame trace, faster than real time:
+ *
+ *   corsair_render <beatmap.osu> <output.trace> [replay.osr] [frame rate] [threads]
+ *
+ * Key splashes are driven by the replay when one is given. The frame rate defaults to 120, the
+ * threads to one per hardware thread. Only the LED positions are read from the SDK; nothing is lit.
+ */
+
+namespace
+{
+	/// Presses of keys the replay was played with splash their LEDs, as in the app.
+	std::vector<OfflineHit> replayHits(const Replay &replay, const std::vector<int> &maniaKeys, const KeyLayoutTable &keyLayout)
+	{
+		const InputThread::Clock::time_point start;
+		std::vector<OfflineHit> hits;
+		for (const auto &event : replay.keyEvents(start, maniaKeys)) {
+			const auto ledId = keyLayout.ledOfVirtualKey(event.virtualKey);
+			if (event.pressed && ledId != CLI_Invalid) {
+				const auto time = std::chrono::duration_cast<std::chrono::milliseconds>(event.timestamp - start).count();
+				hits.push_back(OfflineHit{ static_cast<int>(time), ledId });
+			}
+		}
+		return hits;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3) {
+		std::cerr << "Usage: corsair_render <beatmap.osu> <output.trace> [replay.osr] [frame rate] [threads]" << std::endl;
+		return 1;
+	}
+	const auto frameRate = argc > 4 ? std::atoi(argv[4]) : 120;
+	const auto threads = argc > 5 ? std::atoi(argv[5]) : 0;
+	if (frameRate <= 0) {
+		std::cerr << "Invalid frame rate " << argv[4] << std::endl;
+		return 1;
+	}
+
+	CorsairPerformProtocolHandshake();
+	LedGeometry geometry;
+	if (CorsairGetLastError() || !geometry.loadFromSdk()) {
+		std::cerr << "Cannot read LED positions" << std::endl;
+		return 1;
+	}
+
+	const auto cacheDirectory = std::getenv("CORSAIR_TIMELINE_CACHE");
+	TimelineCache cache(cacheDirectory ? cacheDirectory : MappedImage::userCacheDirectory("TimelineCache"));
+	LightingTimeline timeline;
+	if (!cache.load(argv[1], LightingProfile(), timeline)) {
+		return 1;
+	}
+
+	OfflineRenderer renderer(timeline, geometry);
+	if (argc > 3) {
+		Replay replay;
+		if (!replay.loadFile(argv[3])) {
+			std::cerr << "Cannot read replay " << argv[3] << std::endl;
+			return 1;
+		}
+		if (replay.beatmapHash() != Md5::toHex(timeline.header().beatmapHash)) {
+			std::cerr << "Replay was played on another beatmap" << std::endl;
+		}
+		std::vector<int> maniaKeys;
+		Beatmap beatmap;
+		if (replay.mode() == Replay::cManiaMode && beatmap.loadFile(argv[1])) {
+			maniaKeys = Replay::maniaKeys(static_cast<int>(beatmap.circleSize()));
+		}
+		KeyLayoutTable keyLayout;
+		if (!keyLayout.updateFromSdk()) {
+			std::cerr << "Cannot resolve the hit keys, rendering without key splashes" << std::endl;
+		}
+		renderer.setHits(replayHits(replay, maniaKeys, keyLayout));
+	}
+
+	ThreadPool pool(threads);
+	if (!renderer.render(frameRate, pool, argv[2])) {
+		std::cerr << OfflineRenderer::errorText(renderer.lastError());
+		if (renderer.lastError() != ORE_NothingToRender) {
+			std::cerr << ' ' << argv[2];
+		}
+		std::cerr << std::endl;
+		return 1;
+	}
+	const auto &stats = renderer.stats();
+	std::cout << "Rendered " << stats.frames << " frames at " << frameRate << " Hz in " << stats.seconds * 1000. << " ms ("
+		<< stats.chunks << " chunks on " << stats.threads << " threads, " << stats.frames / stats.seconds << " frames/s), "
+		<< stats.traceBytes << " bytes written to " << argv[2] << std::endl;
+	return 0;
+}
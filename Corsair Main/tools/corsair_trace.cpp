@@ -0,0 +1,257 @@
+#include "CUESDK.h"
+#include "DeltaOutput.h"
+#include "FrameTrace.h"
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+/*
+ * Works with frame traces as recorded by corsair_main (CORSAIR_TRACE), corsair_render or the CUE SDK
+ * stand-in:
+ *
+ *   corsair_trace stats <trace>                     frame rate, frame interval jitter and LEDs changed per frame
+ *   corsair_trace replay <trace> [speed]            plays the trace on the devices at its original timing
+ *   corsair_trace diff <trace> <trace> [tolerance]  compares colors frame by frame, exits with 1 if they differ
+ *   corsair_trace convert <trace> <output>          rewrites a trace (e.g. a stand-in one) in the compact format
+ */
+
+namespace
+{
+	bool openTrace(FrameTraceReader &reader, const char *path)
+	{
+		if (!reader.open(path)) {
+			std::cerr << "Cannot read trace " << path << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	/// Reports a trace that ended in the middle of a frame. Returns false if it did.
+	bool checkComplete(const FrameTraceReader &reader, const char *path)
+	{
+		if (reader.failed()) {
+			std::cerr << path << " is truncated or damaged after frame " << reader.frameIndex() << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	int stats(const char *path)
+	{
+		FrameTraceReader reader;
+		if (!openTrace(reader, path)) {
+			return 2;
+		}
+		int64_t frames = 0;
+		int64_t keyframes = 0;
+		int64_t asyncFrames = 0;
+		int64_t unchangedFrames = 0;
+		int64_t changedLeds = 0;
+		auto maxChangedLeds = 0;
+		int64_t firstNs = 0;
+		int64_t previousNs = 0;
+		double intervalSum = 0.;
+		double intervalSquares = 0.;
+		auto minIntervalNs = INT64_MAX;
+		int64_t maxIntervalNs = 0;
+		LatencyHistogram intervals;
+		while (reader.next()) {
+			const auto timestampNs = reader.timestampNs();
+			if (frames) {
+				const auto interval = timestampNs - previousNs;
+				intervalSum += interval;
+				intervalSquares += static_cast<double>(interval) * interval;
+				minIntervalNs = std::min(minIntervalNs, interval);
+				maxIntervalNs = std::max(maxIntervalNs, interval);
+				intervals.record(std::max<int64_t>(interval, 0) / 1000);
+			} else {
+				firstNs = timestampNs;
+			}
+			previousNs = timestampNs;
+			frames++;
+			keyframes += reader.isKeyframe() ? 1 : 0;
+			asyncFrames += reader.isAsync() ? 1 : 0;
+			unchangedFrames += reader.changedLeds() ? 0 : 1;
+			changedLeds += reader.changedLeds();
+			maxChangedLeds = std::max(maxChangedLeds, reader.changedLeds());
+		}
+		const auto complete = checkComplete(reader, path);
+
+		const auto seconds = (previousNs - firstNs) / 1e9;
+		std::cout << path << ": version " << reader.version() << ", " << reader.size() << " bytes, " << frames << " frames";
+		if (frames) {
+			std::cout << " (" << keyframes << " keyframes, " << asyncFrames << " async), " << static_cast<double>(reader.size()) / frames << " bytes per frame";
+		}
+		std::cout << std::endl;
+		if (frames > 1) {
+			const auto mean = intervalSum / (frames - 1);
+			const auto deviation = std::sqrt(std::max(intervalSquares / (frames - 1) - mean * mean, 0.));
+			std::cout << "Duration: " << seconds << " s, " << (frames - 1) / seconds << " fps\n"
+				<< "Frame interval min/mean/max (us): " << minIntervalNs / 1000 << '/' << static_cast<int64_t>(mean) / 1000 << '/' << maxIntervalNs / 1000
+				<< ", jitter (standard deviation): " << static_cast<int64_t>(deviation) / 1000 << " us\n"
+				<< "Frame interval (us): " << intervals.summary() << std::endl;
+		}
+		if (frames) {
+			std::cout << "LEDs changed per frame mean/max: " << static_cast<double>(changedLeds) / frames << '/' << maxChangedLeds
+				<< ", frames without changes: " << unchangedFrames << std::endl;
+		}
+		return complete ? 0 : 2;
+	}
+
+	int replay(const char *path, double speed)
+	{
+		FrameTraceReader reader;
+		if (!openTrace(reader, path)) {
+			return 2;
+		}
+		if (speed <= 0.) {
+			std::cerr << "Invalid speed" << std::endl;
+			return 2;
+		}
+		CorsairPerformProtocolHandshake();
+		if (CorsairGetLastError()) {
+			std::cerr << "Handshake failed" << std::endl;
+			return 2;
+		}
+		CorsairRequestControl(CAM_ExclusiveLightingControl);
+
+		DeltaOutput output;
+		int64_t firstNs = 0;
+		int64_t lateFrames = 0;
+		const auto start = std::chrono::steady_clock::now();
+		while (reader.next()) {
+			if (!reader.frameIndex()) {
+				firstNs = reader.timestampNs();
+			}
+			const auto due = start + std::chrono::nanoseconds(static_cast<int64_t>((reader.timestampNs() - firstNs) / speed));
+			if (std::chrono::steady_clock::now() > due + std::chrono::milliseconds(1)) {
+				lateFrames++;
+			}
+			std::this_thread::sleep_until(due);
+			if (!output.submit(reader.frame())) {
+				std::cerr << "Failed to set led colors at frame " << reader.frameIndex() << std::endl;
+				return 2;
+			}
+		}
+		const auto outputStats = output.stats();
+		std::cout << "Replayed " << outputStats.frames << " frames, " << lateFrames << " more than 1 ms late, "
+			<< outputStats.submittedLeds << " LEDs submitted" << std::endl;
+		return checkComplete(reader, path) ? 0 : 2;
+	}
+
+	int diff(const char *pathA, const char *pathB, int tolerance)
+	{
+		FrameTraceReader a;
+		FrameTraceReader b;
+		if (!openTrace(a, pathA) || !openTrace(b, pathB)) {
+			return 2;
+		}
+		int64_t frames = 0;
+		int64_t differentFrames = 0;
+		int64_t differentLeds = 0;
+		auto maxDelta = 0;
+		auto moreA = false;
+		auto moreB = false;
+		while (true) {
+			moreA = a.next();
+			moreB = b.next();
+			if (!moreA || !moreB) {
+				break;
+			}
+			frames++;
+			auto differentFrame = false;
+			for (auto led = CLI_Invalid + 1; led <= CLI_Last; ++led) {
+				const auto ledId = static_cast<CorsairLedId>(led);
+				const auto activeA = a.frame().isActive(ledId);
+				const auto activeB = b.frame().isActive(ledId);
+				if (!activeA && !activeB) {
+					continue;
+				}
+				auto delta = 256;
+				if (activeA && activeB) {
+					delta = std::max({ std::abs(a.frame().red()[ledId] - b.frame().red()[ledId]),
+						std::abs(a.frame().green()[ledId] - b.frame().green()[ledId]),
+						std::abs(a.frame().blue()[ledId] - b.frame().blue()[ledId]) });
+					maxDelta = std::max(maxDelta, delta);
+				}
+				if (delta > tolerance) {
+					if (!differentFrames && !differentFrame) {
+						std::cout << "First difference at frame " << a.frameIndex() << " (" << a.timestampNs() / 1000000 << " ms), LED " << led
+							<< (activeA && activeB ? "" : activeA ? " only in the first trace" : " only in the second trace") << std::endl;
+					}
+					differentFrame = true;
+					differentLeds++;
+				}
+			}
+			differentFrames += differentFrame ? 1 : 0;
+		}
+		const auto complete = checkComplete(a, pathA) && checkComplete(b, pathB);
+		if (moreA || moreB) {
+			std::cout << (moreA ? pathA : pathB) << " has more frames than " << (moreA ? pathB : pathA) << std::endl;
+		}
+		std::cout << frames << " frames compared, " << differentFrames << " differ by more than " << tolerance << " in "
+			<< differentLeds << " LEDs, largest channel difference " << maxDelta << std::endl;
+		if (!complete) {
+			return 2;
+		}
+		return differentFrames || moreA || moreB ? 1 : 0;
+	}
+
+	int convert(const char *path, const char *outputPath)
+	{
+		FrameTraceReader reader;
+		if (!openTrace(reader, path)) {
+			return 2;
+		}
+		FrameTraceWriter writer;
+		if (!writer.open(outputPath)) {
+			std::cerr << "Cannot create " << outputPath << std::endl;
+			return 2;
+		}
+		while (reader.next()) {
+			writer.writeFrame(reader.timestampNs(), reader.frame(), reader.isAsync());
+		}
+		const auto frames = writer.frames();
+		const auto size = writer.size();
+		if (!writer.close()) {
+			std::cerr << "Cannot write " << outputPath << std::endl;
+			return 2;
+		}
+		std::cout << "Converted " << frames << " frames, " << reader.size() << " bytes to " << size << std::endl;
+		return checkComplete(reader, path) ? 0 : 2;
+	}
+
+	int usage()
+	{
+		std::cerr << "Usage: corsair_trace stats <trace>\n"
+			"       corsair_trace replay <trace> [speed]\n"
+			"       corsair_trace diff <trace> <trace> [tolerance]\n"
+			"       corsair_trace convert <trace> <output>" << std::endl;
+		return 2;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const std::string command = argc > 1 ? argv[1] : "";
+	if (command == "stats" && argc == 3) {
+		return stats(argv[2]);
+	}
+	if (command == "replay" && (argc == 3 || argc == 4)) {
+		return replay(argv[2], argc == 4 ? std::atof(argv[3]) : 1.);
+	}
+	if (command == "diff" && (argc == 4 || argc == 5)) {
+		return diff(argv[2], argv[3], argc == 5 ? std::atoi(argv[4]) : 0);
+	}
+	if (command == "convert" && argc == 4) {
+		return convert(argv[2], argv[3]);
+	}
+	return usage();
+}
@@ -0,0 +1,43 @@
+# Link time and profile guided optimization for every target of the project.
+#
+# PGO workflow:
+#   1. configure with -DCORSAIR_PGO=GENERATE, build, run the workload (e.g. corsair_bench)
+#   2. with Clang merge the raw profiles: llvm-profdata merge -o <CORSAIR_PGO_DIR>/default.profdata <CORSAIR_PGO_DIR>
+#      with MSVC every binary has its own <CORSAIR_PGO_DIR>/<target>.pgd, the runs' .pgc files are merged into it
+#   3. reconfigure with -DCORSAIR_PGO=USE and rebuild
+
+if(CORSAIR_ENABLE_LTO)
+	include(CheckIPOSupported)
+	check_ipo_supported(RESULT ltoSupported OUTPUT ltoError LANGUAGES CXX)
+	if(ltoSupported)
+		set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+	else()
+		message(WARNING "LTO requested but not supported by the toolchain: ${ltoError}")
+	endif()
+endif()
+
+string(TOUPPER "${CORSAIR_PGO}" pgoStage)
+if(pgoStage STREQUAL "GENERATE")
+	file(MAKE_DIRECTORY "${CORSAIR_PGO_DIR}")
+	if(MSVC)
+		add_compile_options(/GL)
+		# $<TARGET_PROPERTY:NAME> is the target being linked, a shared PGD would be overwritten by each of them.
+		add_link_options(/LTCG /GENPROFILE:PGD=${CORSAIR_PGO_DIR}/$<TARGET_PROPERTY:NAME>.pgd)
+	else()
+		add_compile_options(-fprofile-generate=${CORSAIR_PGO_DIR})
+		add_link_options(-fprofile-generate=${CORSAIR_PGO_DIR})
+	endif()
+elseif(pgoStage STREQUAL "USE")
+	if(MSVC)
+		add_compile_options(/GL)
+		add_link_options(/LTCG /USEPROFILE:PGD=${CORSAIR_PGO_DIR}/$<TARGET_PROPERTY:NAME>.pgd)
+	elseif(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+		add_compile_options(-fprofile-use=${CORSAIR_PGO_DIR}/default.profdata -Wno-profile-instr-unprofiled)
+		add_link_options(-fprofile-use=${CORSAIR_PGO_DIR}/default.profdata)
+	else()
+		add_compile_options(-fprofile-use=${CORSAIR_PGO_DIR} -fprofile-correction -Wno-missing-profile)
+		add_link_options(-fprofile-use=${CORSAIR_PGO_DIR})
+	endif()
+elseif(NOT pgoStage STREQUAL "OFF")
+	message(FATAL_ERROR "CORSAIR_PGO must be OFF, GENERATE or USE, got '${CORSAIR_PGO}'")
+endif()